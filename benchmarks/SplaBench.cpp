@@ -0,0 +1,387 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <spla-algo/SplaAlgo.hpp>
+#include <spla-cpp/Spla.hpp>
+#include <utils/Benchmark.hpp>
+#include <utils/Generators.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Options {
+        std::vector<std::string> generators = {"rmat", "er"};
+        std::vector<std::size_t> blockSizes = {10000, 100000};
+        std::vector<std::string> filter;
+        std::size_t scale = 14;
+        std::size_t edgeFactor = 16;
+        std::size_t warmup = 1;
+        std::size_t iterations = 5;
+        std::string output;
+        std::string baseline;
+        double threshold = 0.1;
+    };
+
+    template<typename T, typename Parse>
+    std::vector<T> SplitList(const std::string &list, Parse parse) {
+        std::vector<T> values;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+            if (!item.empty())
+                values.push_back(parse(item));
+        return values;
+    }
+
+    void PrintUsage() {
+        std::cout << "Usage: spla_bench [options]\n"
+                  << "  --generators <list>   Graph generators: rmat,er (default rmat,er)\n"
+                  << "  --scale <n>           Graph has 2^n vertices (default 14)\n"
+                  << "  --edge-factor <n>     Edges per vertex (default 16)\n"
+                  << "  --block-sizes <list>  Library block sizes (default 10000,100000)\n"
+                  << "  --filter <list>       Run only listed benchmarks\n"
+                  << "  --warmup <n>          Not measured runs (default 1)\n"
+                  << "  --iterations <n>      Measured runs (default 5)\n"
+                  << "  --output <file>       Write results json to file\n"
+                  << "  --baseline <file>     Compare results against baseline json\n"
+                  << "  --threshold <x>       Allowed relative slowdown (default 0.1)\n";
+    }
+
+    Options ParseOptions(int argc, const char *const *argv) {
+        Options options;
+        auto toSize = [](const std::string &s) { return static_cast<std::size_t>(std::stoul(s)); };
+        auto toString = [](const std::string &s) { return s; };
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            std::string value = i + 1 < argc ? argv[i + 1] : "";
+
+            if (arg == "--help") {
+                PrintUsage();
+                std::exit(0);
+            }
+
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                PrintUsage();
+                std::exit(1);
+            }
+
+            if (arg == "--generators")
+                options.generators = SplitList<std::string>(value, toString);
+            else if (arg == "--scale")
+                options.scale = toSize(value);
+            else if (arg == "--edge-factor")
+                options.edgeFactor = toSize(value);
+            else if (arg == "--block-sizes")
+                options.blockSizes = SplitList<std::size_t>(value, toSize);
+            else if (arg == "--filter")
+                options.filter = SplitList<std::string>(value, toString);
+            else if (arg == "--warmup")
+                options.warmup = toSize(value);
+            else if (arg == "--iterations")
+                options.iterations = toSize(value);
+            else if (arg == "--output")
+                options.output = value;
+            else if (arg == "--baseline")
+                options.baseline = value;
+            else if (arg == "--threshold")
+                options.threshold = std::stod(value);
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                PrintUsage();
+                std::exit(1);
+            }
+
+            i += 1;
+        }
+
+        return options;
+    }
+
+    /** Shared state of benchmarks for single graph and library */
+    class Context {
+    public:
+        Context(spla::Library &library, const utils::Graph &a, const utils::Graph &b)
+            : library(library), a(a), b(b) {
+            type = spla::Types::Float32(library);
+            mult = spla::Functions::MultFloat32(library);
+            add = spla::Functions::PlusFloat32(library);
+            aVals.resize(a.GetNvals(), 1.0f);
+            bVals.resize(b.GetNvals(), 1.0f);
+
+            n = a.n;
+            vRows = utils::GenerateIndices(n, n / 100 + 1, 1);
+            uRows = utils::GenerateIndices(n, n / 10 + 1, 2);
+            vVals.resize(vRows.size(), 1.0f);
+            uVals.resize(uRows.size(), 1.0f);
+
+            sortedDesc = spla::Descriptor::Make(library);
+            sortedDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+            sortedDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+            spA = MakeMatrix(a, aVals);
+            spB = MakeMatrix(b, bVals);
+            spV = MakeVector(vRows, vVals);
+            spU = MakeVector(uRows, uVals);
+        }
+
+        spla::RefPtr<spla::Matrix> MakeMatrix(const utils::Graph &g, std::vector<float> &vals) {
+            auto m = spla::Matrix::Make(g.n, g.n, type, library);
+            Run([&](spla::Expression &expr) {
+                auto data = spla::DataMatrix::Make(const_cast<unsigned int *>(g.rows.data()),
+                                                   const_cast<unsigned int *>(g.cols.data()),
+                                                   vals.data(), g.GetNvals(), library);
+                expr.MakeDataWrite(m, data, sortedDesc);
+            });
+            return m;
+        }
+
+        spla::RefPtr<spla::Vector> MakeVector(std::vector<unsigned int> &rows, std::vector<float> &vals) {
+            auto v = spla::Vector::Make(n, type, library);
+            Run([&](spla::Expression &expr) {
+                auto data = spla::DataVector::Make(rows.data(), vals.data(), rows.size(), library);
+                expr.MakeDataWrite(v, data, sortedDesc);
+            });
+            return v;
+        }
+
+        template<typename Compose>
+        void Run(Compose compose) {
+            auto expr = spla::Expression::Make(library);
+            compose(*expr);
+            expr->SubmitWait();
+            if (expr->GetState() != spla::Expression::State::Evaluated) {
+                std::cerr << "Benchmark expression is not evaluated" << std::endl;
+                std::exit(1);
+            }
+        }
+
+        spla::Library &library;
+        const utils::Graph &a;
+        const utils::Graph &b;
+        std::size_t n;
+        spla::RefPtr<spla::Type> type;
+        spla::RefPtr<spla::FunctionBinary> mult;
+        spla::RefPtr<spla::FunctionBinary> add;
+        spla::RefPtr<spla::Descriptor> sortedDesc;
+        std::vector<float> aVals;
+        std::vector<float> bVals;
+        std::vector<unsigned int> vRows;
+        std::vector<unsigned int> uRows;
+        std::vector<float> vVals;
+        std::vector<float> uVals;
+        spla::RefPtr<spla::Matrix> spA;
+        spla::RefPtr<spla::Matrix> spB;
+        spla::RefPtr<spla::Vector> spV;
+        spla::RefPtr<spla::Vector> spU;
+    };
+
+    struct Benchmark {
+        const char *name;
+        std::function<utils::BenchmarkResult(Context &, const Options &)> run;
+    };
+
+    utils::BenchmarkResult MeasureExpression(Context &ctx, const Options &options,
+                                             const std::function<void(spla::Expression &)> &compose) {
+        return utils::Measure(
+                options.warmup, options.iterations, []() {},
+                [&]() { ctx.Run(compose); });
+    }
+
+    std::vector<Benchmark> MakeBenchmarks() {
+        std::vector<Benchmark> benchmarks;
+
+        benchmarks.push_back({"MatrixDataWrite", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Matrix::Make(ctx.n, ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      auto data = spla::DataMatrix::Make(const_cast<unsigned int *>(ctx.a.rows.data()),
+                                                                         const_cast<unsigned int *>(ctx.a.cols.data()),
+                                                                         ctx.aVals.data(), ctx.a.GetNvals(), ctx.library);
+                                      expr.MakeDataWrite(w, data, ctx.sortedDesc);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"MatrixDataRead", [](Context &ctx, const Options &options) {
+                                  std::vector<unsigned int> rows(ctx.spA->GetNvals());
+                                  std::vector<unsigned int> cols(ctx.spA->GetNvals());
+                                  std::vector<float> vals(ctx.spA->GetNvals());
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      auto data = spla::DataMatrix::Make(rows.data(), cols.data(), vals.data(), rows.size(), ctx.library);
+                                      expr.MakeDataRead(ctx.spA, data);
+                                  });
+                                  r.nvals = rows.size();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"MxM", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Matrix::Make(ctx.n, ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeMxM(w, nullptr, ctx.mult, ctx.add, ctx.spA, ctx.spA);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"MxMMasked", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Matrix::Make(ctx.n, ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeMxM(w, ctx.spA, ctx.mult, ctx.add, ctx.spA, ctx.spA);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"VxM", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Vector::Make(ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeVxM(w, nullptr, ctx.mult, ctx.add, ctx.spV, ctx.spA);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"MatrixEWiseAdd", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Matrix::Make(ctx.n, ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeEWiseAdd(w, nullptr, ctx.add, ctx.spA, ctx.spB);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"VectorEWiseAdd", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Vector::Make(ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeEWiseAdd(w, nullptr, ctx.add, ctx.spV, ctx.spU);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"Transpose", [](Context &ctx, const Options &options) {
+                                  auto w = spla::Matrix::Make(ctx.n, ctx.n, ctx.type, ctx.library);
+                                  auto r = MeasureExpression(ctx, options, [&](spla::Expression &expr) {
+                                      expr.MakeTranspose(w, nullptr, nullptr, ctx.spA);
+                                  });
+                                  r.nvals = w->GetNvals();
+                                  return r;
+                              }});
+
+        benchmarks.push_back({"Bfs", [](Context &ctx, const Options &options) {
+                                  spla::RefPtr<spla::Vector> v;
+                                  auto r = utils::Measure(
+                                          options.warmup, options.iterations, []() {},
+                                          [&]() { spla::Bfs(v, ctx.spA, 0); });
+                                  r.nvals = v.IsNotNull() ? v->GetNvals() : 0;
+                                  return r;
+                              }});
+
+        return benchmarks;
+    }
+
+    bool IsSelected(const Options &options, const std::string &name) {
+        return options.filter.empty() ||
+               std::find(options.filter.begin(), options.filter.end(), name) != options.filter.end();
+    }
+
+}// namespace
+
+int main(int argc, const char *const *argv) {
+    auto options = ParseOptions(argc, argv);
+    auto benchmarks = MakeBenchmarks();
+    std::vector<utils::BenchmarkResult> results;
+
+    for (auto &generator : options.generators) {
+        utils::GraphParams params;
+        params.generator = generator;
+        params.scale = options.scale;
+        params.edgeFactor = options.edgeFactor;
+
+        auto a = utils::Generate(params);
+        params.seed += 1;
+        auto b = utils::Generate(params);
+        params.seed = 0;
+
+        std::cout << "Graph " << generator << " n=" << a.n << " nvals=" << a.GetNvals() << std::endl;
+
+        for (auto blockSize : options.blockSizes) {
+            spla::Library library(spla::Library::Config().SetBlockSize(blockSize));
+            Context ctx(library, a, b);
+
+            for (auto &benchmark : benchmarks) {
+                if (!IsSelected(options, benchmark.name))
+                    continue;
+
+                auto result = benchmark.run(ctx, options);
+                result.name = benchmark.name;
+                result.graph = params;
+                result.blockSize = blockSize;
+                results.push_back(result);
+
+                std::cout << "  " << std::left << std::setw(48) << result.GetKey()
+                          << std::fixed << std::setprecision(3)
+                          << " min=" << result.min << " ms"
+                          << " mean=" << result.mean << " ms"
+                          << " nvals=" << result.nvals << std::endl;
+            }
+        }
+    }
+
+    if (!options.output.empty()) {
+        std::ofstream file(options.output);
+        utils::WriteJson(file, results);
+    } else {
+        utils::WriteJson(std::cout, results);
+    }
+
+    if (!options.baseline.empty()) {
+        std::ifstream file(options.baseline);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open baseline " << options.baseline << std::endl;
+            return 1;
+        }
+
+        auto baseline = utils::ReadJson(file);
+        auto regressions = utils::CompareWithBaseline(results, baseline, options.threshold, std::cout);
+        std::cout << "Regressions: " << regressions << std::endl;
+        return regressions > 0 ? 1 : 0;
+    }
+
+    return 0;
+}
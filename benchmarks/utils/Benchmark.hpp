@@ -0,0 +1,232 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_BENCHMARK_HPP
+#define SPLA_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utils/Generators.hpp>
+#include <vector>
+
+namespace utils {
+
+    /** Timings of the single benchmark case (in milliseconds) */
+    struct BenchmarkResult {
+        std::string name;
+        GraphParams graph;
+        std::size_t blockSize = 0;
+        std::size_t nvals = 0;
+        std::size_t iterations = 0;
+        double min = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+
+        /** @return Key to match result with the baseline one */
+        [[nodiscard]] std::string GetKey() const {
+            std::stringstream key;
+            key << name << "/" << graph.generator << "/s" << graph.scale << "/ef" << graph.edgeFactor << "/b" << blockSize;
+            return key.str();
+        }
+    };
+
+    /**
+     * Run benchmark case.
+     *
+     * @param warmup Number of not measured runs
+     * @param iterations Number of measured runs
+     * @param setup Called before each run, not measured
+     * @param run Measured function
+     *
+     * @return Collected timings
+     */
+    inline BenchmarkResult Measure(std::size_t warmup, std::size_t iterations,
+                                   const std::function<void()> &setup,
+                                   const std::function<void()> &run) {
+        using Clock = std::chrono::steady_clock;
+
+        for (std::size_t i = 0; i < warmup; i++) {
+            setup();
+            run();
+        }
+
+        std::vector<double> timings;
+        timings.reserve(iterations);
+
+        for (std::size_t i = 0; i < iterations; i++) {
+            setup();
+            auto begin = Clock::now();
+            run();
+            auto end = Clock::now();
+            timings.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+
+        BenchmarkResult result;
+        result.iterations = iterations;
+
+        if (!timings.empty()) {
+            result.min = *std::min_element(timings.begin(), timings.end());
+            result.max = *std::max_element(timings.begin(), timings.end());
+            result.mean = std::accumulate(timings.begin(), timings.end(), 0.0) / static_cast<double>(timings.size());
+        }
+
+        return result;
+    }
+
+    /**
+     * Write results as json.
+     * Each result is written on the separate line, so file is easy to diff.
+     */
+    inline void WriteJson(std::ostream &stream, const std::vector<BenchmarkResult> &results) {
+        stream << "{\n"
+               << "  \"version\": 1,\n"
+               << "  \"results\": [\n";
+
+        for (std::size_t i = 0; i < results.size(); i++) {
+            auto &r = results[i];
+            stream << "    {"
+                   << "\"name\": \"" << r.name << "\", "
+                   << "\"generator\": \"" << r.graph.generator << "\", "
+                   << "\"scale\": " << r.graph.scale << ", "
+                   << "\"edgeFactor\": " << r.graph.edgeFactor << ", "
+                   << "\"blockSize\": " << r.blockSize << ", "
+                   << "\"nvals\": " << r.nvals << ", "
+                   << "\"iterations\": " << r.iterations << ", "
+                   << std::fixed << std::setprecision(4)
+                   << "\"min\": " << r.min << ", "
+                   << "\"mean\": " << r.mean << ", "
+                   << "\"max\": " << r.max << "}"
+                   << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        stream << "  ]\n"
+               << "}\n";
+    }
+
+    namespace detail {
+        inline std::string FindJsonField(const std::string &line, const std::string &field) {
+            auto key = "\"" + field + "\":";
+            auto pos = line.find(key);
+
+            if (pos == std::string::npos)
+                return {};
+
+            pos += key.size();
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '"'))
+                pos += 1;
+
+            auto end = line.find_first_of(",\"}", pos);
+            return line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        }
+    }// namespace detail
+
+    /**
+     * Read results, previously written by WriteJson.
+     * @note Supports only the layout produced by WriteJson.
+     */
+    inline std::vector<BenchmarkResult> ReadJson(std::istream &stream) {
+        std::vector<BenchmarkResult> results;
+        std::string line;
+
+        while (std::getline(stream, line)) {
+            if (line.find("\"name\":") == std::string::npos)
+                continue;
+
+            BenchmarkResult r;
+            r.name = detail::FindJsonField(line, "name");
+            r.graph.generator = detail::FindJsonField(line, "generator");
+            r.graph.scale = std::stoul(detail::FindJsonField(line, "scale"));
+            r.graph.edgeFactor = std::stoul(detail::FindJsonField(line, "edgeFactor"));
+            r.blockSize = std::stoul(detail::FindJsonField(line, "blockSize"));
+            r.nvals = std::stoul(detail::FindJsonField(line, "nvals"));
+            r.iterations = std::stoul(detail::FindJsonField(line, "iterations"));
+            r.min = std::stod(detail::FindJsonField(line, "min"));
+            r.mean = std::stod(detail::FindJsonField(line, "mean"));
+            r.max = std::stod(detail::FindJsonField(line, "max"));
+            results.push_back(std::move(r));
+        }
+
+        return results;
+    }
+
+    /**
+     * Compare results against baseline by min timing.
+     *
+     * @param results Current results
+     * @param baseline Stored baseline results
+     * @param threshold Allowed relative slowdown (0.1 is 10%)
+     * @param stream Stream to print comparison report
+     *
+     * @return Number of regressions
+     */
+    inline std::size_t CompareWithBaseline(const std::vector<BenchmarkResult> &results,
+                                           const std::vector<BenchmarkResult> &baseline,
+                                           double threshold,
+                                           std::ostream &stream) {
+        std::map<std::string, const BenchmarkResult *> baselineByKey;
+        for (auto &r : baseline)
+            baselineByKey[r.GetKey()] = &r;
+
+        std::size_t regressions = 0;
+
+        for (auto &r : results) {
+            auto key = r.GetKey();
+            auto found = baselineByKey.find(key);
+
+            stream << std::left << std::setw(48) << key << " ";
+
+            if (found == baselineByKey.end()) {
+                stream << "no baseline" << std::endl;
+                continue;
+            }
+
+            auto base = found->second->min;
+            auto ratio = base > 0.0 ? r.min / base : 1.0;
+            auto regression = ratio > 1.0 + threshold;
+            regressions += regression ? 1 : 0;
+
+            stream << std::fixed << std::setprecision(3)
+                   << base << " ms -> " << r.min << " ms "
+                   << "(x" << ratio << ")"
+                   << (regression ? " REGRESSION" : "") << std::endl;
+        }
+
+        return regressions;
+    }
+
+}// namespace utils
+
+#endif//SPLA_BENCHMARK_HPP
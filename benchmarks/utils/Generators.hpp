@@ -0,0 +1,157 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_GENERATORS_HPP
+#define SPLA_GENERATORS_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+    /**
+     * Synthetic graph in coordinate format.
+     * Edges are sorted in row-major order and have no duplicates.
+     */
+    struct Graph {
+        using Index = unsigned int;
+
+        std::size_t n = 0;
+        std::vector<Index> rows;
+        std::vector<Index> cols;
+
+        [[nodiscard]] std::size_t GetNvals() const {
+            return rows.size();
+        }
+    };
+
+    /** Synthetic graph generation params */
+    struct GraphParams {
+        std::string generator = "rmat";
+        std::size_t scale = 14;
+        std::size_t edgeFactor = 16;
+        std::size_t seed = 0;
+    };
+
+    namespace detail {
+        inline Graph MakeGraph(std::size_t n, std::vector<std::pair<Graph::Index, Graph::Index>> &edges) {
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            Graph graph;
+            graph.n = n;
+            graph.rows.reserve(edges.size());
+            graph.cols.reserve(edges.size());
+
+            for (auto &edge : edges) {
+                graph.rows.push_back(edge.first);
+                graph.cols.push_back(edge.second);
+            }
+
+            return graph;
+        }
+    }// namespace detail
+
+    /**
+     * Generate R-MAT graph with 2^scale vertices and 2^scale * edgeFactor edges
+     * (before duplicates removal). Uses Graph500 probabilities by default.
+     */
+    inline Graph GenerateRMat(std::size_t scale, std::size_t edgeFactor, std::size_t seed = 0,
+                              double a = 0.57, double b = 0.19, double c = 0.19) {
+        assert(scale > 0 && scale < 32);
+        std::size_t n = std::size_t{1} << scale;
+        std::size_t m = n * edgeFactor;
+
+        std::default_random_engine engine(seed);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        std::vector<std::pair<Graph::Index, Graph::Index>> edges;
+        edges.reserve(m);
+
+        for (std::size_t e = 0; e < m; e++) {
+            Graph::Index i = 0, j = 0;
+            for (std::size_t bit = 0; bit < scale; bit++) {
+                auto p = dist(engine);
+                auto iBit = p >= a + b;
+                auto jBit = (p >= a && p < a + b) || p >= a + b + c;
+                i = (i << 1) | static_cast<Graph::Index>(iBit);
+                j = (j << 1) | static_cast<Graph::Index>(jBit);
+            }
+            edges.emplace_back(i, j);
+        }
+
+        return detail::MakeGraph(n, edges);
+    }
+
+    /**
+     * Generate Erdos-Renyi graph with 2^scale vertices and 2^scale * edgeFactor
+     * uniformly distributed edges (before duplicates removal).
+     */
+    inline Graph GenerateErdosRenyi(std::size_t scale, std::size_t edgeFactor, std::size_t seed = 0) {
+        assert(scale > 0 && scale < 32);
+        std::size_t n = std::size_t{1} << scale;
+        std::size_t m = n * edgeFactor;
+
+        std::default_random_engine engine(seed);
+        std::uniform_int_distribution<Graph::Index> dist(0, static_cast<Graph::Index>(n - 1));
+        std::vector<std::pair<Graph::Index, Graph::Index>> edges;
+        edges.reserve(m);
+
+        for (std::size_t e = 0; e < m; e++)
+            edges.emplace_back(dist(engine), dist(engine));
+
+        return detail::MakeGraph(n, edges);
+    }
+
+    /** Generate graph by generator name: `rmat` or `er` */
+    inline Graph Generate(const GraphParams &params) {
+        if (params.generator == "er")
+            return GenerateErdosRenyi(params.scale, params.edgeFactor, params.seed);
+        return GenerateRMat(params.scale, params.edgeFactor, params.seed);
+    }
+
+    /** Generate sparse sorted set of `count` distinct indices in [0, n) */
+    inline std::vector<Graph::Index> GenerateIndices(std::size_t n, std::size_t count, std::size_t seed = 0) {
+        std::default_random_engine engine(seed);
+        std::uniform_int_distribution<Graph::Index> dist(0, static_cast<Graph::Index>(n - 1));
+        std::vector<Graph::Index> indices(count);
+
+        for (auto &index : indices)
+            index = dist(engine);
+
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        return indices;
+    }
+
+}// namespace utils
+
+#endif//SPLA_GENERATORS_HPP
@@ -50,5 +50,7 @@
 
 #include <spla-algo/SplaAlgoBfs.hpp>
 #include <spla-algo/SplaAlgoCommon.hpp>
+#include <spla-algo/SplaAlgoIO.hpp>
+#include <spla-algo/SplaAlgoReorder.hpp>
 
 #endif//SPLA_SPLAALGO_HPP
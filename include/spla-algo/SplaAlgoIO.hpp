@@ -0,0 +1,88 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAALGOIO_HPP
+#define SPLA_SPLAALGOIO_HPP
+
+#include <spla-algo/SplaAlgoCommon.hpp>
+#include <spla-cpp/SplaConfig.hpp>
+#include <spla-cpp/SplaLibrary.hpp>
+
+namespace spla {
+
+    /**
+     * @addtogroup Algorithm
+     * @{
+     */
+
+    /**
+     * @brief Load matrix from Matrix Market file.
+     *
+     * Supports `coordinate` format with `pattern`, `real` and `integer` fields
+     * and `general`, `symmetric` and `skew-symmetric` symmetry. Symmetric matrices
+     * are expanded, so result contains both (i,j) and (j,i) entries.
+     * Values of `real` field are stored as `float`, values of `integer` field are stored as `std::int32_t`,
+     * `pattern` matrix has no values.
+     *
+     * File is memory mapped and parsed in parallel by chunks using library executor.
+     * Result entries are grouped by library blocks (block row, then block column),
+     * within block sorted in row-column order and have no duplicates (first entry is kept).
+     * So result data can be written into matrix with `ValuesSorted`, `NoDuplicates`
+     * and `ValuesBlocked` descriptor params set, which avoids any sorting or
+     * host entries filtering in data write.
+     *
+     * @note Blocks are the ones chosen by library for matrix dimensions, so `ValuesBlocked`
+     *       is valid only for matrix made without explicit block size.
+     *
+     * @param filename Name of the file to load
+     * @param library Library instance; its block size is used to group entries
+     *
+     * @return Loaded host matrix
+     */
+    SPLA_API RefPtr<HostMatrix> LoadMatrixMarket(const Filename &filename, Library &library);
+
+    /**
+     * @brief Load matrix from binary edge list file.
+     *
+     * File is a raw sequence of (src, dst) pairs of 32-bit unsigned little-endian indices.
+     * Result matrix has no values and has the same entries layout as `LoadMatrixMarket` result.
+     *
+     * @param filename Name of the file to load
+     * @param n Number of graph vertices; pass 0 to use max index + 1
+     * @param library Library instance; its block size is used to group entries
+     *
+     * @return Loaded host matrix with n x n size
+     */
+    SPLA_API RefPtr<HostMatrix> LoadEdgeList(const Filename &filename, Size n, Library &library);
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAALGOIO_HPP
@@ -0,0 +1,119 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAALGOREORDER_HPP
+#define SPLA_SPLAALGOREORDER_HPP
+
+#include <spla-algo/SplaAlgoCommon.hpp>
+#include <spla-cpp/SplaLibrary.hpp>
+#include <spla-cpp/SplaMatrix.hpp>
+
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Algorithm
+     * @{
+     */
+
+    /**
+     * @brief Method of graph vertices reordering.
+     */
+    enum class Reordering {
+        /** Vertices sorted by degree in descending order, so hubs are packed into first blocks */
+        Degree,
+        /** Reverse Cuthill-McKee ordering, which reduces bandwidth of the matrix */
+        ReverseCuthillMcKee,
+        /** Rabbit-like ordering, where vertices of the same community get consecutive indices */
+        Clustering
+    };
+
+    /**
+     * @brief Compute reordering permutation of graph vertices.
+     *
+     * Matrix is treated as adjacency matrix of undirected graph,
+     * so (i,j) and (j,i) entries are both used as edge between i and j; self loops are ignored.
+     *
+     * @param A Input adjacency matrix of the graph; must be n x n
+     * @param method Reordering method
+     *
+     * @return Permutation, where `perm[i]` is new index of the vertex `i`
+     */
+    SPLA_API std::vector<Index> ComputeReordering(const RefPtr<HostMatrix> &A, Reordering method);
+
+    /**
+     * @brief Permute rows and columns of the matrix.
+     *
+     * Entry (i,j) of the matrix becomes entry (perm[i],perm[j]) of the result.
+     * Result entries layout is the same as of `LoadMatrixMarket` result, so it can be written
+     * into matrix with `ValuesSorted`, `NoDuplicates` and `ValuesBlocked` descriptor params set.
+     *
+     * @param A Input matrix; must be n x n
+     * @param perm Permutation of n indices
+     * @param library Library instance; its block size is used to group entries
+     *
+     * @return Permuted host matrix
+     */
+    SPLA_API RefPtr<HostMatrix> PermuteMatrix(const RefPtr<HostMatrix> &A, const std::vector<Index> &perm, Library &library);
+
+    /**
+     * @brief Permute indices of the vector.
+     *
+     * Entry i of the vector becomes entry perm[i] of the result.
+     * Pass inverse to map vector of the reordered graph back to the original indices.
+     *
+     * @param v Input vector of size n
+     * @param perm Permutation of n indices
+     * @param inverse Apply inverse permutation
+     *
+     * @return Permuted host vector
+     */
+    SPLA_API RefPtr<HostVector> PermuteVector(const RefPtr<HostVector> &v, const std::vector<Index> &perm, bool inverse = false);
+
+    /**
+     * @brief Reorder graph vertices and write reordered matrix.
+     *
+     * Computes permutation with specified method, permutes matrix entries
+     * and writes them into the matrix with data write expression node.
+     * Blocks grouping of entries is reused, if matrix has library chosen blocks grid.
+     *
+     * @param A Matrix to write; must be n x n
+     * @param host Input adjacency matrix of the graph; must be n x n
+     * @param method Reordering method
+     *
+     * @return Permutation, where `perm[i]` is new index of the vertex `i`
+     */
+    SPLA_API std::vector<Index> WriteReordered(const RefPtr<Matrix> &A, const RefPtr<HostMatrix> &host, Reordering method);
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAALGOREORDER_HPP
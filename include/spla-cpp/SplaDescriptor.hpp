@@ -57,6 +57,8 @@ namespace spla {
             ValuesSorted,
             /** Provided matrix/vector values has no duplicated */
             NoDuplicates,
+            /** Provided matrix values are grouped by storage blocks in (block row, block column) order */
+            ValuesBlocked,
             /** Apply !mask (complementary mask) to result or input arguments */
             MaskComplement,
             /** Apply default or provided binary op accum to output and temporary operation result */
@@ -82,7 +84,9 @@ namespace spla {
             /** Force `device-6` for expression node computation */
             DeviceId6,
             /** Force `device-7` for expression node computation */
-            DeviceId7
+            DeviceId7,
+            /** Split written matrix into blocks with balanced number of values instead of equally sized blocks; square matrix gets the same rows and columns split */
+            BalancedBlocks
         };
 
         /**
@@ -71,6 +71,8 @@ namespace spla {
         enum class State {
             /** Default expression state after creation */
             Default,
+            /** Expression compiled and ready for (multiple) submission */
+            Compiled,
             /** Expression submitted for evaluation */
             Submitted,
             /** Expression successfully evaluated after submission */
@@ -83,6 +85,7 @@ namespace spla {
          * Submit expression for the execution.
          *
          * @note Expression asynchronously submitted for execution
+         * @note Compiled expression can be submitted again, when previous evaluation is finished
          * @note Expression cannot be modified after submission
          * @note Call wait to block until expression is evaluated
          * @note Call state query to check current state of the expression
@@ -116,6 +119,38 @@ namespace spla {
          */
         void SubmitWait();
 
+        /**
+         * Compile expression for multiple submissions.
+         *
+         * Validates expression graph, optimizes it, selects node processors and
+         * builds tasks graph once. Compiled expression is submitted as usual,
+         * but each submission only composes and runs nodes tasks.
+         *
+         * @note Expression cannot be modified after compilation
+         * @note Use Expression::Bind() to replace host data of data nodes between submissions
+         *
+         * @see Expression::Submit()
+         * @see Expression::Bind()
+         */
+        void Compile();
+
+        /**
+         * Bind new host data to the data read/write node of the expression.
+         *
+         * Allows to reuse compiled expression with other host buffers,
+         * for example to write new scalar value on each iteration of algorithm.
+         *
+         * @note Expression must not be evaluated at the moment of call
+         * @note Data must be of the same kind as the node data (matrix, vector or scalar)
+         *
+         * @param node Data read or data write node of this expression
+         * @param data New host data of the node
+         */
+        void Bind(const RefPtr<ExpressionNode> &node, const RefPtr<Data> &data);
+
+        /** @return True if expression was compiled for multiple submissions */
+        bool IsCompiled() const;
+
         /**
          * Makes dependency between provided expression nodes.
          * Next `succ` node will be evaluated only after `pred` node evaluation is finished.
@@ -132,6 +167,7 @@ namespace spla {
          * @note By default values are automatically sorted and duplicates reduces (keep first entry)
          * @note Use descriptor `ValuesSorted` hint if values already sorted in row-column order.
          * @note Use descriptor `NoDuplicates` hint if values already has no duplicates
+         * @note Use descriptor `ValuesBlocked` hint if values grouped by library blocks (see LoadMatrixMarket)
          *
          * @param matrix Matrix to write data
          * @param data Raw host data to write
@@ -368,6 +404,116 @@ namespace spla {
                                              const RefPtr<Matrix> &a,
                                              const RefPtr<Descriptor> &desc = nullptr);
 
+        /**
+         * Make insertion of the batch of user entries into the provided matrix.
+         * Batch is supposed to be stored as array of (i, j, values) pairs.
+         *
+         * Only storage blocks touched by the batch are updated, other blocks are preserved as is.
+         * If entry already stored in the matrix, its value is replaced by the batch value.
+         *
+         * @note By default batch is automatically sorted and duplicates reduces (keep first entry)
+         * @note Use descriptor `ValuesBlocked` and `ValuesSorted` hints if batch already sorted in block order.
+         * @note Use descriptor `NoDuplicates` hint if batch already has no duplicates
+         *
+         * @param matrix Matrix to insert entries
+         * @param data Raw host batch to insert
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeInsert(const RefPtr<Matrix> &matrix,
+                                          const RefPtr<DataMatrix> &data,
+                                          const RefPtr<Descriptor> &desc = nullptr);
+
+        /**
+         * Make removal of the batch of user entries from the provided matrix.
+         * Batch is supposed to be stored as array of (i, j) pairs, values are ignored.
+         *
+         * Only storage blocks touched by the batch are updated, entries not stored in the matrix are skipped.
+         *
+         * @note Use descriptor `ValuesBlocked` and `ValuesSorted` hints if batch already sorted in block order.
+         * @note Use descriptor `NoDuplicates` hint if batch already has no duplicates
+         *
+         * @param matrix Matrix to remove entries
+         * @param data Raw host batch with indices to remove
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeRemove(const RefPtr<Matrix> &matrix,
+                                          const RefPtr<DataMatrix> &data,
+                                          const RefPtr<Descriptor> &desc = nullptr);
+
+        /**
+         * Make loop, which evaluates body expression while condition holds.
+         * Condition holds if vector has at least one stored value.
+         *
+         * Condition is checked before each iteration on the worker thread,
+         * so whole iterative algorithm is evaluated without host synchronization.
+         *
+         * @note Body is compiled on first composition, it must not be modified after
+         * @note Body must not contain this expression
+         * @note Loop with empty body does nothing
+         *
+         * @param body Expression to evaluate on each iteration
+         * @param condition Vector to check
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeLoop(const RefPtr<Expression> &body,
+                                        const RefPtr<Vector> &condition,
+                                        const RefPtr<Descriptor> &desc = nullptr);
+
+        /**
+         * Make loop, which evaluates body expression while condition holds.
+         * Condition holds if scalar has value and this value is not zero.
+         *
+         * @see Expression::MakeLoop(const RefPtr<Expression>&, const RefPtr<Vector>&, const RefPtr<Descriptor>&)
+         *
+         * @param body Expression to evaluate on each iteration
+         * @param condition Scalar to check
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeLoop(const RefPtr<Expression> &body,
+                                        const RefPtr<Scalar> &condition,
+                                        const RefPtr<Descriptor> &desc = nullptr);
+
+        /**
+         * Make condition, which evaluates body expression once if condition holds.
+         * Condition holds if vector has at least one stored value.
+         *
+         * @note Body is compiled on first composition, it must not be modified after
+         * @note Body must not contain this expression
+         *
+         * @param body Expression to evaluate
+         * @param condition Vector to check
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeCondition(const RefPtr<Expression> &body,
+                                             const RefPtr<Vector> &condition,
+                                             const RefPtr<Descriptor> &desc = nullptr);
+
+        /**
+         * Make condition, which evaluates body expression once if condition holds.
+         * Condition holds if scalar has value and this value is not zero.
+         *
+         * @see Expression::MakeCondition(const RefPtr<Expression>&, const RefPtr<Vector>&, const RefPtr<Descriptor>&)
+         *
+         * @param body Expression to evaluate
+         * @param condition Scalar to check
+         * @param desc Operation descriptor
+         *
+         * @return Created expression node
+         */
+        RefPtr<ExpressionNode> MakeCondition(const RefPtr<Expression> &body,
+                                             const RefPtr<Scalar> &condition,
+                                             const RefPtr<Descriptor> &desc = nullptr);
+
         /** @return Current expression state */
         State GetState() const;
 
@@ -395,6 +541,11 @@ namespace spla {
                                         std::vector<RefPtr<Object>> &&args,
                                         const RefPtr<Descriptor> &desc);
 
+        RefPtr<ExpressionNode> MakeControlNode(ExpressionNode::Operation op,
+                                               const RefPtr<Expression> &body,
+                                               const RefPtr<Object> &condition,
+                                               const RefPtr<Descriptor> &desc);
+
         void SetState(State state);
         void SetFuture(std::unique_ptr<class ExpressionFuture> &&future);
         void SetTasks(std::unique_ptr<class ExpressionTasks> &&tasks);
@@ -403,6 +554,7 @@ namespace spla {
         std::unique_ptr<class ExpressionFuture> mFuture;
         std::unique_ptr<class ExpressionTasks> mTasks;
         std::atomic<State> mState;
+        bool mCompiled = false;
     };
 
     /**
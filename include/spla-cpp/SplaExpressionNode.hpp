@@ -80,7 +80,15 @@ namespace spla {
             /** Matrix-vector multiplication */
             MxV,
             /** Transpose matrix */
-            Transpose
+            Transpose,
+            /** Insert batch of host entries into matrix */
+            MatrixInsert,
+            /** Remove batch of host entries from matrix */
+            MatrixRemove,
+            /** Evaluate sub-expression while condition holds */
+            Loop,
+            /** Evaluate sub-expression once if condition holds */
+            Condition
         };
 
         /** @return Node argument at specified index */
@@ -98,6 +106,7 @@ namespace spla {
     private:
         friend class Expression;
         friend class ExpressionManager;
+        friend class ExpressionOptimizer;
 
         ExpressionNode(Operation operation, class Expression &expression, class Library &library);
 
@@ -158,6 +167,14 @@ namespace spla {
                     return "MxV";
                 case ExpressionNode::Operation::Transpose:
                     return "Transpose";
+                case ExpressionNode::Operation::MatrixInsert:
+                    return "MatrixInsert";
+                case ExpressionNode::Operation::MatrixRemove:
+                    return "MatrixRemove";
+                case ExpressionNode::Operation::Loop:
+                    return "Loop";
+                case ExpressionNode::Operation::Condition:
+                    return "Condition";
 
                 default:
                     return "Unknown";
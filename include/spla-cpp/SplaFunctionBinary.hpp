@@ -52,9 +52,36 @@ namespace spla {
      * Function signature is following `void(_ACCESS_A const void* vp_a, _ACCESS_B const void* vp_b, _ACCESS_C void* vp_c)`,
      * where a, b and c pointers to values, c must be written by the function.
      * It is up to user to cast these pointers to appropriate types and check values sizes.
+     *
+     * Optionally function can provide native host implementation with the same semantic.
+     * It allows host algorithms to evaluate function without kernels launches.
+     *
+     * Predefined functions from Functions are tagged with operation and value type,
+     * what allows kernels to evaluate them natively instead of calling generic source.
      */
     class SPLA_API FunctionBinary final : public Object {
     public:
+        /** Native host implementation of the function: writes c value using a and b values */
+        using HostFunction = void (*)(const void *a, const void *b, void *c);
+
+        /** Operation of predefined function; Custom for user functions */
+        enum class Op {
+            Custom,
+            Plus,
+            Minus,
+            ReverseMinus,
+            Mult,
+            Div,
+            ReverseDiv,
+            TakeFirst,
+            TakeSecond,
+            Or,
+            And,
+            Xor,
+            Min,
+            Max
+        };
+
         ~FunctionBinary() override = default;
 
         /** @return Input type a. */
@@ -69,6 +96,18 @@ namespace spla {
         /** @return OpenCL function body source code. */
         const std::string &GetSource() const;
 
+        /** @return Native host implementation; null if function has only OpenCL source. */
+        HostFunction GetHostFunction() const;
+
+        /** @return True if function has native host implementation. */
+        bool HasHostFunction() const;
+
+        /** @return Operation of predefined function; Custom for user functions. */
+        Op GetOp() const;
+
+        /** @return OpenCL type name of a, b and c values of predefined function; empty for user functions. */
+        const std::string &GetValueType() const;
+
         /**
          * Check if can apply this function to provided objects.
          *
@@ -93,13 +132,46 @@ namespace spla {
          */
         static RefPtr<FunctionBinary> Make(RefPtr<Type> a, RefPtr<Type> b, RefPtr<Type> c, std::string source, Library &library);
 
+        /**
+         * Makes new function binary instance with native host implementation.
+         *
+         * @param a Input type a
+         * @param b Input type b
+         * @param c Result type c
+         * @param source OpenCL function body source code
+         * @param hostFunction Native host implementation with the same semantic as source
+         * @param library Library global state
+         *
+         * @return New function binary instance
+         */
+        static RefPtr<FunctionBinary> Make(RefPtr<Type> a, RefPtr<Type> b, RefPtr<Type> c, std::string source, HostFunction hostFunction, Library &library);
+
+        /**
+         * Makes new predefined function binary instance.
+         *
+         * @param a Input type a
+         * @param b Input type b
+         * @param c Result type c
+         * @param source OpenCL function body source code
+         * @param hostFunction Native host implementation with the same semantic as source
+         * @param op Operation of the function
+         * @param valueType OpenCL type name of a, b and c values
+         * @param library Library global state
+         *
+         * @return New function binary instance
+         */
+        static RefPtr<FunctionBinary> Make(RefPtr<Type> a, RefPtr<Type> b, RefPtr<Type> c, std::string source, HostFunction hostFunction, Op op, std::string valueType, Library &library);
+
     private:
-        FunctionBinary(RefPtr<Type> a, RefPtr<Type> b, RefPtr<Type> c, std::string source, Library &library);
+        FunctionBinary(RefPtr<Type> a, RefPtr<Type> b, RefPtr<Type> c, std::string source, HostFunction hostFunction, Op op, std::string valueType, Library &library);
 
         RefPtr<Type> mA;
         RefPtr<Type> mB;
         RefPtr<Type> mC;
         std::string mSource;
+        HostFunction mHostFunction;
+        Op mOp;
+        std::string mValueType;
     };
 
     /**
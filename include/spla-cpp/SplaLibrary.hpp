@@ -63,9 +63,34 @@ namespace spla {
             /**
              * Default size (nrows and ncols) for matrix/vector block size.
              * Used to split matrix or vector into equal sized storage blocks.
+             * Adaptive block size never exceeds this value.
              */
             static const std::size_t DEFAULT_BLOCK_SIZE = 1000000;
 
+            /**
+             * Minimum adaptive block size.
+             * Smaller blocks are not worth separate device tasks.
+             */
+            static const std::size_t MIN_ADAPTIVE_BLOCK_SIZE = 4096;
+
+            /**
+             * Minimum number of values in a row (column) of blocks of adaptive block size.
+             * Dimension of object with expected number of values is split into fewer blocks to keep it.
+             */
+            static const std::size_t MIN_ADAPTIVE_BLOCK_NVALS = 65536;
+
+            /**
+             * Default estimated number of scalar products in a single blocks product,
+             * above which blocks product is split into several tasks.
+             */
+            static const std::size_t DEFAULT_PRODUCT_SPLIT_THRESHOLD = 1 << 24;
+
+            /**
+             * Default number of input entries of a single algorithm invocation,
+             * below which operation is evaluated on host through mapped buffers.
+             */
+            static const std::size_t DEFAULT_HOST_PATH_THRESHOLD = 512;
+
             /**
              * Type of OpenCL device.
              */
@@ -127,7 +152,19 @@ namespace spla {
             Config &SetLogFilename(Filename filename);
 
             /**
-             * Set matrix/vector block size param.
+             * Set trace file name, to write execution trace in Chrome trace-event format.
+             *
+             * Trace contains taskflow tasks spans per worker thread, algorithms spans
+             * per device queue and blocks memory counters. Trace is written on library
+             * destruction, can be opened in `chrome://tracing` or Perfetto UI.
+             *
+             * @param filename Trace file name
+             * @return This config
+             */
+            Config &SetTraceFilename(Filename filename);
+
+            /**
+             * Set fixed matrix/vector block size param.
              *
              * This param used to split primitives data:
              * - matrix data in equally sized blocks of size `blockSize` x `blockSize`
@@ -138,26 +175,182 @@ namespace spla {
              * each block processing can be submitted to the separate gpu/queue
              * as a stand alone task.
              *
+             * If block size is not set, it is chosen per matrix/vector dimension
+             * from the dimension and the number of devices (see `IsBlockSizeAdaptive`).
+             * Block size also can be set per object on `Matrix::Make` and `Vector::Make`.
+             *
              * @param blockSize Size of the matrix/vector block; must be greater then zero
              * @return This config
              */
             Config &SetBlockSize(std::size_t blockSize);
 
+            /**
+             * Set device memory budget for blocks of matrices, mapped from snapshot files.
+             *
+             * Blocks of mapped matrix are uploaded to device on first access.
+             * When uploaded blocks of the matrix exceed this budget, least recently
+             * used blocks are evicted from device memory and uploaded again on next access.
+             *
+             * @param budget Budget in bytes per mapped matrix; zero means unlimited
+             * @return This config
+             */
+            Config &SetMappedMemoryBudget(std::size_t budget);
+
+            /**
+             * Enable or disable expressions graph optimization before evaluation.
+             *
+             * Optimizer skips nodes with overwritten results, merges identical nodes,
+             * forwards host data of data write nodes to data read nodes and fuses
+             * supported pairs of nodes into single processing step.
+             *
+             * @param enable True to optimize expressions (enabled by default)
+             * @return This config
+             */
+            Config &SetExpressionOptimization(bool enable);
+
+            /**
+             * Enable or disable online calibration of algorithms selection.
+             *
+             * Library measures time of each algorithm invocation per amount of work magnitude
+             * and prefers measured times over static cost estimates, when selects the cheapest algorithm.
+             *
+             * @param enable True to calibrate algorithms selection (disabled by default)
+             * @return This config
+             */
+            Config &SetAlgorithmCalibration(bool enable);
+
+            /**
+             * Set threshold of blocks product splitting.
+             *
+             * Blocks product of matrix-matrix and vector-matrix multiplication is a single
+             * task by default. If estimated number of scalar products of the blocks pair
+             * exceeds threshold, rows of the left block are split into ranges, which are
+             * multiplied as separate tasks on different devices and queues, so a single
+             * heavy block of skewed matrix does not delay the whole expression.
+             *
+             * @param threshold Estimated number of scalar products; zero disables splitting
+             * @return This config
+             */
+            Config &SetProductSplitThreshold(std::size_t threshold);
+
+            /**
+             * Set threshold of host evaluation of tiny operations.
+             *
+             * Vector-matrix multiplication, vector element-wise addition, assignment,
+             * reduction and mask application on blocks with a few entries are dominated
+             * by kernels launches and buffers allocation. If number of input entries does not
+             * exceed threshold, indices are processed on host through mapped buffers and
+             * only user functions are evaluated on device (by at most a single kernel).
+             *
+             * @param threshold Number of input entries; zero disables host evaluation
+             * @return This config
+             */
+            Config &SetHostPathThreshold(std::size_t threshold);
+
+            /**
+             * Force host path of the algorithms for blocks of any size.
+             *
+             * Host algorithms of matrix-matrix and vector-matrix multiplication, element-wise
+             * addition, transpose, assignment and reduction are selected regardless of `SetHostPathThreshold`,
+             * if used binary functions have native host implementation (all predefined functions have).
+             * Values are evaluated by native functions without kernels compilation and launches.
+             *
+             * @note This is not a separate backend: blocks are still stored in device buffers and
+             *       accessed through mapped memory (zero-copy for CPU devices), so an OpenCL device is required.
+             *
+             * @param enable True to force host path
+             * @return This config
+             */
+            Config &SetForceHostPath(bool enable);
+
+            /**
+             * Enable auto-tuning of kernels launch geometry.
+             *
+             * Work-group size of values kernels and tile size of keys merge are benchmarked
+             * for each device the first time a kernel processes enough entries. The fastest
+             * candidate is used by all subsequent launches on devices with the same name,
+             * driver version and platform.
+             *
+             * @note Tuned values are shared by all libraries of the process.
+             *
+             * @param enable True to tune kernels (disabled by default)
+             * @return This config
+             */
+            Config &SetKernelTuning(bool enable);
+
+            /**
+             * Set file to keep kernels tuning results.
+             *
+             * Tuned values are loaded from the file on library creation, if it exists,
+             * and the file is rewritten each time a new value is tuned.
+             * Tuning results are shared by libraries of the process, so libraries
+             * existing at the same time must use the same file.
+             *
+             * @param filename Tuning file name
+             * @return This config
+             */
+            Config &SetKernelTuningFilename(Filename filename);
+
             /** @return List of available devices for specified config settings */
             [[nodiscard]] std::vector<std::string> GetDevicesNames() const;
 
             /** @return Log filename */
             [[nodiscard]] const std::optional<Filename> &GetLogFilename() const;
 
-            /** @return Block size */
+            /** @return Trace filename */
+            [[nodiscard]] const std::optional<Filename> &GetTraceFilename() const;
+
+            /** @return Block size; upper bound of block size if it is adaptive */
             [[nodiscard]] std::size_t GetBlockSize() const;
 
+            /**
+             * @return True if block size was not set explicitly, so it is chosen per dimension:
+             *         dimension is split in twice the number of devices blocks (or fewer, so each row
+             *         of blocks of object with expected number of values has at least `MIN_ADAPTIVE_BLOCK_NVALS`),
+             *         which size is clamped into [`MIN_ADAPTIVE_BLOCK_SIZE`, `DEFAULT_BLOCK_SIZE`].
+             */
+            [[nodiscard]] bool IsBlockSizeAdaptive() const;
+
+            /** @return Mapped matrices device memory budget */
+            [[nodiscard]] std::size_t GetMappedMemoryBudget() const;
+
+            /** @return True if expressions graph optimization enabled */
+            [[nodiscard]] bool GetExpressionOptimization() const;
+
+            /** @return True if online calibration of algorithms selection enabled */
+            [[nodiscard]] bool GetAlgorithmCalibration() const;
+
+            /** @return Threshold of blocks product splitting */
+            [[nodiscard]] std::size_t GetProductSplitThreshold() const;
+
+            /** @return Threshold of host evaluation of tiny operations */
+            [[nodiscard]] std::size_t GetHostPathThreshold() const;
+
+            /** @return True if host path of the algorithms is forced for blocks of any size */
+            [[nodiscard]] bool GetForceHostPath() const;
+
+            /** @return True if auto-tuning of kernels launch geometry enabled */
+            [[nodiscard]] bool GetKernelTuning() const;
+
+            /** @return Kernels tuning filename */
+            [[nodiscard]] const std::optional<Filename> &GetKernelTuningFilename() const;
+
         private:
             std::optional<std::string> mPlatformName;
             std::optional<DeviceType> mDeviceType;
             std::optional<std::size_t> mDeviceAmount = std::optional{1U};
             std::optional<Filename> mLogFilename;
+            std::optional<Filename> mTraceFilename;
             std::size_t mBlockSize = DEFAULT_BLOCK_SIZE;
+            bool mBlockSizeAdaptive = true;
+            std::size_t mMappedMemoryBudget = 0;
+            bool mExpressionOptimization = true;
+            bool mAlgorithmCalibration = false;
+            std::size_t mProductSplitThreshold = DEFAULT_PRODUCT_SPLIT_THRESHOLD;
+            std::size_t mHostPathThreshold = DEFAULT_HOST_PATH_THRESHOLD;
+            bool mForceHostPath = false;
+            bool mKernelTuning = false;
+            std::optional<Filename> mKernelTuningFilename;
         };
 
     public:
@@ -86,17 +86,65 @@ namespace spla {
         /** @copydoc Object::Clone() */
         RefPtr<Object> Clone() const override;
 
+        /**
+         * Save matrix content into binary snapshot file.
+         * Snapshot stores blocks grid and blocks sorted indices and values as is,
+         * so it can be loaded back without sorting and duplicates reduction.
+         *
+         * @note Snapshot keeps blocks grid, so loaded matrix has the same block size.
+         *
+         * @param filename Name of the file to write.
+         */
+        void Save(const Filename &filename) const;
+
         /**
          * Make new matrix with specified size.
          *
+         * By default block size of each dimension is chosen by library from the dimension,
+         * the expected number of values and the number of devices (see `Library::Config::SetBlockSize`),
+         * so matrices and vectors of the same dimensions without expected number of values share blocks grid. Arguments with different blocks grids can be
+         * used together, but then blocks are remapped onto the grid of the operation first.
+         *
          * @param nrows Number of matrix rows.
          * @param ncols Number of matrix columns
          * @param type Type of stored values.
          * @param library Library global instance.
+         * @param blockSize Optional size of matrix blocks in both dimensions; zero to choose it by library.
+         * @param nvals Optional expected number of values; zero if unknown. Used only if block size is chosen by library.
+         *
+         * @return New matrix instance.
+         */
+        static RefPtr<Matrix> Make(std::size_t nrows, std::size_t ncols, const RefPtr<Type> &type, class Library &library,
+                                   std::size_t blockSize = 0, std::size_t nvals = 0);
+
+        /**
+         * Load matrix from binary snapshot file, written by `Matrix::Save`.
+         *
+         * @param filename Name of the file to load.
+         * @param type Type of stored values; must have the same byte size as saved matrix type.
+         * @param library Library global instance.
+         *
+         * @return New matrix instance.
+         */
+        static RefPtr<Matrix> Load(const Filename &filename, const RefPtr<Type> &type, class Library &library);
+
+        /**
+         * Make matrix backed by memory mapped snapshot file, written by `Matrix::Save`.
+         *
+         * Matrix blocks are uploaded to the device only on first access, so expressions
+         * which touch only a part of the blocks grid do not require whole matrix in device memory.
+         * Uploaded blocks are evicted in least recently used order, when they exceed
+         * library mapped memory budget (see `Library::Config::SetMappedMemoryBudget`).
+         *
+         * @note Snapshot file must not be modified while matrix is alive.
+         *
+         * @param filename Name of the file to map.
+         * @param type Type of stored values; must have the same byte size as saved matrix type.
+         * @param library Library global instance.
          *
          * @return New matrix instance.
          */
-        static RefPtr<Matrix> Make(std::size_t nrows, std::size_t ncols, const RefPtr<Type> &type, class Library &library);
+        static RefPtr<Matrix> Map(const Filename &filename, const RefPtr<Type> &type, class Library &library);
 
     private:
         Matrix(std::size_t nrows, std::size_t ncols, const RefPtr<Type> &type, class Library &library, RefPtr<class MatrixStorage> storage = nullptr);
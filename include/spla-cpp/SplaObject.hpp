@@ -91,6 +91,7 @@ namespace spla {
 
     private:
         friend class ExpressionManager;
+        friend class ExpressionOptimizer;
         virtual RefPtr<Object> CloneEmpty();
         virtual void CopyData(const RefPtr<Object> &object);
 
@@ -78,16 +78,44 @@ namespace spla {
         /** @copydoc Object::Clone() */
         RefPtr<Object> Clone() const override;
 
+        /**
+         * Save vector content into binary snapshot file.
+         * Snapshot stores blocks sorted indices and values as is,
+         * so it can be loaded back without sorting and duplicates reduction.
+         *
+         * @note Snapshot keeps blocks grid, so loaded vector has the same block size.
+         *
+         * @param filename Name of the file to write
+         */
+        void Save(const Filename &filename) const;
+
         /**
          * Make new vector with specified size
          *
+         * By default block size is chosen by library from the number of rows,
+         * the expected number of values and the number of devices (see `Library::Config::SetBlockSize`).
+         *
          * @param nrows Number of vector rows
          * @param type Type of stored values
          * @param library Library global instance
+         * @param blockSize Optional size of vector blocks; zero to choose it by library
+         * @param nvals Optional expected number of values; zero if unknown. Used only if block size is chosen by library
+         *
+         * @return New vector instance
+         */
+        static RefPtr<Vector> Make(std::size_t nrows, const RefPtr<Type> &type, class Library &library,
+                                   std::size_t blockSize = 0, std::size_t nvals = 0);
+
+        /**
+         * Load vector from binary snapshot file, written by `Vector::Save`
+         *
+         * @param filename Name of the file to load
+         * @param type Type of stored values; must have the same byte size as saved vector type
+         * @param library Library global instance
          *
          * @return New vector instance
          */
-        static RefPtr<Vector> Make(std::size_t nrows, const RefPtr<Type> &type, class Library &library);
+        static RefPtr<Vector> Load(const Filename &filename, const RefPtr<Type> &type, class Library &library);
 
     private:
         Vector(std::size_t nrows, const RefPtr<Type> &type, class Library &library, RefPtr<class VectorStorage> storage = nullptr);
@@ -30,6 +30,7 @@
 
 #include <compute/SplaIndicesToRowOffsets.hpp>
 #include <core/SplaError.hpp>
+#include <storage/SplaMatrixStorage.hpp>
 
 #include <limits>
 #include <queue>
@@ -42,11 +43,12 @@ void spla::Bfs(RefPtr<Vector> &sp_v, const RefPtr<Matrix> &sp_A, Index s) {
 
     auto &library = sp_A->GetLibrary();
     auto n = sp_A->GetNrows();
+    auto blockSize = sp_A->GetStorage()->GetRowBlockSize();
 
-    // Vector with reached levels
-    sp_v = Vector::Make(n, Types::Int32(library), library);
+    // Vector with reached levels; split as matrix rows and columns
+    sp_v = Vector::Make(n, Types::Int32(library), library, blockSize);
     // Vector-front of the bfs
-    auto sp_q = Vector::Make(n, Types::Void(library), library);
+    auto sp_q = Vector::Make(n, Types::Void(library), library, blockSize);
     // Scalar to update depth of the v
     auto sp_depth = Scalar::Make(Types::Int32(library), library);
 
@@ -66,17 +68,20 @@ void spla::Bfs(RefPtr<Vector> &sp_v, const RefPtr<Matrix> &sp_A, Index s) {
     // Start for depth 1: v[s]=1
     std::int32_t depth = 1;
 
-    while (sp_q->GetNvals() != 0) {
-        auto sp_iter = Expression::Make(library);
+    // Single iteration expression, compiled once and submitted for each level
+    // NOTE: depth scalar data references `depth`, so each submission writes actual level
+    auto sp_iter = Expression::Make(library);
 
-        auto t1 = sp_iter->MakeDataWrite(sp_depth, DataScalar::Make(&depth, library));     // Update depth scalar
-        auto t2 = sp_iter->MakeAssign(sp_v, sp_q, nullptr, sp_depth, sp_desc_accum);       // New reached vertices v[q] = depth
-        auto t3 = sp_iter->MakeVxM(sp_q, sp_v, nullptr, nullptr, sp_q, sp_A, sp_desc_comp);// Discover new front q[!v] = q x A
+    auto t1 = sp_iter->MakeDataWrite(sp_depth, DataScalar::Make(&depth, library));     // Update depth scalar
+    auto t2 = sp_iter->MakeAssign(sp_v, sp_q, nullptr, sp_depth, sp_desc_accum);       // New reached vertices v[q] = depth
+    auto t3 = sp_iter->MakeVxM(sp_q, sp_v, nullptr, nullptr, sp_q, sp_A, sp_desc_comp);// Discover new front q[!v] = q x A
 
-        sp_iter->Dependency(t1, t2);
-        sp_iter->Dependency(t2, t3);
-        sp_iter->SubmitWait();
+    sp_iter->Dependency(t1, t2);
+    sp_iter->Dependency(t2, t3);
+    sp_iter->Compile();
 
+    while (sp_q->GetNvals() != 0) {
+        sp_iter->SubmitWait();
         depth += 1;
     }
 }
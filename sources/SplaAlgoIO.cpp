@@ -0,0 +1,487 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <spla-algo/SplaAlgoIO.hpp>
+
+#include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaMath.hpp>
+#include <utils/SplaMappedFile.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using spla::Index;
+    using spla::Size;
+
+    /** Entries parsed from single file chunk */
+    struct Entries {
+        std::vector<Index> rows;
+        std::vector<Index> cols;
+        std::vector<unsigned char> vals;
+        std::size_t parsed = 0;// Number of file entries, without mirrored ones
+    };
+
+    /** Collects first error from parallel tasks, since tasks must not throw */
+    class TaskErrors {
+    public:
+        template<typename Work>
+        void Run(Work &&work) {
+            try {
+                work();
+            } catch (std::exception &ex) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mMessage.empty())
+                    mMessage = ex.what();
+            }
+        }
+
+        void Check() const {
+            CHECK_RAISE_ERROR(mMessage.empty(), InvalidArgument, mMessage);
+        }
+
+    private:
+        std::string mMessage;
+        std::mutex mMutex;
+    };
+
+    /** Runs work(i) for i in [0..count) in parallel and waits for completion */
+    template<typename Work>
+    void ParallelFor(tf::Executor &executor, std::size_t count, Work work) {
+        tf::Taskflow taskflow;
+        for (std::size_t i = 0; i < count; i++)
+            taskflow.emplace([i, &work]() { work(i); });
+        executor.run(taskflow).wait();
+    }
+
+    /** Split text into chunks with approximately equal size; each chunk ends with line end */
+    std::vector<std::pair<const char *, const char *>> SplitLines(const char *begin, const char *end, std::size_t chunksCount) {
+        std::vector<std::pair<const char *, const char *>> chunks;
+        auto size = static_cast<std::size_t>(end - begin);
+        auto chunkSize = std::max<std::size_t>(size / std::max<std::size_t>(chunksCount, 1), 1);
+
+        auto first = begin;
+        while (first < end) {
+            auto last = first + std::min(chunkSize, static_cast<std::size_t>(end - first));
+            while (last < end && *(last - 1) != '\n')
+                last += 1;
+            chunks.emplace_back(first, last);
+            first = last;
+        }
+
+        return chunks;
+    }
+
+    std::size_t GetChunksCount(tf::Executor &executor, std::size_t bytes) {
+        // Do not split into too small chunks, overhead will dominate
+        const std::size_t minChunkSize = 1024 * 1024;
+        return std::max<std::size_t>(1, std::min<std::size_t>(executor.num_workers() * 4, bytes / minChunkSize));
+    }
+
+    inline bool IsSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline void SkipSpaces(const char *&p, const char *end) {
+        while (p < end && IsSpace(*p))
+            p += 1;
+    }
+
+    inline void SkipLine(const char *&p, const char *end) {
+        while (p < end && *p != '\n')
+            p += 1;
+        if (p < end)
+            p += 1;
+    }
+
+    inline bool ParseUnsigned(const char *&p, const char *end, std::uint64_t &value) {
+        SkipSpaces(p, end);
+        if (p >= end || *p < '0' || *p > '9')
+            return false;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+            p += 1;
+        }
+        return true;
+    }
+
+    /** Copies token into local buffer, since mapped memory is not null-terminated */
+    inline bool ParseToken(const char *&p, const char *end, char (&buffer)[64]) {
+        SkipSpaces(p, end);
+        std::size_t length = 0;
+        while (p < end && !IsSpace(*p) && *p != '\n' && length + 1 < sizeof(buffer))
+            buffer[length++] = *(p++);
+        buffer[length] = '\0';
+        return length > 0;
+    }
+
+    enum class MMField {
+        Pattern,
+        Real,
+        Integer
+    };
+
+    enum class MMSymmetry {
+        General,
+        Symmetric,
+        SkewSymmetric
+    };
+
+    struct MMHeader {
+        MMField field = MMField::Real;
+        MMSymmetry symmetry = MMSymmetry::General;
+        Size nrows = 0;
+        Size ncols = 0;
+        Size nvals = 0;
+        const char *body = nullptr;
+    };
+
+    std::string ToLower(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+        return s;
+    }
+
+    MMHeader ParseMMHeader(const char *begin, const char *end) {
+        MMHeader header;
+        auto p = begin;
+
+        // Banner: %%MatrixMarket matrix coordinate <field> <symmetry>
+        char tokens[5][64];
+        for (auto &token : tokens)
+            CHECK_RAISE_ERROR(ParseToken(p, end, token), InvalidArgument, "Invalid Matrix Market banner");
+
+        CHECK_RAISE_ERROR(ToLower(tokens[0]) == "%%matrixmarket", InvalidArgument, "Invalid Matrix Market banner " << tokens[0]);
+        CHECK_RAISE_ERROR(ToLower(tokens[1]) == "matrix", InvalidArgument, "Not supported Matrix Market object " << tokens[1]);
+        CHECK_RAISE_ERROR(ToLower(tokens[2]) == "coordinate", NotImplemented, "Not supported Matrix Market format " << tokens[2]);
+
+        auto field = ToLower(tokens[3]);
+        if (field == "pattern")
+            header.field = MMField::Pattern;
+        else if (field == "real" || field == "double")
+            header.field = MMField::Real;
+        else if (field == "integer")
+            header.field = MMField::Integer;
+        else
+            RAISE_ERROR(NotImplemented, "Not supported Matrix Market field " << tokens[3]);
+
+        auto symmetry = ToLower(tokens[4]);
+        if (symmetry == "general")
+            header.symmetry = MMSymmetry::General;
+        else if (symmetry == "symmetric")
+            header.symmetry = MMSymmetry::Symmetric;
+        else if (symmetry == "skew-symmetric")
+            header.symmetry = MMSymmetry::SkewSymmetric;
+        else
+            RAISE_ERROR(NotImplemented, "Not supported Matrix Market symmetry " << tokens[4]);
+
+        SkipLine(p, end);
+
+        // Skip comments and empty lines
+        while (p < end) {
+            auto line = p;
+            SkipSpaces(line, end);
+            if (line < end && *line != '%' && *line != '\n')
+                break;
+            SkipLine(p, end);
+        }
+
+        std::uint64_t nrows, ncols, nvals;
+        CHECK_RAISE_ERROR(ParseUnsigned(p, end, nrows) && ParseUnsigned(p, end, ncols) && ParseUnsigned(p, end, nvals),
+                          InvalidArgument, "Invalid Matrix Market size line");
+        CHECK_RAISE_ERROR(nrows > 0 && ncols > 0, InvalidArgument, "Matrix Market matrix must have non-zero size");
+        SkipLine(p, end);
+
+        header.nrows = static_cast<Size>(nrows);
+        header.ncols = static_cast<Size>(ncols);
+        header.nvals = static_cast<Size>(nvals);
+        header.body = p;
+
+        return header;
+    }
+
+    template<typename T>
+    void AppendValue(std::vector<unsigned char> &vals, T value) {
+        auto offset = vals.size();
+        vals.resize(offset + sizeof(T));
+        std::memcpy(vals.data() + offset, &value, sizeof(T));
+    }
+
+    void ParseMMChunk(const MMHeader &header, const char *p, const char *end, Entries &entries) {
+        auto symmetric = header.symmetry != MMSymmetry::General;
+        auto skew = header.symmetry == MMSymmetry::SkewSymmetric;
+        char token[64];
+
+        while (p < end) {
+            auto line = p;
+            SkipSpaces(line, end);
+
+            if (line >= end || *line == '%' || *line == '\n') {
+                SkipLine(p, end);
+                continue;
+            }
+
+            std::uint64_t i, j;
+            CHECK_RAISE_ERROR(ParseUnsigned(p, end, i) && ParseUnsigned(p, end, j), InvalidArgument,
+                              "Invalid Matrix Market entry");
+            CHECK_RAISE_ERROR(1 <= i && i <= header.nrows && 1 <= j && j <= header.ncols, InvalidArgument,
+                              "Matrix Market entry (" << i << "," << j << ") is out of matrix bounds");
+
+            auto row = static_cast<Index>(i - 1);
+            auto col = static_cast<Index>(j - 1);
+            auto mirror = symmetric && row != col;
+            entries.parsed += 1;
+
+            entries.rows.push_back(row);
+            entries.cols.push_back(col);
+
+            if (mirror) {
+                entries.rows.push_back(col);
+                entries.cols.push_back(row);
+            }
+
+            if (header.field != MMField::Pattern) {
+                CHECK_RAISE_ERROR(ParseToken(p, end, token), InvalidArgument, "Matrix Market entry has no value");
+
+                if (header.field == MMField::Real) {
+                    auto value = static_cast<float>(std::strtod(token, nullptr));
+                    AppendValue(entries.vals, value);
+                    if (mirror)
+                        AppendValue(entries.vals, skew ? -value : value);
+                } else {
+                    auto value = static_cast<std::int32_t>(std::strtol(token, nullptr, 10));
+                    AppendValue(entries.vals, value);
+                    if (mirror)
+                        AppendValue(entries.vals, skew ? -value : value);
+                }
+            }
+
+            SkipLine(p, end);
+        }
+    }
+
+    /**
+     * Merge parsed chunks into single host matrix, where entries grouped by
+     * blocks of the library block size for matrix dimensions, sorted within block and have no duplicates.
+     *
+     * Entries are distributed into block rows buckets (in parallel by chunks),
+     * then each block row is sorted by (block col, row, col) and compacted (in parallel by block rows).
+     */
+    spla::RefPtr<spla::HostMatrix> MakeBlocked(spla::Library &library, Size nrows, Size ncols, Size byteSize,
+                                               std::vector<Entries> &chunks) {
+        auto &executor = library.GetPrivate().GetTaskFlowExecutor();
+        auto rowBlockSize = library.GetPrivate().GetBlockSize(nrows);
+        auto colBlockSize = library.GetPrivate().GetBlockSize(ncols);
+        auto nBlockRows = spla::math::GetBlocksCount(nrows, rowBlockSize);
+        auto nChunks = chunks.size();
+
+        // Count entries of each chunk in each block row
+        std::vector<std::vector<Size>> counts(nChunks, std::vector<Size>(nBlockRows, 0));
+        ParallelFor(executor, nChunks, [&](std::size_t c) {
+            for (auto row : chunks[c].rows)
+                counts[c][row / rowBlockSize] += 1;
+        });
+
+        // Offsets of chunk entries within block row buckets
+        std::vector<Size> bucketOffsets(nBlockRows + 1, 0);
+        std::vector<std::vector<Size>> writeOffsets(nChunks, std::vector<Size>(nBlockRows, 0));
+        for (std::size_t b = 0; b < nBlockRows; b++) {
+            Size offset = bucketOffsets[b];
+            for (std::size_t c = 0; c < nChunks; c++) {
+                writeOffsets[c][b] = offset;
+                offset += counts[c][b];
+            }
+            bucketOffsets[b + 1] = offset;
+        }
+
+        auto total = bucketOffsets[nBlockRows];
+        std::vector<Index> rows(total);
+        std::vector<Index> cols(total);
+        std::vector<unsigned char> vals(total * byteSize);
+
+        // Scatter entries into buckets; chunks order preserved, so the first duplicate stays first
+        ParallelFor(executor, nChunks, [&](std::size_t c) {
+            auto &entries = chunks[c];
+            auto &offsets = writeOffsets[c];
+            for (std::size_t k = 0; k < entries.rows.size(); k++) {
+                auto dst = offsets[entries.rows[k] / rowBlockSize]++;
+                rows[dst] = entries.rows[k];
+                cols[dst] = entries.cols[k];
+                if (byteSize)
+                    std::memcpy(&vals[dst * byteSize], &entries.vals[k * byteSize], byteSize);
+            }
+            entries = Entries();
+        });
+
+        // Sort and compact each block row
+        std::vector<Size> bucketSizes(nBlockRows, 0);
+        std::vector<Index> sortedRows(total);
+        std::vector<Index> sortedCols(total);
+        std::vector<unsigned char> sortedVals(total * byteSize);
+
+        ParallelFor(executor, nBlockRows, [&](std::size_t b) {
+            auto first = bucketOffsets[b];
+            auto last = bucketOffsets[b + 1];
+            std::vector<Size> perm(last - first);
+            std::iota(perm.begin(), perm.end(), first);
+            std::stable_sort(perm.begin(), perm.end(), [&](Size x, Size y) {
+                auto bx = cols[x] / colBlockSize, by = cols[y] / colBlockSize;
+                if (bx != by) return bx < by;
+                if (rows[x] != rows[y]) return rows[x] < rows[y];
+                return cols[x] < cols[y];
+            });
+
+            auto dst = first;
+            for (std::size_t k = 0; k < perm.size(); k++) {
+                auto src = perm[k];
+                if (dst > first && sortedRows[dst - 1] == rows[src] && sortedCols[dst - 1] == cols[src])
+                    continue;
+                sortedRows[dst] = rows[src];
+                sortedCols[dst] = cols[src];
+                if (byteSize)
+                    std::memcpy(&sortedVals[dst * byteSize], &vals[src * byteSize], byteSize);
+                dst += 1;
+            }
+
+            bucketSizes[b] = dst - first;
+        });
+
+        // Remove gaps after duplicates removal
+        std::vector<Size> resultOffsets(nBlockRows + 1, 0);
+        std::inclusive_scan(bucketSizes.begin(), bucketSizes.end(), resultOffsets.begin() + 1);
+
+        auto resultNvals = resultOffsets[nBlockRows];
+        if (resultNvals != total) {
+            ParallelFor(executor, nBlockRows, [&](std::size_t b) {
+                auto src = bucketOffsets[b];
+                auto dst = resultOffsets[b];
+                auto count = bucketSizes[b];
+                std::copy_n(sortedRows.begin() + src, count, rows.begin() + dst);
+                std::copy_n(sortedCols.begin() + src, count, cols.begin() + dst);
+                std::copy_n(sortedVals.begin() + src * byteSize, count * byteSize, vals.begin() + dst * byteSize);
+            });
+            rows.resize(resultNvals);
+            cols.resize(resultNvals);
+            vals.resize(resultNvals * byteSize);
+        } else {
+            std::swap(rows, sortedRows);
+            std::swap(cols, sortedCols);
+            std::swap(vals, sortedVals);
+        }
+
+        return spla::RefPtr<spla::HostMatrix>(new spla::HostMatrix(nrows, ncols, std::move(rows), std::move(cols), std::move(vals)));
+    }
+
+}// namespace
+
+spla::RefPtr<spla::HostMatrix> spla::LoadMatrixMarket(const Filename &filename, Library &library) {
+    MappedFile file(filename);
+    CHECK_RAISE_ERROR(file.GetSize() > 0, InvalidArgument, "Matrix Market file is empty");
+
+    auto begin = file.GetData();
+    auto end = begin + file.GetSize();
+    auto header = ParseMMHeader(begin, end);
+
+    auto &executor = library.GetPrivate().GetTaskFlowExecutor();
+    auto chunks = SplitLines(header.body, end, GetChunksCount(executor, static_cast<std::size_t>(end - header.body)));
+    auto symmetric = header.symmetry != MMSymmetry::General;
+
+    std::vector<Entries> entries(chunks.size());
+    TaskErrors errors;
+
+    ParallelFor(executor, chunks.size(), [&](std::size_t c) {
+        errors.Run([&]() {
+            // Reserve approximately, assuming uniform entries distribution
+            auto chunkNvals = header.nvals / chunks.size() + 1;
+            entries[c].rows.reserve(symmetric ? 2 * chunkNvals : chunkNvals);
+            entries[c].cols.reserve(symmetric ? 2 * chunkNvals : chunkNvals);
+            ParseMMChunk(header, chunks[c].first, chunks[c].second, entries[c]);
+        });
+    });
+
+    errors.Check();
+
+    std::size_t parsed = 0;
+    for (auto &chunk : entries)
+        parsed += chunk.parsed;
+
+    CHECK_RAISE_ERROR(parsed == header.nvals, InvalidArgument,
+                      "Matrix Market file has " << parsed << " entries, but " << header.nvals << " declared in header");
+
+    Size byteSize = header.field == MMField::Pattern ? 0 : 4;
+    return MakeBlocked(library, header.nrows, header.ncols, byteSize, entries);
+}
+
+spla::RefPtr<spla::HostMatrix> spla::LoadEdgeList(const Filename &filename, Size n, Library &library) {
+    MappedFile file(filename);
+
+    const std::size_t edgeSize = 2 * sizeof(std::uint32_t);
+    CHECK_RAISE_ERROR(file.GetSize() % edgeSize == 0, InvalidArgument,
+                      "Edge list file size must be multiple of " << edgeSize << " bytes");
+
+    auto &executor = library.GetPrivate().GetTaskFlowExecutor();
+    auto nedges = file.GetSize() / edgeSize;
+    auto nChunks = std::min<std::size_t>(GetChunksCount(executor, file.GetSize()), std::max<std::size_t>(nedges, 1));
+    auto chunkEdges = (nedges + nChunks - 1) / nChunks;
+
+    std::vector<Entries> entries(nChunks);
+    std::vector<std::uint32_t> maxIndex(nChunks, 0);
+
+    ParallelFor(executor, nChunks, [&](std::size_t c) {
+        auto first = std::min(nedges, c * chunkEdges);
+        auto last = std::min(nedges, first + chunkEdges);
+        auto &chunk = entries[c];
+        chunk.rows.resize(last - first);
+        chunk.cols.resize(last - first);
+
+        for (std::size_t e = first; e < last; e++) {
+            std::uint32_t edge[2];
+            std::memcpy(edge, file.GetData() + e * edgeSize, edgeSize);
+            chunk.rows[e - first] = edge[0];
+            chunk.cols[e - first] = edge[1];
+            maxIndex[c] = std::max(maxIndex[c], std::max(edge[0], edge[1]));
+        }
+    });
+
+    auto maxVertex = static_cast<Size>(*std::max_element(maxIndex.begin(), maxIndex.end()));
+    if (n == 0)
+        n = maxVertex + 1;
+
+    CHECK_RAISE_ERROR(nedges == 0 || maxVertex < n, InvalidArgument,
+                      "Edge list vertex " << maxVertex << " is out of graph bounds " << n);
+
+    return MakeBlocked(library, n, n, 0, entries);
+}
@@ -0,0 +1,439 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <spla-algo/SplaAlgoReorder.hpp>
+#include <spla-cpp/Spla.hpp>
+
+#include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace {
+
+    using spla::Index;
+    using spla::Size;
+
+    /** Undirected graph in compressed rows form, built from matrix entries */
+    struct Graph {
+        std::vector<Size> offsets;
+        std::vector<Index> adjacent;
+
+        [[nodiscard]] Size GetN() const { return offsets.size() - 1; }
+        [[nodiscard]] Size GetDegree(Index v) const { return offsets[v + 1] - offsets[v]; }
+    };
+
+    /** Make symmetric graph from matrix entries; self loops are ignored */
+    Graph MakeGraph(const spla::RefPtr<spla::HostMatrix> &A) {
+        auto n = A->GetNrows();
+        auto &rows = A->GetRowIndices();
+        auto &cols = A->GetColIndices();
+
+        Graph graph;
+        graph.offsets.resize(n + 1, 0);
+
+        for (std::size_t k = 0; k < rows.size(); k++) {
+            if (rows[k] != cols[k]) {
+                graph.offsets[rows[k] + 1] += 1;
+                graph.offsets[cols[k] + 1] += 1;
+            }
+        }
+
+        std::partial_sum(graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
+        graph.adjacent.resize(graph.offsets[n]);
+
+        std::vector<Size> writeOffsets(graph.offsets.begin(), graph.offsets.end() - 1);
+        for (std::size_t k = 0; k < rows.size(); k++) {
+            if (rows[k] != cols[k]) {
+                graph.adjacent[writeOffsets[rows[k]]++] = cols[k];
+                graph.adjacent[writeOffsets[cols[k]]++] = rows[k];
+            }
+        }
+
+        return graph;
+    }
+
+    /** Vertices in ascending degree order; ties are resolved by index */
+    std::vector<Index> GetByDegree(const Graph &graph) {
+        std::vector<Index> vertices(graph.GetN());
+        std::iota(vertices.begin(), vertices.end(), 0);
+        std::stable_sort(vertices.begin(), vertices.end(), [&](Index a, Index b) {
+            return graph.GetDegree(a) < graph.GetDegree(b);
+        });
+        return vertices;
+    }
+
+    /** Bfs from start; fills levels of reached vertices and returns eccentricity of start */
+    Size GetLevels(const Graph &graph, Index start, std::vector<Size> &levels, std::vector<Index> &reached) {
+        for (auto v : reached)
+            levels[v] = std::numeric_limits<Size>::max();
+
+        reached.clear();
+        reached.push_back(start);
+        levels[start] = 0;
+
+        Size eccentricity = 0;
+        for (std::size_t k = 0; k < reached.size(); k++) {
+            auto v = reached[k];
+            for (auto i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                auto u = graph.adjacent[i];
+                if (levels[u] == std::numeric_limits<Size>::max()) {
+                    levels[u] = levels[v] + 1;
+                    eccentricity = levels[u];
+                    reached.push_back(u);
+                }
+            }
+        }
+
+        return eccentricity;
+    }
+
+    /** Find pseudo-peripheral vertex of the start component (George-Liu heuristic) */
+    Index GetPeripheral(const Graph &graph, Index start, std::vector<Size> &levels, std::vector<Index> &reached) {
+        const int maxIterations = 8;
+
+        auto root = start;
+        auto eccentricity = GetLevels(graph, root, levels, reached);
+
+        for (int iteration = 0; iteration < maxIterations; iteration++) {
+            // Candidate is the vertex with min degree among the farthest ones
+            auto candidate = root;
+            for (auto v : reached) {
+                if (levels[v] == eccentricity && (candidate == root || graph.GetDegree(v) < graph.GetDegree(candidate)))
+                    candidate = v;
+            }
+
+            auto candidateEccentricity = GetLevels(graph, candidate, levels, reached);
+            if (candidateEccentricity <= eccentricity)
+                break;
+
+            root = candidate;
+            eccentricity = candidateEccentricity;
+        }
+
+        return root;
+    }
+
+    /** Hubs first */
+    std::vector<Index> OrderByDegree(const Graph &graph) {
+        std::vector<Index> order(graph.GetN());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+            return graph.GetDegree(a) > graph.GetDegree(b);
+        });
+        return order;
+    }
+
+    /** Bfs from peripheral vertex of each component, neighbours are visited in ascending degree order */
+    std::vector<Index> OrderByRcm(const Graph &graph) {
+        auto n = graph.GetN();
+
+        std::vector<Index> order;
+        std::vector<bool> visited(n, false);
+        std::vector<Size> levels(n, std::numeric_limits<Size>::max());
+        std::vector<Index> reached;
+        std::vector<Index> neighbours;
+
+        order.reserve(n);
+
+        for (auto start : GetByDegree(graph)) {
+            if (visited[start])
+                continue;
+
+            auto root = GetPeripheral(graph, start, levels, reached);
+            auto first = order.size();
+
+            order.push_back(root);
+            visited[root] = true;
+
+            for (auto k = first; k < order.size(); k++) {
+                auto v = order[k];
+
+                neighbours.clear();
+                for (auto i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                    auto u = graph.adjacent[i];
+                    if (!visited[u]) {
+                        visited[u] = true;
+                        neighbours.push_back(u);
+                    }
+                }
+
+                std::stable_sort(neighbours.begin(), neighbours.end(), [&](Index a, Index b) {
+                    return graph.GetDegree(a) < graph.GetDegree(b);
+                });
+
+                order.insert(order.end(), neighbours.begin(), neighbours.end());
+            }
+        }
+
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    /**
+     * Rabbit-like ordering: vertices in ascending degree order are merged into neighbour
+     * community with max modularity gain; then communities dendrogram is traversed in depth,
+     * so each community gets consecutive range of indices.
+     *
+     * @note Gain is estimated by edges of the merged vertex only, without aggregation of its community edges.
+     */
+    std::vector<Index> OrderByClustering(const Graph &graph) {
+        auto n = graph.GetN();
+        auto totalWeight = static_cast<double>(graph.adjacent.size());
+
+        std::vector<Index> parent(n);
+        std::vector<double> degrees(n);
+        std::vector<std::vector<Index>> children(n);
+        std::vector<double> weights(n, 0.0);
+        std::vector<Index> touched;
+
+        std::iota(parent.begin(), parent.end(), 0);
+        for (Index v = 0; v < n; v++)
+            degrees[v] = static_cast<double>(graph.GetDegree(v));
+
+        auto find = [&](Index v) {
+            auto root = v;
+            while (parent[root] != root)
+                root = parent[root];
+            while (parent[v] != root) {
+                auto next = parent[v];
+                parent[v] = root;
+                v = next;
+            }
+            return root;
+        };
+
+        if (totalWeight > 0) {
+            for (auto v : GetByDegree(graph)) {
+                // Weights of edges from v to neighbour communities
+                touched.clear();
+                for (auto i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                    auto community = find(graph.adjacent[i]);
+                    if (community == v)
+                        continue;
+                    if (weights[community] == 0.0)
+                        touched.push_back(community);
+                    weights[community] += 1.0;
+                }
+
+                auto best = v;
+                auto bestGain = 0.0;
+                for (auto community : touched) {
+                    auto gain = weights[community] / totalWeight - degrees[v] * degrees[community] / (totalWeight * totalWeight);
+                    if (gain > bestGain) {
+                        best = community;
+                        bestGain = gain;
+                    }
+                    weights[community] = 0.0;
+                }
+
+                if (best != v) {
+                    parent[v] = best;
+                    degrees[best] += degrees[v];
+                    children[best].push_back(v);
+                }
+            }
+        }
+
+        // Depth-first traversal of dendrogram: community root, then merged children in merge order
+        std::vector<Index> order;
+        std::vector<Index> stack;
+        order.reserve(n);
+
+        for (Index v = 0; v < n; v++) {
+            if (parent[v] != v)
+                continue;
+
+            stack.push_back(v);
+            while (!stack.empty()) {
+                auto u = stack.back();
+                stack.pop_back();
+                order.push_back(u);
+                stack.insert(stack.end(), children[u].rbegin(), children[u].rend());
+            }
+        }
+
+        return order;
+    }
+
+    /** Check that perm is a permutation of n indices */
+    void CheckPermutation(const std::vector<Index> &perm, Size n) {
+        CHECK_RAISE_ERROR(perm.size() == n, DimensionMismatch, "Permutation must have " << n << " indices");
+
+        std::vector<bool> seen(n, false);
+        for (auto i : perm) {
+            CHECK_RAISE_ERROR(i < n && !seen[i], InvalidArgument, "Invalid permutation index " << i);
+            seen[i] = true;
+        }
+    }
+
+}// namespace
+
+std::vector<spla::Index> spla::ComputeReordering(const RefPtr<HostMatrix> &A, Reordering method) {
+    CHECK_RAISE_ERROR(A.IsNotNull(), NullPointer, "Passed null argument");
+    CHECK_RAISE_ERROR(A->GetNrows() == A->GetNcols(), DimensionMismatch, "Matrix must be nxn");
+
+    auto graph = MakeGraph(A);
+    std::vector<Index> order;
+
+    switch (method) {
+        case Reordering::Degree:
+            order = OrderByDegree(graph);
+            break;
+        case Reordering::ReverseCuthillMcKee:
+            order = OrderByRcm(graph);
+            break;
+        case Reordering::Clustering:
+            order = OrderByClustering(graph);
+            break;
+        default:
+            RAISE_ERROR(NotImplemented, "Unknown reordering method");
+    }
+
+    // Order lists old indices in new order, permutation maps old index to new one
+    std::vector<Index> perm(order.size());
+    for (std::size_t k = 0; k < order.size(); k++)
+        perm[order[k]] = static_cast<Index>(k);
+
+    return perm;
+}
+
+spla::RefPtr<spla::HostMatrix> spla::PermuteMatrix(const RefPtr<HostMatrix> &A, const std::vector<Index> &perm, Library &library) {
+    CHECK_RAISE_ERROR(A.IsNotNull(), NullPointer, "Passed null argument");
+    CHECK_RAISE_ERROR(A->GetNrows() == A->GetNcols(), DimensionMismatch, "Matrix must be nxn");
+    CheckPermutation(perm, A->GetNrows());
+
+    auto blockSize = library.GetPrivate().GetBlockSize(A->GetNrows());
+    auto nvals = A->GetNnvals();
+    auto byteSize = A->GetElementSize();
+    auto &rows = A->GetRowIndices();
+    auto &cols = A->GetColIndices();
+    auto &vals = A->GetValues();
+
+    std::vector<Index> permRows(nvals);
+    std::vector<Index> permCols(nvals);
+    for (std::size_t k = 0; k < nvals; k++) {
+        permRows[k] = perm[rows[k]];
+        permCols[k] = perm[cols[k]];
+    }
+
+    // Group entries by blocks as loaders do; stable to keep the first of duplicates
+    std::vector<Size> order(nvals);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](Size x, Size y) {
+        auto bx = std::make_pair(permRows[x] / blockSize, permCols[x] / blockSize);
+        auto by = std::make_pair(permRows[y] / blockSize, permCols[y] / blockSize);
+        if (bx != by) return bx < by;
+        if (permRows[x] != permRows[y]) return permRows[x] < permRows[y];
+        return permCols[x] < permCols[y];
+    });
+
+    std::vector<Index> resultRows;
+    std::vector<Index> resultCols;
+    std::vector<unsigned char> resultVals;
+    resultRows.reserve(nvals);
+    resultCols.reserve(nvals);
+    resultVals.reserve(nvals * byteSize);
+
+    for (auto src : order) {
+        if (!resultRows.empty() && resultRows.back() == permRows[src] && resultCols.back() == permCols[src])
+            continue;
+        resultRows.push_back(permRows[src]);
+        resultCols.push_back(permCols[src]);
+        if (byteSize)
+            resultVals.insert(resultVals.end(), vals.begin() + src * byteSize, vals.begin() + (src + 1) * byteSize);
+    }
+
+    return RefPtr<HostMatrix>(new HostMatrix(A->GetNrows(), A->GetNcols(), std::move(resultRows), std::move(resultCols), std::move(resultVals)));
+}
+
+spla::RefPtr<spla::HostVector> spla::PermuteVector(const RefPtr<HostVector> &v, const std::vector<Index> &perm, bool inverse) {
+    CHECK_RAISE_ERROR(v.IsNotNull(), NullPointer, "Passed null argument");
+    CheckPermutation(perm, v->GetNrows());
+
+    auto nvals = v->GetNnvals();
+    auto byteSize = v->GetElementSize();
+    auto &rows = v->GetRowIndices();
+    auto &vals = v->GetValues();
+
+    std::vector<Index> map(perm);
+    if (inverse) {
+        for (std::size_t i = 0; i < perm.size(); i++)
+            map[perm[i]] = static_cast<Index>(i);
+    }
+
+    std::vector<Size> order(nvals);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](Size x, Size y) { return map[rows[x]] < map[rows[y]]; });
+
+    std::vector<Index> resultRows(nvals);
+    std::vector<unsigned char> resultVals(nvals * byteSize);
+    for (std::size_t k = 0; k < nvals; k++) {
+        resultRows[k] = map[rows[order[k]]];
+        if (byteSize)
+            std::memcpy(&resultVals[k * byteSize], &vals[order[k] * byteSize], byteSize);
+    }
+
+    return RefPtr<HostVector>(new HostVector(v->GetNrows(), std::move(resultRows), std::move(resultVals)));
+}
+
+std::vector<spla::Index> spla::WriteReordered(const RefPtr<Matrix> &A, const RefPtr<HostMatrix> &host, Reordering method) {
+    CHECK_RAISE_ERROR(A.IsNotNull(), NullPointer, "Passed null argument");
+    CHECK_RAISE_ERROR(host.IsNotNull(), NullPointer, "Passed null argument");
+    CHECK_RAISE_ERROR(A->GetNrows() == host->GetNrows() && A->GetNcols() == host->GetNcols(), DimensionMismatch,
+                      "Matrix and host matrix must have the same size");
+
+    auto &library = A->GetLibrary();
+    auto perm = ComputeReordering(host, method);
+    auto permuted = PermuteMatrix(host, perm, library);
+
+    // Entries are already grouped, sorted and unique
+    auto desc = Descriptor::Make(library);
+    desc->SetParam(Descriptor::Param::ValuesSorted);
+    desc->SetParam(Descriptor::Param::NoDuplicates);
+
+    // Entries are grouped by library blocks, which may differ from explicit matrix blocks
+    auto blockSize = library.GetPrivate().GetBlockSize(A->GetNrows());
+    auto &storage = A->GetStorage();
+    if (storage->GetRowBlockSize() == blockSize && storage->GetColBlockSize() == blockSize)
+        desc->SetParam(Descriptor::Param::ValuesBlocked);
+
+    auto expression = Expression::Make(library);
+    expression->MakeDataWrite(A, permuted->GetData(library), desc);
+    expression->SubmitWait();
+
+    CHECK_RAISE_ERROR(expression->GetState() == Expression::State::Evaluated, InvalidState,
+                      "Failed to write reordered matrix");
+
+    return perm;
+}
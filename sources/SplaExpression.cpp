@@ -35,7 +35,7 @@
 spla::Expression::~Expression() {
     // Before destruction we must wait until it is executed
     // NOTE: if was not submitted, nothing to do
-    if (GetState() != State::Default)
+    if (GetState() != State::Default && GetState() != State::Compiled)
         Wait();
 
     mFuture.reset();
@@ -51,15 +51,20 @@ spla::Expression::Expression(spla::Library &library) : Object(Object::TypeName::
 }
 
 void spla::Expression::Submit() {
-    CHECK_RAISE_ERROR(GetState() == State::Default, InvalidState, "Expression must be in default state before submission");
+    if (IsCompiled()) {
+        CHECK_RAISE_ERROR(GetState() != State::Submitted, InvalidState, "Compiled expression must be evaluated before next submission");
+    } else {
+        CHECK_RAISE_ERROR(GetState() == State::Default, InvalidState, "Expression must be in default state before submission");
+    }
+
     GetLibrary().GetPrivate().GetExprManager()->Submit(this);
 }
 
 void spla::Expression::Wait() {
-    CHECK_RAISE_ERROR(GetState() != State::Default, InvalidState, "Expression must be submitted for the execution");
+    CHECK_RAISE_ERROR(GetState() != State::Default && GetState() != State::Compiled, InvalidState, "Expression must be submitted for the execution");
 
-    // NOTE: Wait only if submitted
-    if (GetState() == State::Submitted)
+    // NOTE: Wait only if submitted; body of control flow node has no own future
+    if (GetState() == State::Submitted && mFuture)
         mFuture->Get().wait();
 }
 
@@ -68,6 +73,43 @@ void spla::Expression::SubmitWait() {
     Wait();
 }
 
+void spla::Expression::Compile() {
+    CHECK_RAISE_ERROR(GetState() == State::Default, InvalidState, "Expression must be in default state before compilation");
+    GetLibrary().GetPrivate().GetExprManager()->Compile(this);
+}
+
+void spla::Expression::Bind(const spla::RefPtr<spla::ExpressionNode> &node, const spla::RefPtr<spla::Data> &data) {
+    CHECK_RAISE_ERROR(GetState() != State::Submitted, InvalidState, "Expression must not be evaluated while binding data");
+
+    CHECK_RAISE_ERROR(node.IsNotNull(), NullPointer, "Passed null arg");
+    CHECK_RAISE_ERROR(data.IsNotNull(), NullPointer, "Passed null arg");
+    CHECK_RAISE_ERROR(node->Belongs(*this), InvalidArgument, "Node must be part of expression");
+
+    auto &args = node->GetArgs();
+    auto isDataNode = args.size() == 2 && args[1].IsNotNull() &&
+                      (args[1]->GetTypeName() == Object::TypeName::DataMatrix ||
+                       args[1]->GetTypeName() == Object::TypeName::DataVector ||
+                       args[1]->GetTypeName() == Object::TypeName::DataScalar);
+
+    CHECK_RAISE_ERROR(isDataNode, InvalidArgument, "Node must be data read or write node");
+    CHECK_RAISE_ERROR(args[1]->GetTypeName() == data->GetTypeName(), InvalidType,
+                      "Data must be " << ObjectTypeToStr(args[1]->GetTypeName()));
+
+    args[1] = data.As<Object>();
+
+    // Optimizer rewrites may depend on node data, compose tasks again on next submission
+    // NOTE: taskflow may still finish its last tasks after notification
+    if (mTasks && mTasks->IsRewritten(node->GetIdx())) {
+        if (mFuture)
+            mFuture->Get().wait();
+        mTasks.reset();
+    }
+}
+
+bool spla::Expression::IsCompiled() const {
+    return mCompiled;
+}
+
 void spla::Expression::Dependency(const spla::RefPtr<spla::ExpressionNode> &pred,
                                   const spla::RefPtr<spla::ExpressionNode> &succ) {
     CHECK_RAISE_ERROR(GetState() == State::Default, InvalidState, "Expression must be in default state");
@@ -380,6 +422,89 @@ spla::Expression::MakeTranspose(const spla::RefPtr<spla::Matrix> &w,
                     desc);
 }
 
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeInsert(const spla::RefPtr<spla::Matrix> &matrix,
+                             const spla::RefPtr<spla::DataMatrix> &data,
+                             const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(matrix.IsNotNull(), NullPointer, "matrix can't be null");
+    CHECK_RAISE_ERROR(data.IsNotNull(), NullPointer, "data can't be null");
+
+    std::vector<RefPtr<Object>> args = {
+            matrix.As<Object>(),
+            data.As<Object>()};
+
+    return MakeNode(ExpressionNode::Operation::MatrixInsert,
+                    std::move(args),
+                    desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeRemove(const spla::RefPtr<spla::Matrix> &matrix,
+                             const spla::RefPtr<spla::DataMatrix> &data,
+                             const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(matrix.IsNotNull(), NullPointer, "matrix can't be null");
+    CHECK_RAISE_ERROR(data.IsNotNull(), NullPointer, "data can't be null");
+
+    std::vector<RefPtr<Object>> args = {
+            matrix.As<Object>(),
+            data.As<Object>()};
+
+    return MakeNode(ExpressionNode::Operation::MatrixRemove,
+                    std::move(args),
+                    desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeLoop(const spla::RefPtr<spla::Expression> &body,
+                           const spla::RefPtr<spla::Vector> &condition,
+                           const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(condition.IsNotNull(), NullPointer, "condition can't be null");
+    return MakeControlNode(ExpressionNode::Operation::Loop, body, condition.As<Object>(), desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeLoop(const spla::RefPtr<spla::Expression> &body,
+                           const spla::RefPtr<spla::Scalar> &condition,
+                           const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(condition.IsNotNull(), NullPointer, "condition can't be null");
+    return MakeControlNode(ExpressionNode::Operation::Loop, body, condition.As<Object>(), desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeCondition(const spla::RefPtr<spla::Expression> &body,
+                                const spla::RefPtr<spla::Vector> &condition,
+                                const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(condition.IsNotNull(), NullPointer, "condition can't be null");
+    return MakeControlNode(ExpressionNode::Operation::Condition, body, condition.As<Object>(), desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeCondition(const spla::RefPtr<spla::Expression> &body,
+                                const spla::RefPtr<spla::Scalar> &condition,
+                                const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(condition.IsNotNull(), NullPointer, "condition can't be null");
+    return MakeControlNode(ExpressionNode::Operation::Condition, body, condition.As<Object>(), desc);
+}
+
+spla::RefPtr<spla::ExpressionNode>
+spla::Expression::MakeControlNode(ExpressionNode::Operation op,
+                                  const spla::RefPtr<spla::Expression> &body,
+                                  const spla::RefPtr<spla::Object> &condition,
+                                  const spla::RefPtr<spla::Descriptor> &desc) {
+    CHECK_RAISE_ERROR(body.IsNotNull(), NullPointer, "body can't be null");
+    CHECK_RAISE_ERROR(body.Get() != this, InvalidArgument, "Expression can't be body of itself");
+    CHECK_RAISE_ERROR(body->GetState() == State::Default || body->GetState() == State::Compiled, InvalidState,
+                      "Body expression must be in default or compiled state");
+
+    std::vector<RefPtr<Object>> args = {
+            body.As<Object>(),
+            condition};
+
+    return MakeNode(op,
+                    std::move(args),
+                    desc);
+}
+
 void spla::Expression::SetState(State state) {
     mState.store(state);
 }
@@ -43,6 +43,22 @@ const std::string &spla::FunctionBinary::GetSource() const {
     return mSource;
 }
 
+spla::FunctionBinary::HostFunction spla::FunctionBinary::GetHostFunction() const {
+    return mHostFunction;
+}
+
+bool spla::FunctionBinary::HasHostFunction() const {
+    return mHostFunction != nullptr;
+}
+
+spla::FunctionBinary::Op spla::FunctionBinary::GetOp() const {
+    return mOp;
+}
+
+const std::string &spla::FunctionBinary::GetValueType() const {
+    return mValueType;
+}
+
 bool spla::FunctionBinary::CanApply(const spla::TypedObject &a, const spla::TypedObject &b, const spla::TypedObject &c) const {
     return a.GetType() == GetA() &&
            b.GetType() == GetB() &&
@@ -50,9 +66,17 @@ bool spla::FunctionBinary::CanApply(const spla::TypedObject &a, const spla::Type
 }
 
 spla::RefPtr<spla::FunctionBinary> spla::FunctionBinary::Make(spla::RefPtr<spla::Type> a, spla::RefPtr<spla::Type> b, spla::RefPtr<spla::Type> c, std::string source, spla::Library &library) {
-    return RefPtr<FunctionBinary>(new FunctionBinary(std::move(a), std::move(b), std::move(c), std::move(source), library));
+    return RefPtr<FunctionBinary>(new FunctionBinary(std::move(a), std::move(b), std::move(c), std::move(source), nullptr, Op::Custom, std::string(), library));
+}
+
+spla::RefPtr<spla::FunctionBinary> spla::FunctionBinary::Make(spla::RefPtr<spla::Type> a, spla::RefPtr<spla::Type> b, spla::RefPtr<spla::Type> c, std::string source, HostFunction hostFunction, spla::Library &library) {
+    return RefPtr<FunctionBinary>(new FunctionBinary(std::move(a), std::move(b), std::move(c), std::move(source), hostFunction, Op::Custom, std::string(), library));
+}
+
+spla::RefPtr<spla::FunctionBinary> spla::FunctionBinary::Make(spla::RefPtr<spla::Type> a, spla::RefPtr<spla::Type> b, spla::RefPtr<spla::Type> c, std::string source, HostFunction hostFunction, Op op, std::string valueType, spla::Library &library) {
+    return RefPtr<FunctionBinary>(new FunctionBinary(std::move(a), std::move(b), std::move(c), std::move(source), hostFunction, op, std::move(valueType), library));
 }
 
-spla::FunctionBinary::FunctionBinary(spla::RefPtr<spla::Type> a, spla::RefPtr<spla::Type> b, spla::RefPtr<spla::Type> c, std::string source, spla::Library &library)
-    : Object(TypeName::FunctionBinary, library), mA(std::move(a)), mB(std::move(b)), mC(std::move(c)), mSource(std::move(source)) {
+spla::FunctionBinary::FunctionBinary(spla::RefPtr<spla::Type> a, spla::RefPtr<spla::Type> b, spla::RefPtr<spla::Type> c, std::string source, HostFunction hostFunction, Op op, std::string valueType, spla::Library &library)
+    : Object(TypeName::FunctionBinary, library), mA(std::move(a)), mB(std::move(b)), mC(std::move(c)), mSource(std::move(source)), mHostFunction(hostFunction), mOp(op), mValueType(std::move(valueType)) {
 }
@@ -25,7 +25,11 @@
 /* SOFTWARE.                                                                      */
 /**********************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <sstream>
+#include <type_traits>
 
 #include <spla-cpp/SplaFunctions.hpp>
 
@@ -71,6 +75,21 @@ namespace {
             os << "b";
         });
     }
+
+    /** Host counterpart of the function body: c = f(a, b) */
+    template<typename T, typename F>
+    void HostApply(const void *a, const void *b, void *c, F f) {
+        *static_cast<T *>(c) = static_cast<T>(f(*static_cast<const T *>(a), *static_cast<const T *>(b)));
+    }
+
+    /** Integer division by zero traps on host, while it is only undefined value in OpenCL */
+    template<typename T>
+    T HostDiv(T a, T b) {
+        if constexpr (std::is_integral_v<T>)
+            return b != 0 ? static_cast<T>(a / b) : T{0};
+        else
+            return a / b;
+    }
 }// namespace
 
 /**
@@ -78,64 +97,104 @@ namespace {
  * @{
  */
 
-#define SPLA_DEFINE_BINARY_OPERATOR(name, typeName, clType, op)                              \
-    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {   \
-        auto t = Types::typeName(library);                                                   \
-        return FunctionBinary::Make(t, t, t, MakeBinaryOperatorBody(#clType, #op), library); \
+#define SPLA_DEFINE_BINARY_OPERATOR(name, typeName, clType, cppType, op)                                               \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType y) { return x op y; });                                 \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeBinaryOperatorBody(#clType, #op), host,                              \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
+    }
+
+#define SPLA_DEFINE_FLIPPED_BINARY_OPERATOR(name, typeName, clType, cppType, op)                                       \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType y) { return y op x; });                                 \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeFlippedBinaryOperatorBody(#clType, #op), host,                       \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
+    }
+
+#define SPLA_DEFINE_DIV_OPERATOR(name, typeName, clType, cppType)                                                      \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType y) { return HostDiv(x, y); });                          \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeBinaryOperatorBody(#clType, "/"), host,                              \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
     }
 
-#define SPLA_DEFINE_FLIPPED_BINARY_OPERATOR(name, typeName, clType, op)                             \
-    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {          \
-        auto t = Types::typeName(library);                                                          \
-        return FunctionBinary::Make(t, t, t, MakeFlippedBinaryOperatorBody(#clType, #op), library); \
+#define SPLA_DEFINE_FLIPPED_DIV_OPERATOR(name, typeName, clType, cppType)                                              \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType y) { return HostDiv(y, x); });                          \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeFlippedBinaryOperatorBody(#clType, "/"), host,                       \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
     }
 
-#define SPLA_DEFINE_TAKE_FIRST(name, typeName, clType)                                       \
-    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {   \
-        auto t = Types::typeName(library);                                                   \
-        return FunctionBinary::Make(t, t, t, MakeFirstBinaryOperatorBody(#clType), library); \
+#define SPLA_DEFINE_TAKE_FIRST(name, typeName, clType, cppType)                                                        \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType) { return x; });                                        \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeFirstBinaryOperatorBody(#clType), host,                              \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
     }
 
-#define SPLA_DEFINE_TAKE_SECOND(name, typeName, clType)                                       \
-    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {    \
-        auto t = Types::typeName(library);                                                    \
-        return FunctionBinary::Make(t, t, t, MakeSecondBinaryOperatorBody(#clType), library); \
+#define SPLA_DEFINE_TAKE_SECOND(name, typeName, clType, cppType)                                                       \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType, cppType y) { return y; });                                        \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeSecondBinaryOperatorBody(#clType), host,                             \
+                                    FunctionBinary::Op::name, #clType, library);                                      \
     }
 
-#define SPLA_DEFINE_BINARY_FUNCTION(name, typeName, type, fun)                              \
-    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {  \
-        auto t = Types::typeName(library);                                                  \
-        return FunctionBinary::Make(t, t, t, MakeBinaryFunctionBody(#type, #fun), library); \
+#define SPLA_DEFINE_BINARY_FUNCTION(name, typeName, type, cppType, fun)                                                \
+    spla::RefPtr<spla::FunctionBinary> spla::Functions::name##typeName(Library &library) {                            \
+        auto t = Types::typeName(library);                                                                            \
+        auto host = [](const void *a, const void *b, void *c) {                                                       \
+            HostApply<cppType>(a, b, c, [](cppType x, cppType y) { return std::fun(x, y); });                         \
+        };                                                                                                            \
+        return FunctionBinary::Make(t, t, t, MakeBinaryFunctionBody(#type, #fun), host,                               \
+                                    FunctionBinary::Op::name, #type, library);                                        \
     }
 
-#define SPLA_DEFINE_BINARY_OPERATORS(typeName, clType)                     \
-    SPLA_DEFINE_BINARY_OPERATOR(Plus, typeName, clType, +)                 \
-    SPLA_DEFINE_BINARY_OPERATOR(Minus, typeName, clType, -)                \
-    SPLA_DEFINE_FLIPPED_BINARY_OPERATOR(ReverseMinus, typeName, clType, -) \
-    SPLA_DEFINE_BINARY_OPERATOR(Mult, typeName, clType, *)                 \
-    SPLA_DEFINE_BINARY_OPERATOR(Div, typeName, clType, /)                  \
-    SPLA_DEFINE_FLIPPED_BINARY_OPERATOR(ReverseDiv, typeName, clType, /)   \
-    SPLA_DEFINE_TAKE_FIRST(TakeFirst, typeName, clType)                    \
-    SPLA_DEFINE_TAKE_SECOND(TakeSecond, typeName, clType)
+#define SPLA_DEFINE_BINARY_OPERATORS(typeName, clType, cppType)                     \
+    SPLA_DEFINE_BINARY_OPERATOR(Plus, typeName, clType, cppType, +)                 \
+    SPLA_DEFINE_BINARY_OPERATOR(Minus, typeName, clType, cppType, -)                \
+    SPLA_DEFINE_FLIPPED_BINARY_OPERATOR(ReverseMinus, typeName, clType, cppType, -) \
+    SPLA_DEFINE_BINARY_OPERATOR(Mult, typeName, clType, cppType, *)                 \
+    SPLA_DEFINE_DIV_OPERATOR(Div, typeName, clType, cppType)                        \
+    SPLA_DEFINE_FLIPPED_DIV_OPERATOR(ReverseDiv, typeName, clType, cppType)         \
+    SPLA_DEFINE_TAKE_FIRST(TakeFirst, typeName, clType, cppType)                    \
+    SPLA_DEFINE_TAKE_SECOND(TakeSecond, typeName, clType, cppType)
 
-#define SPLA_DEFINE_LOGIC_OPERATORS(typeName, clType)     \
-    SPLA_DEFINE_BINARY_OPERATOR(Or, typeName, clType, |)  \
-    SPLA_DEFINE_BINARY_OPERATOR(And, typeName, clType, &) \
-    SPLA_DEFINE_BINARY_OPERATOR(Xor, typeName, clType, ^)
+#define SPLA_DEFINE_LOGIC_OPERATORS(typeName, clType, cppType)     \
+    SPLA_DEFINE_BINARY_OPERATOR(Or, typeName, clType, cppType, |)  \
+    SPLA_DEFINE_BINARY_OPERATOR(And, typeName, clType, cppType, &) \
+    SPLA_DEFINE_BINARY_OPERATOR(Xor, typeName, clType, cppType, ^)
 
-#define SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(typeName, clType) \
-    SPLA_DEFINE_BINARY_FUNCTION(Min, typeName, clType, fmin) \
-    SPLA_DEFINE_BINARY_FUNCTION(Max, typeName, clType, fmax)
+#define SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(typeName, clType, cppType) \
+    SPLA_DEFINE_BINARY_FUNCTION(Min, typeName, clType, cppType, fmin) \
+    SPLA_DEFINE_BINARY_FUNCTION(Max, typeName, clType, cppType, fmax)
 
-#define SPLA_DEFINE_INT_BINARY_FUNCTIONS(typeName, clType)  \
-    SPLA_DEFINE_BINARY_FUNCTION(Min, typeName, clType, min) \
-    SPLA_DEFINE_BINARY_FUNCTION(Max, typeName, clType, max)
+#define SPLA_DEFINE_INT_BINARY_FUNCTIONS(typeName, clType, cppType)  \
+    SPLA_DEFINE_BINARY_FUNCTION(Min, typeName, clType, cppType, min) \
+    SPLA_DEFINE_BINARY_FUNCTION(Max, typeName, clType, cppType, max)
 
-#define SPLA_DEFINE_INT_FUNCTIONS(MACRO, typeNamePrefix, clTypePrefix) \
-    MACRO(typeNamePrefix##8, clTypePrefix##char)                       \
-    MACRO(typeNamePrefix##16, clTypePrefix##short)                     \
-    MACRO(typeNamePrefix##32, clTypePrefix##int)                       \
-    MACRO(typeNamePrefix##64, clTypePrefix##long)
+#define SPLA_DEFINE_INT_FUNCTIONS(MACRO, typeNamePrefix, clTypePrefix)     \
+    MACRO(typeNamePrefix##8, clTypePrefix##char, clTypePrefix##int8_t)     \
+    MACRO(typeNamePrefix##16, clTypePrefix##short, clTypePrefix##int16_t)  \
+    MACRO(typeNamePrefix##32, clTypePrefix##int, clTypePrefix##int32_t)    \
+    MACRO(typeNamePrefix##64, clTypePrefix##long, clTypePrefix##int64_t)
 
 
 SPLA_DEFINE_INT_FUNCTIONS(SPLA_DEFINE_BINARY_OPERATORS, Int, )
@@ -146,8 +205,8 @@ SPLA_DEFINE_INT_FUNCTIONS(SPLA_DEFINE_BINARY_OPERATORS, UInt, u)
 SPLA_DEFINE_INT_FUNCTIONS(SPLA_DEFINE_LOGIC_OPERATORS, UInt, u)
 SPLA_DEFINE_INT_FUNCTIONS(SPLA_DEFINE_INT_BINARY_FUNCTIONS, UInt, u)
 
-SPLA_DEFINE_BINARY_OPERATORS(Float32, float)
-SPLA_DEFINE_BINARY_OPERATORS(Float64, double)
+SPLA_DEFINE_BINARY_OPERATORS(Float32, float, float)
+SPLA_DEFINE_BINARY_OPERATORS(Float64, double, double)
 
-SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(Float32, float)
-SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(Float64, double)
+SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(Float32, float, float)
+SPLA_DEFINE_FLOAT_BINARY_FUNCTIONS(Float64, double, double)
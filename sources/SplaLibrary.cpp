@@ -97,9 +97,55 @@ spla::Library::Config &spla::Library::Config::SetLogFilename(spla::Filename file
     return *this;
 }
 
+spla::Library::Config &spla::Library::Config::SetTraceFilename(spla::Filename filename) {
+    mTraceFilename.emplace(std::move(filename));
+    return *this;
+}
+
 spla::Library::Config &spla::Library::Config::SetBlockSize(std::size_t blockSize) {
     assert(blockSize > 0);
     mBlockSize = blockSize;
+    mBlockSizeAdaptive = false;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetMappedMemoryBudget(std::size_t budget) {
+    mMappedMemoryBudget = budget;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetExpressionOptimization(bool enable) {
+    mExpressionOptimization = enable;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetAlgorithmCalibration(bool enable) {
+    mAlgorithmCalibration = enable;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetProductSplitThreshold(std::size_t threshold) {
+    mProductSplitThreshold = threshold;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetHostPathThreshold(std::size_t threshold) {
+    mHostPathThreshold = threshold;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetForceHostPath(bool enable) {
+    mForceHostPath = enable;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetKernelTuning(bool enable) {
+    mKernelTuning = enable;
+    return *this;
+}
+
+spla::Library::Config &spla::Library::Config::SetKernelTuningFilename(Filename filename) {
+    mKernelTuningFilename = std::move(filename);
     return *this;
 }
 
@@ -141,6 +187,46 @@ std::size_t spla::Library::Config::GetBlockSize() const {
     return mBlockSize;
 }
 
+bool spla::Library::Config::IsBlockSizeAdaptive() const {
+    return mBlockSizeAdaptive;
+}
+
+std::size_t spla::Library::Config::GetMappedMemoryBudget() const {
+    return mMappedMemoryBudget;
+}
+
+bool spla::Library::Config::GetExpressionOptimization() const {
+    return mExpressionOptimization;
+}
+
+bool spla::Library::Config::GetAlgorithmCalibration() const {
+    return mAlgorithmCalibration;
+}
+
+std::size_t spla::Library::Config::GetProductSplitThreshold() const {
+    return mProductSplitThreshold;
+}
+
+std::size_t spla::Library::Config::GetHostPathThreshold() const {
+    return mHostPathThreshold;
+}
+
+bool spla::Library::Config::GetForceHostPath() const {
+    return mForceHostPath;
+}
+
+bool spla::Library::Config::GetKernelTuning() const {
+    return mKernelTuning;
+}
+
+const std::optional<spla::Filename> &spla::Library::Config::GetKernelTuningFilename() const {
+    return mKernelTuningFilename;
+}
+
 const std::optional<spla::Filename> &spla::Library::Config::GetLogFilename() const {
     return mLogFilename;
 }
+
+const std::optional<spla::Filename> &spla::Library::Config::GetTraceFilename() const {
+    return mTraceFilename;
+}
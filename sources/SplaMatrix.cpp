@@ -56,10 +56,35 @@ spla::RefPtr<spla::Object> spla::Matrix::Clone() const {
     return RefPtr<Matrix>(new Matrix(GetNrows(), GetNcols(), GetType(), GetLibrary(), GetStorage()->Clone())).As<Object>();
 }
 
+void spla::Matrix::Save(const Filename &filename) const {
+    mStorage->Save(filename, GetType()->GetByteSize());
+}
+
 spla::RefPtr<spla::Matrix> spla::Matrix::Make(std::size_t nrows, std::size_t ncols,
+                                              const RefPtr<Type> &type,
+                                              spla::Library &library,
+                                              std::size_t blockSize,
+                                              std::size_t nvals) {
+    auto storage = blockSize ? MatrixStorage::Make(nrows, ncols, blockSize, blockSize, library) : MatrixStorage::Make(nrows, ncols, library, nvals);
+    return spla::RefPtr<spla::Matrix>(new Matrix(nrows, ncols, type, library, std::move(storage)));
+}
+
+spla::RefPtr<spla::Matrix> spla::Matrix::Load(const Filename &filename,
                                               const RefPtr<Type> &type,
                                               spla::Library &library) {
-    return spla::RefPtr<spla::Matrix>(new Matrix(nrows, ncols, type, library));
+    auto storage = MatrixStorage::Load(filename, type->GetByteSize(), library);
+    auto nrows = storage->GetNrows();
+    auto ncols = storage->GetNcols();
+    return spla::RefPtr<spla::Matrix>(new Matrix(nrows, ncols, type, library, std::move(storage)));
+}
+
+spla::RefPtr<spla::Matrix> spla::Matrix::Map(const Filename &filename,
+                                             const RefPtr<Type> &type,
+                                             spla::Library &library) {
+    auto storage = MatrixStorage::Map(filename, type->GetByteSize(), library);
+    auto nrows = storage->GetNrows();
+    auto ncols = storage->GetNcols();
+    return spla::RefPtr<spla::Matrix>(new Matrix(nrows, ncols, type, library, std::move(storage)));
 }
 
 spla::Matrix::Matrix(std::size_t nrows, std::size_t ncols,
@@ -70,7 +95,9 @@ spla::Matrix::Matrix(std::size_t nrows, std::size_t ncols,
 }
 
 spla::RefPtr<spla::Object> spla::Matrix::CloneEmpty() {
-    return Make(GetNrows(), GetNcols(), GetType(), GetLibrary()).As<Object>();
+    // Empty clone keeps blocks grid, so it can be used together with this matrix
+    auto storage = MatrixStorage::Make(GetNrows(), GetNcols(), mStorage->GetRowBlockSize(), mStorage->GetColBlockSize(), GetLibrary());
+    return RefPtr<Matrix>(new Matrix(GetNrows(), GetNcols(), GetType(), GetLibrary(), std::move(storage))).As<Object>();
 }
 
 void spla::Matrix::CopyData(const spla::RefPtr<spla::Object> &object) {
@@ -37,9 +37,20 @@ std::size_t spla::Vector::GetNvals() const {
 }
 
 spla::RefPtr<spla::Vector> spla::Vector::Make(std::size_t nrows,
+                                              const RefPtr<Type> &type,
+                                              spla::Library &library,
+                                              std::size_t blockSize,
+                                              std::size_t nvals) {
+    auto storage = blockSize ? VectorStorage::Make(nrows, blockSize, library) : VectorStorage::Make(nrows, library, nvals);
+    return {new Vector(nrows, type, library, std::move(storage))};
+}
+
+spla::RefPtr<spla::Vector> spla::Vector::Load(const Filename &filename,
                                               const RefPtr<Type> &type,
                                               spla::Library &library) {
-    return {new Vector(nrows, type, library)};
+    auto storage = VectorStorage::Load(filename, type->GetByteSize(), library);
+    auto nrows = storage->GetNrows();
+    return {new Vector(nrows, type, library, std::move(storage))};
 }
 
 spla::Vector::Vector(std::size_t nrows,
@@ -57,13 +68,17 @@ void spla::Vector::Dump(std::ostream &stream) const {
     mStorage->Dump(stream);
 }
 
+void spla::Vector::Save(const Filename &filename) const {
+    mStorage->Save(filename, GetType()->GetByteSize());
+}
+
 spla::RefPtr<spla::Object> spla::Vector::Clone() const {
     return RefPtr<Vector>(new Vector(GetNrows(), GetType(), GetLibrary(), GetStorage()->Clone())).As<Object>();
 }
 
 
 spla::RefPtr<spla::Object> spla::Vector::CloneEmpty() {
-    return Make(GetNrows(), GetType(), GetLibrary()).As<Object>();
+    return Make(GetNrows(), GetType(), GetLibrary(), mStorage->GetBlockSize()).As<Object>();
 }
 
 void spla::Vector::CopyData(const spla::RefPtr<spla::Object> &object) {
@@ -29,7 +29,9 @@
 #define SPLA_SPLAALGORITHM_HPP
 
 #include <algo/SplaAlgorithmParams.hpp>
+#include <core/SplaDeviceManager.hpp>
 #include <spla-cpp/SplaRefCnt.hpp>
+#include <algorithm>
 #include <string>
 
 namespace spla {
@@ -80,6 +82,14 @@ namespace spla {
             Transpose
         };
 
+        /** Estimated cost of the algorithm invocation */
+        struct Cost {
+            /** Amount of processed entries and flops; measured times are grouped by its magnitude */
+            std::size_t work = 0;
+            /** Expected execution time in seconds */
+            double time = 0.0;
+        };
+
         /**
          * Select this algorithm for provided params.
          * @param params Set of algorithm input/output params.
@@ -87,6 +97,20 @@ namespace spla {
          */
         virtual bool Select(const AlgorithmParams &params) const = 0;
 
+        /**
+         * Estimate cost of processing specified params on the device.
+         * Algorithm manager selects the cheapest one among suitable algorithms.
+         *
+         * @note Default implementation reports zero cost, so equally cheap algorithms are selected in registration order
+         *
+         * @param params Set of algorithm input/output params.
+         * @param device Device to process params.
+         * @return Estimated cost.
+         */
+        virtual Cost EstimateCost(const AlgorithmParams &params, const DeviceManager::Device &device) const {
+            return Cost{};
+        }
+
         /**
          * Process specified params in this thread.
          * Invoked by algorithm manager.
@@ -105,6 +129,29 @@ namespace spla {
          * @return Algorithm unique name.
          */
         virtual std::string GetName() const = 0;
+
+    protected:
+        /**
+         * Estimate execution time of the work on the device.
+         * Device throughput is approximated by its compute units and clock frequency.
+         *
+         * @param work Amount of processed entries and flops.
+         * @param launches Number of kernel launches (each adds fixed overhead).
+         * @param device Device to process work.
+         * @return Estimated cost.
+         */
+        static Cost MakeCost(std::size_t work, std::size_t launches, const DeviceManager::Device &device) {
+            const double launchOverhead = 1e-5;
+            const double lanesPerUnit = 16.0;
+
+            auto units = static_cast<double>(std::max<std::size_t>(1, device.compute_units()));
+            auto clock = static_cast<double>(std::max<std::size_t>(1, device.clock_frequency())) * 1e6;
+
+            Cost cost;
+            cost.work = work;
+            cost.time = static_cast<double>(launches) * launchOverhead + static_cast<double>(work) / (units * clock * lanesPerUnit);
+            return cost;
+        }
     };
 
     namespace {
@@ -29,15 +29,24 @@
 
 #include <algo/SplaAlgorithmManager.hpp>
 #include <algo/matrix/SplaMatrixEWiseAddCOO.hpp>
+#include <algo/matrix/SplaMatrixEWiseAddHost.hpp>
 #include <algo/matrix/SplaMatrixTransposeCOO.hpp>
+#include <algo/matrix/SplaMatrixTransposeHost.hpp>
 #include <algo/mxm/SplaMxMCOO.hpp>
+#include <algo/mxm/SplaMxMHost.hpp>
 #include <algo/vector/SplaVectorAssignCOO.hpp>
+#include <algo/vector/SplaVectorAssignHost.hpp>
 #include <algo/vector/SplaVectorEWiseAddCOO.hpp>
+#include <algo/vector/SplaVectorEWiseAddHost.hpp>
 #include <algo/vector/SplaVectorReduceCOO.hpp>
+#include <algo/vector/SplaVectorReduceHost.hpp>
 #include <algo/vxm/SplaVxMCOO.hpp>
+#include <algo/vxm/SplaVxMHost.hpp>
 #include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
 
 #include <cassert>
+#include <chrono>
 
 spla::AlgorithmManager::AlgorithmManager(Library &library) : mLibrary(library) {
     Register(new MatrixEWiseAddCOO());
@@ -47,6 +56,13 @@ spla::AlgorithmManager::AlgorithmManager(Library &library) : mLibrary(library) {
     Register(new VectorEWiseAddCOO());
     Register(new MxMCOO());
     Register(new VxMCOO());
+    Register(new VectorAssignHost());
+    Register(new VectorReduceHost());
+    Register(new VectorEWiseAddHost());
+    Register(new VxMHost());
+    Register(new MatrixEWiseAddHost());
+    Register(new MatrixTransposeHost());
+    Register(new MxMHost());
 }
 
 void spla::AlgorithmManager::Register(const spla::RefPtr<spla::Algorithm> &algo) {
@@ -62,38 +78,114 @@ void spla::AlgorithmManager::Register(const spla::RefPtr<spla::Algorithm> &algo)
 }
 
 void spla::AlgorithmManager::Dispatch(spla::Algorithm::Type type, spla::AlgorithmParams &params) {
-    auto algorithm = SelectAlgorithm(type, params);
-    algorithm->Process(params);
+    std::size_t work;
+    auto algorithm = SelectAlgorithm(type, params, work);
+    Process(algorithm, params, work);
 }
 
 void spla::AlgorithmManager::Dispatch(spla::Algorithm::Type type, const spla::RefPtr<spla::AlgorithmParams> &params) {
     assert(params.IsNotNull());
-    auto algorithm = SelectAlgorithm(type, *params);
-    algorithm->Process(*params);
+    std::size_t work;
+    auto algorithm = SelectAlgorithm(type, *params, work);
+    Process(algorithm, *params, work);
 }
 
 tf::Task spla::AlgorithmManager::Dispatch(spla::Algorithm::Type type, const spla::RefPtr<spla::AlgorithmParams> &params, TaskBuilder &builder) {
     assert(params.IsNotNull());
-    auto algorithm = SelectAlgorithm(type, *params);
-    return builder.Emplace([=]() {
-        algorithm->Process(*params);
+    std::size_t work;
+    auto algorithm = SelectAlgorithm(type, *params, work);
+    return builder.Emplace(algorithm->GetName(), [=]() {
+        Process(algorithm, *params, work);
     });
 }
 
-spla::RefPtr<spla::Algorithm> spla::AlgorithmManager::SelectAlgorithm(spla::Algorithm::Type type, const spla::AlgorithmParams &params) {
+std::optional<double> spla::AlgorithmManager::GetMeasuredTime(const std::string &name, std::size_t work) const {
+    std::lock_guard<std::mutex> lock(mMeasuresMutex);
+
+    auto query = mMeasures.find({name, GetWorkBucket(work)});
+    if (query == mMeasures.end() || query->second.count == 0)
+        return std::nullopt;
+
+    return query->second.total / static_cast<double>(query->second.count);
+}
+
+void spla::AlgorithmManager::Process(const spla::RefPtr<spla::Algorithm> &algorithm, spla::AlgorithmParams &params, std::size_t work) {
+    // Algorithm finishes its queue before exit, so span covers device work
+    auto &tracer = mLibrary.GetPrivate().GetTracer();
+    Tracer::Scope scope(tracer, algorithm->GetName(), "algo", Tracer::Track::Device, params.deviceId);
+
+    if (!mLibrary.GetPrivate().GetContextConfig().GetAlgorithmCalibration()) {
+        algorithm->Process(params);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    algorithm->Process(params);
+    auto end = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mMeasuresMutex);
+    auto &measure = mMeasures[{algorithm->GetName(), GetWorkBucket(work)}];
+    measure.total += std::chrono::duration<double>(end - start).count();
+    measure.count += 1;
+}
+
+spla::RefPtr<spla::Algorithm> spla::AlgorithmManager::SelectAlgorithm(spla::Algorithm::Type type, const spla::AlgorithmParams &params, std::size_t &work) {
     auto iter = mAlgorithms.find(type);
 
     CHECK_RAISE_ERROR(iter != mAlgorithms.end(), InvalidState,
                       "No algorithms for such type=" << AlgorithmTypeToStr(type));
 
     const auto &algorithms = iter->second;
+    const auto &device = mLibrary.GetPrivate().GetDeviceManager().GetDevice(params.deviceId);
+    auto calibration = mLibrary.GetPrivate().GetContextConfig().GetAlgorithmCalibration();
+
+    RefPtr<Algorithm> best;
+    double bestTime = 0.0;
+    bool bestMeasured = false;
+
+    // NOTE: Iterate through all processors for this operation and select
+    // the cheapest one among suitable; equal costs keep registration order
+    for (auto &algorithm : algorithms) {
+        if (!algorithm->Select(params))
+            continue;
+
+        auto cost = algorithm->EstimateCost(params, device);
+        auto time = cost.time;
+        auto measured = false;
+
+        if (calibration) {
+            auto measuredTime = GetMeasuredTime(algorithm->GetName(), cost.work);
+            if (measuredTime.has_value()) {
+                time = measuredTime.value();
+                measured = true;
+            }
+        }
+
+        // In calibration mode not yet measured algorithms are tried first
+        auto better = best.IsNull() ||
+                      (calibration && bestMeasured && !measured) ||
+                      ((!calibration || measured == bestMeasured) && time < bestTime);
+
+        if (better) {
+            best = algorithm;
+            bestTime = time;
+            bestMeasured = measured;
+            work = cost.work;
+        }
+    }
+
+    CHECK_RAISE_ERROR(best.IsNotNull(), InvalidState,
+                      "Failed to find suitable algorithm for the type=" << AlgorithmTypeToStr(type));
+
+    return best;
+}
 
-    // NOTE: Iterate through all processors for this operation and
-    // select the first one, which meets requirements
-    for (auto &algorithm : algorithms)
-        if (algorithm->Select(params))
-            return algorithm;
-
-    RAISE_ERROR(InvalidState,
-                "Failed to find suitable algorithm for the type=" << AlgorithmTypeToStr(type));
+std::size_t spla::AlgorithmManager::GetWorkBucket(std::size_t work) {
+    // Power of two magnitude of the work
+    std::size_t bucket = 0;
+    while (work > 0) {
+        work >>= 1u;
+        bucket += 1;
+    }
+    return bucket;
 }
@@ -31,7 +31,12 @@
 #include <algo/SplaAlgorithm.hpp>
 #include <core/SplaTaskBuilder.hpp>
 #include <spla-cpp/SplaRefCnt.hpp>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace spla {
@@ -51,6 +56,10 @@ namespace spla {
      *
      * For example, for MxM operation of matrix blocks can store several algorithms,
      * such as MxM_csr, MxM_coo and etc. and choose suitable for provided params.
+     *
+     * Among suitable algorithms the one with the least estimated cost is selected.
+     * If calibration is enabled, measured times per work magnitude are used instead
+     * of estimations, and not yet measured algorithms are tried first.
      */
     class AlgorithmManager final : public RefCnt {
     public:
@@ -62,14 +71,35 @@ namespace spla {
         void Dispatch(Algorithm::Type type, const RefPtr<AlgorithmParams> &params);
         tf::Task Dispatch(Algorithm::Type type, const RefPtr<AlgorithmParams> &params, TaskBuilder &builder);
 
+        /**
+         * Mean measured time of the algorithm for the amount of work.
+         *
+         * @param name Algorithm name.
+         * @param work Amount of work, reported by algorithm cost estimation.
+         * @return Mean time in seconds, if algorithm was measured for this work magnitude.
+         */
+        std::optional<double> GetMeasuredTime(const std::string &name, std::size_t work) const;
+
     private:
-        RefPtr<Algorithm> SelectAlgorithm(Algorithm::Type type, const AlgorithmParams &params);
+        RefPtr<Algorithm> SelectAlgorithm(Algorithm::Type type, const AlgorithmParams &params, std::size_t &work);
+        void Process(const RefPtr<Algorithm> &algorithm, AlgorithmParams &params, std::size_t work);
+        static std::size_t GetWorkBucket(std::size_t work);
 
     private:
         using AlgorithmList = std::vector<RefPtr<Algorithm>>;
         using AlgorithmMap = std::unordered_map<Algorithm::Type, AlgorithmList>;
 
+        /** Accumulated measured time of (algorithm, work bucket) */
+        struct Measure {
+            double total = 0.0;
+            std::size_t count = 0;
+        };
+
+        using MeasureMap = std::map<std::pair<std::string, std::size_t>, Measure>;
+
         AlgorithmMap mAlgorithms;
+        MeasureMap mMeasures;
+        mutable std::mutex mMeasuresMutex;
         Library &mLibrary;
     };
 
@@ -29,6 +29,7 @@
 #define SPLA_SPLAALGORITHMPARAMS_HPP
 
 #include <core/SplaDeviceManager.hpp>
+#include <limits>
 #include <spla-cpp/SplaDescriptor.hpp>
 #include <spla-cpp/SplaFunctionBinary.hpp>
 #include <spla-cpp/SplaRefCnt.hpp>
@@ -105,6 +106,8 @@ namespace spla {
         RefPtr<Type> ta;
         RefPtr<Type> tb;
         RefPtr<Type> tw;
+        std::size_t aBeginRow = 0;                                    // first row of a to multiply
+        std::size_t aEndRow = std::numeric_limits<std::size_t>::max();// past the last row of a to multiply
     };
 
     /** Blocked vector-matrix multiply params */
@@ -122,6 +125,8 @@ namespace spla {
         RefPtr<Type> ta;
         RefPtr<Type> tb;
         RefPtr<Type> tw;
+        std::size_t aBeginRow = 0;                                    // first row of a (and b) to multiply
+        std::size_t aEndRow = std::numeric_limits<std::size_t>::max();// past the last row of a (and b) to multiply
     };
 
     /** Blocked vector-scalar assignment params */
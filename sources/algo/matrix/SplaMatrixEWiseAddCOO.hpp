@@ -35,6 +35,7 @@ namespace spla {
     public:
         ~MatrixEWiseAddCOO() override = default;
         bool Select(const AlgorithmParams &params) const override;
+        Cost EstimateCost(const AlgorithmParams &params, const DeviceManager::Device &device) const override;
         void Process(AlgorithmParams &params) override;
         Type GetType() const override;
         std::string GetName() const override;
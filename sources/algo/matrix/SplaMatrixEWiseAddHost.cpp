@@ -0,0 +1,191 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/matrix/SplaMatrixEWiseAddHost.hpp>
+#include <compute/SplaApplyMask.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <optional>
+
+bool spla::MatrixEWiseAddHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsMatrixEWiseAdd *>(&params);
+
+    if (!p ||
+        !p->mask.Is<MatrixCOO>() ||
+        !p->a.Is<MatrixCOO>() ||
+        !p->b.Is<MatrixCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto native = !p->type->HasValues() || p->op->HasHostFunction();
+
+    return config.GetForceHostPath() && native;
+}
+
+spla::Algorithm::Cost spla::MatrixEWiseAddHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsMatrixEWiseAdd *>(&params);
+    auto nvals = [](const RefPtr<MatrixBlock> &block) { return block.IsNotNull() ? block->GetNvals() : 0; };
+
+    // Single pass merge of a, b and mask
+    return MakeCost(nvals(p->a) + nvals(p->b) + nvals(p->mask), 0, device);
+}
+
+void spla::MatrixEWiseAddHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsMatrixEWiseAdd *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto &type = p->type;
+    auto byteSize = type->GetByteSize();
+    auto typeHasValues = type->HasValues();
+    auto hostOp = typeHasValues ? p->op->GetHostFunction() : nullptr;
+
+    auto blockA = p->a.Cast<MatrixCOO>();
+    auto blockB = p->b.Cast<MatrixCOO>();
+    auto maskBlock = p->mask.Cast<MatrixCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    // Masked view of the block: indices of entries, which pass the mask
+    struct Masked {
+        std::optional<HostMapped<unsigned int>> rows;
+        std::optional<HostMapped<unsigned int>> cols;
+        std::optional<HostMapped<unsigned char>> vals;
+        std::vector<std::size_t> entries;
+    };
+
+    auto applyMask = [&](RefPtr<MatrixCOO> &block, Masked &masked) {
+        // Nothing to do
+        if (block.IsNull())
+            return;
+
+        // No inverse and no block - null result
+        if (p->hasMask && !complementMask && maskBlock.IsNull())
+            return;
+
+        masked.rows.emplace(block->GetRows(), queue);
+        masked.cols.emplace(block->GetCols(), queue);
+        masked.vals.emplace(block->GetVals(), queue);
+
+        auto keep = [&](std::size_t i) { masked.entries.push_back(i); };
+
+        // No mask or must apply inverse mask (but !null = all)
+        if (!p->hasMask || maskBlock.IsNull()) {
+            for (std::size_t i = 0; i < block->GetNvals(); i++)
+                keep(i);
+            return;
+        }
+
+        HostMapped<unsigned int> maskRows(maskBlock->GetRows(), queue);
+        HostMapped<unsigned int> maskCols(maskBlock->GetCols(), queue);
+        detail::MaskPairKeysHost(maskRows.Data(), maskCols.Data(), maskRows.Size(),
+                                 masked.rows->Data(), masked.cols->Data(), masked.rows->Size(),
+                                 complementMask,
+                                 keep);
+    };
+
+    std::vector<unsigned int> resultRows;
+    std::vector<unsigned int> resultCols;
+    std::vector<unsigned char> resultVals;
+
+    {
+        Masked a, b;
+        applyMask(blockA, a);
+        applyMask(blockB, b);
+
+        auto append = [&](const Masked &block, std::size_t i) {
+            resultRows.push_back((*block.rows)[i]);
+            resultCols.push_back((*block.cols)[i]);
+            if (typeHasValues)
+                resultVals.insert(resultVals.end(), block.vals->begin() + i * byteSize, block.vals->begin() + (i + 1) * byteSize);
+        };
+
+        // Merge a and b by (row, col), entries present in both are combined by op
+        std::size_t i = 0, j = 0;
+        while (i < a.entries.size() || j < b.entries.size()) {
+            if (j == b.entries.size()) {
+                append(a, a.entries[i++]);
+                continue;
+            }
+            if (i == a.entries.size()) {
+                append(b, b.entries[j++]);
+                continue;
+            }
+
+            auto ea = a.entries[i];
+            auto eb = b.entries[j];
+            auto ra = (*a.rows)[ea], ca = (*a.cols)[ea];
+            auto rb = (*b.rows)[eb], cb = (*b.cols)[eb];
+
+            if (ra < rb || (ra == rb && ca < cb)) {
+                append(a, ea);
+                i += 1;
+            } else if (rb < ra || (rb == ra && cb < ca)) {
+                append(b, eb);
+                j += 1;
+            } else {
+                resultRows.push_back(ra);
+                resultCols.push_back(ca);
+                if (typeHasValues) {
+                    resultVals.resize(resultVals.size() + byteSize);
+                    hostOp(a.vals->begin() + ea * byteSize, b.vals->begin() + eb * byteSize, resultVals.data() + resultVals.size() - byteSize);
+                }
+                i += 1;
+                j += 1;
+            }
+        }
+    }
+
+    if (resultRows.empty())
+        return;
+
+    auto nrows = blockA.IsNotNull() ? blockA->GetNrows() : blockB->GetNrows();
+    auto ncols = blockA.IsNotNull() ? blockA->GetNcols() : blockB->GetNcols();
+    auto resultNvals = resultRows.size();
+
+    p->w = MatrixCOO::Make(nrows, ncols, resultNvals,
+                           UploadMapped(resultRows, queue),
+                           UploadMapped(resultCols, queue),
+                           UploadMapped(resultVals, queue))
+                   .As<MatrixBlock>();
+}
+
+spla::Algorithm::Type spla::MatrixEWiseAddHost::GetType() const {
+    return Type::MatrixEWiseAdd;
+}
+
+std::string spla::MatrixEWiseAddHost::GetName() const {
+    return "MatrixEWiseAddHost";
+}
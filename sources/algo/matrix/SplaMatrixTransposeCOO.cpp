@@ -33,6 +33,7 @@
 #include <core/SplaQueueFinisher.hpp>
 #include <storage/SplaMatrixStorage.hpp>
 #include <storage/block/SplaMatrixCOO.hpp>
+#include <cmath>
 
 bool spla::MatrixTransposeCOO::Select(const spla::AlgorithmParams &params) const {
     auto p = dynamic_cast<const ParamsTranspose *>(&params);
@@ -42,6 +43,15 @@ bool spla::MatrixTransposeCOO::Select(const spla::AlgorithmParams &params) const
            p->a.Is<MatrixCOO>();
 }
 
+spla::Algorithm::Cost spla::MatrixTransposeCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsTranspose *>(&params);
+    auto nvals = p->a.IsNotNull() ? p->a->GetNvals() : 0;
+    auto depth = std::max<std::size_t>(1, static_cast<std::size_t>(std::log2(nvals + 1)));
+
+    // Sort of swapped indices dominates
+    return MakeCost(nvals * depth, 2, device);
+}
+
 void spla::MatrixTransposeCOO::Process(spla::AlgorithmParams &params) {
     using namespace boost;
 
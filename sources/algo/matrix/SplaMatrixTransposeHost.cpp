@@ -0,0 +1,150 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/matrix/SplaMatrixTransposeHost.hpp>
+#include <compute/SplaApplyMask.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <algorithm>
+#include <numeric>
+
+bool spla::MatrixTransposeHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsTranspose *>(&params);
+
+    return p &&
+           p->mask.Is<MatrixCOO>() &&
+           p->a.Is<MatrixCOO>() &&
+           p->desc->GetLibrary().GetPrivate().GetContextConfig().GetForceHostPath();
+}
+
+spla::Algorithm::Cost spla::MatrixTransposeHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsTranspose *>(&params);
+    auto nvals = p->a.IsNotNull() ? p->a->GetNvals() : 0;
+
+    // Counting sort by columns is linear
+    return MakeCost(nvals, 0, device);
+}
+
+void spla::MatrixTransposeHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsTranspose *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto &type = p->type;
+    auto byteSize = type->GetByteSize();
+    auto typeHasValues = type->HasValues();
+
+    auto a = p->a.Cast<MatrixCOO>();
+    auto mask = p->mask.Cast<MatrixCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    // Do not process empty block
+    if (a.IsNull())
+        return;
+    // Nothing to do
+    if (p->hasMask && !complementMask && mask.IsNull())
+        return;
+
+    auto nvals = a->GetNvals();
+    auto nrowsT = a->GetNcols();
+    auto ncolsT = a->GetNrows();
+
+    // Buffers to store result
+    std::vector<unsigned int> rows(nvals);
+    std::vector<unsigned int> cols(nvals);
+    std::vector<unsigned char> vals(typeHasValues ? nvals * byteSize : 0);
+
+    {
+        HostMapped<unsigned int> aRows(a->GetRows(), queue);
+        HostMapped<unsigned int> aCols(a->GetCols(), queue);
+        HostMapped<unsigned char> aVals(a->GetVals(), queue);
+
+        // Counting sort by columns; stable, so rows of each column stay sorted
+        std::vector<std::size_t> offsets(nrowsT + 1, 0);
+        for (auto col : aCols)
+            offsets[col + 1] += 1;
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        for (std::size_t i = 0; i < nvals; i++) {
+            auto dst = offsets[aCols[i]]++;
+            rows[dst] = aCols[i];
+            cols[dst] = aRows[i];
+            if (typeHasValues)
+                std::copy(aVals.begin() + i * byteSize, aVals.begin() + (i + 1) * byteSize, vals.begin() + dst * byteSize);
+        }
+    }
+
+    // Apply finally mask if required
+    if (p->hasMask && mask.IsNotNull()) {
+        std::vector<unsigned int> tmpRows;
+        std::vector<unsigned int> tmpCols;
+        std::vector<unsigned char> tmpVals;
+
+        HostMapped<unsigned int> maskRows(mask->GetRows(), queue);
+        HostMapped<unsigned int> maskCols(mask->GetCols(), queue);
+        detail::MaskPairKeysHost(maskRows.Data(), maskCols.Data(), maskRows.Size(),
+                                 rows.data(), cols.data(), rows.size(),
+                                 complementMask,
+                                 [&](std::size_t i) {
+                                     tmpRows.push_back(rows[i]);
+                                     tmpCols.push_back(cols[i]);
+                                     if (typeHasValues)
+                                         tmpVals.insert(tmpVals.end(), vals.begin() + i * byteSize, vals.begin() + (i + 1) * byteSize);
+                                 });
+
+        std::swap(rows, tmpRows);
+        std::swap(cols, tmpCols);
+        std::swap(vals, tmpVals);
+    }
+
+    // Save if result is not empty
+    if (!rows.empty()) {
+        auto nvalsT = rows.size();
+        p->w = MatrixCOO::Make(nrowsT, ncolsT, nvalsT,
+                               UploadMapped(rows, queue),
+                               UploadMapped(cols, queue),
+                               UploadMapped(vals, queue))
+                       .As<MatrixBlock>();
+    }
+}
+
+spla::Algorithm::Type spla::MatrixTransposeHost::GetType() const {
+    return spla::Algorithm::Type::Transpose;
+}
+
+std::string spla::MatrixTransposeHost::GetName() const {
+    return "TransposeHost";
+}
@@ -31,12 +31,14 @@
 #include <compute/SplaIndicesToRowOffsets.hpp>
 #include <compute/SplaReduceByKey.hpp>
 #include <compute/SplaReduceDuplicates.hpp>
+#include <compute/SplaScan.hpp>
 #include <compute/SplaSortByRowColumn.hpp>
 #include <compute/SplaTransformValues.hpp>
 #include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <core/SplaQueueFinisher.hpp>
 #include <storage/block/SplaMatrixCOO.hpp>
+#include <cmath>
 
 using IndeciesVector = boost::compute::vector<unsigned int>;
 using ValuesVector = boost::compute::vector<unsigned char>;
@@ -56,6 +58,7 @@ namespace spla::detail {
                               const IndeciesVector &outputPtr,
                               IndeciesVector &aGatherLocations,
                               IndeciesVector &bGatherLocations,
+                              ScanStatus &scanStatus,
                               IndeciesVector &I,
                               IndeciesVector &J,
                               ValuesVector &V,
@@ -96,7 +99,7 @@ namespace spla::detail {
             }
         });
         compute::for_each_n(compute::counting_iterator<unsigned int>(beginSegment), endSegment - beginSegment, calcAGatherLoc, queue);
-        compute::inclusive_scan(aGatherLocations.begin(), aGatherLocations.end(), aGatherLocations.begin(), compute::max<unsigned int>(), queue);
+        InclusiveScanMax(aGatherLocations.begin(), aGatherLocations.end(), aGatherLocations.begin(), scanStatus, queue);
 
         // compute gather locations of intermediate format for 'b'
         const auto &aCols = a.GetCols();
@@ -122,8 +125,7 @@ namespace spla::detail {
             TransformValues(aGatherLocations, bGatherLocations,
                             a.GetVals(), b.GetVals(),
                             V,
-                            a.GetValueByteSize(), b.GetValueByteSize(), wValueByteSize,
-                            fMultiply->GetSource(),
+                            *fMultiply,
                             queue);
 
             // sort (I,J,V) tuples by (I,J)
@@ -155,6 +157,27 @@ bool spla::MxMCOO::Select(const spla::AlgorithmParams &params) const {
            p->b.Is<MatrixCOO>();
 }
 
+spla::Algorithm::Cost spla::MxMCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsMxM *>(&params);
+
+    if (p->a.IsNull() || p->b.IsNull())
+        return MakeCost(0, 1, device);
+
+    // Expected products count: each a entry meets average row of b
+    auto rows = std::max<std::size_t>(1, p->b->GetNrows());
+    auto flops = p->a->GetNvals() * p->b->GetNvals() / rows + p->a->GetNvals();
+
+    // Only a range of a rows may be multiplied; entries assumed to be spread evenly over rows
+    auto aNrows = std::max<std::size_t>(1, p->a->GetNrows());
+    auto rangeRows = std::min(p->aEndRow, aNrows) - std::min(p->aBeginRow, aNrows);
+    flops = flops / aNrows * rangeRows + flops % aNrows * rangeRows / aNrows;
+
+    auto depth = std::max<std::size_t>(1, static_cast<std::size_t>(std::log2(flops + 1)));
+
+    // Products are sorted and reduced by key
+    return MakeCost(flops * depth, 8, device);
+}
+
 void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
     using namespace boost;
 
@@ -203,14 +226,28 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
                     segmentLengths.begin(),
                     queue);
 
-    // output pointer
+    // output pointer; scan status is reused by scans of all workspace slices
+    ScanStatus scanStatus(ctx);
     compute::vector<unsigned int> outputPtr(a.GetNvals() + 1, ctx);
-    compute::exclusive_scan(segmentLengths.begin(), segmentLengths.end(),
-                            outputPtr.begin(),
-                            0u,
-                            queue);
+    ExclusiveScan(segmentLengths.begin(), segmentLengths.end(), outputPtr.begin(), scanStatus, queue);
 
-    std::size_t cooNumNonZeros = (outputPtr.end() - 1).read(queue);
+    // Compute row offsets for A, if only a range of A rows must be multiplied or workspace is sliced
+    compute::vector<unsigned int> aRowOffsets(ctx);
+    auto aBeginRow = std::min(params->aBeginRow, a.GetNrows());
+    auto aEndRow = std::min(params->aEndRow, a.GetNrows());
+    auto aHasRange = aBeginRow > 0 || aEndRow < a.GetNrows();
+    std::size_t aBeginSegment = 0;
+    std::size_t aEndSegment = a.GetNvals();
+
+    if (aHasRange) {
+        IndicesToRowOffsets(a.GetRows(), aRowOffsets, a.GetNrows(), queue);
+        aBeginSegment = (aRowOffsets.begin() + static_cast<std::ptrdiff_t>(aBeginRow)).read(queue);
+        aEndSegment = (aRowOffsets.begin() + static_cast<std::ptrdiff_t>(aEndRow)).read(queue);
+    }
+
+    // Number of products to compute and products before selected range
+    std::size_t cooSkipped = (outputPtr.begin() + static_cast<std::ptrdiff_t>(aBeginSegment)).read(queue);
+    std::size_t cooNumNonZeros = (outputPtr.begin() + static_cast<std::ptrdiff_t>(aEndSegment)).read(queue) - cooSkipped;
     std::size_t workspaceCapacity = cooNumNonZeros;
     {
         const auto maxGlobalMem = device.global_memory_size();
@@ -244,8 +281,8 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
 
     if (cooNumNonZeros <= workspaceCapacity) {
         // compute W = A * B in one step
-        std::size_t beginSegment = 0;
-        std::size_t endSegment = a.GetNvals();
+        std::size_t beginSegment = aBeginSegment;
+        std::size_t endSegment = aEndSegment;
         std::size_t workspaceSize = cooNumNonZeros;
 
         wTmpNnz = detail::CooSpmmHelper(workspaceSize,
@@ -253,7 +290,7 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
                                         a, b, wRows, wCols, wVals, wValueByteSize,
                                         bRowOffsets,
                                         segmentLengths, outputPtr,
-                                        aGatherLocations, bGatherLocations,
+                                        aGatherLocations, bGatherLocations, scanStatus,
                                         I, J, V,
                                         params->mult, params->add,
                                         queue, logger);
@@ -279,8 +316,8 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
         std::deque<MatrixSlice> slices;
 
         // compute row offsets for A
-        compute::vector<unsigned int> aRowOffsets(ctx);
-        IndicesToRowOffsets(a.GetRows(), aRowOffsets, a.GetNrows(), queue);
+        if (!aHasRange)
+            IndicesToRowOffsets(a.GetRows(), aRowOffsets, a.GetNrows(), queue);
 
         // compute workspace requirements for each row
         compute::vector<unsigned int> cumulativeRowWorkspace(a.GetNrows(), ctx);
@@ -289,13 +326,14 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
                         cumulativeRowWorkspace.begin(),
                         queue);
 
-        std::ptrdiff_t beginRow = 0;
-        std::size_t totalWork = 0;
+        auto beginRow = static_cast<std::ptrdiff_t>(aBeginRow);
+        auto lastRow = static_cast<std::ptrdiff_t>(aEndRow);
+        std::size_t totalWork = cooSkipped;
 
-        while (static_cast<std::size_t>(beginRow) < a.GetNrows()) {
+        while (beginRow < lastRow) {
             // find the largest endRow such that the capacity of [beginRow, endRow) fits in the workspaceCapacity
             std::ptrdiff_t endRow = compute::upper_bound(cumulativeRowWorkspace.begin() + beginRow,
-                                                         cumulativeRowWorkspace.end(),
+                                                         cumulativeRowWorkspace.begin() + lastRow,
                                                          totalWork + workspaceCapacity,
                                                          queue) -
                                     cumulativeRowWorkspace.begin();
@@ -313,7 +351,7 @@ void spla::MxMCOO::Process(spla::AlgorithmParams &algoParams) {
                                              a, b, wSliceRows, wSliceCols, wSliceVals, wValueByteSize,
                                              bRowOffsets,
                                              segmentLengths, outputPtr,
-                                             aGatherLocations, bGatherLocations,
+                                             aGatherLocations, bGatherLocations, scanStatus,
                                              I, J, V,
                                              params->mult, params->add,
                                              queue, logger);
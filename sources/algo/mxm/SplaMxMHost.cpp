@@ -0,0 +1,221 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/mxm/SplaMxMHost.hpp>
+#include <compute/SplaApplyMask.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+bool spla::MxMHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsMxM *>(&params);
+
+    if (!p ||
+        !p->w.Is<MatrixCOO>() ||
+        !p->mask.Is<MatrixCOO>() ||
+        !p->a.Is<MatrixCOO>() ||
+        !p->b.Is<MatrixCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto native = !p->tw->HasValues() || (p->mult->HasHostFunction() && p->add->HasHostFunction());
+
+    return config.GetForceHostPath() && native;
+}
+
+spla::Algorithm::Cost spla::MxMHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsMxM *>(&params);
+
+    if (p->a.IsNull() || p->b.IsNull())
+        return MakeCost(0, 0, device);
+
+    // Expected products count: each a entry meets average row of b
+    auto rows = std::max<std::size_t>(1, p->b->GetNrows());
+    auto flops = p->a->GetNvals() * p->b->GetNvals() / rows + p->a->GetNvals();
+
+    // Only a range of a rows may be multiplied; entries assumed to be spread evenly over rows
+    auto aNrows = std::max<std::size_t>(1, p->a->GetNrows());
+    auto rangeRows = std::min(p->aEndRow, aNrows) - std::min(p->aBeginRow, aNrows);
+    flops = flops / aNrows * rangeRows + flops % aNrows * rangeRows / aNrows;
+
+    // Products are accumulated row by row without sort
+    return MakeCost(flops, 0, device);
+}
+
+void spla::MxMHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsMxM *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto a = p->a.Cast<MatrixCOO>();
+    auto b = p->b.Cast<MatrixCOO>();
+    auto mask = p->mask.Cast<MatrixCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    if (p->hasMask && !complementMask && mask.IsNull())
+        return;
+
+    if (a->GetNvals() == 0 || b->GetNvals() == 0)
+        return;
+
+    auto hasValues = p->tw->HasValues();
+    auto byteSizeA = p->ta->GetByteSize();
+    auto byteSizeB = p->tb->GetByteSize();
+    auto byteSizeW = p->tw->GetByteSize();
+    auto mult = hasValues ? p->mult->GetHostFunction() : nullptr;
+    auto add = hasValues ? p->add->GetHostFunction() : nullptr;
+    auto N = b->GetNcols();
+
+    // Select rows range [aBeginRow, aEndRow), whole a by default
+    auto aBeginRow = static_cast<unsigned int>(std::min(p->aBeginRow, a->GetNrows()));
+    auto aEndRow = static_cast<unsigned int>(std::min(p->aEndRow, a->GetNrows()));
+
+    std::vector<unsigned int> wRows;
+    std::vector<unsigned int> wCols;
+    std::vector<unsigned char> wVals;
+
+    {
+        HostMapped<unsigned int> aRows(a->GetRows(), queue);
+        HostMapped<unsigned int> aCols(a->GetCols(), queue);
+        HostMapped<unsigned char> aVals(a->GetVals(), queue);
+        HostMapped<unsigned int> bRows(b->GetRows(), queue);
+        HostMapped<unsigned int> bCols(b->GetCols(), queue);
+        HostMapped<unsigned char> bVals(b->GetVals(), queue);
+
+        // Row offsets of b
+        std::vector<std::size_t> bOffsets(b->GetNrows() + 1, 0);
+        for (auto row : bRows)
+            bOffsets[row + 1] += 1;
+        std::partial_sum(bOffsets.begin(), bOffsets.end(), bOffsets.begin());
+
+        // Dense accumulator of single w row: marker stores last row, which touched the column
+        std::vector<unsigned int> marker(N, std::numeric_limits<unsigned int>::max());
+        std::vector<unsigned int> touched;
+        std::vector<unsigned char> accum(hasValues ? N * byteSizeW : 0);
+        std::vector<unsigned char> product(byteSizeW);
+        std::vector<unsigned char> sum(byteSizeW);
+
+        auto aIter = static_cast<std::size_t>(std::lower_bound(aRows.begin(), aRows.end(), aBeginRow) - aRows.begin());
+        auto aEnd = static_cast<std::size_t>(std::lower_bound(aRows.begin(), aRows.end(), aEndRow) - aRows.begin());
+
+        while (aIter < aEnd) {
+            auto row = aRows[aIter];
+
+            // Accumulate a[row,k] * b[k,:] for each k of the row
+            for (; aIter < aEnd && aRows[aIter] == row; aIter++) {
+                auto k = aCols[aIter];
+
+                for (auto bIter = bOffsets[k]; bIter < bOffsets[k + 1]; bIter++) {
+                    auto j = bCols[bIter];
+                    auto first = marker[j] != row;
+
+                    if (first) {
+                        marker[j] = row;
+                        touched.push_back(j);
+                    }
+
+                    if (!hasValues)
+                        continue;
+
+                    auto target = accum.data() + j * byteSizeW;
+
+                    if (first)
+                        mult(aVals.begin() + aIter * byteSizeA, bVals.begin() + bIter * byteSizeB, target);
+                    else {
+                        mult(aVals.begin() + aIter * byteSizeA, bVals.begin() + bIter * byteSizeB, product.data());
+                        add(target, product.data(), sum.data());
+                        std::copy(sum.begin(), sum.end(), target);
+                    }
+                }
+            }
+
+            // Emit row sorted by columns
+            std::sort(touched.begin(), touched.end());
+
+            for (auto j : touched) {
+                wRows.push_back(row);
+                wCols.push_back(j);
+                if (hasValues)
+                    wVals.insert(wVals.end(), accum.begin() + j * byteSizeW, accum.begin() + (j + 1) * byteSizeW);
+            }
+
+            touched.clear();
+        }
+    }
+
+    // Apply mask if required
+    if (p->hasMask && mask.IsNotNull() && !wRows.empty()) {
+        std::vector<unsigned int> tmpRows;
+        std::vector<unsigned int> tmpCols;
+        std::vector<unsigned char> tmpVals;
+
+        HostMapped<unsigned int> maskRows(mask->GetRows(), queue);
+        HostMapped<unsigned int> maskCols(mask->GetCols(), queue);
+        detail::MaskPairKeysHost(maskRows.Data(), maskCols.Data(), maskRows.Size(),
+                                 wRows.data(), wCols.data(), wRows.size(),
+                                 complementMask,
+                                 [&](std::size_t i) {
+                                     tmpRows.push_back(wRows[i]);
+                                     tmpCols.push_back(wCols[i]);
+                                     if (hasValues)
+                                         tmpVals.insert(tmpVals.end(), wVals.begin() + i * byteSizeW, wVals.begin() + (i + 1) * byteSizeW);
+                                 });
+
+        std::swap(wRows, tmpRows);
+        std::swap(wCols, tmpCols);
+        std::swap(wVals, tmpVals);
+    }
+
+    if (wRows.empty())
+        return;
+
+    auto wNnz = wRows.size();
+    p->w = MatrixCOO::Make(a->GetNrows(), N, wNnz,
+                           UploadMapped(wRows, queue),
+                           UploadMapped(wCols, queue),
+                           UploadMapped(wVals, queue))
+                   .As<MatrixBlock>();
+}
+
+spla::Algorithm::Type spla::MxMHost::GetType() const {
+    return Type::MxM;
+}
+
+std::string spla::MxMHost::GetName() const {
+    return "MxMHost";
+}
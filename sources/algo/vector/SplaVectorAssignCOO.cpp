@@ -39,6 +39,13 @@ bool spla::VectorAssignCOO::Select(const spla::AlgorithmParams &params) const {
            p->mask.Is<VectorCOO>();
 }
 
+spla::Algorithm::Cost spla::VectorAssignCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorAssign *>(&params);
+    auto maskNvals = p->mask.IsNotNull() ? p->mask->GetNvals() : 0;
+
+    return MakeCost(p->hasMask ? maskNvals : p->size, 2, device);
+}
+
 void spla::VectorAssignCOO::Process(spla::AlgorithmParams &params) {
     using namespace boost;
 
@@ -0,0 +1,133 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/vector/SplaVectorAssignHost.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+#include <numeric>
+
+bool spla::VectorAssignHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsVectorAssign *>(&params);
+
+    if (!p || !p->mask.Is<VectorCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto complementMask = p->desc->IsParamSet(Descriptor::Param::MaskComplement);
+    auto maskNvals = p->mask.IsNotNull() ? p->mask->GetNvals() : 0;
+
+    // Only direct mask bounds result by its entries
+    return (p->hasMask && !complementMask ? maskNvals : p->size) <= config.GetHostPathThreshold() ||
+           config.GetForceHostPath();
+}
+
+spla::Algorithm::Cost spla::VectorAssignHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorAssign *>(&params);
+    auto maskNvals = p->mask.IsNotNull() ? p->mask->GetNvals() : 0;
+
+    // No kernels launches, only buffers mapping
+    return MakeCost(p->hasMask ? maskNvals : p->size, 0, device);
+}
+
+void spla::VectorAssignHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsVectorAssign *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto s = p->s;
+    auto size = p->size;
+    auto type = p->type;
+    auto mask = p->mask.Cast<VectorCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    // Indices and values of the result
+    std::vector<unsigned int> rows;
+    std::vector<unsigned char> vals;
+
+    // Assign full result
+    if (!p->hasMask || (mask.IsNull() && complementMask)) {
+        rows.resize(size);
+        std::iota(rows.begin(), rows.end(), 0u);
+    }
+    // Has mask, must filter
+    else {
+        // Nothing to do
+        if (mask.IsNull())
+            return;
+
+        HostMapped<unsigned int> maskRows(mask->GetRows(), queue);
+
+        // Apply direct mask
+        if (!complementMask)
+            rows.assign(maskRows.begin(), maskRows.end());
+        // Apply complement mask, skipping indices of sorted mask
+        else {
+            std::size_t m = 0;
+            for (unsigned int i = 0; i < size; i++) {
+                if (m < maskRows.Size() && maskRows[m] == i)
+                    m += 1;
+                else
+                    rows.push_back(i);
+            }
+        }
+    }
+
+    auto nvals = rows.size();
+
+    // If after masking has no values, nothing to store
+    if (!nvals)
+        return;
+
+    // If type has values, replicate scalar value for each nnz
+    if (type->HasValues()) {
+        auto byteSize = type->GetByteSize();
+        HostMapped<unsigned char> value(s->GetVal(), queue);
+
+        vals.reserve(nvals * byteSize);
+        for (std::size_t i = 0; i < nvals; i++)
+            vals.insert(vals.end(), value.begin(), value.begin() + byteSize);
+    }
+
+    p->w = VectorCOO::Make(size, nvals, UploadMapped(rows, queue), UploadMapped(vals, queue)).As<VectorBlock>();
+}
+
+spla::Algorithm::Type spla::VectorAssignHost::GetType() const {
+    return spla::Algorithm::Type::VectorAssign;
+}
+
+std::string spla::VectorAssignHost::GetName() const {
+    return "VectorAssignHost";
+}
@@ -45,6 +45,14 @@ bool spla::VectorEWiseAddCOO::Select(const spla::AlgorithmParams &params) const
            p->b.Is<VectorCOO>();
 }
 
+spla::Algorithm::Cost spla::VectorEWiseAddCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorEWiseAdd *>(&params);
+    auto nvals = [](const RefPtr<VectorBlock> &block) { return block.IsNotNull() ? block->GetNvals() : 0; };
+
+    // Merge of a and b, then optional mask
+    return MakeCost(nvals(p->a) + nvals(p->b) + nvals(p->mask), 4, device);
+}
+
 void spla::VectorEWiseAddCOO::Process(spla::AlgorithmParams &params) {
     using namespace boost;
 
@@ -188,25 +196,7 @@ void spla::VectorEWiseAddCOO::Process(spla::AlgorithmParams &params) {
     compute::vector<unsigned char> mergedValues(ctx);
     if (typeHasValues) {
         mergedValues.resize(mergeCount * byteSize, queue);
-        auto &aVals = blockA->GetVals();
-        auto &bVals = blockB->GetVals();
-        auto offset = blockA->GetNvals();
-        BOOST_COMPUTE_CLOSURE(void, copyValues, (unsigned int i), (mergedPerm, mergedValues, aVals, bVals, offset, byteSize), {
-            const uint idx = mergedPerm[i];
-
-            if (idx < offset) {
-                const uint dst = i * byteSize;
-                const uint src = idx * byteSize;
-                for (uint k = 0; k < byteSize; k++)
-                    mergedValues[dst + k] = aVals[src + k];
-            } else {
-                const uint dst = i * byteSize;
-                const uint src = (idx - offset) * byteSize;
-                for (uint k = 0; k < byteSize; k++)
-                    mergedValues[dst + k] = bVals[src + k];
-            }
-        });
-        compute::for_each_n(compute::counting_iterator<unsigned int>(0), mergedPerm.size(), copyValues, queue);
+        GatherMerged(mergedPerm, blockA->GetVals(), blockB->GetVals(), mergedValues, blockA->GetNvals(), byteSize, queue);
     }
 
     // Reduce duplicates
@@ -0,0 +1,204 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/SplaAlgorithmParams.hpp>
+#include <algo/vector/SplaVectorEWiseAddHost.hpp>
+#include <compute/SplaApplyMask.hpp>
+#include <compute/SplaTransformValues.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+#include <algorithm>
+#include <optional>
+
+bool spla::VectorEWiseAddHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsVectorEWiseAdd *>(&params);
+
+    if (!p ||
+        !p->mask.Is<VectorCOO>() ||
+        !p->a.Is<VectorCOO>() ||
+        !p->b.Is<VectorCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto nvals = [](const RefPtr<VectorBlock> &block) { return block.IsNotNull() ? block->GetNvals() : 0; };
+    auto native = !p->type->HasValues() || p->op->HasHostFunction();
+
+    return nvals(p->a) + nvals(p->b) + nvals(p->mask) <= config.GetHostPathThreshold() ||
+           (config.GetForceHostPath() && native);
+}
+
+spla::Algorithm::Cost spla::VectorEWiseAddHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorEWiseAdd *>(&params);
+    auto nvals = [](const RefPtr<VectorBlock> &block) { return block.IsNotNull() ? block->GetNvals() : 0; };
+
+    // Merge on host, single kernel for values of intersecting entries if op is not native
+    auto launches = p->type->HasValues() && !p->op->HasHostFunction() ? 1 : 0;
+    return MakeCost(nvals(p->a) + nvals(p->b) + nvals(p->mask), launches, device);
+}
+
+void spla::VectorEWiseAddHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsVectorEWiseAdd *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+    auto &logger = library->GetLogger();
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto &type = p->type;
+    auto byteSize = type->GetByteSize();
+    auto typeHasValues = type->HasValues();
+    auto hostOp = typeHasValues ? p->op->GetHostFunction() : nullptr;
+
+    auto blockA = p->a.Cast<VectorCOO>();
+    auto blockB = p->b.Cast<VectorCOO>();
+    auto maskBlock = p->mask.Cast<VectorCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    // Select entries of the block, which pass the mask: its indices and locations in the block
+    auto applyMask = [&](RefPtr<VectorCOO> &block, std::vector<unsigned int> &rows, std::vector<unsigned int> &locations) {
+        // Nothing to do
+        if (block.IsNull())
+            return;
+
+        // No inverse and no block - null result
+        if (p->hasMask && !complementMask && maskBlock.IsNull())
+            return;
+
+        HostMapped<unsigned int> blockRows(block->GetRows(), queue);
+        auto keep = [&](std::size_t i) {
+            rows.push_back(blockRows[i]);
+            locations.push_back(static_cast<unsigned int>(i));
+        };
+
+        // No mask or must apply inverse mask (but !null = all)
+        if (!p->hasMask || maskBlock.IsNull()) {
+            for (std::size_t i = 0; i < blockRows.Size(); i++)
+                keep(i);
+            return;
+        }
+
+        HostMapped<unsigned int> maskRows(maskBlock->GetRows(), queue);
+        detail::MaskKeysHost(maskRows.Data(), maskRows.Size(), blockRows.Data(), blockRows.Size(), complementMask, keep);
+    };
+
+    std::vector<unsigned int> rowsA, locationsA;
+    std::vector<unsigned int> rowsB, locationsB;
+
+    applyMask(blockA, rowsA, locationsA);
+    applyMask(blockB, rowsB, locationsB);
+
+    // Merge a and b, entries present in both are combined by op later
+    std::vector<unsigned int> resultRows;
+    std::vector<unsigned char> resultVals;
+    std::vector<unsigned int> intersectA, intersectB, intersectOffsets;
+
+    {
+        std::optional<HostMapped<unsigned char>> valsA;
+        std::optional<HostMapped<unsigned char>> valsB;
+
+        if (typeHasValues && blockA.IsNotNull())
+            valsA.emplace(blockA->GetVals(), queue);
+        if (typeHasValues && blockB.IsNotNull())
+            valsB.emplace(blockB->GetVals(), queue);
+
+        auto append = [&](unsigned int row, const std::optional<HostMapped<unsigned char>> &vals, unsigned int location) {
+            resultRows.push_back(row);
+            if (typeHasValues)
+                resultVals.insert(resultVals.end(), vals->begin() + location * byteSize, vals->begin() + (location + 1) * byteSize);
+        };
+
+        std::size_t i = 0, j = 0;
+        while (i < rowsA.size() || j < rowsB.size()) {
+            if (j == rowsB.size() || (i < rowsA.size() && rowsA[i] < rowsB[j])) {
+                append(rowsA[i], valsA, locationsA[i]);
+                i += 1;
+            } else if (i == rowsA.size() || rowsB[j] < rowsA[i]) {
+                append(rowsB[j], valsB, locationsB[j]);
+                j += 1;
+            } else {
+                // Value is evaluated natively or on device, reserve space for it
+                if (hostOp) {
+                    resultVals.resize(resultVals.size() + byteSize);
+                    hostOp(valsA->begin() + locationsA[i] * byteSize,
+                           valsB->begin() + locationsB[j] * byteSize,
+                           resultVals.data() + resultVals.size() - byteSize);
+                } else if (typeHasValues) {
+                    intersectA.push_back(locationsA[i]);
+                    intersectB.push_back(locationsB[j]);
+                    intersectOffsets.push_back(static_cast<unsigned int>(resultVals.size()));
+                    resultVals.resize(resultVals.size() + byteSize);
+                }
+                resultRows.push_back(rowsA[i]);
+                i += 1;
+                j += 1;
+            }
+        }
+    }
+
+    if (resultRows.empty())
+        return;
+
+    // Evaluate not native op for intersecting entries by single kernel
+    if (!intersectOffsets.empty()) {
+        auto intersectCount = intersectOffsets.size();
+        auto mapA = UploadMapped(intersectA, queue);
+        auto mapB = UploadMapped(intersectB, queue);
+        compute::vector<unsigned char> intersectVals(intersectCount * byteSize, ctx);
+
+        TransformValues(mapA, mapB,
+                        blockA->GetVals(), blockB->GetVals(), intersectVals,
+                        *p->op,
+                        queue);
+
+        HostMapped<unsigned char> intersectValsHost(intersectVals, queue);
+        for (std::size_t k = 0; k < intersectCount; k++)
+            std::copy(intersectValsHost.begin() + k * byteSize,
+                      intersectValsHost.begin() + (k + 1) * byteSize,
+                      resultVals.begin() + intersectOffsets[k]);
+    }
+
+    auto nrows = blockA.IsNotNull() ? blockA->GetNrows() : blockB->GetNrows();
+    auto resultNvals = resultRows.size();
+
+    p->w = VectorCOO::Make(nrows, resultNvals, UploadMapped(resultRows, queue), UploadMapped(resultVals, queue)).As<VectorBlock>();
+    SPDLOG_LOGGER_TRACE(logger, "Merge vectors on host size={} nnz={}", nrows, resultNvals);
+}
+
+spla::Algorithm::Type spla::VectorEWiseAddHost::GetType() const {
+    return Type::VectorEWiseAdd;
+}
+
+std::string spla::VectorEWiseAddHost::GetName() const {
+    return "VectorEWiseAddHost";
+}
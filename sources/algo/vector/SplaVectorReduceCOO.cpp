@@ -39,6 +39,13 @@ bool spla::VectorReduceCOO::Select(const spla::AlgorithmParams &params) const {
     return p && p->vec.Is<VectorCOO>();
 }
 
+spla::Algorithm::Cost spla::VectorReduceCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorReduce *>(&params);
+    auto nvals = p->vec.IsNotNull() ? p->vec->GetNvals() : 0;
+
+    return MakeCost(nvals, 1, device);
+}
+
 void spla::VectorReduceCOO::Process(spla::AlgorithmParams &params) {
     using namespace boost;
 
@@ -48,8 +55,6 @@ void spla::VectorReduceCOO::Process(spla::AlgorithmParams &params) {
     auto library = p->desc->GetLibrary().GetPrivatePtr();
     auto device = library->GetDeviceManager().GetDevice(p->deviceId);
     auto vector = p->vec.Cast<VectorCOO>();
-    auto type = p->type;
-    auto valueByteSize = type->GetByteSize();
     auto reduceOp = p->reduce;
 
     if (!vector->GetNvals()) {
@@ -61,7 +66,7 @@ void spla::VectorReduceCOO::Process(spla::AlgorithmParams &params) {
     compute::command_queue queue(ctx, device);
     QueueFinisher finisher(queue);
 
-    p->scalar = ScalarValue::Make(Reduce(vector->GetVals(), valueByteSize, reduceOp->GetSource(), queue));
+    p->scalar = ScalarValue::Make(Reduce(vector->GetVals(), *reduceOp, queue));
 }
 
 spla::Algorithm::Type spla::VectorReduceCOO::GetType() const {
@@ -0,0 +1,115 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/vector/SplaVectorReduceHost.hpp>
+#include <compute/SplaReduce.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/SplaScalarValue.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+#include <algorithm>
+
+bool spla::VectorReduceHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsVectorReduce *>(&params);
+
+    if (!p || !p->vec.Is<VectorCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto nvals = p->vec.IsNotNull() ? p->vec->GetNvals() : 0;
+
+    return nvals <= config.GetHostPathThreshold() ||
+           (config.GetForceHostPath() && p->reduce->HasHostFunction());
+}
+
+spla::Algorithm::Cost spla::VectorReduceHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVectorReduce *>(&params);
+    auto nvals = p->vec.IsNotNull() ? p->vec->GetNvals() : 0;
+
+    // Single value is copied as is, otherwise folded natively or by single work item
+    return MakeCost(nvals, nvals > 1 && !p->reduce->HasHostFunction() ? 1 : 0, device);
+}
+
+void spla::VectorReduceHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsVectorReduce *>(&params);
+    assert(p != nullptr);
+
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    auto vector = p->vec.Cast<VectorCOO>();
+    auto type = p->type;
+    auto valueByteSize = type->GetByteSize();
+    auto reduceOp = p->reduce;
+
+    if (!vector->GetNvals()) {
+        p->scalar = nullptr;
+        return;
+    }
+
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    // Nothing to reduce, value is the result
+    if (vector->GetNvals() == 1) {
+        p->scalar = ScalarValue::Make(compute::vector<unsigned char>(vector->GetVals(), queue));
+        return;
+    }
+
+    if (!reduceOp->HasHostFunction()) {
+        p->scalar = ScalarValue::Make(ReduceSerial(vector->GetVals(), valueByteSize, reduceOp->GetSource(), queue));
+        return;
+    }
+
+    // Fold values natively on host
+    auto hostOp = reduceOp->GetHostFunction();
+    std::vector<unsigned char> result(valueByteSize);
+    std::vector<unsigned char> tmp(valueByteSize);
+
+    {
+        HostMapped<unsigned char> vals(vector->GetVals(), queue);
+        std::copy(vals.begin(), vals.begin() + valueByteSize, result.begin());
+
+        for (std::size_t i = 1; i < vector->GetNvals(); i++) {
+            hostOp(result.data(), vals.begin() + i * valueByteSize, tmp.data());
+            std::swap(result, tmp);
+        }
+    }
+
+    p->scalar = ScalarValue::Make(UploadMapped(result, queue));
+}
+
+spla::Algorithm::Type spla::VectorReduceHost::GetType() const {
+    return spla::Algorithm::Type::VectorReduce;
+}
+
+std::string spla::VectorReduceHost::GetName() const {
+    return "VectorReduceHost";
+}
@@ -27,17 +27,18 @@
 
 #include <algo/vxm/SplaVxMCOO.hpp>
 #include <boost/compute/algorithm.hpp>
-#include <boost/compute/algorithm/scatter_if.hpp>
 #include <compute/SplaApplyMask.hpp>
+#include <compute/SplaExpandProducts.hpp>
 #include <compute/SplaIndicesToRowOffsets.hpp>
 #include <compute/SplaReduceByKey.hpp>
 #include <compute/SplaReduceDuplicates.hpp>
+#include <compute/SplaScan.hpp>
 #include <compute/SplaSortByRow.hpp>
-#include <compute/SplaTransformValues.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <core/SplaQueueFinisher.hpp>
 #include <storage/block/SplaMatrixCOO.hpp>
 #include <storage/block/SplaVectorCOO.hpp>
+#include <cmath>
 
 bool spla::VxMCOO::Select(const spla::AlgorithmParams &params) const {
     auto p = dynamic_cast<const ParamsVxM *>(&params);
@@ -49,6 +50,26 @@ bool spla::VxMCOO::Select(const spla::AlgorithmParams &params) const {
            p->b.Is<MatrixCOO>();
 }
 
+spla::Algorithm::Cost spla::VxMCOO::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVxM *>(&params);
+
+    if (p->a.IsNull() || p->b.IsNull())
+        return MakeCost(0, 1, device);
+
+    // Expected products count: each a entry meets average row of b
+    auto rows = std::max<std::size_t>(1, p->b->GetNrows());
+    auto flops = p->a->GetNvals() * p->b->GetNvals() / rows + p->a->GetNvals();
+
+    // Only a range of a rows may be multiplied; entries assumed to be spread evenly over rows
+    auto rangeRows = std::min(p->aEndRow, rows) - std::min(p->aBeginRow, rows);
+    flops = flops / rows * rangeRows + flops % rows * rangeRows / rows;
+
+    auto depth = std::max<std::size_t>(1, static_cast<std::size_t>(std::log2(flops + 1)));
+
+    // Products are sorted and reduced by key
+    return MakeCost(flops * depth, 5, device);
+}
+
 void spla::VxMCOO::Process(spla::AlgorithmParams &params) {
     using namespace boost;
 
@@ -72,8 +93,6 @@ void spla::VxMCOO::Process(spla::AlgorithmParams &params) {
     if (a->GetNvals() == 0 || b->GetNvals() == 0)
         return;
 
-    const auto &ta = p->ta;
-    const auto &tb = p->tb;
     const auto &tw = p->tw;
     auto hasValues = tw->HasValues();
     auto M = a->GetNrows();
@@ -84,74 +103,72 @@ void spla::VxMCOO::Process(spla::AlgorithmParams &params) {
     compute::vector<unsigned int> lengths(ctx);
     IndicesToRowOffsets(b->GetRows(), offsets, lengths, M, queue);
 
-    // Compute number of products for each a[i] x b[i,:]
-    compute::vector<unsigned int> segmentLengths(a->GetNvals() + 1, ctx);
-    compute::gather(a->GetRows().begin(), a->GetRows().end(), lengths.begin(), segmentLengths.begin(), queue);
+    // Select entries of a within rows range [aBeginRow, aEndRow), whole a by default
+    auto &aRows = a->GetRows();
+    auto aBeginRow = static_cast<unsigned int>(std::min<std::size_t>(p->aBeginRow, M));
+    auto aEndRow = static_cast<unsigned int>(std::min<std::size_t>(p->aEndRow, M));
+    unsigned int aBegin = 0;
+    unsigned int aEnd = static_cast<unsigned int>(a->GetNvals());
+
+    if (aBeginRow > 0 || aEndRow < M) {
+        aBegin = static_cast<unsigned int>(compute::lower_bound(aRows.begin(), aRows.end(), aBeginRow, queue) - aRows.begin());
+        aEnd = static_cast<unsigned int>(compute::lower_bound(aRows.begin(), aRows.end(), aEndRow, queue) - aRows.begin());
+    }
 
-    // Compute offsets between each a[i] x b[i,:] products
-    compute::vector<unsigned int> outputPtr(a->GetNvals() + 1, ctx);
-    compute::exclusive_scan(segmentLengths.begin(), segmentLengths.end(), outputPtr.begin(), 0u, queue);
+    auto aNvals = static_cast<std::size_t>(aEnd - aBegin);
 
-    // Number of products to count
-    std::size_t cooNnz = (outputPtr.end() - 1).read(queue);
+    if (aNvals == 0)
+        return;
+
+    // Compute number of products for each a[i] x b[i,:]
+    compute::vector<unsigned int> segmentLengths(aNvals + 1, ctx);
+    compute::gather(aRows.begin() + aBegin, aRows.begin() + aEnd, lengths.begin(), segmentLengths.begin(), queue);
+    compute::fill_n(segmentLengths.end() - 1, 1, 0u, queue);
+
+    // Compute offsets between each a[i] x b[i,:] products and number of products to count
+    compute::vector<unsigned int> outputPtr(aNvals + 1, ctx);
+    std::size_t cooNnz = ExclusiveScan(segmentLengths.begin(), segmentLengths.end(), outputPtr.begin(), queue);
 
     // nothing to do, no a[i] * b[i,:] product
     if (!cooNnz)
         return;
 
-    // Determine location of a and b values (indices in coo arrays) to copy for products evaluation
-    compute::vector<unsigned int> aLocations(cooNnz, ctx);
-    compute::vector<unsigned int> bLocations(cooNnz, ctx);
-
-    compute::fill(aLocations.begin(), aLocations.end(), 0u, queue);
-    compute::scatter_if(compute::counting_iterator<unsigned int>(0),
-                        compute::counting_iterator<unsigned int>(a->GetNvals()),
-                        outputPtr.begin(),
-                        segmentLengths.begin(),
-                        aLocations.begin(),
-                        queue);
-    compute::inclusive_scan(aLocations.begin(), aLocations.end(), aLocations.begin(), compute::max<unsigned int>(), queue);
-
-    auto &aRows = a->GetRows();
-    BOOST_COMPUTE_CLOSURE(void, unfoldSegment, (unsigned int i), (outputPtr, offsets, aRows, aLocations, bLocations), {
-        uint locationOfRowIndex = aLocations[i];
-        uint rowIdx = aRows[locationOfRowIndex];
-        uint rowBaseOffset = offsets[rowIdx];
-        uint offsetOfRowSegment = outputPtr[locationOfRowIndex];
-        bLocations[i] = rowBaseOffset + (i - offsetOfRowSegment);
-    });
-    compute::for_each_n(compute::counting_iterator<unsigned int>(0), cooNnz, unfoldSegment, queue);
-
-    // Gather indices j for each product a[i] * b[i,j]
+    // Expand products a[i] * b[i,j] in a single pass: locate a and b entries,
+    // gather indices j and evaluate multiply op without intermediate locations
     compute::vector<unsigned int> J(cooNnz, ctx);
-    compute::gather(bLocations.begin(), bLocations.end(), b->GetCols().begin(), J.begin(), queue);
+    compute::vector<unsigned char> V(hasValues ? cooNnz * tw->GetByteSize() : 0, ctx);
+    ExpandProducts(outputPtr, aRows, offsets, b->GetCols(),
+                   a->GetVals(), b->GetVals(),
+                   J, V,
+                   aBegin,
+                   hasValues ? p->mult.Get() : nullptr,
+                   queue);
 
     // Store final result here
     compute::vector<unsigned int> rows(ctx);
     compute::vector<unsigned char> vals(ctx);
 
-    // Compute a[i] * b[i, j] for each value i and j
-    if (hasValues) {
-        compute::vector<unsigned char> V(cooNnz * tw->GetByteSize(), ctx);
-        TransformValues(aLocations, bLocations,
-                        a->GetVals(), b->GetVals(), V,
-                        ta->GetByteSize(),
-                        tb->GetByteSize(),
-                        tw->GetByteSize(),
-                        p->mult->GetSource(),
-                        queue);
+    // Tiny products are masked on host, where a single map is cheaper than masking kernels
+    auto hostThreshold = library->GetContextConfig().GetHostPathThreshold();
+    auto hostMask = [&](const compute::vector<unsigned int> &keys) {
+        return keys.size() + mask->GetNvals() <= hostThreshold;
+    };
 
+    if (hasValues) {
         // Sort a[i] * b[i, j] products, so all j products stored in sequence
         SortByRow(J, V, tw->GetByteSize(), queue);
 
         // Reduce all produces a[i] * b[i, j] for j using provided add op
-        ReduceByKey(J, V, rows, vals, tw->GetByteSize(), p->add->GetSource(), queue);
+        ReduceByKey(J, V, rows, vals, *p->add, queue);
 
         // Apply mask if required
         if (p->hasMask && mask.IsNotNull()) {
             compute::vector<unsigned int> tmpRows(ctx);
             compute::vector<unsigned char> tmpVals(ctx);
-            ApplyMask(mask->GetRows(), rows, vals, tmpRows, tmpVals, tw->GetByteSize(), complementMask, queue);
+            if (hostMask(rows))
+                ApplyMaskHost(mask->GetRows(), rows, vals, tmpRows, tmpVals, tw->GetByteSize(), complementMask, queue);
+            else
+                ApplyMask(mask->GetRows(), rows, vals, tmpRows, tmpVals, tw->GetByteSize(), complementMask, queue);
             std::swap(rows, tmpRows);
             std::swap(vals, tmpVals);
         }
@@ -165,7 +182,11 @@ void spla::VxMCOO::Process(spla::AlgorithmParams &params) {
         // Apply mask to indices
         if (p->hasMask && mask.IsNotNull()) {
             compute::vector<unsigned int> tmpRows(ctx);
-            MaskKeys(mask->GetRows(), rows, tmpRows, complementMask, queue);
+            compute::vector<unsigned char> tmpVals(ctx);
+            if (hostMask(rows))
+                ApplyMaskHost(mask->GetRows(), rows, vals, tmpRows, tmpVals, 0, complementMask, queue);
+            else
+                MaskKeys(mask->GetRows(), rows, tmpRows, complementMask, queue);
             std::swap(rows, tmpRows);
         }
     }
@@ -0,0 +1,233 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algo/vxm/SplaVxMHost.hpp>
+#include <compute/SplaApplyMask.hpp>
+#include <compute/SplaReduceByKey.hpp>
+#include <compute/SplaTransformValues.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+#include <algorithm>
+
+bool spla::VxMHost::Select(const spla::AlgorithmParams &params) const {
+    auto p = dynamic_cast<const ParamsVxM *>(&params);
+
+    if (!p ||
+        !p->w.Is<VectorCOO>() ||
+        !p->mask.Is<VectorCOO>() ||
+        !p->a.Is<VectorCOO>() ||
+        !p->b.Is<MatrixCOO>())
+        return false;
+
+    auto &config = p->desc->GetLibrary().GetPrivate().GetContextConfig();
+    auto nvals = [](const auto &block) -> std::size_t { return block.IsNotNull() ? block->GetNvals() : 0; };
+    auto native = !p->tw->HasValues() || (p->mult->HasHostFunction() && p->add->HasHostFunction());
+
+    // Whole b block is mapped, so it must be tiny as well
+    return nvals(p->a) + nvals(p->b) + nvals(p->mask) <= config.GetHostPathThreshold() ||
+           (config.GetForceHostPath() && native);
+}
+
+spla::Algorithm::Cost spla::VxMHost::EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const {
+    auto p = dynamic_cast<const ParamsVxM *>(&params);
+    auto nvals = [](const auto &block) -> std::size_t { return block.IsNotNull() ? block->GetNvals() : 0; };
+
+    // Products are found on host, values are multiplied and reduced natively or on device
+    auto native = !p->tw->HasValues() || (p->mult->HasHostFunction() && p->add->HasHostFunction());
+    return MakeCost(nvals(p->a) + nvals(p->b) + nvals(p->mask), native ? 0 : 2, device);
+}
+
+void spla::VxMHost::Process(spla::AlgorithmParams &params) {
+    using namespace boost;
+
+    auto p = dynamic_cast<ParamsVxM *>(&params);
+    auto library = p->desc->GetLibrary().GetPrivatePtr();
+    auto &desc = p->desc;
+
+    auto device = library->GetDeviceManager().GetDevice(p->deviceId);
+    compute::context ctx = library->GetContext();
+    compute::command_queue queue(ctx, device);
+    QueueFinisher finisher(queue);
+
+    auto a = p->a.Cast<VectorCOO>();
+    auto b = p->b.Cast<MatrixCOO>();
+    auto mask = p->mask.Cast<VectorCOO>();
+    auto complementMask = desc->IsParamSet(Descriptor::Param::MaskComplement);
+
+    if (p->hasMask && !complementMask && mask.IsNull())
+        return;
+
+    if (a->GetNvals() == 0 || b->GetNvals() == 0)
+        return;
+
+    const auto &ta = p->ta;
+    const auto &tb = p->tb;
+    const auto &tw = p->tw;
+    auto hasValues = tw->HasValues();
+    auto M = a->GetNrows();
+    auto N = b->GetNcols();
+
+    // Select entries of a within rows range [aBeginRow, aEndRow), whole a by default
+    auto aBeginRow = static_cast<unsigned int>(std::min<std::size_t>(p->aBeginRow, M));
+    auto aEndRow = static_cast<unsigned int>(std::min<std::size_t>(p->aEndRow, M));
+
+    // Column j and locations of a and b values for each product a[i] * b[i,j]
+    struct Product {
+        unsigned int j;
+        unsigned int aLocation;
+        unsigned int bLocation;
+    };
+
+    std::vector<Product> products;
+
+    {
+        HostMapped<unsigned int> aRows(a->GetRows(), queue);
+        HostMapped<unsigned int> bRows(b->GetRows(), queue);
+        HostMapped<unsigned int> bCols(b->GetCols(), queue);
+
+        auto aBegin = std::lower_bound(aRows.begin(), aRows.end(), aBeginRow);
+        auto aEnd = std::lower_bound(aRows.begin(), aRows.end(), aEndRow);
+
+        for (auto aIter = aBegin; aIter != aEnd; ++aIter) {
+            auto bRange = std::equal_range(bRows.begin(), bRows.end(), *aIter);
+            for (auto bIter = bRange.first; bIter != bRange.second; ++bIter) {
+                auto bLocation = static_cast<unsigned int>(bIter - bRows.begin());
+                products.push_back({bCols[bLocation], static_cast<unsigned int>(aIter - aRows.begin()), bLocation});
+            }
+        }
+    }
+
+    // Stable sort keeps products of each j in order of a rows
+    std::stable_sort(products.begin(), products.end(), [](const Product &x, const Product &y) { return x.j < y.j; });
+
+    // Apply mask to columns of products before its evaluation
+    if (p->hasMask && mask.IsNotNull()) {
+        std::vector<unsigned int> keys(products.size());
+        std::vector<Product> masked;
+
+        for (std::size_t i = 0; i < products.size(); i++)
+            keys[i] = products[i].j;
+
+        HostMapped<unsigned int> maskRows(mask->GetRows(), queue);
+        detail::MaskKeysHost(maskRows.Data(), maskRows.Size(), keys.data(), keys.size(), complementMask,
+                             [&](std::size_t i) { masked.push_back(products[i]); });
+
+        std::swap(products, masked);
+    }
+
+    if (products.empty())
+        return;
+
+    // Store final result here
+    compute::vector<unsigned int> rows(ctx);
+    compute::vector<unsigned char> vals(ctx);
+
+    if (hasValues && p->mult->HasHostFunction() && p->add->HasHostFunction()) {
+        auto mult = p->mult->GetHostFunction();
+        auto add = p->add->GetHostFunction();
+        auto byteSizeA = ta->GetByteSize();
+        auto byteSizeB = tb->GetByteSize();
+        auto byteSizeW = tw->GetByteSize();
+
+        std::vector<unsigned int> J;
+        std::vector<unsigned char> W;
+        std::vector<unsigned char> product(byteSizeW);
+        std::vector<unsigned char> sum(byteSizeW);
+
+        {
+            HostMapped<unsigned char> aVals(a->GetVals(), queue);
+            HostMapped<unsigned char> bVals(b->GetVals(), queue);
+
+            // Products of the same j are adjacent, fold them in place
+            for (auto &entry : products) {
+                mult(aVals.begin() + entry.aLocation * byteSizeA, bVals.begin() + entry.bLocation * byteSizeB, product.data());
+
+                if (J.empty() || J.back() != entry.j) {
+                    J.push_back(entry.j);
+                    W.insert(W.end(), product.begin(), product.end());
+                } else {
+                    auto last = W.data() + W.size() - byteSizeW;
+                    add(last, product.data(), sum.data());
+                    std::copy(sum.begin(), sum.end(), last);
+                }
+            }
+        }
+
+        rows = UploadMapped(J, queue);
+        vals = UploadMapped(W, queue);
+    } else if (hasValues) {
+        auto count = products.size();
+        std::vector<unsigned int> J(count), aLocations(count), bLocations(count);
+
+        for (std::size_t i = 0; i < count; i++) {
+            J[i] = products[i].j;
+            aLocations[i] = products[i].aLocation;
+            bLocations[i] = products[i].bLocation;
+        }
+
+        auto unique = std::adjacent_find(J.begin(), J.end()) == J.end();
+        auto aLocationsDevice = UploadMapped(aLocations, queue);
+        auto bLocationsDevice = UploadMapped(bLocations, queue);
+
+        // Compute a[i] * b[i, j] for each product
+        compute::vector<unsigned char> V(count * tw->GetByteSize(), ctx);
+        TransformValues(aLocationsDevice, bLocationsDevice,
+                        a->GetVals(), b->GetVals(), V,
+                        *p->mult,
+                        queue);
+
+        // Reduce products a[i] * b[i, j] for j using provided add op, if any j repeats
+        if (unique) {
+            rows = UploadMapped(J, queue);
+            std::swap(vals, V);
+        } else
+            ReduceByKey(UploadMapped(J, queue), V, rows, vals, *p->add, queue);
+    } else {
+        std::vector<unsigned int> J;
+
+        // Keep only first entry of each j
+        for (auto &product : products)
+            if (J.empty() || J.back() != product.j)
+                J.push_back(product.j);
+
+        rows = UploadMapped(J, queue);
+    }
+
+    auto nvals = rows.size();
+    p->w = VectorCOO::Make(N, nvals, std::move(rows), std::move(vals)).As<VectorBlock>();
+}
+
+spla::Algorithm::Type spla::VxMHost::GetType() const {
+    return Type::VxM;
+}
+
+std::string spla::VxMHost::GetName() const {
+    return "VxMHost";
+}
@@ -32,6 +32,8 @@
 #include <boost/compute/container/vector.hpp>
 #include <compute/SplaGather.hpp>
 #include <compute/SplaMaskByKey.hpp>
+#include <core/SplaHostMapped.hpp>
+#include <vector>
 
 namespace spla {
 
@@ -95,6 +97,114 @@ namespace spla {
         }
     }
 
+    namespace detail {
+
+        /**
+         * @brief Walk sorted keys on host and report ones, which pass the mask.
+         *
+         * @param mask Sorted mask keys
+         * @param maskSize Number of mask keys
+         * @param keys Sorted keys to filter
+         * @param count Number of keys to filter
+         * @param complement Pass true to keep keys, which are not in the mask
+         * @param keep Callback invoked with index of each kept key
+         */
+        template<typename Keep>
+        inline void MaskKeysHost(const unsigned int *mask, std::size_t maskSize,
+                                 const unsigned int *keys, std::size_t count,
+                                 bool complement,
+                                 Keep &&keep) {
+            std::size_t m = 0;
+
+            for (std::size_t i = 0; i < count; i++) {
+                while (m < maskSize && mask[m] < keys[i])
+                    m += 1;
+
+                auto inMask = m < maskSize && mask[m] == keys[i];
+                if (inMask != complement)
+                    keep(i);
+            }
+        }
+
+        /**
+         * @brief Walk sorted pairs of keys on host and report ones, which pass the mask.
+         *
+         * @param maskRows Mask rows indices; pairs are sorted by row, then by column
+         * @param maskCols Mask cols indices
+         * @param maskSize Number of mask pairs
+         * @param rows Rows indices to filter; pairs are sorted by row, then by column
+         * @param cols Cols indices to filter
+         * @param count Number of pairs to filter
+         * @param complement Pass true to keep pairs, which are not in the mask
+         * @param keep Callback invoked with index of each kept pair
+         */
+        template<typename Keep>
+        inline void MaskPairKeysHost(const unsigned int *maskRows, const unsigned int *maskCols, std::size_t maskSize,
+                                     const unsigned int *rows, const unsigned int *cols, std::size_t count,
+                                     bool complement,
+                                     Keep &&keep) {
+            std::size_t m = 0;
+
+            for (std::size_t i = 0; i < count; i++) {
+                while (m < maskSize && (maskRows[m] < rows[i] || (maskRows[m] == rows[i] && maskCols[m] < cols[i])))
+                    m += 1;
+
+                auto inMask = m < maskSize && maskRows[m] == rows[i] && maskCols[m] == cols[i];
+                if (inMask != complement)
+                    keep(i);
+            }
+        }
+
+    }// namespace detail
+
+    /**
+     * @brief Apply mask to coo vector on host.
+     *
+     * Same as `ApplyMask` for vectors, but maps buffers and filters entries on host.
+     * Intended for tiny vectors, where kernels launches dominate actual work.
+     *
+     * @param mask Mask indices
+     * @param inputRows Row indices
+     * @param inputVals Values
+     * @param outputRows Result row indices; resized automatically
+     * @param outputVals Result values; resized automatically
+     * @param byteSize Size of values; if 0, apply only indices mask
+     * @param complement Pass true to apply inverse (complementary mask)
+     * @param queue Command queue to perform operation
+     */
+    inline void ApplyMaskHost(const boost::compute::vector<unsigned int> &mask,
+                              const boost::compute::vector<unsigned int> &inputRows,
+                              const boost::compute::vector<unsigned char> &inputVals,
+                              boost::compute::vector<unsigned int> &outputRows,
+                              boost::compute::vector<unsigned char> &outputVals,
+                              std::size_t byteSize,
+                              bool complement,
+                              boost::compute::command_queue &queue) {
+        if (mask.empty() || inputRows.empty())
+            return;
+
+        std::vector<unsigned int> rows;
+        std::vector<unsigned char> vals;
+
+        {
+            HostMapped<unsigned int> maskHost(mask, queue);
+            HostMapped<unsigned int> rowsHost(inputRows, queue);
+            HostMapped<unsigned char> valsHost(inputVals, queue);
+
+            detail::MaskKeysHost(maskHost.Data(), maskHost.Size(),
+                                 rowsHost.Data(), rowsHost.Size(),
+                                 complement,
+                                 [&](std::size_t i) {
+                                     rows.push_back(rowsHost[i]);
+                                     if (byteSize != 0)
+                                         vals.insert(vals.end(), valsHost.begin() + i * byteSize, valsHost.begin() + (i + 1) * byteSize);
+                                 });
+        }
+
+        outputRows = UploadMapped(rows, queue);
+        outputVals = UploadMapped(vals, queue);
+    }
+
     /**
      * @brief Apply mask to coo matrix.
      *
@@ -0,0 +1,224 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLABUILTINOP_HPP
+#define SPLA_SPLABUILTINOP_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/types.hpp>
+#include <compute/SplaGather.hpp>
+#include <spla-cpp/SplaFunctionBinary.hpp>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    namespace detail {
+
+        /**
+         * @brief OpenCL expression of predefined function applied to a and b
+         * @return Expression or empty string, if function has no native form
+         */
+        inline std::string BuiltinExpression(const FunctionBinary &f, const std::string &a, const std::string &b) {
+            using Op = FunctionBinary::Op;
+            auto isFloat = f.GetValueType() == "float" || f.GetValueType() == "double";
+
+            switch (f.GetOp()) {
+                case Op::Plus:
+                    return "(" + a + " + " + b + ")";
+                case Op::Minus:
+                    return "(" + a + " - " + b + ")";
+                case Op::ReverseMinus:
+                    return "(" + b + " - " + a + ")";
+                case Op::Mult:
+                    return "(" + a + " * " + b + ")";
+                case Op::Div:
+                    return "(" + a + " / " + b + ")";
+                case Op::ReverseDiv:
+                    return "(" + b + " / " + a + ")";
+                case Op::TakeFirst:
+                    return a;
+                case Op::TakeSecond:
+                    return b;
+                case Op::Or:
+                    return "(" + a + " | " + b + ")";
+                case Op::And:
+                    return "(" + a + " & " + b + ")";
+                case Op::Xor:
+                    return "(" + a + " ^ " + b + ")";
+                case Op::Min:
+                    return std::string(isFloat ? "fmin(" : "min(") + a + ", " + b + ")";
+                case Op::Max:
+                    return std::string(isFloat ? "fmax(" : "max(") + a + ", " + b + ")";
+                default:
+                    return std::string();
+            }
+        }
+
+        /**
+         * @brief Calls f with value of host type matching OpenCL value type of predefined function
+         * @return Result of f or false if value type is not known
+         */
+        template<typename F>
+        inline bool DispatchBuiltinType(const FunctionBinary &op, F &&f) {
+            using namespace boost::compute;
+            const auto &type = op.GetValueType();
+
+            if (type == "char")
+                return f(char_());
+            if (type == "uchar")
+                return f(uchar_());
+            if (type == "short")
+                return f(short_());
+            if (type == "ushort")
+                return f(ushort_());
+            if (type == "int")
+                return f(int_());
+            if (type == "uint")
+                return f(uint_());
+            if (type == "long")
+                return f(long_());
+            if (type == "ulong")
+                return f(ulong_());
+            if (type == "float")
+                return f(float_());
+            if (type == "double")
+                return f(double_());
+
+            return false;
+        }
+
+        /**
+         * @brief Calls f with Boost.Compute function object of associative predefined function of type T
+         * @return True if function is associative and f was called
+         */
+        template<typename T, typename F>
+        inline bool DispatchAssociativeOp(const FunctionBinary &op, F &&f) {
+            namespace compute = boost::compute;
+            using Op = FunctionBinary::Op;
+
+            switch (op.GetOp()) {
+                case Op::Plus:
+                    f(compute::plus<T>());
+                    return true;
+                case Op::Mult:
+                    f(compute::multiplies<T>());
+                    return true;
+                case Op::Min:
+                    if constexpr (std::is_floating_point_v<T>)
+                        f(compute::fmin<T>());
+                    else
+                        f(compute::min<T>());
+                    return true;
+                case Op::Max:
+                    if constexpr (std::is_floating_point_v<T>)
+                        f(compute::fmax<T>());
+                    else
+                        f(compute::max<T>());
+                    return true;
+                default:
+                    break;
+            }
+
+            if constexpr (std::is_integral_v<T>) {
+                switch (op.GetOp()) {
+                    case Op::Or:
+                        f(compute::bit_or<T>());
+                        return true;
+                    case Op::And:
+                        f(compute::bit_and<T>());
+                        return true;
+                    case Op::Xor:
+                        f(compute::bit_xor<T>());
+                        return true;
+                    default:
+                        break;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Emits application of binary function c = op(a, b) to values at given byte offsets
+         * Predefined functions are evaluated inline on typed values,
+         * other functions are called through generic pointer-based source.
+         */
+        template<class AIterator, class BIterator, class CIterator>
+        inline void ApplyBinaryOp(boost::compute::detail::meta_kernel &k,
+                                  const FunctionBinary &op,
+                                  AIterator a, const std::string &aOffset,
+                                  BIterator b, const std::string &bOffset,
+                                  CIterator c, const std::string &cOffset) {
+            using boost::compute::uint_;
+            const auto &type = op.GetValueType();
+            auto expression = BuiltinExpression(op, "_spla_a", "_spla_b");
+            auto byteSize = op.GetC()->GetByteSize();
+
+            if (!expression.empty() &&
+                IsValueAligned(a, byteSize) &&
+                IsValueAligned(b, byteSize) &&
+                IsValueAligned(c, byteSize)) {
+                k << "{\n"
+                  << "const " << type << " _spla_a = *((__global const " << type << "*)&" << a[k.expr<uint_>(aOffset)] << ");\n"
+                  << "const " << type << " _spla_b = *((__global const " << type << "*)&" << b[k.expr<uint_>(bOffset)] << ");\n"
+                  << "*((__global " << type << "*)&" << c[k.expr<uint_>(cOffset)] << ") = " << expression << ";\n"
+                  << "}\n";
+                return;
+            }
+
+            std::stringstream _spla_binary_op;
+            _spla_binary_op << "void _spla_binary_op(__global void* vp_a, __global void* vp_b, __global void* vp_c) {\n"
+                            << "#define _ACCESS_A __global\n"
+                            << "#define _ACCESS_B __global\n"
+                            << "#define _ACCESS_C __global\n"
+                            << "   " << op.GetSource() << "\n"
+                            << "#undef _ACCESS_A\n"
+                            << "#undef _ACCESS_B\n"
+                            << "#undef _ACCESS_C\n"
+                            << "}";
+
+            k.add_function("_spla_binary_op", _spla_binary_op.str());
+            k << "_spla_binary_op(&" << a[k.expr<uint_>(aOffset)] << ", &" << b[k.expr<uint_>(bOffset)] << ", &" << c[k.expr<uint_>(cOffset)] << ");\n";
+        }
+
+    }// namespace detail
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLABUILTINOP_HPP
@@ -0,0 +1,160 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAEXPANDPRODUCTS_HPP
+#define SPLA_SPLAEXPANDPRODUCTS_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <compute/SplaBuiltinOp.hpp>
+#include <compute/SplaKernelLaunch.hpp>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    namespace detail {
+
+        class ExpandProductsKernel : public boost::compute::detail::meta_kernel {
+        public:
+            ExpandProductsKernel() : boost::compute::detail::meta_kernel("__spla_expand_products_kernel") {
+            }
+
+            template<typename IndexIterator,
+                     typename ValuesIterator>
+            void SetRange(IndexIterator outputPtr,
+                          IndexIterator aRows,
+                          IndexIterator bOffsets,
+                          IndexIterator bCols,
+                          IndexIterator J,
+                          ValuesIterator aValues,
+                          ValuesIterator bValues,
+                          ValuesIterator outputValues,
+                          std::size_t aBegin,
+                          std::size_t segments,
+                          std::size_t count,
+                          const FunctionBinary *mult) {
+                using namespace boost;
+                mCount = count;
+                mCountArg = add_arg<compute::uint_>("count");
+                add_set_arg<compute::uint_>("a_begin", static_cast<compute::uint_>(aBegin));
+                add_set_arg<compute::uint_>("segments", static_cast<compute::uint_>(segments));
+
+                // Segment of the product i is found by binary search over exclusive offsets,
+                // so each work item handles exactly one product regardless of rows lengths
+                *this << "const uint i = get_global_id(0);\n"
+                      << "if (i >= count) return;\n"
+                      << "uint first = 0;\n"
+                      << "uint last = segments;\n"
+                      << "while (first + 1 < last) {\n"
+                      << "    const uint mid = (first + last) / 2;\n"
+                      << "    if (" << outputPtr[expr<compute::uint_>("mid")] << " <= i) first = mid; else last = mid;\n"
+                      << "}\n"
+                      << "const uint a_idx = a_begin + first;\n"
+                      << "const uint row = " << aRows[expr<compute::uint_>("a_idx")] << ";\n"
+                      << "const uint b_idx = " << bOffsets[expr<compute::uint_>("row")] << " + (i - " << outputPtr[expr<compute::uint_>("first")] << ");\n"
+                      << J[expr<compute::uint_>("i")] << " = " << bCols[expr<compute::uint_>("b_idx")] << ";\n";
+
+                if (mult) {
+                    *this << "const uint a_offset = a_idx * " << mult->GetA()->GetByteSize() << ";\n"
+                          << "const uint b_offset = b_idx * " << mult->GetB()->GetByteSize() << ";\n"
+                          << "const uint result_offset = i * " << mult->GetC()->GetByteSize() << ";\n";
+                    ApplyBinaryOp(*this, *mult, aValues, "a_offset", bValues, "b_offset", outputValues, "result_offset");
+                }
+            }
+
+            boost::compute::event Exec(boost::compute::command_queue &queue) {
+                if (mCount == 0) {
+                    return boost::compute::event();
+                }
+
+                return ExecTuned(*this, mCountArg, mCount, queue);
+            }
+
+        private:
+            std::size_t mCount = 0;
+            std::size_t mCountArg = 0;
+        };
+
+    }// namespace detail
+
+    /**
+     * @brief Expands products a[i] * b[i,:] in a single pass
+     * Fuses location of a and b entries, gather of product column indices
+     * and evaluation of the multiply op, so no intermediate location arrays
+     * are stored in global memory. For each product k writes J[k] = j and,
+     * if mult is provided, values[k] = mult(a[i], b[i,j]).
+     *
+     * @param outputPtr Exclusive offsets of products of selected a entries; size is segments + 1
+     * @param aRows Row indices of a entries
+     * @param bOffsets Row offsets of matrix b
+     * @param bCols Column indices of matrix b
+     * @param aValues A values
+     * @param bValues B values
+     * @param J Where to store products column indices; must be allocated by the user
+     * @param values Where to store products values; must be allocated by the user if mult is provided
+     * @param aBegin Index of first selected a entry
+     * @param mult Multiply function; null if no values computed
+     * @param queue Command queue to perform operation
+     *
+     * @return Event to sync this operation
+     */
+    inline boost::compute::event ExpandProducts(const boost::compute::vector<unsigned int> &outputPtr,
+                                                const boost::compute::vector<unsigned int> &aRows,
+                                                const boost::compute::vector<unsigned int> &bOffsets,
+                                                const boost::compute::vector<unsigned int> &bCols,
+                                                const boost::compute::vector<unsigned char> &aValues,
+                                                const boost::compute::vector<unsigned char> &bValues,
+                                                boost::compute::vector<unsigned int> &J,
+                                                boost::compute::vector<unsigned char> &values,
+                                                std::size_t aBegin,
+                                                const FunctionBinary *mult,
+                                                boost::compute::command_queue &queue) {
+        assert(!outputPtr.empty());
+        assert(!mult || values.size() == J.size() * mult->GetC()->GetByteSize());
+
+        detail::ExpandProductsKernel kernel;
+        kernel.SetRange(outputPtr.begin(), aRows.begin(), bOffsets.begin(), bCols.begin(), J.begin(),
+                        aValues.begin(), bValues.begin(), values.begin(),
+                        aBegin,
+                        outputPtr.size() - 1,
+                        J.size(),
+                        mult);
+
+        return kernel.Exec(queue);
+    }
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAEXPANDPRODUCTS_HPP
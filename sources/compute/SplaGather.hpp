@@ -30,6 +30,7 @@
 
 #include <boost/compute.hpp>
 #include <boost/compute/iterator/zip_iterator.hpp>
+#include <compute/SplaKernelLaunch.hpp>
 
 namespace spla {
 
@@ -40,6 +41,60 @@ namespace spla {
 
     namespace detail {
 
+        /**
+         * @brief Native OpenCL type to move a value of given byte size as a whole
+         * @return Type name or nullptr, if value must be moved byte by byte
+         */
+        inline const char *ValueMoveType(std::size_t byteSize) {
+            switch (byteSize) {
+                case 1:
+                    return "uchar";
+                case 2:
+                    return "ushort";
+                case 4:
+                    return "uint";
+                case 8:
+                    return "ulong";
+                case 16:
+                    return "uint4";
+                default:
+                    return nullptr;
+            }
+        }
+
+        /** Typed access requires values buffer iterator to point to values boundary */
+        template<class Iterator>
+        inline bool IsValueAligned(const Iterator &, std::size_t) {
+            return false;
+        }
+
+        inline bool IsValueAligned(const boost::compute::buffer_iterator<unsigned char> &it, std::size_t byteSize) {
+            return it.get_index() % byteSize == 0;
+        }
+
+        /**
+         * @brief Emits copy of single value from input at byte offset src to result at byte offset dst
+         * Values of 1, 2, 4, 8 and 16 bytes are moved with single native load and store,
+         * other sizes fall back to byte by byte loop.
+         */
+        template<class OutputIterator, class InputIterator>
+        inline void CopyValue(boost::compute::detail::meta_kernel &k,
+                              OutputIterator result, const std::string &dst,
+                              InputIterator input, const std::string &src,
+                              std::size_t byteSize) {
+            using boost::compute::uint_;
+            auto type = ValueMoveType(byteSize);
+
+            if (type && IsValueAligned(result, byteSize) && IsValueAligned(input, byteSize)) {
+                k << "*((__global " << type << "*)&" << result[k.expr<uint_>(dst)] << ") = "
+                  << "*((__global const " << type << "*)&" << input[k.expr<uint_>(src)] << ");\n";
+                return;
+            }
+
+            k << "for (uint byte_i = 0; byte_i < " << byteSize << "; byte_i++)\n"
+              << "  " << result[k.expr<uint_>("(" + dst + ") + byte_i")] << " = " << input[k.expr<uint_>("(" + src + ") + byte_i")] << ";\n";
+        }
+
         template<class InputIterator, class MapIterator, class OutputIterator>
         class GatherKernel : public boost::compute::detail::meta_kernel {
         public:
@@ -51,14 +106,56 @@ namespace spla {
                           OutputIterator result,
                           std::size_t elementsInSequence) {
                 mCount = boost::compute::detail::iterator_range_size(first, last);
+                mCountArg = add_arg<boost::compute::uint_>("count");
 
                 *this << "const uint i = get_global_id(0);\n"
+                      << "if (i >= count) return;\n"
                       << "const uint index = " << first[expr<boost::compute::uint_>("i")] << ";\n"
                       << "const uint dst = i * " << elementsInSequence << ";\n"
-                      << "const uint src = index * " << elementsInSequence << ";\n"
-                      << "for (uint k = 0; k < " << elementsInSequence << "; k++) {\n"
-                      << "  " << result[expr<boost::compute::uint_>("dst + k")] << "=" << input[expr<boost::compute::uint_>("src + k")] << ";\n"
-                      << "}";
+                      << "const uint src = index * " << elementsInSequence << ";\n";
+                CopyValue(*this, result, "dst", input, "src", elementsInSequence);
+            }
+
+            boost::compute::event Exec(boost::compute::command_queue &queue) {
+                if (mCount == 0) {
+                    return boost::compute::event();
+                }
+
+                return ExecTuned(*this, mCountArg, mCount, queue);
+            }
+
+        private:
+            std::size_t mCount = 0;
+            std::size_t mCountArg = 0;
+        };
+
+        class GatherMergedKernel : public boost::compute::detail::meta_kernel {
+        public:
+            GatherMergedKernel() : meta_kernel("__spla_gather_merged") {}
+
+            template<class MapIterator, class InputIterator, class OutputIterator>
+            void SetRange(MapIterator first,
+                          MapIterator last,
+                          InputIterator aValues,
+                          InputIterator bValues,
+                          OutputIterator result,
+                          std::size_t offset,
+                          std::size_t byteSize) {
+                mCount = boost::compute::detail::iterator_range_size(first, last);
+                mCountArg = add_arg<boost::compute::uint_>("count");
+                add_set_arg<boost::compute::uint_>("offset", static_cast<boost::compute::uint_>(offset));
+
+                *this << "const uint i = get_global_id(0);\n"
+                      << "if (i >= count) return;\n"
+                      << "const uint idx = " << first[expr<boost::compute::uint_>("i")] << ";\n"
+                      << "const uint dst = i * " << byteSize << ";\n"
+                      << "if (idx < offset) {\n"
+                      << "  const uint src = idx * " << byteSize << ";\n";
+                CopyValue(*this, result, "dst", aValues, "src", byteSize);
+                *this << "} else {\n"
+                      << "  const uint src = (idx - offset) * " << byteSize << ";\n";
+                CopyValue(*this, result, "dst", bValues, "src", byteSize);
+                *this << "}\n";
             }
 
             boost::compute::event Exec(boost::compute::command_queue &queue) {
@@ -66,11 +163,12 @@ namespace spla {
                     return boost::compute::event();
                 }
 
-                return exec_1d(queue, 0, mCount);
+                return ExecTuned(*this, mCountArg, mCount, queue);
             }
 
         private:
             std::size_t mCount = 0;
+            std::size_t mCountArg = 0;
         };
 
     }// namespace detail
@@ -121,6 +219,33 @@ namespace spla {
         Gather(map.begin(), map.end(), values.begin(), result.begin(), elementsInSequence, queue);
     }
 
+    /**
+     * Gathers values of two merged sequences using merge permutation.
+     * Permutation indices less than offset refer to a values, others refer to b values shifted by offset,
+     * i.e. result[i] = perm[i] < offset ? a[perm[i]] : b[perm[i] - offset] for each value of byteSize.
+     *
+     * @param perm Merge permutation
+     * @param aValues Values of first sequence
+     * @param bValues Values of second sequence
+     * @param result Where to store result; must be allocated by the user
+     * @param offset Number of values in first sequence
+     * @param byteSize Size of single value
+     * @param queue Execution queue
+     */
+    inline boost::compute::event GatherMerged(const boost::compute::vector<unsigned int> &perm,
+                                              const boost::compute::vector<unsigned char> &aValues,
+                                              const boost::compute::vector<unsigned char> &bValues,
+                                              boost::compute::vector<unsigned char> &result,
+                                              std::size_t offset,
+                                              std::size_t byteSize,
+                                              boost::compute::command_queue &queue) {
+        assert(result.size() == perm.size() * byteSize);
+
+        detail::GatherMergedKernel kernel;
+        kernel.SetRange(perm.begin(), perm.end(), aValues.begin(), bValues.begin(), result.begin(), offset, byteSize);
+        return kernel.Exec(queue);
+    }
+
     /**
      * @}
      */
@@ -30,6 +30,7 @@
 
 #include <boost/compute/algorithm.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <compute/SplaScan.hpp>
 
 #include <algorithm>
 #include <numeric>
@@ -79,7 +80,10 @@ namespace spla {
         });
 
         compute::for_each_n(compute::counting_iterator<unsigned int>(0), indices.size(), countRowLengths, queue);
-        compute::exclusive_scan(lengths.begin(), lengths.end(), offsets.begin(), queue);
+
+        // Total is not needed, so do not wait for the scan
+        ScanStatus status(queue.get_context());
+        ExclusiveScan(lengths.begin(), lengths.end(), offsets.begin(), status, queue);
     }
 
     /**
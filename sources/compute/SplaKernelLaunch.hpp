@@ -0,0 +1,99 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAKERNELLAUNCH_HPP
+#define SPLA_SPLAKERNELLAUNCH_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/kernel.hpp>
+#include <core/SplaKernelTuner.hpp>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    namespace detail {
+
+        /**
+         * @brief Launches 1d meta kernel with tuned work-group size
+         * Work-group size is selected per kernel name and device by KernelTuner;
+         * zero work-group size lets runtime choose it. Global size is rounded up
+         * to work-group size multiple, so kernel must skip work items with
+         * id not less than its count argument.
+         *
+         * @param k Kernel to launch; must not modify its inputs
+         * @param countArg Index of kernel count argument
+         * @param count Number of work items to process
+         * @param queue Command queue to launch kernel on
+         *
+         * @return Event of the launch
+         */
+        inline boost::compute::event ExecTuned(boost::compute::detail::meta_kernel &k,
+                                               std::size_t countArg,
+                                               std::size_t count,
+                                               boost::compute::command_queue &queue) {
+            using namespace boost;
+
+            k.set_arg(countArg, static_cast<compute::uint_>(count));
+            compute::kernel kernel = k.compile(queue.get_context());
+
+            auto device = queue.get_device();
+            auto maxLocalSize = kernel.get_work_group_info<std::size_t>(device, CL_KERNEL_WORK_GROUP_SIZE);
+
+            std::vector<std::size_t> candidates{0};
+            for (std::size_t localSize = 32; localSize <= 512 && localSize <= maxLocalSize; localSize *= 2)
+                candidates.push_back(localSize);
+
+            auto launch = [&](std::size_t localSize) {
+                auto globalSize = localSize ? (count + localSize - 1) / localSize * localSize : count;
+                return queue.enqueue_1d_range_kernel(kernel, 0, globalSize, localSize);
+            };
+
+            auto localSize = KernelTuner::Instance().Select(device, k.name() + ".local_size", candidates, 0, count,
+                                                            [&](std::size_t candidate) { launch(candidate).wait(); });
+
+            // Tuned on other variant of the kernel source, which may use less resources
+            if (localSize > maxLocalSize)
+                localSize = 0;
+
+            return launch(localSize);
+        }
+
+    }// namespace detail
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAKERNELLAUNCH_HPP
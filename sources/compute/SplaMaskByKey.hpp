@@ -31,6 +31,7 @@
 #include <boost/compute.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/iterator/zip_iterator.hpp>
+#include <compute/SplaScan.hpp>
 
 namespace spla {
 
@@ -357,11 +358,8 @@ namespace spla {
                                               compare, equals, complement);
             intersectionCountKernel.exec(queue);
 
-            // Compute actual counts offsets
-            exclusive_scan(counts.begin(), counts.end(), counts.begin(), queue);
-
-            // Get result count and resize buffers
-            std::size_t resultCount = (counts.end() - 1).read(queue);
+            // Compute actual counts offsets and result count, resize buffers
+            std::size_t resultCount = ExclusiveScan(counts.begin(), counts.end(), counts.begin(), queue);
             resizeResult(resultCount);
 
             // Find result intersections
@@ -32,6 +32,7 @@
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/hana.hpp>
+#include <core/SplaKernelTuner.hpp>
 
 namespace spla {
 
@@ -196,29 +197,38 @@ namespace spla {
             namespace compute = boost::compute;
             using compute::uint_;
 
-            const std::size_t tileSize = 1024;
+            auto merge = [&](std::size_t tileSize) {
+                compute::vector<uint_> tileA((count1 + count2 + tileSize - 1) / tileSize + 1, queue.get_context());
+                compute::vector<uint_> tileB((count1 + count2 + tileSize - 1) / tileSize + 1, queue.get_context());
 
-            compute::vector<uint_> tileA((count1 + count2 + tileSize - 1) / tileSize + 1, queue.get_context());
-            compute::vector<uint_> tileB((count1 + count2 + tileSize - 1) / tileSize + 1, queue.get_context());
+                // Tile the sets
+                MergeByKeyPathKernel tilingKernel;
+                tilingKernel.tileSize = static_cast<unsigned int>(tileSize);
+                tilingKernel.SetRange(count1, count2, tileA.begin() + 1, tileB.begin() + 1, compareFirstToSecond);
+                fill_n(tileA.begin(), 1, uint_(0), queue);
+                fill_n(tileB.begin(), 1, uint_(0), queue);
+                tilingKernel.exec(queue);
 
-            // Tile the sets
-            MergeByKeyPathKernel tilingKernel;
-            tilingKernel.tileSize = static_cast<unsigned int>(tileSize);
-            tilingKernel.SetRange(count1, count2, tileA.begin() + 1, tileB.begin() + 1, compareFirstToSecond);
-            fill_n(tileA.begin(), 1, uint_(0), queue);
-            fill_n(tileB.begin(), 1, uint_(0), queue);
-            tilingKernel.exec(queue);
+                fill_n(tileA.end() - 1, 1, static_cast<uint_>(count1), queue);
+                fill_n(tileB.end() - 1, 1, static_cast<uint_>(count2), queue);
 
-            fill_n(tileA.end() - 1, 1, static_cast<uint_>(count1), queue);
-            fill_n(tileB.end() - 1, 1, static_cast<uint_>(count2), queue);
+                // Merge
+                SerialMergeByKeyKernel mergeKernel;
+                mergeKernel.tileSize = static_cast<unsigned int>(tileSize);
+                mergeKernel.SetRange(tileA.begin(), tileA.end(), tileB.begin(),
+                                     compareFirstToSecond, assignResultToFirst, assignResultToSecond);
 
-            // Merge
-            SerialMergeByKeyKernel mergeKernel;
-            mergeKernel.tileSize = static_cast<unsigned int>(tileSize);
-            mergeKernel.SetRange(tileA.begin(), tileA.end(), tileB.begin(),
-                                 compareFirstToSecond, assignResultToFirst, assignResultToSecond);
+                mergeKernel.exec(queue);
+            };
 
-            mergeKernel.exec(queue);
+            // Tile size is a part of kernels source, so each candidate is compiled once while tuning
+            auto tileSize = KernelTuner::Instance().Select(queue.get_device(), "__spla_merge_by_key.tile_size",
+                                                           {256, 512, 1024, 2048, 4096}, 1024, count1 + count2,
+                                                           [&](std::size_t candidate) {
+                                                               merge(candidate);
+                                                               queue.finish();
+                                                           });
+            merge(tileSize);
 
             return static_cast<std::ptrdiff_t>(count1 + count2);
         }
@@ -29,6 +29,7 @@
 
 #include <boost/compute/algorithm/reduce.hpp>
 
+#include <compute/SplaBuiltinOp.hpp>
 #include <compute/metautil/SplaMetaUtil.hpp>
 
 
@@ -264,6 +265,41 @@ namespace spla {
             compute::copy_n(results.begin(), valueByteSize, result.begin(), queue);
         }
 
+        inline void SerialReduce(const boost::compute::vector<unsigned char> &values,
+                                 std::size_t valueByteSize,
+                                 boost::compute::vector<unsigned char> &result,
+                                 const std::string &functionBody,
+                                 boost::compute::command_queue &queue) {
+            const compute::context &context = queue.get_context();
+            const std::size_t nValues = values.size() / valueByteSize;
+
+            compute::detail::meta_kernel k("serial_reduce");
+            const std::size_t countArg = k.add_arg<uint_>("count");
+            const std::size_t outputArg = k.add_arg<unsigned char *>(compute::memory_object::global_memory, "output");
+
+            ReduceOp reduceOp(k, "serial_reduce_reduce", functionBody, valueByteSize,
+                              Visibility::Unspecified,
+                              Visibility::Global,
+                              Visibility::Unspecified);
+
+            k << DeclareVal{"result", valueByteSize} << ";\n"
+              << AssignVal{ValVar{"result"}, ValArrItem{values, "0", valueByteSize, k}, valueByteSize}
+              << "for(uint i = 1; i < count; i++)\n"
+              << reduceOp.Apply(ValVar{"result"},
+                                ValArrItem(values, "i", valueByteSize, k),
+                                ValVar{"result"})
+              << AssignVal{ValArrItem{"output", "0", valueByteSize},
+                           ValVar{"result"},
+                           valueByteSize}
+              << ";\n";
+
+            compute::kernel kernel = k.compile(context);
+            kernel.set_arg(countArg, static_cast<uint_>(nValues));
+            kernel.set_arg(outputArg, result.get_buffer());
+
+            queue.enqueue_task(kernel);
+        }
+
     }// namespace detail
 
     inline boost::compute::vector<unsigned char> Reduce(const boost::compute::vector<unsigned char> &values,
@@ -281,6 +317,66 @@ namespace spla {
         return result;
     }
 
+    /**
+     * @brief Reduce values with reduce function object.
+     *
+     * Associative predefined functions are reduced natively on typed values,
+     * other functions fall back to the generic byte-sized reduction.
+     *
+     * @param values Values to reduce
+     * @param reduceOp Reduce function
+     * @param queue Command queue to perform operation
+     *
+     * @return Single reduced value
+     */
+    inline boost::compute::vector<unsigned char> Reduce(const boost::compute::vector<unsigned char> &values,
+                                                        const FunctionBinary &reduceOp,
+                                                        boost::compute::command_queue &queue) {
+        using namespace boost;
+
+        auto valueByteSize = reduceOp.GetC()->GetByteSize();
+        auto count = values.size() / valueByteSize;
+
+        if (count > 0) {
+            compute::vector<unsigned char> result(valueByteSize, queue.get_context());
+
+            auto native = detail::DispatchBuiltinType(reduceOp, [&](auto value) {
+                using T = decltype(value);
+                return detail::DispatchAssociativeOp<T>(reduceOp, [&](auto function) {
+                    auto first = compute::make_buffer_iterator<T>(values.get_buffer(), 0);
+                    compute::reduce(first, first + count, compute::make_buffer_iterator<T>(result.get_buffer(), 0), function, queue);
+                });
+            });
+
+            if (native)
+                return result;
+        }
+
+        return Reduce(values, valueByteSize, reduceOp.GetSource(), queue);
+    }
+
+    /**
+     * @brief Reduce values sequentially by a single work item.
+     *
+     * Launches exactly one kernel without intermediate buffers,
+     * so it is the cheapest way to reduce a few values.
+     *
+     * @param values Values to reduce; must contain at least one value
+     * @param valueByteSize Size of single value
+     * @param reduceOp Source code of reduce function
+     * @param queue Command queue to perform operation
+     *
+     * @return Single reduced value
+     */
+    inline boost::compute::vector<unsigned char> ReduceSerial(const boost::compute::vector<unsigned char> &values,
+                                                              std::size_t valueByteSize,
+                                                              const std::string &reduceOp,
+                                                              boost::compute::command_queue &queue) {
+        boost::compute::vector<unsigned char> result(valueByteSize, queue.get_context());
+        detail::SerialReduce(values, valueByteSize, result, reduceOp, queue);
+        return result;
+    }
+
 }// namespace spla
 
 #endif//SPLA_SPLAREDUCE_HPP
@@ -30,13 +30,17 @@
 
 #include <functional>
 
+#include <boost/compute/algorithm/fill.hpp>
 #include <boost/compute/algorithm/for_each_n.hpp>
 #include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/algorithm/reduce_by_key.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/iterator/counting_iterator.hpp>
 #include <boost/compute/memory/local_buffer.hpp>
 
+#include <compute/SplaBuiltinOp.hpp>
+#include <compute/SplaScan.hpp>
 #include <compute/metautil/SplaMetaUtil.hpp>
 
 
@@ -49,8 +53,16 @@ namespace spla {
 
     namespace detail {
 
-        inline void GenerateUintKeys(const std::vector<std::reference_wrapper<const compute::vector<unsigned int>>> &keysFirst,
-                                     const compute::vector<unsigned int>::iterator &newKeysFirst,
+        /** Segment reduction with per-thread loop is used, if average segment is not longer */
+        inline constexpr std::size_t SHORT_SEGMENT_AVG_LENGTH = 4;
+
+        /** Segment reduction with per-thread loop is used, if no segment is longer */
+        inline constexpr std::size_t SHORT_SEGMENT_MAX_LENGTH = 64;
+
+        /** Writes 1 for each key different from previous one, and @p firstFlag for the first key */
+        inline void GenerateKeyFlags(const std::vector<std::reference_wrapper<const compute::vector<unsigned int>>> &keysFirst,
+                                     const compute::vector<unsigned int>::iterator &flagsFirst,
+                                     uint_ firstFlag,
                                      std::size_t preferredWorkGroupSize,
                                      compute::command_queue &queue) {
             compute::detail::meta_kernel k("spla_reduce_by_key_new_key_flags");
@@ -68,9 +80,9 @@ namespace spla {
               << AssignKey{KeyVar("previous_key"), KeyVec(keysFirst, "gid - 1", k), nKeys}
               << "    value = " << CompareKey{KeyVar("previous_key"), KeyVar("key"), nKeys} << " ? 0 : 1;\n"
               << "}\n else {\n"
-              << "    value = 0;\n"
+              << "    value = " << firstFlag << ";\n"
               << "}\n"
-              << newKeysFirst[k.var<const uint_>("gid")] << " = value;\n";
+              << flagsFirst[k.var<const uint_>("gid")] << " = value;\n";
 
             const compute::context &context = queue.get_context();
             compute::kernel kernel = k.compile(context);
@@ -82,11 +94,125 @@ namespace spla {
                                           0,
                                           workGroupsNo * preferredWorkGroupSize,
                                           preferredWorkGroupSize);
+        }
 
+        inline void GenerateUintKeys(const std::vector<std::reference_wrapper<const compute::vector<unsigned int>>> &keysFirst,
+                                     const compute::vector<unsigned int>::iterator &newKeysFirst,
+                                     std::size_t preferredWorkGroupSize,
+                                     compute::command_queue &queue) {
+            const std::size_t count = keysFirst.at(0).get().size();
+
+            GenerateKeyFlags(keysFirst, newKeysFirst, 0, preferredWorkGroupSize, queue);
             inclusive_scan(newKeysFirst, newKeysFirst + static_cast<std::ptrdiff_t>(count),
                            newKeysFirst, queue);
         }
 
+        /** @return Length of the longest segment between consecutive @p heads */
+        inline std::size_t MaxSegmentLength(const compute::vector<uint_> &heads,
+                                            std::size_t count,
+                                            std::size_t workGroupSize,
+                                            compute::command_queue &queue) {
+            const std::size_t segments = heads.size();
+            compute::vector<uint_> maxLength(1, queue.get_context());
+            compute::fill(maxLength.begin(), maxLength.end(), 0u, queue);
+
+            compute::detail::meta_kernel k("spla_reduce_by_key_max_segment_length");
+            k.add_set_arg<const uint_>("count", static_cast<uint_>(count));
+            k.add_set_arg<const uint_>("segments", static_cast<uint_>(segments));
+
+            k << k.decl<const uint_>("gid") << " = get_global_id(0);\n"
+              << "if (gid >= segments) {\n    return;\n}\n"
+              << k.decl<const uint_>("end") << " = gid + 1 < segments ? " << heads.begin()[k.var<const uint_>("gid + 1")] << " : count;\n"
+              << "atomic_max(&" << maxLength.begin()[k.var<const uint_>("0")] << ", end - " << heads.begin()[k.var<const uint_>("gid")] << ");\n";
+
+            auto workGroupsNo = static_cast<std::size_t>(
+                    std::ceil(static_cast<float>(segments) / static_cast<float>(workGroupSize)));
+
+            compute::kernel kernel = k.compile(queue.get_context());
+            queue.enqueue_1d_range_kernel(kernel,
+                                          0,
+                                          workGroupsNo * workGroupSize,
+                                          workGroupSize);
+
+            return maxLength.begin().read(queue);
+        }
+
+        /** Each work item reduces values of one segment, starting at its head, in a sequential loop */
+        inline void ReduceShortSegments(const std::vector<std::reference_wrapper<const compute::vector<uint_>>> &keys,
+                                        const compute::vector<unsigned char> &values,
+                                        const compute::vector<uint_> &heads,
+                                        const std::vector<std::reference_wrapper<compute::vector<uint_>>> &keysResult,
+                                        compute::vector<unsigned char> &valuesResult,
+                                        std::size_t count,
+                                        std::size_t workGroupSize,
+                                        std::size_t vBytes,
+                                        const std::string &reduceBody,
+                                        compute::command_queue &queue) {
+            const std::size_t segments = heads.size();
+            const std::size_t nKeys = keys.size();
+            assert(nKeys == keysResult.size());
+
+            compute::detail::meta_kernel k("spla_reduce_by_key_short_segments");
+            k.add_set_arg<const uint_>("count", static_cast<uint_>(count));
+            k.add_set_arg<const uint_>("segments", static_cast<uint_>(segments));
+            ReduceOp reduceOp(k, "spla_reduce", reduceBody, vBytes);
+
+            k << k.decl<const uint_>("gid") << " = get_global_id(0);\n"
+              << "if (gid >= segments) {\n    return;\n}\n"
+              << k.decl<const uint_>("begin") << " = " << heads.begin()[k.var<const uint_>("gid")] << ";\n"
+              << k.decl<const uint_>("end") << " = gid + 1 < segments ? " << heads.begin()[k.var<const uint_>("gid + 1")] << " : count;\n"
+              << DeclareVal{"result", vBytes} << ";\n"
+              << DeclareVal{"value", vBytes} << ";\n"
+              << AssignVal{ValVar("result"), ValArrItem(values, "begin", vBytes, k), vBytes} << ";\n"
+              << "for (" << k.decl<uint_>("idx") << " = begin + 1; idx < end; idx += 1) {\n"
+              << AssignVal{ValVar("value"), ValArrItem(values, "idx", vBytes, k), vBytes} << ";\n"
+              << reduceOp.Apply(ValVar("result"), ValVar("value"), ValVar("result")) << ";\n"
+              << "}\n"
+              << AssignKey{KeyVec(keysResult, "gid", k), KeyVec(keys, "begin", k), nKeys} << ";\n"
+              << AssignVal{ValArrItem(valuesResult, "gid", vBytes, k), ValVar("result"), vBytes} << ";\n";
+
+            auto workGroupsNo = static_cast<std::size_t>(
+                    std::ceil(static_cast<float>(segments) / static_cast<float>(workGroupSize)));
+
+            compute::kernel kernel = k.compile(queue.get_context());
+            queue.enqueue_1d_range_kernel(kernel,
+                                          0,
+                                          workGroupsNo * workGroupSize,
+                                          workGroupSize);
+        }
+
+        /**
+         * @brief Reduction by key for sequences of short segments
+         *
+         * If segments, given by their heads, are short on average and none of them is long,
+         * each segment is reduced by single work item without carry propagation between work groups.
+         * The longest segment is searched only if the average length allows such reduction.
+         *
+         * @return True if reduction is done, false if segments are too long
+         */
+        inline bool ReduceByKeyShortSegments(const std::vector<std::reference_wrapper<const compute::vector<uint_>>> &keys,
+                                             const compute::vector<unsigned char> &values,
+                                             const compute::vector<uint_> &heads,
+                                             const std::vector<std::reference_wrapper<compute::vector<uint_>>> &keysResult,
+                                             compute::vector<unsigned char> &valuesResult,
+                                             std::size_t count,
+                                             std::size_t valueByteSize,
+                                             const std::string &reduceBody,
+                                             std::size_t workGroupSize,
+                                             compute::command_queue &queue) {
+            const std::size_t segments = heads.size();
+
+            if (count > segments * SHORT_SEGMENT_AVG_LENGTH)
+                return false;
+            if (MaxSegmentLength(heads, count, workGroupSize, queue) > SHORT_SEGMENT_MAX_LENGTH)
+                return false;
+
+            ReduceShortSegments(keys, values, heads, keysResult, valuesResult,
+                                count, workGroupSize, valueByteSize, reduceBody, queue);
+
+            return true;
+        }
+
         inline void CarryOuts(const compute::vector<uint_> &keys,
                               const compute::vector<unsigned char> &values,
                               const compute::vector<uint_>::iterator &carryOutsKeysFirst,
@@ -321,10 +447,12 @@ namespace spla {
 
         /**
          * @details
-         * 1. Keys are recalculated with @p GenerateUintKeys. It is done by
-         *  comparison of each two adjustment keys and inclusive scan is performed
-         *  on the resulting vector. As a bonus, we already know size of the resulting
-         *  keys vector: it is the value of the last key + 1. @n
+         * 0. Segments heads are flagged by comparison of each two adjacent keys
+         *  and compacted, which gives the size of the resulting keys vector.
+         *  Sequences of short segments are reduced with @p ReduceByKeyShortSegments,
+         *  otherwise general algorithm below is used. @n
+         * 1. Keys are recalculated as inclusive scan of heads flags, where
+         *  the first flag is zero, so keys are counted from zero. @n
          * 2. For each work group carry-out value is calculated (it's done by key-oriented
          *  Hillis/Steele scan), where @n
          *      - Carry-out is a pair of the last key processed by work
@@ -352,8 +480,28 @@ namespace spla {
 
             const compute::device &device = queue.get_device();
             const std::size_t workGroupSize = device.get_info<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
-            compute::vector<uint_> newKeys(count, context);
-            GenerateUintKeys(keys, newKeys.begin(), workGroupSize, queue);
+
+            // Segments heads are flagged and compacted in single pass, so result size is known for both paths
+            compute::vector<uint_> flags(count, context);
+            GenerateKeyFlags(keys, flags.begin(), 1, workGroupSize, queue);
+
+            compute::vector<uint_> heads(context);
+            const std::size_t resultSize = Compact(flags.begin(), flags.end(), heads, queue);
+
+            for (compute::vector<uint_> &kRes : keysResult) {
+                kRes.resize(resultSize, queue);
+            }
+            valuesResult.resize(resultSize * valueByteSize, queue);
+
+            if (ReduceByKeyShortSegments(keys, values, heads, keysResult, valuesResult,
+                                         count, valueByteSize, reduceBody, workGroupSize, queue)) {
+                return resultSize;
+            }
+
+            // New keys are inclusive scan of heads flags, counted from zero
+            compute::vector<uint_> &newKeys = flags;
+            newKeys.begin().write(0u, queue);
+            inclusive_scan(newKeys.begin(), newKeys.end(), newKeys.begin(), queue);
 
             const auto carryOutSize = static_cast<std::size_t>(
                     std::ceil(static_cast<float>(count) / static_cast<float>(workGroupSize)));
@@ -378,13 +526,6 @@ namespace spla {
                      reduceBody,
                      queue);
 
-            const std::size_t resultSize = compute::detail::read_single_value<uint_>(newKeys.get_buffer(), count - 1, queue) + 1;
-
-            for (compute::vector<uint_> &kRes : keysResult) {
-                kRes.resize(resultSize, queue);
-            }
-            valuesResult.resize(resultSize * valueByteSize, queue);
-
             FinalReduction(keys,
                            values.begin(),
                            keysResult,
@@ -401,6 +542,37 @@ namespace spla {
             return resultSize;
         }
 
+        /** Reduces typed values with native Boost.Compute function object; keys must be single sequence */
+        template<typename T, typename Function>
+        inline std::size_t ReduceByKeyTyped(const compute::vector<uint_> &keys,
+                                            const compute::vector<unsigned char> &values,
+                                            compute::vector<uint_> &keysResult,
+                                            compute::vector<unsigned char> &valuesResult,
+                                            Function function,
+                                            compute::command_queue &queue) {
+            const std::size_t count = keys.size();
+
+            keysResult.resize(count, queue);
+            valuesResult.resize(count * sizeof(T), queue);
+
+            if (count == 0) {
+                return 0;
+            }
+
+            auto result = compute::reduce_by_key(keys.begin(), keys.end(),
+                                                 compute::make_buffer_iterator<T>(values.get_buffer(), 0),
+                                                 keysResult.begin(),
+                                                 compute::make_buffer_iterator<T>(valuesResult.get_buffer(), 0),
+                                                 function,
+                                                 queue);
+
+            const auto resultSize = static_cast<std::size_t>(result.first - keysResult.begin());
+            keysResult.resize(resultSize, queue);
+            valuesResult.resize(resultSize * sizeof(T), queue);
+
+            return resultSize;
+        }
+
     }// namespace detail
 
     /**
@@ -494,6 +666,41 @@ namespace spla {
                 queue);
     }
 
+    /**
+     * @brief Reduction of values by key with reduce function object. @n
+     *
+     * Associative predefined functions are reduced natively on typed values,
+     * other functions fall back to the generic byte-sized reduction.
+     *
+     * @param inputIndices Vector of keys
+     * @param inputValues Sequence of bytes, where values are packed
+     * @param outputIndices Output sequence of keys
+     * @param outputValues Output sequence of value's bytes
+     * @param reduceOp Reduce function
+     * @param queue OpenCL command queue
+     * @return Size of the resulting key sequence
+     */
+    inline std::size_t ReduceByKey(const boost::compute::vector<unsigned int> &inputIndices,
+                                   const boost::compute::vector<unsigned char> &inputValues,
+                                   boost::compute::vector<unsigned int> &outputIndices,
+                                   boost::compute::vector<unsigned char> &outputValues,
+                                   const FunctionBinary &reduceOp,
+                                   boost::compute::command_queue &queue) {
+        std::size_t resultSize = 0;
+
+        auto native = detail::DispatchBuiltinType(reduceOp, [&](auto value) {
+            using T = decltype(value);
+            return detail::DispatchAssociativeOp<T>(reduceOp, [&](auto function) {
+                resultSize = detail::ReduceByKeyTyped<T>(inputIndices, inputValues, outputIndices, outputValues, function, queue);
+            });
+        });
+
+        if (native)
+            return resultSize;
+
+        return ReduceByKey(inputIndices, inputValues, outputIndices, outputValues, reduceOp.GetC()->GetByteSize(), reduceOp.GetSource(), queue);
+    }
+
     /**
      * @brief The algorithm performs reduction of two input keys sequences
      * for each contiguous subsequence of equivalent keys.
@@ -29,6 +29,8 @@
 #define SPLA_SPLAREDUCEDUPLICATES_HPP
 
 #include <boost/compute.hpp>
+#include <compute/SplaGather.hpp>
+#include <compute/SplaScan.hpp>
 
 namespace spla {
 
@@ -82,10 +84,9 @@ namespace spla {
                       << "    _spla_reduce_op(&" << input[expr<compute::uint_>("arg1")] << ", &" << input[expr<compute::uint_>("arg2")] << ", &" << result[expr<compute::uint_>("arg3")] << ");\n"
                       << "  } else {\n"
                       << "    const uint dst = offset * " << elementsInSequence << ";\n"
-                      << "    const uint src = i * " << elementsInSequence << ";\n"
-                      << "    for (uint k = 0; k < " << elementsInSequence << "; k++)\n"
-                      << "      " << result[expr<boost::compute::uint_>("dst + k")] << " = " << input[expr<boost::compute::uint_>("src + k")] << ";\n"
-                      << "  }\n"
+                      << "    const uint src = i * " << elementsInSequence << ";\n";
+                CopyValue(*this, result, "dst", input, "src", elementsInSequence);
+                *this << "  }\n"
                       << "}";
             }
 
@@ -155,11 +156,9 @@ namespace spla {
             }
 
             // Define write offsets (where to write value in result buffer) for each unique value
-            compute::vector<unsigned int> offsets(unique.size(), ctx);
-            compute::exclusive_scan(unique.begin(), unique.end(), offsets.begin(), 0, queue);
-
-            // Count number of unique values to allocate storage
-            std::size_t resultNvals = (offsets.end() - 1).read(queue);
+            // and count number of unique values to allocate storage
+            compute::vector<unsigned int> offsets(count, ctx);
+            std::size_t resultNvals = ExclusiveScan(unique.begin(), unique.begin() + count, offsets.begin(), queue);
 
             if (!inputIndices1.empty())
                 resultIndices1.resize(resultNvals, queue);
@@ -0,0 +1,427 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLASCAN_HPP
+#define SPLA_SPLASCAN_HPP
+
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <algorithm>
+#include <string>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @brief Status buffer of single-pass scans
+     *
+     * Scans, submitted to the same queue one after another, reuse the buffer
+     * instead of allocating it on each call. Total of the last scan is kept in
+     * the buffer and can be read when it is actually needed.
+     */
+    class ScanStatus {
+    public:
+        explicit ScanStatus(const boost::compute::context &ctx) : mStatus(ctx) {}
+
+        /**
+         * Prepares zeroed status for a scan.
+         *
+         * @param tiles Number of tiles of the scan
+         * @param queue Command queue to perform scan on
+         *
+         * @return Status buffer
+         */
+        const boost::compute::vector<boost::compute::uint_> &Reset(std::size_t tiles, boost::compute::command_queue &queue) {
+            using namespace boost;
+
+            // Layout: tiles counter, total, then flags, aggregates and inclusive prefixes of each tile
+            const std::size_t size = 2 + 3 * tiles;
+
+            // Content is not preserved, so there is no need to copy it on resize
+            if (mStatus.size() < size)
+                mStatus = compute::vector<compute::uint_>(size, queue.get_context());
+
+            compute::fill_n(mStatus.begin(), size, 0u, queue);
+            return mStatus;
+        }
+
+        /**
+         * Reads total of the last scan; waits for its completion.
+         *
+         * @param queue Command queue the scan is performed on
+         *
+         * @return Total of scanned values
+         */
+        [[nodiscard]] std::size_t ReadTotal(boost::compute::command_queue &queue) const {
+            return mStatus.empty() ? 0 : (mStatus.begin() + 1).read(queue);
+        }
+
+    private:
+        boost::compute::vector<boost::compute::uint_> mStatus;
+    };
+
+    namespace detail {
+
+        /** Kind of single-pass scan output */
+        enum class ScanKind {
+            Exclusive,
+            Inclusive,
+            Compact
+        };
+
+        /**
+         * @brief Single-pass scan of unsigned values with decoupled look-back
+         *
+         * Each work-group scans its tile of values in local memory and publishes
+         * tile aggregate. Then its first work item looks back over preceding tiles,
+         * accumulating their aggregates until a tile with published inclusive prefix,
+         * and publishes own inclusive prefix. Values are read and written exactly once.
+         *
+         * Work-groups may be scheduled in any order, so tiles ids are not taken from
+         * group ids, but from atomic ticket counter in order of work-groups start.
+         * Thus work-group spins only on tiles of work-groups, which have already started
+         * and never wait for it, and look-back completes as long as started work-groups
+         * keep running (OpenCL devices do not preempt resident work-groups).
+         *
+         * Work-group size is a part of the kernel source; status buffer is bound after compilation.
+         */
+        class SinglePassScanKernel : public boost::compute::detail::meta_kernel {
+        public:
+            static constexpr std::size_t MAX_WORK_GROUP_SIZE = 256;
+            static constexpr std::size_t ITEMS_PER_THREAD = 4;
+
+            explicit SinglePassScanKernel(std::size_t workGroupSize)
+                : meta_kernel("__spla_single_pass_scan"),
+                  mWorkGroupSize(workGroupSize),
+                  mTileSize(workGroupSize * ITEMS_PER_THREAD) {}
+
+            template<class InputIterator, class OutputIterator>
+            void SetRange(InputIterator input,
+                          OutputIterator output,
+                          std::size_t count,
+                          const std::string &op,
+                          ScanKind kind) {
+                using boost::compute::uint_;
+
+                mTiles = (count + mTileSize - 1) / mTileSize;
+
+                mStatusArg = add_arg<uint_ *>(boost::compute::memory_object::global_memory, "status");
+                add_set_arg<uint_>("count", static_cast<uint_>(count));
+                add_set_arg<uint_>("tiles", static_cast<uint_>(mTiles));
+
+                std::string combine = op == "max" ? "max(x, y)" : "x + y";
+                add_function("_spla_scan_op", "uint _spla_scan_op(uint x, uint y) { return " + combine + "; }");
+
+                *this << "__local uint tile_id;\n"
+                      << "__local uint tile_prefix;\n"
+                      << "__local uint scratch[" << mWorkGroupSize << "];\n"
+                      << "__global uint *counter = status;\n"
+                      << "__global uint *total = status + 1;\n"
+                      << "__global uint *flags = status + 2;\n"
+                      << "__global uint *aggregates = flags + tiles;\n"
+                      << "__global uint *inclusives = aggregates + tiles;\n"
+                      << "const uint lid = get_local_id(0);\n"
+                      << "if (lid == 0) tile_id = atomic_inc(counter);\n"
+                      << "barrier(CLK_LOCAL_MEM_FENCE);\n"
+                      << "const uint tile = tile_id;\n"
+                      << "const uint base = tile * " << mTileSize << " + lid * " << ITEMS_PER_THREAD << ";\n"
+                      << "uint values[" << ITEMS_PER_THREAD << "];\n"
+                      << "uint sum = 0;\n"
+                      << "for (uint k = 0; k < " << ITEMS_PER_THREAD << "; k++) {\n"
+                      << "    const uint idx = base + k;\n"
+                      << "    uint value = 0;\n"
+                      << "    if (idx < count) value = " << input[expr<uint_>("idx")] << ";\n";
+
+                if (kind == ScanKind::Compact)
+                    *this << "    value = value ? 1 : 0;\n";
+
+                *this << "    values[k] = value;\n"
+                      << "    sum = _spla_scan_op(sum, value);\n"
+                      << "}\n"
+                      // Inclusive scan of work items sums within the tile
+                      << "scratch[lid] = sum;\n"
+                      << "barrier(CLK_LOCAL_MEM_FENCE);\n"
+                      << "for (uint offset = 1; offset < " << mWorkGroupSize << "; offset <<= 1) {\n"
+                      << "    const uint other = lid >= offset ? scratch[lid - offset] : 0;\n"
+                      << "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+                      << "    scratch[lid] = _spla_scan_op(scratch[lid], other);\n"
+                      << "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+                      << "}\n"
+                      << "const uint thread_prefix = lid > 0 ? scratch[lid - 1] : 0;\n"
+                      // Decoupled look-back: flag 1 publishes aggregate, flag 2 publishes inclusive prefix
+                      << "if (lid == 0) {\n"
+                      << "    const uint aggregate = scratch[" << mWorkGroupSize - 1 << "];\n"
+                      << "    uint prefix = 0;\n"
+                      << "    if (tile > 0) {\n"
+                      << "        atomic_xchg(&aggregates[tile], aggregate);\n"
+                      << "        mem_fence(CLK_GLOBAL_MEM_FENCE);\n"
+                      << "        atomic_xchg(&flags[tile], 1u);\n"
+                      << "        uint pred = tile - 1;\n"
+                      // Predecessors got smaller tickets, so their work-groups are already running
+                      << "        while (true) {\n"
+                      << "            const uint flag = atomic_or(&flags[pred], 0u);\n"
+                      << "            if (flag == 0) continue;\n"
+                      << "            mem_fence(CLK_GLOBAL_MEM_FENCE);\n"
+                      << "            if (flag == 2) {\n"
+                      << "                prefix = _spla_scan_op(prefix, atomic_or(&inclusives[pred], 0u));\n"
+                      << "                break;\n"
+                      << "            }\n"
+                      << "            prefix = _spla_scan_op(prefix, atomic_or(&aggregates[pred], 0u));\n"
+                      << "            pred -= 1;\n"
+                      << "        }\n"
+                      << "    }\n"
+                      << "    const uint inclusive = _spla_scan_op(prefix, aggregate);\n"
+                      << "    atomic_xchg(&inclusives[tile], inclusive);\n"
+                      << "    mem_fence(CLK_GLOBAL_MEM_FENCE);\n"
+                      << "    atomic_xchg(&flags[tile], 2u);\n"
+                      << "    if (tile + 1 == tiles) *total = inclusive;\n"
+                      << "    tile_prefix = prefix;\n"
+                      << "}\n"
+                      << "barrier(CLK_LOCAL_MEM_FENCE);\n"
+                      << "uint running = _spla_scan_op(tile_prefix, thread_prefix);\n"
+                      << "for (uint k = 0; k < " << ITEMS_PER_THREAD << "; k++) {\n"
+                      << "    const uint idx = base + k;\n"
+                      << "    if (idx >= count) break;\n";
+
+                switch (kind) {
+                    case ScanKind::Exclusive:
+                        *this << "    " << output[expr<uint_>("idx")] << " = running;\n"
+                              << "    running = _spla_scan_op(running, values[k]);\n";
+                        break;
+                    case ScanKind::Inclusive:
+                        *this << "    running = _spla_scan_op(running, values[k]);\n"
+                              << "    " << output[expr<uint_>("idx")] << " = running;\n";
+                        break;
+                    case ScanKind::Compact:
+                        *this << "    if (values[k]) " << output[expr<uint_>("running")] << " = idx;\n"
+                              << "    running += values[k];\n";
+                        break;
+                }
+
+                *this << "}\n";
+            }
+
+            /**
+             * Launches compiled kernel.
+             *
+             * @param kernel Kernel, compiled from this meta kernel
+             * @param status Status of the scan
+             * @param queue Command queue to launch kernel on
+             */
+            boost::compute::event Exec(boost::compute::kernel &kernel,
+                                       ScanStatus &status,
+                                       boost::compute::command_queue &queue) {
+                kernel.set_arg(mStatusArg, status.Reset(mTiles, queue).get_buffer());
+                return queue.enqueue_1d_range_kernel(kernel, 0, mTiles * mWorkGroupSize, mWorkGroupSize);
+            }
+
+        private:
+            std::size_t mWorkGroupSize;
+            std::size_t mTileSize;
+            std::size_t mTiles = 0;
+            std::size_t mStatusArg = 0;
+        };
+
+        /** Scans values; does not wait for completion, total is kept in status */
+        template<class InputIterator, class OutputIterator>
+        inline void SinglePassScan(InputIterator first,
+                                   InputIterator last,
+                                   OutputIterator result,
+                                   const std::string &op,
+                                   ScanKind kind,
+                                   ScanStatus &status,
+                                   boost::compute::command_queue &queue) {
+            using namespace boost;
+
+            auto count = compute::detail::iterator_range_size(first, last);
+
+            if (count == 0) {
+                status.Reset(0, queue);
+                return;
+            }
+
+            auto device = queue.get_device();
+            auto workGroupSize = std::min(SinglePassScanKernel::MAX_WORK_GROUP_SIZE, device.max_work_group_size());
+
+            while (true) {
+                SinglePassScanKernel scanKernel(workGroupSize);
+                scanKernel.SetRange(first, result, count, op, kind);
+
+                auto kernel = scanKernel.compile(queue.get_context());
+                auto kernelWorkGroupSize = kernel.get_work_group_info<std::size_t>(device, CL_KERNEL_WORK_GROUP_SIZE);
+
+                if (workGroupSize <= kernelWorkGroupSize) {
+                    scanKernel.Exec(kernel, status, queue);
+                    return;
+                }
+
+                // Kernel resources limit work-group size below the device one
+                workGroupSize = std::max<std::size_t>(kernelWorkGroupSize, 1);
+            }
+        }
+
+    }// namespace detail
+
+    /**
+     * @brief Exclusive sum scan of unsigned values in single pass
+     * Allows in-place scan, when result is equal to first.
+     * Does not wait for completion; total can be read from status.
+     *
+     * @param first Begin of values to scan
+     * @param last End of values to scan
+     * @param result Begin of result values
+     * @param status Status buffer to reuse
+     * @param queue Command queue to perform operation
+     */
+    template<class InputIterator, class OutputIterator>
+    inline void ExclusiveScan(InputIterator first,
+                              InputIterator last,
+                              OutputIterator result,
+                              ScanStatus &status,
+                              boost::compute::command_queue &queue) {
+        detail::SinglePassScan(first, last, result, "plus", detail::ScanKind::Exclusive, status, queue);
+    }
+
+    /**
+     * @brief Exclusive sum scan of unsigned values in single pass
+     * Allows in-place scan, when result is equal to first.
+     *
+     * @param first Begin of values to scan
+     * @param last End of values to scan
+     * @param result Begin of result values
+     * @param queue Command queue to perform operation
+     *
+     * @return Sum of all values
+     */
+    template<class InputIterator, class OutputIterator>
+    inline std::size_t ExclusiveScan(InputIterator first,
+                                     InputIterator last,
+                                     OutputIterator result,
+                                     boost::compute::command_queue &queue) {
+        ScanStatus status(queue.get_context());
+        ExclusiveScan(first, last, result, status, queue);
+        return status.ReadTotal(queue);
+    }
+
+    /**
+     * @brief Inclusive max scan of unsigned values in single pass
+     * Allows in-place scan, when result is equal to first.
+     * Does not wait for completion; max can be read from status.
+     *
+     * @param first Begin of values to scan
+     * @param last End of values to scan
+     * @param result Begin of result values
+     * @param status Status buffer to reuse
+     * @param queue Command queue to perform operation
+     */
+    template<class InputIterator, class OutputIterator>
+    inline void InclusiveScanMax(InputIterator first,
+                                 InputIterator last,
+                                 OutputIterator result,
+                                 ScanStatus &status,
+                                 boost::compute::command_queue &queue) {
+        detail::SinglePassScan(first, last, result, "max", detail::ScanKind::Inclusive, status, queue);
+    }
+
+    /**
+     * @brief Inclusive max scan of unsigned values in single pass
+     * Allows in-place scan, when result is equal to first.
+     *
+     * @param first Begin of values to scan
+     * @param last End of values to scan
+     * @param result Begin of result values
+     * @param queue Command queue to perform operation
+     *
+     * @return Max of all values
+     */
+    template<class InputIterator, class OutputIterator>
+    inline std::size_t InclusiveScanMax(InputIterator first,
+                                        InputIterator last,
+                                        OutputIterator result,
+                                        boost::compute::command_queue &queue) {
+        ScanStatus status(queue.get_context());
+        InclusiveScanMax(first, last, result, status, queue);
+        return status.ReadTotal(queue);
+    }
+
+    /**
+     * @brief Stream compaction: collects indices of non-zero flags in order in single pass
+     *
+     * @param first Begin of flags
+     * @param last End of flags
+     * @param indices Where to store indices of non-zero flags; resized to their count
+     * @param status Status buffer to reuse
+     * @param queue Command queue to perform operation
+     *
+     * @return Number of non-zero flags
+     */
+    template<class InputIterator>
+    inline std::size_t Compact(InputIterator first,
+                               InputIterator last,
+                               boost::compute::vector<unsigned int> &indices,
+                               ScanStatus &status,
+                               boost::compute::command_queue &queue) {
+        indices.resize(boost::compute::detail::iterator_range_size(first, last), queue);
+        detail::SinglePassScan(first, last, indices.begin(), "plus", detail::ScanKind::Compact, status, queue);
+        auto count = status.ReadTotal(queue);
+        indices.resize(count, queue);
+        return count;
+    }
+
+    /**
+     * @brief Stream compaction: collects indices of non-zero flags in order in single pass
+     *
+     * @param first Begin of flags
+     * @param last End of flags
+     * @param indices Where to store indices of non-zero flags; resized to their count
+     * @param queue Command queue to perform operation
+     *
+     * @return Number of non-zero flags
+     */
+    template<class InputIterator>
+    inline std::size_t Compact(InputIterator first,
+                               InputIterator last,
+                               boost::compute::vector<unsigned int> &indices,
+                               boost::compute::command_queue &queue) {
+        ScanStatus status(queue.get_context());
+        return Compact(first, last, indices, status, queue);
+    }
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLASCAN_HPP
@@ -30,6 +30,8 @@
 
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/container/vector.hpp>
+#include <compute/SplaBuiltinOp.hpp>
+#include <compute/SplaKernelLaunch.hpp>
 
 namespace spla {
 
@@ -60,6 +62,7 @@ namespace spla {
                           const std::string &transformOp) {
                 using namespace boost;
                 mCount = count;
+                mCountArg = add_arg<compute::uint_>("count");
 
                 std::stringstream _spla_transform_op;
                 _spla_transform_op << "void _spla_transform_op(__global void* vp_a, __global void* vp_b, __global void* vp_c) {\n"
@@ -75,6 +78,7 @@ namespace spla {
                 add_function("_spla_transform_op", _spla_transform_op.str());
 
                 *this << "const uint i = get_global_id(0);\n"
+                      << "if (i >= count) return;\n"
                       << "const uint a_idx = " << aMap[expr<compute::uint_>("i")] << ";\n"
                       << "const uint b_idx = " << bMap[expr<compute::uint_>("i")] << ";\n"
                       << "const uint a_offset = a_idx * " << aByteSize << ";\n"
@@ -83,16 +87,41 @@ namespace spla {
                       << "_spla_transform_op(&" << aValues[expr<compute::uint_>("a_offset")] << ", &" << bValues[expr<compute::uint_>("b_offset")] << ", &" << outputValues[expr<compute::uint_>("result_offset")] << ");\n";
             }
 
+            template<typename InputMap,
+                     typename InputValues,
+                     typename OutputValues>
+            void SetRange(InputMap aMap,
+                          InputMap bMap,
+                          InputValues aValues,
+                          InputValues bValues,
+                          OutputValues outputValues,
+                          std::size_t count,
+                          const FunctionBinary &transformOp) {
+                using namespace boost;
+                mCount = count;
+                mCountArg = add_arg<compute::uint_>("count");
+
+                *this << "const uint i = get_global_id(0);\n"
+                      << "if (i >= count) return;\n"
+                      << "const uint a_idx = " << aMap[expr<compute::uint_>("i")] << ";\n"
+                      << "const uint b_idx = " << bMap[expr<compute::uint_>("i")] << ";\n"
+                      << "const uint a_offset = a_idx * " << transformOp.GetA()->GetByteSize() << ";\n"
+                      << "const uint b_offset = b_idx * " << transformOp.GetB()->GetByteSize() << ";\n"
+                      << "const uint result_offset = i * " << transformOp.GetC()->GetByteSize() << ";\n";
+                ApplyBinaryOp(*this, transformOp, aValues, "a_offset", bValues, "b_offset", outputValues, "result_offset");
+            }
+
             boost::compute::event Exec(boost::compute::command_queue &queue) {
                 if (mCount == 0) {
                     return boost::compute::event();
                 }
 
-                return exec_1d(queue, 0, mCount);
+                return ExecTuned(*this, mCountArg, mCount, queue);
             }
 
         private:
             std::size_t mCount = 0;
+            std::size_t mCountArg = 0;
         };
 
     }// namespace detail
@@ -144,6 +173,43 @@ namespace spla {
         return kernel.Exec(queue);
     }
 
+    /**
+     * @brief Transforms a and b values using map and transform function
+     * Predefined functions are evaluated natively on typed values,
+     * other functions fall back to the generic source code.
+     *
+     * @param aMap Map for a values
+     * @param bMap Map for b values
+     * @param aValues A values
+     * @param bValues B values
+     * @param values Where to store result of transformation; must be allocated by the user
+     * @param transformOp Transform function
+     * @param queue Command queue to perform operation
+     *
+     * @return Event to syn this operation
+     */
+    inline boost::compute::event TransformValues(const boost::compute::vector<unsigned int> &aMap,
+                                                 const boost::compute::vector<unsigned int> &bMap,
+                                                 const boost::compute::vector<unsigned char> &aValues,
+                                                 const boost::compute::vector<unsigned char> &bValues,
+                                                 boost::compute::vector<unsigned char> &values,
+                                                 const FunctionBinary &transformOp,
+                                                 boost::compute::command_queue &queue) {
+        auto count = aMap.size();
+
+        assert(aMap.size() == bMap.size());
+        assert(values.size() == count * transformOp.GetC()->GetByteSize());
+
+        detail::TransformValuesKernel kernel;
+        kernel.SetRange(aMap.begin(), bMap.begin(),
+                        aValues.begin(), bValues.begin(),
+                        values.begin(),
+                        count,
+                        transformOp);
+
+        return kernel.Exec(queue);
+    }
+
     /**
      * @}
      */
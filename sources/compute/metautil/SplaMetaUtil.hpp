@@ -222,6 +222,22 @@ namespace spla::detail {
     };
 
     inline MetaKernel &operator<<(MetaKernel &k, const AssignVal &v) {
+        // Address space and alignment of values are not known here,
+        // so common sizes are moved with vector load and store of bytes
+        switch (v.vBytes) {
+            case 1:
+                k << v.Left.GetByteByN("0") << " = " << v.Right.GetByteByN("0") << ";\n";
+                return k;
+            case 2:
+            case 4:
+            case 8:
+            case 16:
+                k << "vstore" << std::to_string(v.vBytes) << "(vload" << std::to_string(v.vBytes) << "(0, " << v.Right.GetPointer() << "), 0, " << v.Left.GetPointer() << ");\n";
+                return k;
+            default:
+                break;
+        }
+
         k << "for (uint byte_i = 0; byte_i < " << std::to_string(v.vBytes) << "; byte_i++) {\n"
           << v.Left.GetByteByN("byte_i") << " = " << v.Right.GetByteByN("byte_i") << ";\n"
           << "}\n";
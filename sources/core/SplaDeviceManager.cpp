@@ -27,6 +27,10 @@
 
 #include <core/SplaDeviceManager.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 namespace spla {
     namespace {
         bool FetchSpecifiedDevice(Descriptor &desc, DeviceManager::DeviceId &id) {
@@ -51,6 +55,9 @@ namespace spla {
 
             return true;
         }
+
+        // Bound number of tracked blocks locations, dropped storages leave unused entries
+        const std::size_t MAX_TRACKED_LOCATIONS = 1u << 16u;
     }// namespace
 }// namespace spla
 
@@ -68,7 +75,7 @@ spla::DeviceManager::DeviceId spla::DeviceManager::FetchDevice(const spla::RefPt
 
     // If it does not fetched or specified id is too large, we can simply use next suitable
     if (!fetched || id >= mDevices.size())
-        id = NextDevice();
+        id = NextDevice(0, {});
 
     return id;
 }
@@ -93,18 +100,76 @@ std::vector<spla::DeviceManager::DeviceId> spla::DeviceManager::FetchDevices(std
     if (fetched) {
         // If specified id is too large, we can simply use next suitable
         if (id >= mDevices.size())
-            id = NextDevice();
+            id = NextDevice(0, {});
         result.resize(required, id);
     } else {
-        // Use even work distribution for all tasks
+        // Work is unknown, use least loaded devices in turn
         result.reserve(required);
         for (std::size_t i = 0; i < required; i++)
-            result.push_back(NextDevice());
+            result.push_back(NextDevice(0, {}));
     }
 
     return result;
 }
 
+std::vector<std::shared_ptr<spla::DeviceManager::Ticket>> spla::DeviceManager::Schedule(const std::vector<Work> &work, const spla::RefPtr<spla::ExpressionNode> &node) {
+    std::lock_guard<std::mutex> lockGuard(mMutex);
+
+    std::vector<std::shared_ptr<Ticket>> result(work.size());
+
+    if (work.empty())
+        return result;
+
+    assert(node);
+    auto desc = node->GetDescriptor();
+    assert(desc);
+
+    DeviceId id;
+
+    // Try to fetch device id from desc, then single device is used for all work
+    auto fetched = FetchSpecifiedDevice(*desc, id) && id < mDevices.size();
+
+    // Heavier work is scheduled first, so light work fills the gaps
+    std::vector<std::size_t> order(work.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+        return work[i].amount > work[j].amount;
+    });
+
+    for (auto i : order) {
+        auto &piece = work[i];
+        auto deviceId = fetched ? id : NextDevice(piece.amount, piece.inputs);
+
+        mLoad[deviceId] += piece.amount;
+        result[i] = std::shared_ptr<Ticket>(new Ticket(*this, deviceId, piece.amount));
+
+        if (piece.output.has_value()) {
+            // Owners ids grow monotonically, so locations of the oldest owners are dropped first
+            while (mProducers.size() >= MAX_TRACKED_LOCATIONS)
+                EraseLocations(mProducers.begin()->first.first);
+            mProducers[piece.output.value()] = deviceId;
+        }
+    }
+
+    return result;
+}
+
+spla::DeviceManager::LocationOwner spla::DeviceManager::NewLocationOwner() {
+    std::lock_guard<std::mutex> lockGuard(mMutex);
+    return mNextLocationOwner++;
+}
+
+void spla::DeviceManager::ForgetLocations(LocationOwner owner) {
+    std::lock_guard<std::mutex> lockGuard(mMutex);
+    EraseLocations(owner);
+}
+
+std::size_t spla::DeviceManager::GetLoad(spla::DeviceManager::DeviceId id) const {
+    std::lock_guard<std::mutex> lockGuard(mMutex);
+    assert(id < mDevices.size());
+    return mLoad[id];
+}
+
 const spla::DeviceManager::Device &spla::DeviceManager::GetDevice(spla::DeviceManager::DeviceId id) const {
     assert(id < mDevices.size());
     return mDevices[id];
@@ -116,10 +181,66 @@ const std::vector<spla::DeviceManager::Device> &spla::DeviceManager::GetDevices(
 
 spla::DeviceManager::DeviceManager(std::vector<Device> devices) : mDevices(std::move(devices)) {
     assert(!mDevices.empty());
+    mLoad.resize(mDevices.size(), 0);
+}
+
+spla::DeviceManager::DeviceId spla::DeviceManager::NextDevice(std::size_t amount, const std::vector<Location> &inputs) {
+    auto count = mDevices.size();
+    auto best = mNextDevice;
+    auto bestScore = std::numeric_limits<double>::max();
+
+    // Score is expected load of the device after the work,
+    // where share of inputs produced on other devices counts as extra work.
+    // NOTE: scan starts from next device, so ties are resolved in round-robin manner
+    for (std::size_t k = 0; k < count; k++) {
+        auto device = (mNextDevice + k) % count;
+        std::size_t remote = 0;
+
+        for (auto &input : inputs) {
+            auto producer = mProducers.find(input);
+            if (producer != mProducers.end() && producer->second != device)
+                remote += 1;
+        }
+
+        auto remoteShare = inputs.empty() ? 0.0 : static_cast<double>(remote) / static_cast<double>(inputs.size());
+        auto score = static_cast<double>(mLoad[device]) + static_cast<double>(amount) * remoteShare;
+
+        if (score < bestScore) {
+            best = device;
+            bestScore = score;
+        }
+    }
+
+    mNextDevice = (best + 1) % count;
+    return best;
 }
 
-spla::DeviceManager::DeviceId spla::DeviceManager::NextDevice() {
-    auto next = mNextDevice;
-    mNextDevice = (mNextDevice + 1) % mDevices.size();
-    return next;
-}
\ No newline at end of file
+void spla::DeviceManager::Release(spla::DeviceManager::DeviceId id, std::size_t amount) {
+    std::lock_guard<std::mutex> lockGuard(mMutex);
+    assert(id < mDevices.size());
+    assert(mLoad[id] >= amount);
+    mLoad[id] -= amount;
+}
+
+spla::DeviceManager::Ticket::Ticket(spla::DeviceManager &manager, spla::DeviceManager::DeviceId id, std::size_t amount)
+    : mManager(manager), mDeviceId(id), mAmount(amount) {
+}
+
+spla::DeviceManager::Ticket::~Ticket() {
+    Release();
+}
+
+void spla::DeviceManager::Ticket::Release() {
+    if (!mReleased.exchange(true))
+        mManager.Release(mDeviceId, mAmount);
+}
+
+spla::DeviceManager::DeviceId spla::DeviceManager::Ticket::GetDeviceId() const noexcept {
+    return mDeviceId;
+}
+
+void spla::DeviceManager::EraseLocations(LocationOwner owner) {
+    auto first = mProducers.lower_bound(Location{owner, 0});
+    auto last = mProducers.lower_bound(Location{owner + 1, 0});
+    mProducers.erase(first, last);
+}
@@ -28,10 +28,16 @@
 #ifndef SPLA_SPLADEVICEMANAGER_HPP
 #define SPLA_SPLADEVICEMANAGER_HPP
 
+#include <atomic>
 #include <boost/compute/device.hpp>
 #include <cstddef>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <spla-cpp/SplaExpressionNode.hpp>
+#include <utility>
+#include <vector>
 
 namespace spla {
 
@@ -45,13 +51,60 @@ namespace spla {
      * @brief Computational devices management for expressions execution.
      *
      * Device manager allows to fetch single device id or a number of device ids
-     * for processing sequential or parallel equally complex parts of expression nodes.
+     * for processing sequential or parallel parts of expression nodes.
+     *
+     * Scheduler tracks in-flight work of each device and the device, where
+     * each block was last produced. Work is assigned to the least loaded device,
+     * while devices holding the inputs of the work are preferred.
      */
     class DeviceManager {
     public:
         using DeviceId = std::size_t;
         using Device = boost::compute::device;
 
+        /** Id of blocks owner (storage or node temporary results); ids are never reused */
+        using LocationOwner = std::size_t;
+
+        /** Block location: blocks owner and linear block index */
+        using Location = std::pair<LocationOwner, std::size_t>;
+
+        /** Single piece of work to schedule */
+        struct Work {
+            /** Estimated amount of work, for instance nnz of the inputs */
+            std::size_t amount = 0;
+            /** Locations of the input blocks */
+            std::vector<Location> inputs;
+            /** Location of the produced block, if any */
+            std::optional<Location> output;
+        };
+
+        /**
+         * @class Ticket
+         * @brief Scheduled work on the device.
+         *
+         * Amount of work is accounted as device in-flight work until ticket is released.
+         * Ticket is released explicitly, when work is done, or on destruction.
+         */
+        class Ticket {
+        public:
+            ~Ticket();
+
+            /** Release work from the device load; safe to call several times */
+            void Release();
+
+            /** @return Device to process the work */
+            [[nodiscard]] DeviceId GetDeviceId() const noexcept;
+
+        private:
+            friend class DeviceManager;
+            Ticket(DeviceManager &manager, DeviceId id, std::size_t amount);
+
+            DeviceManager &mManager;
+            DeviceId mDeviceId;
+            std::size_t mAmount;
+            std::atomic_bool mReleased{false};
+        };
+
         /**
          * Fetch device id for execution for specified expression node.
          * @note Uses node descriptor and expression settings to select device.
@@ -72,6 +125,38 @@ namespace spla {
          */
         std::vector<DeviceId> FetchDevices(std::size_t required, const RefPtr<ExpressionNode> &node);
 
+        /**
+         * Schedule pieces of work for execution for specified expression node.
+         * Heavier pieces are assigned first, each to the device with the least
+         * in-flight work, with penalty for the inputs produced on other devices.
+         * @note Uses node descriptor to force specified device.
+         *
+         * @param work Pieces of work to schedule.
+         * @param node Expression node to process by device.
+         * @return Tickets of scheduled work (vector size matches provided work size).
+         */
+        std::vector<std::shared_ptr<Ticket>> Schedule(const std::vector<Work> &work, const RefPtr<ExpressionNode> &node);
+
+        /**
+         * Make new blocks owner id for locations of its blocks.
+         * @return Owner id, unique for the lifetime of the library.
+         */
+        LocationOwner NewLocationOwner();
+
+        /**
+         * Forget devices, where blocks of the owner were produced.
+         * Used for temporary results of the node, once work consuming them is scheduled.
+         * @param owner Blocks owner id.
+         */
+        void ForgetLocations(LocationOwner owner);
+
+        /**
+         * Get in-flight work of the device.
+         * @param id Device id.
+         * @return Amount of scheduled, but not yet released work.
+         */
+        std::size_t GetLoad(DeviceId id) const;
+
         /**
          * Get boost device by device id.
          * @param id Device id returned by one of the `Fetch` functions.
@@ -88,10 +173,15 @@ namespace spla {
     private:
         friend class LibraryPrivate;
         explicit DeviceManager(std::vector<Device> devices);
-        DeviceId NextDevice();
+        DeviceId NextDevice(std::size_t amount, const std::vector<Location> &inputs);
+        void Release(DeviceId id, std::size_t amount);
+        void EraseLocations(LocationOwner owner);
 
         std::vector<Device> mDevices;
+        std::vector<std::size_t> mLoad;
+        std::map<Location, DeviceId> mProducers;
         std::size_t mNextDevice = 0;
+        LocationOwner mNextLocationOwner = 0;
 
         mutable std::mutex mMutex;
     };
@@ -0,0 +1,116 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAHOSTMAPPED_HPP
+#define SPLA_SPLAHOSTMAPPED_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <cstring>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class HostMapped
+     * @brief Host view of device vector data
+     *
+     * Maps device buffer of the vector into host memory for the scope of this object
+     * and unmaps it, when the flow leaves the scope. Used by host evaluation path of tiny
+     * operations, where single map is cheaper than chain of kernels launches.
+     *
+     * @note Map is blocking, so data is available right after construction.
+     * @note Empty vectors are not mapped at all.
+     *
+     * @tparam T Type of vector elements
+     */
+    template<typename T>
+    class HostMapped {
+    public:
+        HostMapped(const boost::compute::vector<T> &vector,
+                   boost::compute::command_queue &queue,
+                   cl_map_flags flags = boost::compute::command_queue::map_read)
+            : mBuffer(vector.get_buffer()), mQueue(queue), mSize(vector.size()) {
+            if (mSize > 0)
+                mData = static_cast<T *>(mQueue.enqueue_map_buffer(mBuffer, flags, 0, mSize * sizeof(T)));
+        }
+
+        HostMapped(const HostMapped &) = delete;
+        HostMapped(HostMapped &&) = delete;
+        HostMapped &operator=(const HostMapped &) = delete;
+        HostMapped &operator=(HostMapped &&) = delete;
+
+        ~HostMapped() {
+            if (mData)
+                mQueue.enqueue_unmap_buffer(mBuffer, mData);
+        }
+
+        [[nodiscard]] T *Data() const noexcept { return mData; }
+        [[nodiscard]] std::size_t Size() const noexcept { return mSize; }
+        [[nodiscard]] T *begin() const noexcept { return mData; }
+        [[nodiscard]] T *end() const noexcept { return mData + mSize; }
+        T &operator[](std::size_t i) const noexcept { return mData[i]; }
+
+    private:
+        boost::compute::buffer mBuffer;
+        boost::compute::command_queue &mQueue;
+        std::size_t mSize;
+        T *mData = nullptr;
+    };
+
+    /**
+     * @brief Upload host data into new device vector through mapped buffer.
+     *
+     * @param data Host data to upload
+     * @param queue Command queue to perform operation
+     *
+     * @return Device vector with data copy
+     */
+    template<typename T>
+    inline boost::compute::vector<T> UploadMapped(const std::vector<T> &data,
+                                                  boost::compute::command_queue &queue) {
+        boost::compute::vector<T> result(data.size(), queue.get_context());
+        HostMapped<T> mapped(result, queue, boost::compute::command_queue::map_write);
+
+        if (!data.empty())
+            std::memcpy(mapped.Data(), data.data(), data.size() * sizeof(T));
+
+        return result;
+    }
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAHOSTMAPPED_HPP
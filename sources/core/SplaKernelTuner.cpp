@@ -0,0 +1,166 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaError.hpp>
+#include <core/SplaKernelTuner.hpp>
+#include <boost/compute/platform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+spla::KernelTuner &spla::KernelTuner::Instance() {
+    static KernelTuner tuner;
+    return tuner;
+}
+
+void spla::KernelTuner::Attach(bool enable, const std::optional<Filename> &filename) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (filename.has_value()) {
+        CHECK_RAISE_ERROR(mFilenameLibraries == 0 || filename == mFilename, InvalidArgument,
+                          "Kernel tuning file conflicts with the file used by other library");
+
+        if (mFilenameLibraries++ == 0) {
+            mFilename = filename;
+            Load();
+        }
+    }
+
+    if (enable)
+        mEnabledLibraries += 1;
+}
+
+void spla::KernelTuner::Detach(bool enable, const std::optional<Filename> &filename) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (filename.has_value() && --mFilenameLibraries == 0)
+        mFilename.reset();
+
+    if (enable)
+        mEnabledLibraries -= 1;
+}
+
+std::string spla::KernelTuner::GetDeviceKey(const boost::compute::device &device) {
+    // Tuned values depend on the driver, so the same device may be tuned anew
+    return device.name() + '|' + device.driver_version() + '|' + device.platform().name();
+}
+
+std::size_t spla::KernelTuner::Select(const boost::compute::device &device,
+                                      const std::string &parameter,
+                                      const std::vector<std::size_t> &candidates,
+                                      std::size_t defaultValue,
+                                      std::size_t work,
+                                      const std::function<void(std::size_t)> &run) {
+    auto key = std::make_pair(GetDeviceKey(device), parameter);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Stored value may come from stale or malformed tuning file, so it is used only if it is a candidate
+        auto &values = mValues[key.first];
+        auto found = values.find(parameter);
+        if (found != values.end()) {
+            if (std::find(candidates.begin(), candidates.end(), found->second) != candidates.end())
+                return found->second;
+
+            values.erase(found);
+        }
+
+        // Other launches use default value, while the parameter is being tuned
+        if (mEnabledLibraries == 0 || work < MIN_TUNING_WORK || candidates.size() < 2 || !mInProgress.insert(key).second)
+            return defaultValue;
+    }
+
+    auto best = Benchmark(candidates, run);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mValues[key.first][parameter] = best;
+    mInProgress.erase(key);
+    Store();
+
+    return best;
+}
+
+std::size_t spla::KernelTuner::Benchmark(const std::vector<std::size_t> &candidates,
+                                         const std::function<void(std::size_t)> &run) const {
+    using Clock = std::chrono::steady_clock;
+
+    auto best = candidates.front();
+    auto bestTime = std::numeric_limits<double>::max();
+
+    for (auto candidate : candidates) {
+        // First run compiles the program, if candidate is a part of its source
+        run(candidate);
+
+        auto begin = Clock::now();
+        run(candidate);
+        auto time = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        if (time < bestTime) {
+            best = candidate;
+            bestTime = time;
+        }
+    }
+
+    return best;
+}
+
+void spla::KernelTuner::Load() {
+    std::ifstream file(mFilename.value());
+    std::string line;
+
+    // Each line is tab-separated: device key, parameter, value
+    while (std::getline(file, line)) {
+        auto first = line.find('\t');
+        if (first == std::string::npos)
+            continue;
+
+        auto second = line.find('\t', first + 1);
+        if (second == std::string::npos)
+            continue;
+
+        std::size_t value = 0;
+        std::istringstream stream(line.substr(second + 1));
+        if (!(stream >> value))
+            continue;
+
+        mValues[line.substr(0, first)][line.substr(first + 1, second - first - 1)] = value;
+    }
+}
+
+void spla::KernelTuner::Store() const {
+    if (!mFilename.has_value())
+        return;
+
+    std::ofstream file(mFilename.value());
+
+    for (const auto &device : mValues)
+        for (const auto &parameter : device.second)
+            file << device.first << '\t' << parameter.first << '\t' << parameter.second << '\n';
+}
@@ -0,0 +1,139 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAKERNELTUNER_HPP
+#define SPLA_SPLAKERNELTUNER_HPP
+
+#include <boost/compute/device.hpp>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <spla-cpp/SplaConfig.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class KernelTuner
+     * @brief Process-wide store of tuned kernels launch parameters.
+     *
+     * Compute primitives know only the command queue they are launched on,
+     * so tuned parameters (work-group sizes, tile sizes) are kept per device
+     * (name, driver version and platform) in a single store shared by all libraries
+     * of the process. Each library attaches to the store on creation and detaches
+     * on destruction: benchmarking is enabled while at least one attached library
+     * enables it, and all attached libraries must use the same tuning file.
+     *
+     * If benchmarking is enabled, the first launch processing at least
+     * `MIN_TUNING_WORK` items runs every candidate value, and the fastest one
+     * is stored and used for all subsequent launches on the same device.
+     */
+    class KernelTuner {
+    public:
+        /** Minimal number of processed items of a launch to benchmark candidates on */
+        static constexpr std::size_t MIN_TUNING_WORK = 1u << 16;
+
+        /** @return Process-wide tuner */
+        static KernelTuner &Instance();
+
+        /**
+         * Attaches library to the tuner.
+         *
+         * @param enable True to benchmark candidates of not yet tuned parameters
+         * @param filename Optional file to load tuned parameters from and to store them to
+         *
+         * @throw InvalidArgument If filename differs from the one of other attached library
+         */
+        void Attach(bool enable, const std::optional<Filename> &filename);
+
+        /**
+         * Detaches library from the tuner.
+         * Arguments must match ones the library was attached with.
+         *
+         * @param enable True if library enabled benchmarking
+         * @param filename Optional tuning file of the library
+         */
+        void Detach(bool enable, const std::optional<Filename> &filename);
+
+        /**
+         * @param device Device to get key for
+         * @return Key of tuned parameters of the device
+         */
+        static std::string GetDeviceKey(const boost::compute::device &device);
+
+        /**
+         * Selects value of the parameter for the device.
+         *
+         * @param device Device to launch kernel on
+         * @param parameter Unique name of the kernel parameter
+         * @param candidates Candidate values to benchmark
+         * @param defaultValue Value to use if parameter is not tuned
+         * @param work Number of items processed by the launch
+         * @param run Launches the kernel with candidate value and waits for completion;
+         *            must not modify the kernel inputs, since it is called several times
+         *
+         * @return Tuned value, if it is one of candidates, or default value
+         */
+        std::size_t Select(const boost::compute::device &device,
+                           const std::string &parameter,
+                           const std::vector<std::size_t> &candidates,
+                           std::size_t defaultValue,
+                           std::size_t work,
+                           const std::function<void(std::size_t)> &run);
+
+    private:
+        KernelTuner() = default;
+
+        std::size_t Benchmark(const std::vector<std::size_t> &candidates,
+                              const std::function<void(std::size_t)> &run) const;
+        void Load();
+        void Store() const;
+
+        mutable std::mutex mMutex;
+        std::size_t mEnabledLibraries = 0;
+        std::size_t mFilenameLibraries = 0;
+        std::optional<Filename> mFilename;
+        std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>> mValues;
+        std::set<std::pair<std::string, std::string>> mInProgress;
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAKERNELTUNER_HPP
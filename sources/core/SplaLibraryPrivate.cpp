@@ -25,8 +25,11 @@
 /* SOFTWARE.                                                                      */
 /**********************************************************************************/
 
+#include <algorithm>
 #include <core/SplaError.hpp>
+#include <core/SplaKernelTuner.hpp>
 #include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaMath.hpp>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
@@ -82,7 +85,8 @@ namespace {
 spla::LibraryPrivate::LibraryPrivate(
         spla::Library &library,
         spla::Library::Config config)
-    : mDeviceManager(FindAllDevices(config.GetDevicesNames())),
+    : mTracer(config.GetTraceFilename()),
+      mDeviceManager(FindAllDevices(config.GetDevicesNames())),
       mPlatform(GetDevicesPlatform(mDeviceManager.GetDevices())),
       mContext(mDeviceManager.GetDevices()),
       mContextConfig(std::move(config)) {
@@ -90,6 +94,11 @@ spla::LibraryPrivate::LibraryPrivate(
     mDefaultDesc = Descriptor::Make(library);
     mExprManager = RefPtr<ExpressionManager>(new ExpressionManager(library));
     mAlgoManager = RefPtr<AlgorithmManager>(new AlgorithmManager(library));
+    KernelTuner::Instance().Attach(mContextConfig.GetKernelTuning(), mContextConfig.GetKernelTuningFilename());
+}
+
+spla::LibraryPrivate::~LibraryPrivate() {
+    KernelTuner::Instance().Detach(mContextConfig.GetKernelTuning(), mContextConfig.GetKernelTuningFilename());
 }
 
 tf::Executor &spla::LibraryPrivate::GetTaskFlowExecutor() noexcept {
@@ -136,6 +145,29 @@ std::unordered_map<std::string, spla::RefPtr<spla::Type>> &spla::LibraryPrivate:
     return mTypeCache;
 }
 
-std::size_t spla::LibraryPrivate::GetBlockSize() const noexcept {
-    return mContextConfig.GetBlockSize();
-}
\ No newline at end of file
+std::size_t spla::LibraryPrivate::GetBlockSize(std::size_t dim, std::size_t nvals) const noexcept {
+    std::size_t minBlockSize = Library::Config::MIN_ADAPTIVE_BLOCK_SIZE;
+    std::size_t maxBlockSize = mContextConfig.GetBlockSize();
+
+    if (!mContextConfig.IsBlockSizeAdaptive())
+        return maxBlockSize;
+
+    // Two blocks per device along each dimension give enough independent
+    // tasks to keep all devices busy, while blocks are still large enough
+    auto blocksCount = 2 * std::max<std::size_t>(mDeviceManager.GetDevices().size(), 1);
+
+    // Sparse objects are split into fewer blocks, so each row of blocks has enough values for a task
+    if (nvals > 0)
+        blocksCount = std::min(blocksCount, std::max<std::size_t>(nvals / Library::Config::MIN_ADAPTIVE_BLOCK_NVALS, 1));
+
+    auto blockSize = math::GetBlocksCount(dim, blocksCount);
+
+    blockSize = std::max(blockSize, minBlockSize);
+    blockSize = std::min(blockSize, maxBlockSize);
+
+    return blockSize;
+}
+
+spla::Tracer &spla::LibraryPrivate::GetTracer() noexcept {
+    return mTracer;
+}
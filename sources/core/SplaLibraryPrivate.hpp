@@ -32,6 +32,7 @@
 #include <boost/compute/device.hpp>
 #include <boost/compute/system.hpp>
 #include <core/SplaDeviceManager.hpp>
+#include <core/SplaTracer.hpp>
 #include <expression/SplaExpressionManager.hpp>
 #include <spdlog/spdlog.h>
 #include <spla-cpp/SplaDescriptor.hpp>
@@ -57,6 +58,7 @@ namespace spla {
     class LibraryPrivate {
     public:
         explicit LibraryPrivate(Library &library, Library::Config config);
+        ~LibraryPrivate();
 
         tf::Executor &GetTaskFlowExecutor() noexcept;
 
@@ -81,9 +83,22 @@ namespace spla {
 
         std::unordered_map<std::string, RefPtr<Type>> &GetTypeCache() noexcept;
 
-        std::size_t GetBlockSize() const noexcept;
+        /**
+         * Block size to split dimension of new matrix or vector.
+         * Without expected number of values depends only on the dimension,
+         * so objects of the same dimension share blocks grid.
+         *
+         * @param dim Dimension to split (number of rows or columns)
+         * @param nvals Expected number of values of the object; zero if unknown
+         * @return Fixed config block size or block size adapted to dimension, values and devices count
+         */
+        std::size_t GetBlockSize(std::size_t dim, std::size_t nvals = 0) const noexcept;
+
+        Tracer &GetTracer() noexcept;
 
     private:
+        // NOTE: tracer must outlive executor, since tasks are traced
+        Tracer mTracer;
         tf::Executor mExecutor;
         RefPtr<Descriptor> mDefaultDesc;
         RefPtr<ExpressionManager> mExprManager;
@@ -48,6 +48,23 @@ namespace spla::math {
             return size < blockSize ? size : blockSize;
         }
 
+        /**
+         * Number of parts to split blocks product work into, so each part does not exceed threshold.
+         *
+         * @param work Estimated work of the product
+         * @param threshold Max work of a single part; zero disables splitting
+         * @param maxParts Max number of parts (at least 1)
+         *
+         * @return Number of parts in range [1, maxParts]
+         */
+        inline std::size_t GetSplitsCount(std::size_t work, std::size_t threshold, std::size_t maxParts) {
+            if (!threshold || work <= threshold || maxParts <= 1)
+                return 1;
+
+            auto parts = GetBlocksCount(work, threshold);
+            return parts < maxParts ? parts : maxParts;
+        }
+
         /**
          * @}
          */
@@ -28,14 +28,23 @@
 #include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <core/SplaTaskBuilder.hpp>
+#include <expression/SplaExpressionTasks.hpp>
 #include <spdlog/spdlog.h>
 
 tf::Task spla::TaskBuilder::Emplace(std::function<void()> work) {
-    auto task = [expression = mExpression, work = std::move(work)]() {
+    return Emplace(std::string(), std::move(work));
+}
+
+tf::Task spla::TaskBuilder::Emplace(const std::string &name, std::function<void()> work) {
+    auto taskName = name.empty() ? mNodeName : mNodeName + " " + name;
+    auto task = [expression = mExpression, taskName, work = std::move(work)]() {
         // If some error occurred earlier, no sense to continue
         if (expression->GetState() == Expression::State::Aborted)
             return;
 
+        auto &tracer = expression->GetLibrary().GetPrivate().GetTracer();
+        Tracer::Scope scope(tracer, taskName, "task", Tracer::Track::Thread);
+
         try {
             work();
         } catch (std::exception &ex) {
@@ -45,9 +54,41 @@ tf::Task spla::TaskBuilder::Emplace(std::function<void()> work) {
         }
     };
 
-    return mSubflow.emplace(std::move(task));
+    return mSubflow.emplace(std::move(task)).name(taskName);
+}
+
+tf::Task spla::TaskBuilder::EmplaceCondition(const std::string &name, std::function<bool()> predicate) {
+    auto taskName = mNodeName + " " + name;
+    auto task = [expression = mExpression, taskName, predicate = std::move(predicate)]() -> int {
+        // Leave the loop or skip branch, nothing to evaluate
+        if (expression->GetState() == Expression::State::Aborted)
+            return 1;
+
+        auto &tracer = expression->GetLibrary().GetPrivate().GetTracer();
+        Tracer::Scope scope(tracer, taskName, "task", Tracer::Track::Thread);
+
+        try {
+            return predicate() ? 0 : 1;
+        } catch (std::exception &ex) {
+            expression->SetState(Expression::State::Aborted);
+            auto logger = expression->GetLibrary().GetPrivate().GetLogger();
+            SPDLOG_LOGGER_ERROR(logger, "Error inside expression node condition. {}", ex.what());
+            return 1;
+        }
+    };
+
+    return mSubflow.emplace(std::move(task)).name(taskName);
+}
+
+tf::Task spla::TaskBuilder::EmplaceModule(const std::string &name, spla::Expression &expression) {
+    CHECK_RAISE_ERROR(expression.IsCompiled(), InvalidState, "Module expression must be compiled");
+    CHECK_RAISE_ERROR(expression.mTasks, InvalidState, "Module expression must have composed tasks");
+
+    return mSubflow.composed_of(expression.mTasks->taskflow).name(mNodeName + " " + name);
 }
 
-spla::TaskBuilder::TaskBuilder(spla::Expression *expression, tf::Subflow &subflow)
-    : mExpression(expression), mSubflow(subflow) {
+spla::TaskBuilder::TaskBuilder(spla::Expression *expression, std::size_t nodeIdx, tf::Subflow &subflow)
+    : mExpression(expression),
+      mNodeName(ExpressionNodeOpToStr(expression->GetNodes()[nodeIdx]->GetNodeOp())),
+      mSubflow(subflow) {
 }
\ No newline at end of file
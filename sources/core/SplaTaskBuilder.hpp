@@ -33,6 +33,7 @@
 #include <taskflow/taskflow.hpp>
 
 #include <functional>
+#include <string>
 
 namespace spla {
 
@@ -59,11 +60,43 @@ namespace spla {
          */
         tf::Task Emplace(std::function<void()> work);
 
+        /**
+         * Emplace named work to the subflow.
+         * Name is used for the task in the trace and taskflow dump.
+         *
+         * @param name Name of the work (for instance, processed block index).
+         * @param work Function to execute as work inside task.
+         * @return Taskflow task handle.
+         */
+        tf::Task Emplace(const std::string &name, std::function<void()> work);
+
+        /**
+         * Emplace named condition task to the subflow.
+         * Task must precede exactly two tasks: first one is taken if predicate holds,
+         * second one is taken otherwise, if error occurred or computation is aborted.
+         *
+         * @param name Name of the condition.
+         * @param predicate Function to evaluate condition.
+         * @return Taskflow task handle.
+         */
+        tf::Task EmplaceCondition(const std::string &name, std::function<bool()> predicate);
+
+        /**
+         * Emplace evaluation of compiled expression as module task to the subflow.
+         * Module task may be evaluated several times, if it is a part of the loop.
+         *
+         * @param name Name of the module.
+         * @param expression Compiled non-empty expression to evaluate.
+         * @return Taskflow task handle.
+         */
+        tf::Task EmplaceModule(const std::string &name, Expression &expression);
+
     private:
         friend class ExpressionManager;
-        TaskBuilder(Expression *expression, tf::Subflow &subflow);
+        TaskBuilder(Expression *expression, std::size_t nodeIdx, tf::Subflow &subflow);
 
         Expression *mExpression;
+        std::string mNodeName;
         tf::Subflow &mSubflow;
     };
 
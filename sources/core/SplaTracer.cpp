@@ -0,0 +1,189 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaTracer.hpp>
+#include <fstream>
+
+namespace {
+    constexpr std::size_t HOST_PID = 1;
+    constexpr std::size_t DEVICES_PID = 2;
+
+    void WriteEscaped(std::ostream &stream, const std::string &string) {
+        for (char c : string) {
+            switch (c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+                case '\\':
+                    stream << "\\\\";
+                    break;
+                case '\n':
+                    stream << "\\n";
+                    break;
+                default:
+                    stream << c;
+            }
+        }
+    }
+
+    void WriteName(std::ostream &stream, const char *kind, std::size_t pid, std::size_t tid, const std::string &name) {
+        stream << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+               << ",\"args\":{\"name\":\"";
+        WriteEscaped(stream, name);
+        stream << "\"}}";
+    }
+}// namespace
+
+spla::Tracer::Scope::Scope(spla::Tracer &tracer, std::string name, const char *category, Track track, std::size_t trackId)
+    : mTracer(tracer), mName(std::move(name)), mCategory(category), mTrack(track), mTrackId(trackId) {
+    if (mTracer.IsEnabled())
+        mBegin = Clock::now();
+}
+
+spla::Tracer::Scope::~Scope() {
+    if (mTracer.IsEnabled())
+        mTracer.AddSpan(std::move(mName), mCategory, mTrack, mTrackId, mBegin, Clock::now());
+}
+
+spla::Tracer::Tracer(std::optional<Filename> filename)
+    : mFilename(std::move(filename)), mStart(Clock::now()) {
+}
+
+spla::Tracer::~Tracer() {
+    Flush();
+}
+
+bool spla::Tracer::IsEnabled() const noexcept {
+    return mFilename.has_value();
+}
+
+void spla::Tracer::AddSpan(std::string name, const char *category, Track track, std::size_t trackId, TimePoint begin, TimePoint end) {
+    if (!IsEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    Event event;
+    event.name = std::move(name);
+    event.category = category;
+    event.phase = 'X';
+    event.ts = ToMicroseconds(begin);
+    event.dur = ToMicroseconds(end) - event.ts;
+    event.value = 0;
+
+    if (track == Track::Thread) {
+        event.pid = HOST_PID;
+        event.tid = GetThreadTrackId();
+    } else {
+        event.pid = DEVICES_PID;
+        event.tid = trackId;
+        mDevices.insert(trackId);
+    }
+
+    mEvents.push_back(std::move(event));
+}
+
+void spla::Tracer::AddCounter(const char *name, std::int64_t delta) {
+    if (!IsEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &counter = mCounters[name];
+    counter += delta;
+
+    Event event;
+    event.name = name;
+    event.category = "memory";
+    event.phase = 'C';
+    event.pid = HOST_PID;
+    event.tid = 0;
+    event.ts = ToMicroseconds(Clock::now());
+    event.dur = 0;
+    event.value = counter;
+
+    mEvents.push_back(std::move(event));
+}
+
+void spla::Tracer::Flush() {
+    if (!IsEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::ofstream file(mFilename.value());
+
+    if (!file.is_open())
+        return;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    WriteName(file, "process_name", HOST_PID, 0, "Host");
+    file << ",\n";
+    WriteName(file, "process_name", DEVICES_PID, 0, "Devices");
+
+    for (auto &thread : mThreads) {
+        file << ",\n";
+        WriteName(file, "thread_name", HOST_PID, thread.second, "Worker " + std::to_string(thread.second));
+    }
+
+    for (auto device : mDevices) {
+        file << ",\n";
+        WriteName(file, "thread_name", DEVICES_PID, device, "Device " + std::to_string(device));
+    }
+
+    for (auto &event : mEvents) {
+        file << ",\n{\"name\":\"";
+        WriteEscaped(file, event.name);
+        file << "\",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase
+             << "\",\"pid\":" << event.pid << ",\"tid\":" << event.tid << ",\"ts\":" << event.ts;
+
+        if (event.phase == 'X')
+            file << ",\"dur\":" << event.dur;
+        if (event.phase == 'C')
+            file << ",\"args\":{\"bytes\":" << event.value << "}";
+
+        file << "}";
+    }
+
+    file << "\n]}\n";
+}
+
+std::size_t spla::Tracer::GetThreadTrackId() {
+    auto id = std::this_thread::get_id();
+    auto found = mThreads.find(id);
+
+    if (found != mThreads.end())
+        return found->second;
+
+    // Thread ids start from 1, since 0 is used by counters
+    auto trackId = mThreads.size() + 1;
+    mThreads.emplace(id, trackId);
+    return trackId;
+}
+
+std::int64_t spla::Tracer::ToMicroseconds(TimePoint time) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - mStart).count();
+}
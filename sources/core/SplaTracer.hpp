@@ -0,0 +1,158 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLATRACER_HPP
+#define SPLA_SPLATRACER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <spla-cpp/SplaConfig.hpp>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class Tracer
+     * @brief Collects execution trace in Chrome trace-event format.
+     *
+     * Records spans of the taskflow tasks per worker thread, spans
+     * of the algorithms execution per device queue and counters of the
+     * memory, stored in matrix and vector blocks. Collected trace is written
+     * to the file on tracer destruction, so it can be opened in
+     * `chrome://tracing` or `ui.perfetto.dev`.
+     *
+     * If no file name provided, tracer is disabled and all calls are no-op.
+     *
+     * @note Thread-safe
+     */
+    class Tracer {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+        /** Track of the spans: either host worker thread or device queue */
+        enum class Track {
+            Thread,
+            Device
+        };
+
+        /**
+         * @class Scope
+         * @brief Span, which lasts until the end of the scope.
+         */
+        class Scope {
+        public:
+            Scope(Tracer &tracer, std::string name, const char *category, Track track, std::size_t trackId = 0);
+            Scope(const Scope &) = delete;
+            Scope(Scope &&) = delete;
+            Scope &operator=(const Scope &) = delete;
+            Scope &operator=(Scope &&) = delete;
+            ~Scope();
+
+        private:
+            Tracer &mTracer;
+            std::string mName;
+            const char *mCategory;
+            Track mTrack;
+            std::size_t mTrackId;
+            TimePoint mBegin;
+        };
+
+        explicit Tracer(std::optional<Filename> filename);
+        Tracer(const Tracer &) = delete;
+        Tracer(Tracer &&) = delete;
+        ~Tracer();
+
+        /** @return True if trace is collected */
+        [[nodiscard]] bool IsEnabled() const noexcept;
+
+        /**
+         * Add complete span event.
+         *
+         * @param name Name of the span
+         * @param category Category of the span (task, algo, etc.)
+         * @param track Track where to show span
+         * @param trackId Device id for device track; ignored for thread track (current thread is used)
+         * @param begin Time when span started
+         * @param end Time when span finished
+         */
+        void AddSpan(std::string name, const char *category, Track track, std::size_t trackId, TimePoint begin, TimePoint end);
+
+        /**
+         * Change counter value by delta and record new value.
+         *
+         * @param name Counter name
+         * @param delta Signed value change
+         */
+        void AddCounter(const char *name, std::int64_t delta);
+
+        /** Write collected events to the trace file */
+        void Flush();
+
+    private:
+        struct Event {
+            std::string name;
+            const char *category;
+            char phase;
+            std::size_t pid;
+            std::size_t tid;
+            std::int64_t ts;
+            std::int64_t dur;
+            std::int64_t value;
+        };
+
+        std::size_t GetThreadTrackId();
+        std::int64_t ToMicroseconds(TimePoint time) const;
+
+        std::optional<Filename> mFilename;
+        TimePoint mStart;
+        std::vector<Event> mEvents;
+        std::unordered_map<std::thread::id, std::size_t> mThreads;
+        std::unordered_map<std::string, std::int64_t> mCounters;
+        std::set<std::size_t> mDevices;
+        mutable std::mutex mMutex;
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLATRACER_HPP
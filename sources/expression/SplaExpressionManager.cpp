@@ -28,14 +28,20 @@
 #include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <expression/SplaExpressionFuture.hpp>
+#include <expression/SplaExpressionOptimizer.hpp>
 #include <expression/SplaExpressionTasks.hpp>
+#include <expression/control/SplaExpressionCondition.hpp>
+#include <expression/control/SplaExpressionLoop.hpp>
 
 #include <expression/matrix/SplaMatrixDataRead.hpp>
 #include <expression/matrix/SplaMatrixDataWrite.hpp>
 #include <expression/matrix/SplaMatrixEWiseAdd.hpp>
+#include <expression/matrix/SplaMatrixInsert.hpp>
+#include <expression/matrix/SplaMatrixRemove.hpp>
 #include <expression/matrix/SplaMatrixTranspose.hpp>
 #include <expression/prod/SplaMxM.hpp>
 #include <expression/prod/SplaVxM.hpp>
+#include <expression/prod/SplaVxMAssign.hpp>
 #include <expression/scalar/SplaScalarDataRead.hpp>
 #include <expression/scalar/SplaScalarDataWrite.hpp>
 #include <expression/vector/SplaVectorAssign.hpp>
@@ -54,6 +60,8 @@ spla::ExpressionManager::ExpressionManager(spla::Library &library) : mLibrary(li
     Register(new MatrixDataWrite());
     Register(new MatrixEWiseAdd());
     Register(new MatrixTranspose());
+    Register(new MatrixInsert());
+    Register(new MatrixRemove());
     Register(new ScalarDataRead());
     Register(new ScalarDataWrite());
     Register(new VectorAssign());
@@ -63,10 +71,29 @@ spla::ExpressionManager::ExpressionManager(spla::Library &library) : mLibrary(li
     Register(new VectorReduce());
     Register(new MxM());
     Register(new VxM());
+    Register(new ExpressionLoop());
+    Register(new ExpressionCondition());
+
+    // Fused processors for pairs of nodes, found by expression optimizer
+    RegisterFused(new VxMAssign());
 }
 
 void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expression) {
     CHECK_RAISE_ERROR(expression.IsNotNull(), InvalidArgument, "Passed null expression");
+
+    // Compiled expression reuses its tasks graph, composed once
+    if (expression->IsCompiled()) {
+        CHECK_RAISE_ERROR(expression->GetState() != Expression::State::Submitted, InvalidArgument,
+                          "Passed compiled expression=" << expression->GetLabel() << " must be evaluated before next submission");
+
+        // NOTE: tasks are dropped if data bind invalidates optimizer plan
+        if (!expression->Empty() && !expression->mTasks)
+            Compose(expression);
+
+        Run(expression);
+        return;
+    }
+
     CHECK_RAISE_ERROR(expression->GetState() == Expression::State::Default, InvalidArgument,
                       "Passed expression=" << expression->GetLabel() << " must be in `Default` state before evaluation");
 
@@ -79,6 +106,43 @@ void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expre
         return;
     }
 
+    Compose(expression);
+    Run(expression);
+}
+
+void spla::ExpressionManager::Compile(const spla::RefPtr<spla::Expression> &expression) {
+    CHECK_RAISE_ERROR(expression.IsNotNull(), InvalidArgument, "Passed null expression");
+    CHECK_RAISE_ERROR(expression->GetState() == Expression::State::Default, InvalidArgument,
+                      "Passed expression=" << expression->GetLabel() << " must be in `Default` state before compilation");
+
+    if (!expression->Empty())
+        Compose(expression);
+
+    expression->mCompiled = true;
+    expression->SetState(Expression::State::Compiled);
+}
+
+void spla::ExpressionManager::Run(const spla::RefPtr<spla::Expression> &expression) {
+    // Previous run of the same taskflow must be finished
+    // NOTE: notification sets state before taskflow is actually finished
+    if (expression->mFuture)
+        expression->mFuture->Get().wait();
+
+    expression->SetState(Expression::State::Submitted);
+
+    // NOTE: Special case, expression without nodes
+    if (expression->Empty()) {
+        expression->SetState(Expression::State::Evaluated);
+        return;
+    }
+
+    auto &executor = mLibrary.GetPrivate().GetTaskFlowExecutor();
+    auto expressionFuture = std::make_unique<ExpressionFuture>(executor.run(expression->mTasks->taskflow));
+
+    expression->SetFuture(std::move(expressionFuture));
+}
+
+void spla::ExpressionManager::Compose(const spla::RefPtr<spla::Expression> &expression) {
     TraversalInfo context;
     context.expression = expression;
 
@@ -95,43 +159,85 @@ void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expre
     CheckCycles(context);
 
     auto &nodes = expression->GetNodes();
+
+    // Bodies of control flow nodes are evaluated as modules of compiled expressions
+    for (auto &node : nodes) {
+        auto op = node->GetNodeOp();
+        if (op == ExpressionNode::Operation::Loop || op == ExpressionNode::Operation::Condition) {
+            auto body = node->GetArg(0).Cast<Expression>();
+            if (!body->IsCompiled())
+                Compile(body);
+        }
+    }
+
     auto expressionTasks = std::make_unique<ExpressionTasks>();
     auto &taskflow = expressionTasks->taskflow;
+    auto &plan = expressionTasks->plan;
+
+    // Rewrite expression graph before composition, by default each node processed as is
+    plan = ExpressionPlan(nodes.size());
+    expressionTasks->aliasedArgs.resize(nodes.size());
+    if (mLibrary.GetPrivate().GetContextConfig().GetExpressionOptimization())
+        ExpressionOptimizer(*this).Optimize(*expression, plan);
 
     std::vector<tf::Task> modules;
     modules.reserve(nodes.size());
 
     for (std::size_t idx = 0; idx < nodes.size(); idx++) {
+        auto step = plan.steps[idx];
+
+        // Skipped node keeps its dependencies, but composes nothing
+        if (step.action == ExpressionPlan::Action::Skip) {
+            modules.push_back(taskflow.emplace([]() {}).name(std::string("Skip ") + ExpressionNodeOpToStr(nodes[idx]->GetNodeOp())));
+            continue;
+        }
+
         // Select processor for node
-        auto processor = SelectProcessor(idx, *expression);
+        RefPtr<NodeProcessor> processor;
+        RefPtr<FusedNodeProcessor> fusedProcessor;
+
+        if (step.action == ExpressionPlan::Action::Process)
+            processor = SelectProcessor(idx, *expression);
+        if (step.action == ExpressionPlan::Action::Fuse)
+            fusedProcessor = FindFusedProcessor(idx, step.source, *expression);
+
         // Wrap processor into task to handle dynamic changes of expression nodes params
-        auto task = [idx, expression = expression.Get(), processor = processor.Get()](tf::Subflow &subflow) {
+        auto task = [idx, step, expression = expression.Get(), tasks = expressionTasks.get(), processor = processor.Get(), fusedProcessor = fusedProcessor.Get()](tf::Subflow &subflow) {
             // If aborted in previous tasks, candle run
             if (expression->GetState() == Expression::State::Aborted)
                 return;
 
-            // Check, if out arg appears in the input list
-            auto &args = expression->GetNodes()[idx]->GetArgs();
-            if (!args.empty()) {
-                auto out = args[0];
-                auto query = std::find(args.begin() + 1, args.end(), out);
-                // If appears, must create a proxy
-                // And replace all `in` entries with read-only proxy
-                if (query != args.end()) {
-                    auto proxy = out->Clone();
-                    std::for_each(args.begin() + 1, args.end(), [&](RefPtr<Object> &arg) {
-                        if (arg == out)
-                            arg = proxy;
-                    });
-                }
-            }
+            ProxyAliasedArgs(*expression->GetNodes()[idx], tasks->aliasedArgs[idx]);
+            if (step.action == ExpressionPlan::Action::Fuse)
+                ProxyAliasedArgs(*expression->GetNodes()[step.source], tasks->aliasedArgs[step.source]);
+
+            // Trace time spent on the node tasks composition
+            auto &tracer = expression->GetLibrary().GetPrivate().GetTracer();
+            Tracer::Scope scope(tracer, ExpressionNodeOpToStr(expression->GetNodes()[idx]->GetNodeOp()), "node", Tracer::Track::Thread);
 
             // Task build wraps error handling and abortion
-            TaskBuilder taskBuilder(expression, subflow);
+            TaskBuilder taskBuilder(expression, idx, subflow);
 
             try {
                 // Actual task graph composition
-                processor->Process(idx, *expression, taskBuilder);
+                switch (step.action) {
+                    case ExpressionPlan::Action::Process:
+                        processor->Process(idx, *expression, taskBuilder);
+                        break;
+                    case ExpressionPlan::Action::Fuse: {
+                        TaskBuilder secondTaskBuilder(expression, step.source, subflow);
+                        fusedProcessor->Process(idx, step.source, *expression, taskBuilder, secondTaskBuilder);
+                        break;
+                    }
+                    case ExpressionPlan::Action::Share:
+                        ExpressionOptimizer::ComposeShare(idx, step.source, *expression, taskBuilder);
+                        break;
+                    case ExpressionPlan::Action::Forward:
+                        ExpressionOptimizer::ComposeForward(idx, step.source, *expression, taskBuilder);
+                        break;
+                    default:
+                        break;
+                }
             } catch (std::exception &ex) {
                 expression->SetState(Expression::State::Aborted);
                 auto logger = expression->GetLibrary().GetPrivate().GetLogger();
@@ -141,6 +247,15 @@ void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expre
         modules.push_back(taskflow.emplace(std::move(task)));
     }
 
+    // Dummy task to reset expression state, when evaluated as module several times
+    auto start = taskflow.emplace([expression = expression.Get()]() {
+                             expression->SetState(Expression::State::Submitted);
+                         })
+                         .name("Start");
+
+    for (auto begin : context.startNodes)
+        start.precede(modules[begin]);
+
     for (std::size_t idx = 0; idx < nodes.size(); idx++) {
         // Compose final taskflow graph
         auto &node = nodes[idx];
@@ -154,8 +269,14 @@ void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expre
         }
     }
 
+    // Dependencies, introduced by optimizer
+    for (auto &dependency : plan.dependencies)
+        modules[dependency.first].precede(modules[dependency.second]);
+
     // Dummy task to notify expression state
-    auto notification = taskflow.emplace([expression = expression.Get()]() {
+    // NOTE: restores args of aliased nodes, so the next run creates fresh proxies
+    auto notification = taskflow.emplace([expression = expression.Get(), tasks = expressionTasks.get()]() {
+                                    RestoreAliasedArgs(*expression, tasks->aliasedArgs);
                                     if (expression->GetState() != Expression::State::Aborted)
                                         expression->SetState(Expression::State::Evaluated);
                                 })
@@ -165,11 +286,7 @@ void spla::ExpressionManager::Submit(const spla::RefPtr<spla::Expression> &expre
     for (auto end : context.endNodes)
         modules[end].precede(notification);
 
-    auto &executor = mLibrary.GetPrivate().GetTaskFlowExecutor();
-    auto expressionFuture = std::make_unique<ExpressionFuture>(executor.run(taskflow));
-
     expression->SetTasks(std::move(expressionTasks));
-    expression->SetFuture(std::move(expressionFuture));
 }
 
 void spla::ExpressionManager::Register(const spla::RefPtr<spla::NodeProcessor> &processor) {
@@ -184,6 +301,62 @@ void spla::ExpressionManager::Register(const spla::RefPtr<spla::NodeProcessor> &
     list->second.push_back(processor);
 }
 
+void spla::ExpressionManager::RegisterFused(const spla::RefPtr<spla::FusedNodeProcessor> &processor) {
+    CHECK_RAISE_ERROR(processor.IsNotNull(), InvalidArgument, "Passed null processor");
+
+    auto ops = std::make_pair(processor->GetFirstOperationType(), processor->GetSecondOperationType());
+    mFusedProcessors[ops].push_back(processor);
+}
+
+spla::RefPtr<spla::FusedNodeProcessor>
+spla::ExpressionManager::FindFusedProcessor(std::size_t firstIdx, std::size_t secondIdx, const spla::Expression &expression) const {
+    auto &nodes = expression.GetNodes();
+    auto ops = std::make_pair(nodes[firstIdx]->GetNodeOp(), nodes[secondIdx]->GetNodeOp());
+    auto iter = mFusedProcessors.find(ops);
+
+    if (iter == mFusedProcessors.end())
+        return RefPtr<FusedNodeProcessor>();
+
+    // NOTE: first suitable processor has priority, as for ordinary processors
+    for (auto &processor : iter->second)
+        if (processor->Select(firstIdx, secondIdx, expression))
+            return processor;
+
+    return RefPtr<FusedNodeProcessor>();
+}
+
+void spla::ExpressionManager::ProxyAliasedArgs(spla::ExpressionNode &node, std::vector<RefPtr<Object>> &original) {
+    // Check, if out arg appears in the input list
+    auto &args = node.GetArgs();
+    if (!args.empty()) {
+        auto out = args[0];
+        auto query = std::find(args.begin() + 1, args.end(), out);
+        // If appears, must create a proxy
+        // And replace all `in` entries with read-only proxy
+        // NOTE: Clone is copy-on-write, proxy shares out blocks and
+        // keeps them alive, while out is rewritten by the node tasks
+        if (query != args.end()) {
+            original = args;
+            auto proxy = out->Clone();
+            std::for_each(args.begin() + 1, args.end(), [&](RefPtr<Object> &arg) {
+                if (arg == out)
+                    arg = proxy;
+            });
+        }
+    }
+}
+
+void spla::ExpressionManager::RestoreAliasedArgs(spla::Expression &expression, std::vector<std::vector<RefPtr<Object>>> &original) {
+    auto &nodes = expression.GetNodes();
+
+    for (std::size_t idx = 0; idx < nodes.size(); idx++) {
+        if (!original[idx].empty()) {
+            nodes[idx]->GetArgs() = std::move(original[idx]);
+            original[idx].clear();
+        }
+    }
+}
+
 void spla::ExpressionManager::FindStartNodes(spla::ExpressionManager::TraversalInfo &context) {
     auto &expression = context.expression;
     auto &nodes = expression->GetNodes();
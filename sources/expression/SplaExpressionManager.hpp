@@ -28,11 +28,15 @@
 #ifndef SPLA_SPLAEXPRESSIONMANAGER_HPP
 #define SPLA_SPLAEXPRESSIONMANAGER_HPP
 
+#include <expression/SplaFusedNodeProcessor.hpp>
 #include <expression/SplaNodeProcessor.hpp>
 #include <spla-cpp/SplaExpression.hpp>
 #include <spla-cpp/SplaExpressionNode.hpp>
 #include <spla-cpp/SplaLibrary.hpp>
+#include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace spla {
 
@@ -71,9 +75,20 @@ namespace spla {
         ~ExpressionManager() override = default;
 
         void Submit(const RefPtr<Expression> &expression);
+        void Compile(const RefPtr<Expression> &expression);
         void Register(const RefPtr<NodeProcessor> &processor);
 
+        void RegisterFused(const RefPtr<FusedNodeProcessor> &processor);
+
+        /** @return Fused processor for the pair of nodes; null if nodes can not be fused */
+        RefPtr<FusedNodeProcessor> FindFusedProcessor(std::size_t firstIdx, std::size_t secondIdx, const Expression &expression) const;
+
     private:
+        void Compose(const RefPtr<Expression> &expression);
+        void Run(const RefPtr<Expression> &expression);
+
+        static void ProxyAliasedArgs(ExpressionNode &node, std::vector<RefPtr<Object>> &original);
+        static void RestoreAliasedArgs(Expression &expression, std::vector<std::vector<RefPtr<Object>>> &original);
         void FindStartNodes(TraversalInfo &context);
         void FindEndNodes(TraversalInfo &context);
         void CheckCycles(TraversalInfo &context);
@@ -84,8 +99,11 @@ namespace spla {
     private:
         using ProcessorList = std::vector<RefPtr<NodeProcessor>>;
         using ProcessorMap = std::unordered_map<ExpressionNode::Operation, ProcessorList>;
+        using FusedProcessorList = std::vector<RefPtr<FusedNodeProcessor>>;
+        using FusedProcessorMap = std::map<std::pair<ExpressionNode::Operation, ExpressionNode::Operation>, FusedProcessorList>;
 
         ProcessorMap mProcessors;
+        FusedProcessorMap mFusedProcessors;
         Library &mLibrary;
     };
 
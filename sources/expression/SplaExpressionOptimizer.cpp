@@ -0,0 +1,491 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <expression/SplaExpressionManager.hpp>
+#include <expression/SplaExpressionOptimizer.hpp>
+#include <spla-cpp/SplaData.hpp>
+#include <spla-cpp/SplaMatrix.hpp>
+#include <spla-cpp/SplaScalar.hpp>
+#include <spla-cpp/SplaVector.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace spla {
+    namespace {
+        /** Copy host buffer, if both buffers are provided */
+        inline void CopyHostBuffer(const void *src, void *dst, std::size_t byteSize) {
+            if (src && dst && src != dst && byteSize > 0)
+                std::memcpy(dst, src, byteSize);
+        }
+
+        /** @return True if data write node stores host data as is, so data read returns the same arrays */
+        inline bool IsWrittenAsIs(const ExpressionNode &write) {
+            auto &desc = write.GetDescriptor();
+            return desc->IsParamSet(Descriptor::Param::ValuesSorted) &&
+                   desc->IsParamSet(Descriptor::Param::NoDuplicates) &&
+                   !desc->IsParamSet(Descriptor::Param::ValuesBlocked);
+        }
+
+        /** @return Data write operation, which result is read by provided data read operation */
+        inline bool IsDataReadOf(ExpressionNode::Operation read, ExpressionNode::Operation write) {
+            return (read == ExpressionNode::Operation::MatrixDataRead && write == ExpressionNode::Operation::MatrixDataWrite) ||
+                   (read == ExpressionNode::Operation::VectorDataRead && write == ExpressionNode::Operation::VectorDataWrite) ||
+                   (read == ExpressionNode::Operation::ScalarDataRead && write == ExpressionNode::Operation::ScalarDataWrite);
+        }
+
+        /** @return True if result of one object can be shared by the other */
+        inline bool CanShare(const RefPtr<Object> &a, const RefPtr<Object> &b) {
+            if (a->GetTypeName() != b->GetTypeName())
+                return false;
+
+            switch (a->GetTypeName()) {
+                case Object::TypeName::Matrix: {
+                    auto ma = a.Cast<Matrix>();
+                    auto mb = b.Cast<Matrix>();
+                    return ma->GetType() == mb->GetType() && ma->GetNrows() == mb->GetNrows() && ma->GetNcols() == mb->GetNcols();
+                }
+                case Object::TypeName::Vector: {
+                    auto va = a.Cast<Vector>();
+                    auto vb = b.Cast<Vector>();
+                    return va->GetType() == vb->GetType() && va->GetNrows() == vb->GetNrows();
+                }
+                case Object::TypeName::Scalar:
+                    return a.Cast<Scalar>()->GetType() == b.Cast<Scalar>()->GetType();
+                default:
+                    return false;
+            }
+        }
+    }// namespace
+}// namespace spla
+
+struct spla::ExpressionOptimizer::Context {
+    explicit Context(const Expression &expression) : expression(expression) {}
+
+    /** @return True if node is reachable from node `from` by dependencies */
+    bool Reachable(std::size_t from, std::size_t to) const {
+        return reach[from][to] != 0;
+    }
+
+    /** Adds dependency edge and updates reachability */
+    void AddDependency(std::size_t pred, std::size_t succ) {
+        auto count = reach.size();
+        for (std::size_t a = 0; a < count; a++) {
+            if (a != pred && !reach[a][pred])
+                continue;
+            reach[a][succ] = 1;
+            for (std::size_t b = 0; b < count; b++)
+                if (reach[succ][b])
+                    reach[a][b] = 1;
+        }
+    }
+
+    /** @return Nodes, which read or write provided object */
+    std::vector<std::size_t> GetAccesses(const Object *object) const {
+        std::vector<std::size_t> result;
+        for (std::size_t idx = 0; idx < effects.size(); idx++) {
+            auto &e = effects[idx];
+            if (e.output == object || std::find(e.inputs.begin(), e.inputs.end(), object) != e.inputs.end())
+                result.push_back(idx);
+        }
+        return result;
+    }
+
+    /** @return Nodes, which write provided object */
+    std::vector<std::size_t> GetWriters(const Object *object) const {
+        std::vector<std::size_t> result;
+        for (std::size_t idx = 0; idx < effects.size(); idx++)
+            if (effects[idx].output == object)
+                result.push_back(idx);
+        return result;
+    }
+
+    const Expression &expression;
+    std::vector<Effects> effects;
+    std::vector<std::vector<char>> reach;
+};
+
+spla::ExpressionOptimizer::ExpressionOptimizer(const spla::ExpressionManager &manager) : mManager(manager) {
+}
+
+void spla::ExpressionOptimizer::Optimize(const spla::Expression &expression, spla::ExpressionPlan &plan) const {
+    auto &nodes = expression.GetNodes();
+    auto count = nodes.size();
+
+    assert(plan.steps.size() == count);
+
+    // Effects of control flow nodes are defined by their bodies; keep graph as is
+    auto hasControl = std::any_of(nodes.begin(), nodes.end(), [](const RefPtr<ExpressionNode> &node) {
+        return node->GetNodeOp() == ExpressionNode::Operation::Loop ||
+               node->GetNodeOp() == ExpressionNode::Operation::Condition;
+    });
+
+    if (hasControl)
+        return;
+
+    Context context(expression);
+    context.effects.reserve(count);
+
+    for (auto &node : nodes)
+        context.effects.push_back(GetEffects(*node));
+
+    // Transitive closure of dependencies, nodes indexed in topological order is not guaranteed
+    context.reach.resize(count, std::vector<char>(count, 0));
+    for (std::size_t idx = 0; idx < count; idx++) {
+        std::vector<std::size_t> stack{idx};
+        while (!stack.empty()) {
+            auto current = stack.back();
+            stack.pop_back();
+            for (auto next : nodes[current]->GetNext()) {
+                auto nextIdx = next->GetIdx();
+                if (!context.reach[idx][nextIdx]) {
+                    context.reach[idx][nextIdx] = 1;
+                    stack.push_back(nextIdx);
+                }
+            }
+        }
+    }
+
+    EliminateDead(context, plan);
+    MergeIdentical(context, plan);
+    ForwardData(context, plan);
+    FuseNodes(context, plan);
+}
+
+void spla::ExpressionOptimizer::ComposeShare(std::size_t nodeIdx, std::size_t sourceIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    auto &nodes = expression.GetNodes();
+    auto out = nodes[nodeIdx]->GetArg(0);
+    auto source = nodes[sourceIdx]->GetArg(0);
+
+    builder.Emplace("share", [=]() {
+        // NOTE: Clone is copy-on-write, so result blocks are shared without device work
+        out->CopyData(source->Clone());
+    });
+}
+
+void spla::ExpressionOptimizer::ComposeForward(std::size_t nodeIdx, std::size_t sourceIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    auto &nodes = expression.GetNodes();
+    auto &read = nodes[nodeIdx];
+    auto &write = nodes[sourceIdx];
+
+    switch (read->GetNodeOp()) {
+        case ExpressionNode::Operation::MatrixDataRead: {
+            auto byteSize = read->GetArg(0).Cast<Matrix>()->GetType()->GetByteSize();
+            auto src = write->GetArg(1).Cast<DataMatrix>();
+            auto dst = read->GetArg(1).Cast<DataMatrix>();
+            builder.Emplace("forward", [=]() {
+                auto nvals = src->GetNvals();
+                CHECK_RAISE_ERROR(dst->GetNvals() >= nvals, InvalidArgument,
+                                  "Provided data arrays do not have enough space to store matrix data");
+                CopyHostBuffer(src->GetRows(), dst->GetRows(), nvals * sizeof(unsigned int));
+                CopyHostBuffer(src->GetCols(), dst->GetCols(), nvals * sizeof(unsigned int));
+                CopyHostBuffer(src->GetVals(), dst->GetVals(), nvals * byteSize);
+            });
+            break;
+        }
+        case ExpressionNode::Operation::VectorDataRead: {
+            auto byteSize = read->GetArg(0).Cast<Vector>()->GetType()->GetByteSize();
+            auto src = write->GetArg(1).Cast<DataVector>();
+            auto dst = read->GetArg(1).Cast<DataVector>();
+            builder.Emplace("forward", [=]() {
+                auto nvals = src->GetNvals();
+                CHECK_RAISE_ERROR(dst->GetNvals() >= nvals, InvalidArgument,
+                                  "Provided data arrays do not have enough space to store vector data");
+                CopyHostBuffer(src->GetRows(), dst->GetRows(), nvals * sizeof(unsigned int));
+                CopyHostBuffer(src->GetVals(), dst->GetVals(), nvals * byteSize);
+            });
+            break;
+        }
+        case ExpressionNode::Operation::ScalarDataRead: {
+            auto byteSize = read->GetArg(0).Cast<Scalar>()->GetType()->GetByteSize();
+            auto src = write->GetArg(1).Cast<DataScalar>();
+            auto dst = read->GetArg(1).Cast<DataScalar>();
+            builder.Emplace("forward", [=]() {
+                CopyHostBuffer(src->GetValue(), dst->GetValue(), byteSize);
+            });
+            break;
+        }
+        default:
+            RAISE_ERROR(InvalidState, "Unsupported node op=" << ExpressionNodeOpToStr(read->GetNodeOp()) << " to forward data");
+    }
+}
+
+spla::ExpressionOptimizer::Effects spla::ExpressionOptimizer::GetEffects(const spla::ExpressionNode &node) {
+    Effects effects;
+    auto &args = node.GetArgs();
+    auto &desc = node.GetDescriptor();
+
+    auto input = [&](std::size_t idx) {
+        if (idx < args.size() && args[idx].IsNotNull())
+            effects.inputs.push_back(args[idx].Get());
+    };
+    auto output = [&](bool overwrite) {
+        effects.output = args[0].Get();
+        effects.overwrite = overwrite;
+        if (!overwrite)
+            input(0);
+    };
+    auto accum = desc.IsNotNull() && desc->IsParamSet(Descriptor::Param::AccumResult);
+
+    switch (node.GetNodeOp()) {
+        case ExpressionNode::Operation::MatrixDataWrite:
+        case ExpressionNode::Operation::VectorDataWrite:
+        case ExpressionNode::Operation::ScalarDataWrite:
+            output(true);
+            break;
+        case ExpressionNode::Operation::MatrixDataRead:
+        case ExpressionNode::Operation::VectorDataRead:
+        case ExpressionNode::Operation::ScalarDataRead:
+            input(0);
+            break;
+        case ExpressionNode::Operation::VectorAssign:
+            // w, mask, accum, s
+            output(!accum);
+            input(1);
+            input(3);
+            break;
+        case ExpressionNode::Operation::MatrixEWiseAdd:
+        case ExpressionNode::Operation::VectorEWiseAdd:
+            // w, mask, op, a, b
+            output(true);
+            input(1);
+            input(3);
+            input(4);
+            break;
+        case ExpressionNode::Operation::VectorReduce:
+            // s, op, v
+            output(true);
+            input(2);
+            break;
+        case ExpressionNode::Operation::MxM:
+        case ExpressionNode::Operation::VxM:
+        case ExpressionNode::Operation::MxV:
+            // w, mask, mult, add, a, b
+            output(true);
+            input(1);
+            input(4);
+            input(5);
+            break;
+        case ExpressionNode::Operation::Transpose:
+            // w, mask, accum, a
+            output(!accum);
+            input(1);
+            input(3);
+            break;
+        case ExpressionNode::Operation::MatrixInsert:
+        case ExpressionNode::Operation::MatrixRemove:
+            output(false);
+            break;
+        default:
+            // Unknown node: treat as reading and writing all its args
+            for (std::size_t idx = 0; idx < args.size(); idx++)
+                input(idx);
+            if (!args.empty())
+                output(false);
+            break;
+    }
+
+    return effects;
+}
+
+void spla::ExpressionOptimizer::EliminateDead(spla::ExpressionOptimizer::Context &context, spla::ExpressionPlan &plan) const {
+    auto &expression = context.expression;
+    auto &nodes = expression.GetNodes();
+    auto logger = expression.GetLibrary().GetPrivate().GetLogger();
+
+    for (std::size_t x = 0; x < nodes.size(); x++) {
+        auto object = context.effects[x].output;
+        if (!object)
+            continue;
+
+        auto accesses = context.GetAccesses(object);
+
+        // Node is dead if its result is overwritten by other node y,
+        // and any other access of the object happens only after y
+        for (auto y : context.GetWriters(object)) {
+            auto &e = context.effects[y];
+
+            if (y == x || !e.overwrite || !context.Reachable(x, y) ||
+                std::find(e.inputs.begin(), e.inputs.end(), object) != e.inputs.end())
+                continue;
+
+            auto observed = std::any_of(accesses.begin(), accesses.end(), [&](std::size_t t) {
+                return t != x && t != y && !context.Reachable(y, t);
+            });
+
+            if (!observed) {
+                plan.steps[x].action = ExpressionPlan::Action::Skip;
+                SPDLOG_LOGGER_TRACE(logger, "Skip dead node idx={} op={} overwritten by idx={}",
+                                    x, ExpressionNodeOpToStr(nodes[x]->GetNodeOp()), y);
+                break;
+            }
+        }
+    }
+}
+
+void spla::ExpressionOptimizer::MergeIdentical(spla::ExpressionOptimizer::Context &context, spla::ExpressionPlan &plan) const {
+    auto &expression = context.expression;
+    auto &nodes = expression.GetNodes();
+    auto logger = expression.GetLibrary().GetPrivate().GetLogger();
+
+    auto live = [&](std::size_t idx) { return plan.steps[idx].action == ExpressionPlan::Action::Process; };
+
+    // Pure node: result depends only on inputs and does not read own output
+    auto pure = [&](std::size_t idx) {
+        auto &e = context.effects[idx];
+        return e.output && e.overwrite &&
+               std::find(e.inputs.begin(), e.inputs.end(), e.output) == e.inputs.end();
+    };
+
+    auto identical = [&](std::size_t a, std::size_t b) {
+        auto &argsA = nodes[a]->GetArgs();
+        auto &argsB = nodes[b]->GetArgs();
+        return nodes[a]->GetNodeOp() == nodes[b]->GetNodeOp() &&
+               nodes[a]->GetDescriptor() == nodes[b]->GetDescriptor() &&
+               argsA.size() == argsB.size() &&
+               std::equal(argsA.begin() + 1, argsA.end(), argsB.begin() + 1);
+    };
+
+    for (std::size_t j = 0; j < nodes.size(); j++) {
+        if (!live(j) || !pure(j))
+            continue;
+
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            if (i == j || !live(i) || !pure(i) || !identical(i, j))
+                continue;
+
+            // Primary node must be evaluated first, duplicate waits for it
+            if (context.Reachable(j, i))
+                continue;
+
+            auto &primary = context.effects[i];
+            auto &duplicate = context.effects[j];
+
+            // Inputs must be written only before both nodes, and primary
+            // result must not change until duplicate is evaluated
+            auto stable = std::all_of(primary.inputs.begin(), primary.inputs.end(), [&](const Object *input) {
+                auto writers = context.GetWriters(input);
+                return std::all_of(writers.begin(), writers.end(), [&](std::size_t t) {
+                    return context.Reachable(t, i) && context.Reachable(t, j);
+                });
+            });
+            auto writers = context.GetWriters(primary.output);
+            auto exclusive = std::all_of(writers.begin(), writers.end(), [&](std::size_t t) {
+                return t == i || t == j || context.Reachable(t, i) || context.Reachable(j, t);
+            });
+
+            if (!stable || !exclusive)
+                continue;
+
+            auto sameOutput = primary.output == duplicate.output;
+            if (!sameOutput && !CanShare(nodes[i]->GetArg(0), nodes[j]->GetArg(0)))
+                continue;
+
+            plan.steps[j].action = sameOutput ? ExpressionPlan::Action::Skip : ExpressionPlan::Action::Share;
+            plan.steps[j].source = i;
+            plan.dependencies.emplace_back(i, j);
+            context.AddDependency(i, j);
+
+            SPDLOG_LOGGER_TRACE(logger, "Merge node idx={} into identical node idx={} op={}",
+                                j, i, ExpressionNodeOpToStr(nodes[j]->GetNodeOp()));
+            break;
+        }
+    }
+}
+
+void spla::ExpressionOptimizer::ForwardData(spla::ExpressionOptimizer::Context &context, spla::ExpressionPlan &plan) const {
+    auto &expression = context.expression;
+    auto &nodes = expression.GetNodes();
+    auto logger = expression.GetLibrary().GetPrivate().GetLogger();
+
+    for (std::size_t r = 0; r < nodes.size(); r++) {
+        if (plan.steps[r].action != ExpressionPlan::Action::Process)
+            continue;
+
+        // Object must be last written by data write node before read
+        auto writers = context.GetWriters(nodes[r]->GetArg(0).Get());
+        auto last = std::find_if(writers.begin(), writers.end(), [&](std::size_t t) {
+            return context.Reachable(t, r) && std::all_of(writers.begin(), writers.end(), [&](std::size_t other) {
+                       return other == t || context.Reachable(other, t) || context.Reachable(r, other);
+                   });
+        });
+
+        if (last == writers.end())
+            continue;
+
+        auto w = *last;
+        if (!IsDataReadOf(nodes[r]->GetNodeOp(), nodes[w]->GetNodeOp()))
+            continue;
+
+        if (nodes[w]->GetNodeOp() != ExpressionNode::Operation::ScalarDataWrite && !IsWrittenAsIs(*nodes[w]))
+            continue;
+
+        plan.steps[r].action = ExpressionPlan::Action::Forward;
+        plan.steps[r].source = w;
+
+        SPDLOG_LOGGER_TRACE(logger, "Forward data of node idx={} to read node idx={} op={}",
+                            w, r, ExpressionNodeOpToStr(nodes[r]->GetNodeOp()));
+    }
+}
+
+void spla::ExpressionOptimizer::FuseNodes(spla::ExpressionOptimizer::Context &context, spla::ExpressionPlan &plan) const {
+    auto &expression = context.expression;
+    auto &nodes = expression.GetNodes();
+    auto logger = expression.GetLibrary().GetPrivate().GetLogger();
+
+    auto live = [&](std::size_t idx) { return plan.steps[idx].action == ExpressionPlan::Action::Process; };
+
+    for (std::size_t a = 0; a < nodes.size(); a++) {
+        if (!live(a))
+            continue;
+
+        for (auto next : nodes[a]->GetNext()) {
+            auto b = next->GetIdx();
+
+            // Second node must depend only on the first one
+            if (!live(b) || next->GetPrev().size() != 1)
+                continue;
+
+            if (mManager.FindFusedProcessor(a, b, expression).IsNull())
+                continue;
+
+            plan.steps[a].action = ExpressionPlan::Action::Fuse;
+            plan.steps[a].source = b;
+            plan.steps[b].action = ExpressionPlan::Action::Skip;
+            plan.steps[b].source = a;
+
+            SPDLOG_LOGGER_TRACE(logger, "Fuse nodes idx={} op={} and idx={} op={}",
+                                a, ExpressionNodeOpToStr(nodes[a]->GetNodeOp()),
+                                b, ExpressionNodeOpToStr(nodes[b]->GetNodeOp()));
+            break;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAEXPRESSIONOPTIMIZER_HPP
+#define SPLA_SPLAEXPRESSIONOPTIMIZER_HPP
+
+#include <core/SplaTaskBuilder.hpp>
+#include <spla-cpp/SplaExpression.hpp>
+#include <spla-cpp/SplaExpressionNode.hpp>
+#include <utility>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @brief Rewrite of the expression graph, applied on tasks composition.
+     *
+     * Nodes keep their indices and dependencies, plan only defines how each node is composed.
+     */
+    struct ExpressionPlan {
+        /** How to compose node tasks */
+        enum class Action {
+            /** Process node with its own processor */
+            Process,
+            /** Node has no effect or processed within other node; compose nothing */
+            Skip,
+            /** Process node together with its only successor `source` by fused processor */
+            Fuse,
+            /** Node computes the same result as node `source`; share its result */
+            Share,
+            /** Node reads data, written by data write node `source`; copy host data */
+            Forward
+        };
+
+        /** Plan of single node */
+        struct Step {
+            Action action = Action::Process;
+            std::size_t source = 0;
+        };
+
+        explicit ExpressionPlan(std::size_t nodesCount) : steps(nodesCount) {}
+
+        /** Steps for each expression node */
+        std::vector<Step> steps;
+        /** Additional (pred, succ) nodes dependencies required by the plan */
+        std::vector<std::pair<std::size_t, std::size_t>> dependencies;
+    };
+
+    /**
+     * @class ExpressionOptimizer
+     *
+     * @brief Expression graph optimization pass, runs before tasks composition.
+     *
+     * Optimizer analyzes objects, read and written by the nodes, and rewrites
+     * the graph in the following order:
+     *  - skips dead nodes, which results are overwritten before being observed;
+     *  - merges nodes with identical operation and inputs;
+     *  - forwards host data of data write node to the data read node of the same object;
+     *  - fuses node with its only successor, if suitable fused processor is registered.
+     *
+     * All rewrites are conservative: rewrite is applied only if dependencies
+     * order all other accesses of the involved objects before or after rewritten nodes.
+     *
+     * @see ExpressionManager
+     * @see FusedNodeProcessor
+     */
+    class ExpressionOptimizer {
+    public:
+        explicit ExpressionOptimizer(const class ExpressionManager &manager);
+
+        /**
+         * @brief Optimize expression graph.
+         *
+         * @param expression Validated expression without cycles
+         * @param plan Plan to fill, all nodes are processed as is by default
+         */
+        void Optimize(const Expression &expression, ExpressionPlan &plan) const;
+
+        /** Compose tasks of the node, which shares result of `sourceIdx` node */
+        static void ComposeShare(std::size_t nodeIdx, std::size_t sourceIdx, const Expression &expression, TaskBuilder &builder);
+
+        /** Compose tasks of the data read node, which copies data of `sourceIdx` data write node */
+        static void ComposeForward(std::size_t nodeIdx, std::size_t sourceIdx, const Expression &expression, TaskBuilder &builder);
+
+    private:
+        /** Objects accessed by the node */
+        struct Effects {
+            /** Objects read by the node */
+            std::vector<const Object *> inputs;
+            /** Object written by the node; may be null */
+            const Object *output = nullptr;
+            /** True if output content fully replaced by the node */
+            bool overwrite = false;
+        };
+
+        struct Context;
+
+        static Effects GetEffects(const ExpressionNode &node);
+
+        void EliminateDead(Context &context, ExpressionPlan &plan) const;
+        void MergeIdentical(Context &context, ExpressionPlan &plan) const;
+        void ForwardData(Context &context, ExpressionPlan &plan) const;
+        void FuseNodes(Context &context, ExpressionPlan &plan) const;
+
+    private:
+        const class ExpressionManager &mManager;
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAEXPRESSIONOPTIMIZER_HPP
@@ -28,7 +28,9 @@
 #ifndef SPLA_SPLAEXPRESSIONTASKS_HPP
 #define SPLA_SPLAEXPRESSIONTASKS_HPP
 
+#include <expression/SplaExpressionOptimizer.hpp>
 #include <taskflow/taskflow.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace spla {
@@ -42,6 +44,23 @@ namespace spla {
     public:
         /** Expression taskflow graph */
         tf::Taskflow taskflow;
+        /** Optimizer plan, used to compose taskflow graph */
+        ExpressionPlan plan{0};
+        /** Original args of nodes, replaced by proxies while evaluated */
+        std::vector<std::vector<RefPtr<Object>>> aliasedArgs;
+
+        /** @return True if node is rewritten by optimizer or used as source of other node rewrite */
+        bool IsRewritten(std::size_t nodeIdx) const {
+            using Action = ExpressionPlan::Action;
+
+            if (nodeIdx < plan.steps.size() && plan.steps[nodeIdx].action != Action::Process)
+                return true;
+
+            return std::any_of(plan.steps.begin(), plan.steps.end(), [&](const ExpressionPlan::Step &step) {
+                return (step.action == Action::Fuse || step.action == Action::Share || step.action == Action::Forward) &&
+                       step.source == nodeIdx;
+            });
+        }
     };
 
     /**
@@ -0,0 +1,98 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAFUSEDNODEPROCESSOR_HPP
+#define SPLA_SPLAFUSEDNODEPROCESSOR_HPP
+
+#include <core/SplaTaskBuilder.hpp>
+#include <spla-cpp/SplaExpression.hpp>
+#include <spla-cpp/SplaExpressionNode.hpp>
+#include <spla-cpp/SplaRefCnt.hpp>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class FusedNodeProcessor
+     *
+     * @brief Interface to the processor of the pair of dependent expression nodes.
+     *
+     * Fused processor composes tasks of the first node and its only successor
+     * within single node processing step, so tasks of the second node may start
+     * as soon as required parts of the first node result are computed.
+     *
+     * Fusion candidates are found by the expression optimizer.
+     *
+     * @see ExpressionOptimizer
+     * @see NodeProcessor
+     */
+    class FusedNodeProcessor : public RefCnt {
+    public:
+        /**
+         * @brief Select this processor for processing specified pair of nodes.
+         *
+         * @param firstIdx Index of the first node in expression
+         * @param secondIdx Index of the second node in expression, depends only on first node
+         * @param expression Expression being processed
+         *
+         * @return True if this processor can process nodes together
+         */
+        virtual bool Select(std::size_t firstIdx, std::size_t secondIdx, const Expression &expression) = 0;
+
+        /**
+         * @brief Process specified pair of nodes in the expression.
+         *
+         * Same as for NodeProcessor, no actual computation must happen within
+         * Process method call; only tasks graph of both nodes is composed.
+         *
+         * @param firstIdx Index of the first node in expression
+         * @param secondIdx Index of the second node in expression
+         * @param expression Expression being processed
+         * @param firstBuilder TaskBuilder for first node tasks
+         * @param secondBuilder TaskBuilder for second node tasks
+         */
+        virtual void Process(std::size_t firstIdx, std::size_t secondIdx, const Expression &expression,
+                             TaskBuilder &firstBuilder, TaskBuilder &secondBuilder) = 0;
+
+        /** @return Type of the first node operation, handled by this processor */
+        virtual ExpressionNode::Operation GetFirstOperationType() const = 0;
+
+        /** @return Type of the second node operation, handled by this processor */
+        virtual ExpressionNode::Operation GetSecondOperationType() const = 0;
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAFUSEDNODEPROCESSOR_HPP
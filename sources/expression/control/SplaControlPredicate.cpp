@@ -0,0 +1,71 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <boost/compute.hpp>
+#include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <expression/control/SplaControlPredicate.hpp>
+#include <spla-cpp/SplaScalar.hpp>
+#include <spla-cpp/SplaVector.hpp>
+#include <storage/SplaScalarStorage.hpp>
+#include <storage/SplaScalarValue.hpp>
+#include <algorithm>
+#include <vector>
+
+bool spla::EvalControlPredicate(const spla::RefPtr<spla::ExpressionNode> &node) {
+    auto &condition = node->GetArg(1);
+
+    switch (condition->GetTypeName()) {
+        case Object::TypeName::Vector:
+            return condition.Cast<Vector>()->GetNvals() != 0;
+
+        case Object::TypeName::Scalar: {
+            auto deviceValue = condition.Cast<Scalar>()->GetStorage()->GetValue();
+
+            if (deviceValue.IsNull())
+                return false;
+
+            using namespace boost;
+
+            auto &library = node->GetLibrary().GetPrivate();
+            auto &deviceMan = library.GetDeviceManager();
+            auto deviceId = deviceMan.FetchDevice(node);
+
+            compute::device device = deviceMan.GetDevice(deviceId);
+            compute::context ctx = library.GetContext();
+            compute::command_queue queue(ctx, device);
+
+            std::vector<unsigned char> hostValue(deviceValue->GetVal().size());
+            compute::copy(deviceValue->GetVal().begin(), deviceValue->GetVal().end(), hostValue.begin(), queue);
+
+            return std::any_of(hostValue.begin(), hostValue.end(), [](unsigned char b) { return b != 0; });
+        }
+
+        default:
+            RAISE_ERROR(InvalidType, "Unsupported condition type " << ObjectTypeToStr(condition->GetTypeName()));
+    }
+}
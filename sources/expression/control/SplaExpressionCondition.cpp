@@ -0,0 +1,69 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaError.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <expression/control/SplaControlPredicate.hpp>
+#include <expression/control/SplaExpressionCondition.hpp>
+
+bool spla::ExpressionCondition::Select(std::size_t nodeIdx, const spla::Expression &expression) {
+    return true;
+}
+
+void spla::ExpressionCondition::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    auto &nodes = expression.GetNodes();
+    auto node = nodes[nodeIdx];
+    auto library = expression.GetLibrary().GetPrivatePtr();
+    auto logger = library->GetLogger();
+
+    auto body = node->GetArg(0).Cast<Expression>();
+
+    assert(body.IsNotNull());
+
+    // Nothing to evaluate
+    if (body->Empty()) {
+        SPDLOG_LOGGER_TRACE(logger, "Skip condition with empty body");
+        return;
+    }
+
+    // Condition: check -> body -> done, or check -> skip
+    auto check = builder.EmplaceCondition("check", [=]() {
+        return EvalControlPredicate(node);
+    });
+    auto module = builder.EmplaceModule("body", *body);
+    auto skip = builder.Emplace("skip", []() {});
+    auto done = builder.Emplace("done", [=]() {
+        CHECK_RAISE_ERROR(body->GetState() != Expression::State::Aborted, InvalidState, "Condition body evaluation aborted");
+    });
+
+    check.precede(module, skip);
+    module.precede(done);
+}
+
+spla::ExpressionNode::Operation spla::ExpressionCondition::GetOperationType() const {
+    return ExpressionNode::Operation::Condition;
+}
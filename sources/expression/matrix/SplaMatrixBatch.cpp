@@ -0,0 +1,107 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algorithm>
+#include <core/SplaError.hpp>
+#include <expression/matrix/SplaMatrixBatch.hpp>
+#include <numeric>
+
+std::vector<spla::MatrixBatchBlock> spla::SplitMatrixBatch(const DataMatrix &data, const Descriptor &desc,
+                                                           const BlockPartition &rows, const BlockPartition &cols,
+                                                           std::size_t byteSize) {
+    auto rowsHost = data.GetRows();
+    auto colsHost = data.GetCols();
+    auto valsHost = reinterpret_cast<const unsigned char *>(data.GetVals());
+    auto nvalsHost = data.GetNvals();
+    auto nrows = rows.GetDim();
+    auto ncols = cols.GetDim();
+
+    std::vector<MatrixBatchBlock> blocks;
+
+    if (nvalsHost == 0)
+        return blocks;
+
+    CHECK_RAISE_ERROR(rowsHost && colsHost, NullPointer, "batch indices can't be null");
+    CHECK_RAISE_ERROR(byteSize == 0 || valsHost, NullPointer, "batch values can't be null");
+
+    for (std::size_t k = 0; k < nvalsHost; k++) {
+        CHECK_RAISE_ERROR(rowsHost[k] < nrows && colsHost[k] < ncols, InvalidArgument,
+                          "Batch entry (" << rowsHost[k] << "," << colsHost[k] << ") out of matrix bounds");
+    }
+
+    auto blockOf = [=](std::size_t k) {
+        return MatrixStorage::Index{static_cast<unsigned int>(rows.GetBlockIndex(rowsHost[k])),
+                                    static_cast<unsigned int>(cols.GetBlockIndex(colsHost[k]))};
+    };
+
+    // Order of entries: (block, row, column); stable to keep first of duplicates
+    std::vector<std::size_t> order(nvalsHost);
+    std::iota(order.begin(), order.end(), 0);
+
+    // Blocked hint refers to uniform blocks, so it is useless for other partitions
+    auto sorted = rows.IsUniform() && cols.IsUniform() &&
+                  desc.IsParamSet(Descriptor::Param::ValuesBlocked) &&
+                  desc.IsParamSet(Descriptor::Param::ValuesSorted);
+
+    if (!sorted) {
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            auto blockA = blockOf(a);
+            auto blockB = blockOf(b);
+            if (blockA != blockB)
+                return blockA < blockB;
+            return std::make_pair(rowsHost[a], colsHost[a]) < std::make_pair(rowsHost[b], colsHost[b]);
+        });
+    }
+
+    auto reduceDuplicates = !desc.IsParamSet(Descriptor::Param::NoDuplicates);
+
+    for (std::size_t k = 0; k < nvalsHost; k++) {
+        auto idx = order[k];
+
+        if (reduceDuplicates && k > 0) {
+            auto prev = order[k - 1];
+            if (rowsHost[prev] == rowsHost[idx] && colsHost[prev] == colsHost[idx])
+                continue;
+        }
+
+        auto blockIndex = blockOf(idx);
+
+        if (blocks.empty() || blocks.back().index != blockIndex) {
+            blocks.emplace_back();
+            blocks.back().index = blockIndex;
+        }
+
+        auto &block = blocks.back();
+        block.rows.push_back(rowsHost[idx] - rows.GetBlockOffset(blockIndex.first));
+        block.cols.push_back(colsHost[idx] - cols.GetBlockOffset(blockIndex.second));
+
+        if (byteSize)
+            block.vals.insert(block.vals.end(), valsHost + idx * byteSize, valsHost + (idx + 1) * byteSize);
+    }
+
+    return blocks;
+}
@@ -0,0 +1,80 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAMATRIXBATCH_HPP
+#define SPLA_SPLAMATRIXBATCH_HPP
+
+#include <spla-cpp/SplaData.hpp>
+#include <spla-cpp/SplaDescriptor.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @brief Part of the host batch of entries, which falls into single storage block.
+     *
+     * Indices are local to the block, sorted in row-column order and have no duplicates.
+     */
+    struct MatrixBatchBlock {
+        MatrixStorage::Index index;
+        std::vector<unsigned int> rows;
+        std::vector<unsigned int> cols;
+        std::vector<unsigned char> vals;
+    };
+
+    /**
+     * @brief Splits host batch of entries into storage blocks.
+     *
+     * Entries are sorted by (block, row, column) unless `ValuesBlocked` and `ValuesSorted`
+     * hints are set and storage partition is uniform; duplicates are reduced (keep first entry) unless `NoDuplicates` hint is set.
+     * Only blocks with at least one entry are returned, in (block row, block column) order.
+     *
+     * @param data Host batch of entries
+     * @param desc Descriptor with batch layout hints
+     * @param rows Storage rows partition
+     * @param cols Storage columns partition
+     * @param byteSize Size of value in bytes; pass 0 to ignore values
+     *
+     * @return Touched blocks with local entries
+     */
+    std::vector<MatrixBatchBlock> SplitMatrixBatch(const DataMatrix &data, const Descriptor &desc,
+                                                   const BlockPartition &rows, const BlockPartition &cols,
+                                                   std::size_t byteSize);
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAMATRIXBATCH_HPP
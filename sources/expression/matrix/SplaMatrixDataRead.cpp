@@ -37,8 +37,8 @@
 namespace spla {
     namespace {
         struct MatrixDataReadShared {
-            /** Blocks entries */
-            MatrixStorage::EntryMap entries;
+            /** Blocks shapes; blocks are fetched by row tasks */
+            MatrixStorage::BlockInfoMap entries;
             /** Number of nnz in each storage blocks' row */
             std::vector<std::size_t> blockRowsNvals;
             /** Offsets of each storage blocks' rows */
@@ -71,14 +71,14 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
                       "Provided data arrays do not have enough space to store matrix data");
 
     auto shared = std::make_shared<MatrixDataReadShared>();
-    storage->GetBlocks(shared->entries);
+    storage->GetBlocksInfo(shared->entries);
 
     for (const auto &entry : shared->entries) {
-        CHECK_RAISE_ERROR(entry.second->GetFormat() == MatrixBlock::Format::COO, NotImplemented,
+        CHECK_RAISE_ERROR(entry.second.format == MatrixBlock::Format::COO, NotImplemented,
                           "Supported only COO matrix block format");
     }
 
-    auto collectNnz = builder.Emplace([=]() {
+    auto collectNnz = builder.Emplace("collect nnz", [=]() {
         auto &blockRowsNvals = shared->blockRowsNvals;
         auto &blockRowsOffsets = shared->blockRowsOffsets;
 
@@ -89,7 +89,7 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
         for (const auto &entry : shared->entries) {
             auto &index = entry.first;
             auto row = index.first;
-            auto nnz = entry.second->GetNvals();
+            auto nnz = entry.second.nvals;
             blockRowsNvals[row] += nnz;
         }
 
@@ -102,7 +102,7 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
 
     for (std::size_t i = 0; i < storage->GetNblockRows(); i++) {
         auto deviceId = devicesIds[i];
-        auto copyBlocksInRow = builder.Emplace([=]() {
+        auto copyBlocksInRow = builder.Emplace("blocks row (" + std::to_string(i) + ")", [=]() {
             using namespace boost;
 
             auto device = library->GetDeviceManager().GetDevice(deviceId);
@@ -131,7 +131,7 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
                 auto query = entries.find(index);
 
                 if (query != entries.end()) {
-                    blocks.push_back(*query);
+                    blocks.emplace_back(index, storage->GetBlock(index, deviceId));
                     blockColIdx.push_back(static_cast<unsigned int>(j));
                 }
             }
@@ -144,7 +144,8 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
             auto vals = reinterpret_cast<unsigned char *>(matrixData->GetVals());
             assert(rows || cols || vals);
 
-            auto blockSize = library->GetBlockSize();
+            auto &rowPartition = storage->GetRowPartition();
+            auto &colPartition = storage->GetColPartition();
             auto blockNrows = blocks.front().second->GetNrows();
             auto byteSize = matrix->GetType()->GetByteSize();
             auto typeHasValues = byteSize != 0;
@@ -165,7 +166,7 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
             if (rows) {
                 std::size_t writeOffset = offset;
                 std::vector<std::size_t> readPositions(blocks.size(), 0);
-                auto blockFirstRow = static_cast<unsigned int>(i * blockSize);
+                auto blockFirstRow = rowPartition.GetBlockOffset(i);
 
                 for (unsigned int row = 0; row < blockNrows; row++) {
                     for (std::size_t k = 0; k < blocks.size(); k++) {
@@ -199,7 +200,7 @@ void spla::MatrixDataRead::Process(std::size_t nodeIdx, const spla::Expression &
                         const auto &rowsBuffer = blocksRows[k];
                         const auto &colsBuffer = blocksCols[k];
                         auto &readPos = readPositions[k];
-                        auto blockFirstCol = static_cast<unsigned int>(blockColIdx[k] * blockSize);
+                        auto blockFirstCol = colPartition.GetBlockOffset(blockColIdx[k]);
 
                         while (readPos < rowsBuffer.size() && rowsBuffer[readPos] == row) {
                             cols[writeOffset] = colsBuffer[readPos] + blockFirstCol;
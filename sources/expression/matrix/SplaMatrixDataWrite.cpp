@@ -27,9 +27,10 @@
 
 #include <boost/compute.hpp>
 #include <compute/SplaGather.hpp>
+#include <compute/SplaScan.hpp>
 #include <compute/SplaSortByRowColumn.hpp>
+#include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
-#include <core/SplaMath.hpp>
 #include <core/SplaQueueFinisher.hpp>
 #include <expression/matrix/SplaMatrixDataWrite.hpp>
 #include <storage/SplaMatrixStorage.hpp>
@@ -56,17 +57,52 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
 
     auto nrows = matrix->GetNrows();
     auto ncols = matrix->GetNcols();
-    auto blockSize = library->GetBlockSize();
+    auto storage = matrix->GetStorage();
+    auto rowBlockSize = storage->GetRowBlockSize();
+    auto colBlockSize = storage->GetColBlockSize();
+
+    // Matrix content is replaced, so split points are chosen again for written data
+    if (desc->IsParamSet(Descriptor::Param::BalancedBlocks)) {
+        auto rowsHost = matrixData->GetRows();
+        auto colsHost = matrixData->GetCols();
+        auto nvalsHost = matrixData->GetNvals();
+
+        std::vector<std::size_t> rowsCounts(nrows, 0);
+        std::vector<std::size_t> colsCounts(ncols, 0);
+
+        for (std::size_t k = 0; k < nvalsHost; k++) {
+            CHECK_RAISE_ERROR(rowsHost[k] < nrows && colsHost[k] < ncols, InvalidArgument,
+                              "Entry (" << rowsHost[k] << "," << colsHost[k] << ") out of matrix bounds");
+            rowsCounts[rowsHost[k]] += 1;
+            colsCounts[colsHost[k]] += 1;
+        }
 
-    auto blocksCountInRow = math::GetBlocksCount(nrows, blockSize);
-    auto blocksCountInCol = math::GetBlocksCount(ncols, blockSize);
+        // Square matrix gets the same rows and columns split, so it can be multiplied by itself and transposed one
+        if (nrows == ncols && rowBlockSize == colBlockSize) {
+            for (std::size_t k = 0; k < nrows; k++)
+                rowsCounts[k] += colsCounts[k];
+
+            auto partition = BlockPartition::Balanced(rowsCounts, rowBlockSize);
+            storage->SetPartition(partition, partition);
+        } else
+            storage->SetPartition(BlockPartition::Balanced(rowsCounts, rowBlockSize),
+                                  BlockPartition::Balanced(colsCounts, colBlockSize));
+    } else if (!storage->IsUniformPartition())
+        storage->SetPartition(BlockPartition::Uniform(nrows, rowBlockSize),
+                              BlockPartition::Uniform(ncols, colBlockSize));
+
+    auto &rowPartition = storage->GetRowPartition();
+    auto &colPartition = storage->GetColPartition();
+    auto blocksCountInRow = rowPartition.GetBlocksCount();
+    auto blocksCountInCol = colPartition.GetBlocksCount();
+    auto blockedHint = desc->IsParamSet(Descriptor::Param::ValuesBlocked) && storage->IsUniformPartition();
     auto requiredDeviceCount = blocksCountInRow * blocksCountInCol;
     auto devicesIds = library->GetDeviceManager().FetchDevices(requiredDeviceCount, node);
 
     for (std::size_t i = 0; i < blocksCountInRow; i++) {
         for (std::size_t j = 0; j < blocksCountInCol; j++) {
             auto deviceId = devicesIds[i * blocksCountInCol + j];
-            builder.Emplace([=]() {
+            builder.Emplace("block (" + std::to_string(i) + "," + std::to_string(j) + ")", [=]() {
                 using namespace boost;
 
                 compute::context ctx = library->GetContext();
@@ -75,11 +111,11 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                 QueueFinisher finisher(queue);
 
                 auto blockIndex = MatrixStorage::Index{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
-                auto blockNrows = math::GetBlockActualSize(i, nrows, blockSize);
-                auto blockNcols = math::GetBlockActualSize(j, ncols, blockSize);
+                auto blockNrows = rowPartition.GetBlockSize(i);
+                auto blockNcols = colPartition.GetBlockSize(j);
 
-                auto firstRow = static_cast<unsigned int>(i * blockSize);
-                auto firstCol = static_cast<unsigned int>(j * blockSize);
+                auto firstRow = rowPartition.GetBlockOffset(i);
+                auto firstCol = colPartition.GetBlockOffset(j);
                 auto lastRow = firstRow + static_cast<unsigned int>(blockNrows);
                 auto lastCol = firstCol + static_cast<unsigned int>(blockNcols);
 
@@ -91,10 +127,42 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                 assert(rowsHost);
                 assert(colsHost);
 
+                // Range of host entries to scan, whole data by default
+                std::size_t firstHost = 0;
+                std::size_t lastHost = nvalsHost;
+
+                // If entries grouped by blocks, find block range with binary search
+                if (blockedHint) {
+                    auto blockOf = [=](std::size_t k) {
+                        return MatrixStorage::Index{static_cast<unsigned int>(rowsHost[k] / rowPartition.GetUniformBlockSize()),
+                                                    static_cast<unsigned int>(colsHost[k] / colPartition.GetUniformBlockSize())};
+                    };
+
+                    std::size_t low = 0, high = nvalsHost;
+                    while (low < high) {
+                        auto mid = low + (high - low) / 2;
+                        if (blockOf(mid) < blockIndex)
+                            low = mid + 1;
+                        else
+                            high = mid;
+                    }
+                    firstHost = low;
+
+                    high = nvalsHost;
+                    while (low < high) {
+                        auto mid = low + (high - low) / 2;
+                        if (blockIndex < blockOf(mid))
+                            high = mid;
+                        else
+                            low = mid + 1;
+                    }
+                    lastHost = low;
+                }
+
                 // Count number of nnz values to store in this block
                 std::size_t blockNvals = 0;
                 {
-                    for (std::size_t k = 0; k < nvalsHost; k++) {
+                    for (std::size_t k = firstHost; k < lastHost; k++) {
                         auto rowIdx = rowsHost[k];
                         auto colIdx = colsHost[k];
 
@@ -107,8 +175,6 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                 SPDLOG_LOGGER_TRACE(logger, "Process matrix block ({},{}) size=({},{}) ranges=([{}..{}),[{}..{})) nvals={}",
                                     i, j, blockNrows, blockNcols, firstRow, lastRow, firstCol, lastCol, blockNvals);
 
-                auto storage = matrix->GetStorage();
-
                 // If no values, leave block empty and exit
                 if (!blockNvals) {
                     storage->RemoveBlock(blockIndex);
@@ -140,7 +206,7 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                 {
                     using namespace boost;
 
-                    for (std::size_t k = 0; k < nvalsHost; k++) {
+                    for (std::size_t k = firstHost; k < lastHost; k++) {
                         auto rowIdx = rowsHost[k];
                         auto colIdx = colsHost[k];
 
@@ -181,7 +247,7 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                 if (!desc->IsParamSet(Descriptor::Param::NoDuplicates) && blockNvals > 1) {
                     // Use this mask to find unique elements
                     // NOTE: unique has 1, otherwise 0
-                    compute::vector<unsigned int> mask(blockNvals + 1, ctx);
+                    compute::vector<unsigned int> mask(blockNvals, ctx);
                     mask.begin().write(1u, queue);
 
                     BOOST_COMPUTE_CLOSURE(
@@ -201,12 +267,9 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                                        findUnique,
                                        queue);
 
-                    // Define write offsets (where to write value in result buffer) for each unique value
-                    compute::vector<unsigned int> offsets(mask.size(), ctx);
-                    compute::exclusive_scan(mask.begin(), mask.end(), offsets.begin(), 0, queue);
-
-                    // Count number of unique values to allocate storage
-                    std::size_t resultNvals = (offsets.end() - 1).read(queue);
+                    // Collect indices of unique entries in order, count them to allocate storage
+                    compute::vector<unsigned int> unique(ctx);
+                    std::size_t resultNvals = Compact(mask.begin(), mask.end(), unique, queue);
 
                     // Allocate new buffers
                     compute::vector<unsigned int> newRows(resultNvals, ctx);
@@ -214,37 +277,13 @@ void spla::MatrixDataWrite::Process(std::size_t nodeIdx, const spla::Expression
                     compute::vector<unsigned char> newVals(ctx);
 
                     // Copy indices
-                    BOOST_COMPUTE_CLOSURE(
-                            void, copyIndices, (unsigned int i), (mask, offsets, newRows, newCols, blockRows, blockCols), {
-                                if (mask[i]) {
-                                    const uint offset = offsets[i];
-                                    newRows[offset] = blockRows[i];
-                                    newCols[offset] = blockCols[i];
-                                }
-                            });
-                    compute::for_each_n(compute::counting_iterator<unsigned int>(0),
-                                        blockNvals,
-                                        copyIndices,
-                                        queue);
+                    compute::gather(unique.begin(), unique.end(), blockRows.begin(), newRows.begin(), queue);
+                    compute::gather(unique.begin(), unique.end(), blockCols.begin(), newCols.begin(), queue);
 
                     // Copy values
                     if (typeHasValues) {
                         newVals.resize(resultNvals * byteSize, queue);
-
-                        BOOST_COMPUTE_CLOSURE(void, copyValues, (unsigned int i), (mask, offsets, newVals, blockVals, byteSize), {
-                            if (mask[i]) {
-                                const size_t offset = offsets[i];
-                                const size_t dst = byteSize * offset;
-                                const size_t src = byteSize * i;
-                                for (size_t k = 0; k < byteSize; k++) {
-                                    newVals[dst + k] = blockVals[src + k];
-                                }
-                            }
-                        });
-                        compute::for_each_n(compute::counting_iterator<unsigned int>(0),
-                                            blockNvals,
-                                            copyValues,
-                                            queue);
+                        Gather(unique, blockVals, newVals, byteSize, queue);
                     }
 
                     SPDLOG_LOGGER_TRACE(logger, "Reduce duplicates block ({},{}) entries old={} new={}",
@@ -53,22 +53,31 @@ void spla::MatrixEWiseAdd::Process(std::size_t nodeIdx, const spla::Expression &
     assert(b.IsNotNull());
     assert(desc.IsNotNull());
 
+    // Blocks are added pairwise, so b and mask blocks are remapped onto blocks of a, if split differently;
+    // w may be b or mask itself, so they are read from clones, which keep blocks while w is resplit
+    auto rowPartition = a->GetStorage()->GetRowPartition();
+    auto colPartition = a->GetStorage()->GetColPartition();
+    auto bStorage = b->GetStorage()->Clone();
+    auto maskStorage = mask.IsNotNull() ? mask->GetStorage()->Clone() : RefPtr<MatrixStorage>{};
+
+    w->GetStorage()->SetPartition(rowPartition, colPartition);
+
     std::size_t requiredDeviceCount = w->GetStorage()->GetNblockRows() * w->GetStorage()->GetNblockCols();
     auto deviceIds = library->GetDeviceManager().FetchDevices(requiredDeviceCount, node);
 
     for (std::size_t i = 0; i < w->GetStorage()->GetNblockRows(); i++) {
         for (std::size_t j = 0; j < w->GetStorage()->GetNblockCols(); j++) {
             auto deviceId = deviceIds[i * w->GetStorage()->GetNblockCols() + j];
-            builder.Emplace([=]() {
+            builder.Emplace("block (" + std::to_string(i) + "," + std::to_string(j) + ")", [=]() {
                 auto blockIndex = MatrixStorage::Index{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
                 ParamsMatrixEWiseAdd params;
                 params.desc = desc;
                 params.deviceId = deviceId;
                 params.hasMask = mask.IsNotNull();
-                params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(blockIndex) : RefPtr<MatrixBlock>{};
+                params.mask = mask.IsNotNull() ? maskStorage->GetBlock(rowPartition, colPartition, blockIndex, deviceId) : RefPtr<MatrixBlock>{};
                 params.op = op;
-                params.a = a->GetStorage()->GetBlock(blockIndex);
-                params.b = b->GetStorage()->GetBlock(blockIndex);
+                params.a = a->GetStorage()->GetBlock(blockIndex, deviceId);
+                params.b = bStorage->GetBlock(rowPartition, colPartition, blockIndex, deviceId);
                 params.type = w->GetType();
                 library->GetAlgoManager()->Dispatch(Algorithm::Type::MatrixEWiseAdd, params);
 
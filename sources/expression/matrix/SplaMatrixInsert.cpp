@@ -0,0 +1,158 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <boost/compute.hpp>
+#include <compute/SplaGather.hpp>
+#include <compute/SplaMaskByKey.hpp>
+#include <compute/SplaMergeByKey.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <expression/matrix/SplaMatrixBatch.hpp>
+#include <expression/matrix/SplaMatrixInsert.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <memory>
+
+bool spla::MatrixInsert::Select(std::size_t nodeIdx, const spla::Expression &expression) {
+    return true;
+}
+
+void spla::MatrixInsert::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    auto &nodes = expression.GetNodes();
+    auto node = nodes[nodeIdx];
+    auto library = expression.GetLibrary().GetPrivatePtr();
+    auto logger = library->GetLogger();
+
+    auto matrix = node->GetArg(0).Cast<Matrix>();
+    auto matrixData = node->GetArg(1).Cast<DataMatrix>();
+    auto desc = node->GetDescriptor();
+
+    assert(matrix.IsNotNull());
+    assert(matrixData.IsNotNull());
+    assert(desc.IsNotNull());
+
+    auto type = matrix->GetType();
+    auto byteSize = type->GetByteSize();
+    auto typeHasValues = type->HasValues();
+    auto storage = matrix->GetStorage();
+
+    // Split batch on host, so only touched blocks are updated
+    auto batch = std::make_shared<std::vector<MatrixBatchBlock>>(
+            SplitMatrixBatch(*matrixData, *desc, storage->GetRowPartition(), storage->GetColPartition(), typeHasValues ? byteSize : 0));
+    auto devicesIds = library->GetDeviceManager().FetchDevices(batch->size(), node);
+
+    for (std::size_t k = 0; k < batch->size(); k++) {
+        auto deviceId = devicesIds[k];
+        auto &blockIndex = (*batch)[k].index;
+
+        builder.Emplace("block (" + std::to_string(blockIndex.first) + "," + std::to_string(blockIndex.second) + ")", [=]() {
+            using namespace boost;
+
+            compute::context ctx = library->GetContext();
+            compute::device device = library->GetDeviceManager().GetDevice(deviceId);
+            compute::command_queue queue(ctx, device);
+            QueueFinisher finisher(queue);
+
+            auto &batchBlock = (*batch)[k];
+            auto blockNrows = storage->GetRowPartition().GetBlockSize(batchBlock.index.first);
+            auto blockNcols = storage->GetColPartition().GetBlockSize(batchBlock.index.second);
+            auto batchNvals = batchBlock.rows.size();
+
+            compute::vector<unsigned int> batchRows(batchBlock.rows.begin(), batchBlock.rows.end(), queue);
+            compute::vector<unsigned int> batchCols(batchBlock.cols.begin(), batchBlock.cols.end(), queue);
+            compute::vector<unsigned char> batchVals(batchBlock.vals.begin(), batchBlock.vals.end(), queue);
+
+            auto block = storage->GetBlock(batchBlock.index, deviceId).Cast<MatrixCOO>();
+
+            // Nothing stored yet, batch becomes the block
+            if (block.IsNull()) {
+                auto result = MatrixCOO::Make(blockNrows, blockNcols, batchNvals, std::move(batchRows), std::move(batchCols), std::move(batchVals));
+                storage->SetBlock(batchBlock.index, result.As<MatrixBlock>());
+                return;
+            }
+
+            // Keep stored entries, which are not overwritten by the batch
+            auto blockNvals = block->GetNvals();
+            compute::vector<unsigned int> keptRows(ctx);
+            compute::vector<unsigned int> keptCols(ctx);
+            compute::vector<unsigned int> keptPerm(ctx);
+            compute::vector<unsigned int> batchPerm(ctx);
+
+            if (typeHasValues) {
+                compute::vector<unsigned int> perm(blockNvals, ctx);
+                compute::copy_n(compute::make_counting_iterator(0), blockNvals, perm.begin(), queue);
+                MaskByPairKeys(batchRows, batchCols,
+                               block->GetRows(), block->GetCols(), perm,
+                               keptRows, keptCols, keptPerm,
+                               true,
+                               queue);
+
+                // NOTE: offset batch perm indices to preserve uniqueness
+                batchPerm.resize(batchNvals, queue);
+                compute::copy_n(compute::make_counting_iterator(static_cast<unsigned int>(blockNvals)), batchNvals, batchPerm.begin(), queue);
+            } else
+                MaskPairKeys(batchRows, batchCols,
+                             block->GetRows(), block->GetCols(),
+                             keptRows, keptCols,
+                             true,
+                             queue);
+
+            // Merge kept and batch entries, no duplicates possible after masking
+            auto mergeCount = keptRows.size() + batchNvals;
+            compute::vector<unsigned int> mergedRows(mergeCount, ctx);
+            compute::vector<unsigned int> mergedCols(mergeCount, ctx);
+            compute::vector<unsigned char> mergedVals(ctx);
+
+            if (typeHasValues) {
+                compute::vector<unsigned int> mergedPerm(mergeCount, ctx);
+                MergeByPairKeys(keptRows.begin(), keptRows.end(), keptCols.begin(),
+                                keptPerm.begin(),
+                                batchRows.begin(), batchRows.end(), batchCols.begin(),
+                                batchPerm.begin(),
+                                mergedRows.begin(), mergedCols.begin(), mergedPerm.begin(),
+                                queue);
+
+                mergedVals.resize(mergeCount * byteSize, queue);
+                GatherMerged(mergedPerm, block->GetVals(), batchVals, mergedVals, blockNvals, byteSize, queue);
+            } else
+                MergePairKeys(keptRows.begin(), keptRows.end(), keptCols.begin(),
+                              batchRows.begin(), batchRows.end(), batchCols.begin(),
+                              mergedRows.begin(), mergedCols.begin(),
+                              queue);
+
+            SPDLOG_LOGGER_TRACE(logger, "Insert block ({},{}) entries old={} batch={} new={}",
+                                batchBlock.index.first, batchBlock.index.second, blockNvals, batchNvals, mergeCount);
+
+            auto result = MatrixCOO::Make(blockNrows, blockNcols, mergeCount, std::move(mergedRows), std::move(mergedCols), std::move(mergedVals));
+            storage->SetBlock(batchBlock.index, result.As<MatrixBlock>());
+        });
+    }
+}
+
+spla::ExpressionNode::Operation spla::MatrixInsert::GetOperationType() const {
+    return ExpressionNode::Operation::MatrixInsert;
+}
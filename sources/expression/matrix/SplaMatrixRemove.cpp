@@ -0,0 +1,134 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <boost/compute.hpp>
+#include <compute/SplaGather.hpp>
+#include <compute/SplaMaskByKey.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaQueueFinisher.hpp>
+#include <expression/matrix/SplaMatrixBatch.hpp>
+#include <expression/matrix/SplaMatrixRemove.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <memory>
+
+bool spla::MatrixRemove::Select(std::size_t nodeIdx, const spla::Expression &expression) {
+    return true;
+}
+
+void spla::MatrixRemove::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    auto &nodes = expression.GetNodes();
+    auto node = nodes[nodeIdx];
+    auto library = expression.GetLibrary().GetPrivatePtr();
+    auto logger = library->GetLogger();
+
+    auto matrix = node->GetArg(0).Cast<Matrix>();
+    auto matrixData = node->GetArg(1).Cast<DataMatrix>();
+    auto desc = node->GetDescriptor();
+
+    assert(matrix.IsNotNull());
+    assert(matrixData.IsNotNull());
+    assert(desc.IsNotNull());
+
+    auto type = matrix->GetType();
+    auto byteSize = type->GetByteSize();
+    auto typeHasValues = type->HasValues();
+    auto storage = matrix->GetStorage();
+
+    // Split batch on host (values are ignored), so only touched blocks are updated
+    auto batch = std::make_shared<std::vector<MatrixBatchBlock>>(
+            SplitMatrixBatch(*matrixData, *desc, storage->GetRowPartition(), storage->GetColPartition(), 0));
+    auto devicesIds = library->GetDeviceManager().FetchDevices(batch->size(), node);
+
+    for (std::size_t k = 0; k < batch->size(); k++) {
+        auto deviceId = devicesIds[k];
+        auto &blockIndex = (*batch)[k].index;
+
+        builder.Emplace("block (" + std::to_string(blockIndex.first) + "," + std::to_string(blockIndex.second) + ")", [=]() {
+            using namespace boost;
+
+            auto &batchBlock = (*batch)[k];
+            auto block = storage->GetBlock(batchBlock.index, deviceId).Cast<MatrixCOO>();
+
+            // Nothing to remove
+            if (block.IsNull())
+                return;
+
+            compute::context ctx = library->GetContext();
+            compute::device device = library->GetDeviceManager().GetDevice(deviceId);
+            compute::command_queue queue(ctx, device);
+            QueueFinisher finisher(queue);
+
+            compute::vector<unsigned int> batchRows(batchBlock.rows.begin(), batchBlock.rows.end(), queue);
+            compute::vector<unsigned int> batchCols(batchBlock.cols.begin(), batchBlock.cols.end(), queue);
+
+            auto blockNvals = block->GetNvals();
+            compute::vector<unsigned int> resultRows(ctx);
+            compute::vector<unsigned int> resultCols(ctx);
+            compute::vector<unsigned char> resultVals(ctx);
+
+            if (typeHasValues) {
+                compute::vector<unsigned int> perm(blockNvals, ctx);
+                compute::vector<unsigned int> resultPerm(ctx);
+                compute::copy_n(compute::make_counting_iterator(0), blockNvals, perm.begin(), queue);
+                MaskByPairKeys(batchRows, batchCols,
+                               block->GetRows(), block->GetCols(), perm,
+                               resultRows, resultCols, resultPerm,
+                               true,
+                               queue);
+
+                resultVals.resize(resultPerm.size() * byteSize, queue);
+                Gather(resultPerm.begin(), resultPerm.end(), block->GetVals().begin(), resultVals.begin(), byteSize, queue);
+            } else
+                MaskPairKeys(batchRows, batchCols,
+                             block->GetRows(), block->GetCols(),
+                             resultRows, resultCols,
+                             true,
+                             queue);
+
+            auto resultNvals = resultRows.size();
+
+            SPDLOG_LOGGER_TRACE(logger, "Remove block ({},{}) entries old={} batch={} new={}",
+                                batchBlock.index.first, batchBlock.index.second, blockNvals, batchBlock.rows.size(), resultNvals);
+
+            if (resultNvals == blockNvals)
+                return;
+
+            if (resultNvals == 0) {
+                storage->RemoveBlock(batchBlock.index);
+                return;
+            }
+
+            auto result = MatrixCOO::Make(block->GetNrows(), block->GetNcols(), resultNvals, std::move(resultRows), std::move(resultCols), std::move(resultVals));
+            storage->SetBlock(batchBlock.index, result.As<MatrixBlock>());
+        });
+    }
+}
+
+spla::ExpressionNode::Operation spla::MatrixRemove::GetOperationType() const {
+    return ExpressionNode::Operation::MatrixRemove;
+}
@@ -56,20 +56,33 @@ void spla::MatrixTranspose::Process(std::size_t nodeIdx, const spla::Expression
     /** Handle case if new to accum(w, s) */
     auto tmp = w;
     auto applyAccum = desc->IsParamSet(Descriptor::Param::AccumResult);
+    // Transposed blocks are transposed blocks of a, so they have swapped partition of a
+    auto rowPartition = a->GetStorage()->GetColPartition();
+    auto colPartition = a->GetStorage()->GetRowPartition();
+    // Accumulated w keeps its partition, so transposed blocks are remapped onto it, if split differently
+    auto wRowPartition = applyAccum ? w->GetStorage()->GetRowPartition() : rowPartition;
+    auto wColPartition = applyAccum ? w->GetStorage()->GetColPartition() : colPartition;
+    auto samePartition = wRowPartition == rowPartition && wColPartition == colPartition;
     // Create temporary vector for assignment result
     if (applyAccum) tmp = Matrix::Make(w->GetNrows(), w->GetNcols(), w->GetType(), w->GetLibrary());
     // If no accum, clear result first
     if (!applyAccum) w->GetStorage()->Clear();
+    w->GetStorage()->SetPartition(wRowPartition, wColPartition);
+    tmp->GetStorage()->SetPartition(rowPartition, colPartition);
     // If assign is null, make default to keep new entries
     if (applyAccum && accum.IsNull()) accum = utils::MakeFunctionChooseSecond(w->GetType());
 
-    std::size_t requiredDeviceCount = w->GetStorage()->GetNblockRows() * w->GetStorage()->GetNblockCols();
-    auto deviceIds = library->GetDeviceManager().FetchDevices(requiredDeviceCount, node);
+    auto nBlockRows = rowPartition.GetBlocksCount();
+    auto nBlockCols = colPartition.GetBlocksCount();
+    auto deviceIds = library->GetDeviceManager().FetchDevices(nBlockRows * nBlockCols, node);
 
-    for (std::size_t i = 0; i < w->GetStorage()->GetNblockRows(); i++) {
-        for (std::size_t j = 0; j < w->GetStorage()->GetNblockCols(); j++) {
-            auto deviceId = deviceIds[i * w->GetStorage()->GetNblockCols() + j];
-            auto taskTranspose = builder.Emplace([=]() {
+    std::vector<tf::Task> transposeTasks;
+    transposeTasks.reserve(nBlockRows * nBlockCols);
+
+    for (std::size_t i = 0; i < nBlockRows; i++) {
+        for (std::size_t j = 0; j < nBlockCols; j++) {
+            auto deviceId = deviceIds[i * nBlockCols + j];
+            auto taskTranspose = builder.Emplace("block (" + std::to_string(i) + "," + std::to_string(j) + ")", [=]() {
                 MatrixStorage::Index aIndex{static_cast<unsigned int>(j), static_cast<unsigned int>(i)};
                 MatrixStorage::Index wIndex{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
 
@@ -77,8 +90,8 @@ void spla::MatrixTranspose::Process(std::size_t nodeIdx, const spla::Expression
                 params.desc = desc;
                 params.deviceId = deviceId;
                 params.hasMask = mask.IsNotNull();
-                params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(wIndex) : RefPtr<MatrixBlock>{};
-                params.a = a->GetStorage()->GetBlock(aIndex);
+                params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(rowPartition, colPartition, wIndex, deviceId) : RefPtr<MatrixBlock>{};
+                params.a = a->GetStorage()->GetBlock(aIndex, deviceId);
                 params.type = w->GetType();
                 library->GetAlgoManager()->Dispatch(Algorithm::Type::Transpose, params);
 
@@ -89,28 +102,48 @@ void spla::MatrixTranspose::Process(std::size_t nodeIdx, const spla::Expression
                 }
             });
 
-            if (applyAccum) {
-                auto taskAccum = builder.Emplace([=]() {
-                    MatrixStorage::Index wIndex{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
-
-                    ParamsMatrixEWiseAdd params;
-                    params.desc = desc;
-                    params.deviceId = deviceId;
-                    params.a = w->GetStorage()->GetBlock(wIndex);
-                    params.b = tmp->GetStorage()->GetBlock(wIndex);
-                    params.op = accum;
-                    params.type = w->GetType();
-                    library->GetAlgoManager()->Dispatch(Algorithm::Type::MatrixEWiseAdd, params);
-
-                    if (params.w.IsNotNull()) {
-                        w->GetStorage()->SetBlock(wIndex, params.w);
-                        SPDLOG_LOGGER_TRACE(logger, "Accum block=({},{}) nnz={}",
-                                            wIndex.first, wIndex.second, params.w->GetNvals());
-                    }
-                });
-
-                // Transpose matrix and then accum results
-                taskTranspose.precede(taskAccum);
+            transposeTasks.push_back(taskTranspose);
+        }
+    }
+
+    if (!applyAccum)
+        return;
+
+    auto nBlockRowsW = wRowPartition.GetBlocksCount();
+    auto nBlockColsW = wColPartition.GetBlocksCount();
+    auto accumDeviceIds = samePartition ? deviceIds : library->GetDeviceManager().FetchDevices(nBlockRowsW * nBlockColsW, node);
+
+    for (std::size_t i = 0; i < nBlockRowsW; i++) {
+        for (std::size_t j = 0; j < nBlockColsW; j++) {
+            auto deviceId = accumDeviceIds[i * nBlockColsW + j];
+            auto taskAccum = builder.Emplace("accum (" + std::to_string(i) + "," + std::to_string(j) + ")", [=]() {
+                MatrixStorage::Index wIndex{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
+
+                ParamsMatrixEWiseAdd params;
+                params.desc = desc;
+                params.deviceId = deviceId;
+                params.a = w->GetStorage()->GetBlock(wIndex, deviceId);
+                params.b = tmp->GetStorage()->GetBlock(wRowPartition, wColPartition, wIndex, deviceId);
+                params.op = accum;
+                params.type = w->GetType();
+                library->GetAlgoManager()->Dispatch(Algorithm::Type::MatrixEWiseAdd, params);
+
+                if (params.w.IsNotNull()) {
+                    w->GetStorage()->SetBlock(wIndex, params.w);
+                    SPDLOG_LOGGER_TRACE(logger, "Accum block=({},{}) nnz={}",
+                                        wIndex.first, wIndex.second, params.w->GetNvals());
+                }
+            });
+
+            // Transpose matrix and then accum results of transposed blocks, which intersect w block
+            auto rowBegin = wRowPartition.GetBlockOffset(i);
+            auto rowEnd = rowBegin + wRowPartition.GetBlockSize(i);
+            auto colBegin = wColPartition.GetBlockOffset(j);
+            auto colEnd = colBegin + wColPartition.GetBlockSize(j);
+
+            for (auto k = rowPartition.GetBlockIndex(rowBegin); k <= rowPartition.GetBlockIndex(rowEnd - 1); k++) {
+                for (auto l = colPartition.GetBlockIndex(colBegin); l <= colPartition.GetBlockIndex(colEnd - 1); l++)
+                    transposeTasks[k * nBlockCols + l].precede(taskAccum);
             }
         }
     }
@@ -27,37 +27,77 @@
 
 #include <algo/SplaAlgorithmManager.hpp>
 #include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaMath.hpp>
+#include <core/SplaQueueFinisher.hpp>
 #include <expression/prod/SplaMxM.hpp>
+#include <storage/SplaMatrixReblock.hpp>
 #include <storage/SplaMatrixStorage.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+
+#include <algorithm>
+#include <limits>
 
 namespace spla {
     namespace {
-        /** Utility to fetch mask block from entry map */
-        inline RefPtr<MatrixBlock> GetMaskBlock(MatrixStorage::EntryMap &map, const MatrixStorage::Index &idx) {
-            auto found = map.find(idx);
-            return found != map.end() ? found->second : RefPtr<MatrixBlock>{};
-        }
+        /** Non empty result of a[i,k] x b[k,j] product or of its rows range part */
+        struct ProductResult {
+            std::size_t product;
+            std::size_t part;
+            RefPtr<MatrixBlock> block;
+        };
 
-        /** Used to aggregate non empty results of a[i,j] x b[k,j] products for each (i,j) entry */
+        /** Used to aggregate non empty results of a[i,k] x b[k,j] products for each non-empty (i,j) entry */
         class ProductsResults {
         public:
-            ProductsResults(std::size_t m, std::size_t n) : mN(n), mBlocks(m * n) {}
+            explicit ProductsResults(std::size_t n) : mBlocks(n) {}
 
-            void AddBlock(std::size_t i, std::size_t j, const RefPtr<MatrixBlock> &block) {
+            void AddBlock(std::size_t m, ProductResult result) {
                 std::lock_guard<std::mutex> lockGuard(mMutex);
-                mBlocks[i * mN + j].push_back(block);
+                mBlocks[m].push_back(std::move(result));
             }
 
-            void GetBlocks(std::size_t i, std::size_t j, std::vector<RefPtr<MatrixBlock>> &blocks) {
+            void GetBlocks(std::size_t m, std::vector<ProductResult> &blocks) {
                 std::lock_guard<std::mutex> lockGuard(mMutex);
-                blocks = mBlocks[i * mN + j];
+                blocks = mBlocks[m];
             }
 
         private:
-            std::size_t mN;
-            std::vector<std::vector<RefPtr<MatrixBlock>>> mBlocks;
+            std::vector<std::vector<ProductResult>> mBlocks;
             mutable std::mutex mMutex;
         };
+
+        /** Concatenate results of disjoint rows ranges of the same product, given in rows order */
+        RefPtr<MatrixBlock> ConcatenateParts(const std::vector<RefPtr<MatrixBlock>> &parts, std::size_t byteSize,
+                                             const boost::compute::context &ctx, boost::compute::command_queue &queue) {
+            using namespace boost;
+
+            if (parts.size() == 1)
+                return parts.front();
+
+            std::size_t nvals = 0;
+            for (auto &part : parts)
+                nvals += part->GetNvals();
+
+            compute::vector<unsigned int> rows(nvals, ctx);
+            compute::vector<unsigned int> cols(nvals, ctx);
+            compute::vector<unsigned char> vals(nvals * byteSize, ctx);
+
+            std::ptrdiff_t offset = 0;
+            for (auto &part : parts) {
+                auto coo = part.Cast<MatrixCOO>();
+                assert(coo.IsNotNull());
+
+                compute::copy(coo->GetRows().begin(), coo->GetRows().end(), rows.begin() + offset, queue);
+                compute::copy(coo->GetCols().begin(), coo->GetCols().end(), cols.begin() + offset, queue);
+                if (byteSize)
+                    compute::copy(coo->GetVals().begin(), coo->GetVals().end(), vals.begin() + offset * static_cast<std::ptrdiff_t>(byteSize), queue);
+
+                offset += static_cast<std::ptrdiff_t>(coo->GetNvals());
+            }
+
+            auto &first = parts.front();
+            return MatrixCOO::Make(first->GetNrows(), first->GetNcols(), nvals, std::move(rows), std::move(cols), std::move(vals)).As<MatrixBlock>();
+        }
     }// namespace
 }// namespace spla
 
@@ -85,60 +125,93 @@ void spla::MxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
     assert(b.IsNotNull());
     assert(desc.IsNotNull());
 
-    // Clear w, so by default empty result returned
-    w->GetStorage()->Clear();
-
     auto ta = a->GetType();
     auto tb = b->GetType();
     auto tw = w->GetType();
     auto hasMask = mask.IsNotNull();
     auto &aStorage = a->GetStorage();
-    auto &bStorage = b->GetStorage();
+    auto &rowPartition = aStorage->GetRowPartition();
+    auto &colPartition = b->GetStorage()->GetColPartition();
+
+    // Blocks a[i,k] x b[k,j] are multiplied, so b rows are remapped onto a columns blocks and mask onto
+    // blocks of the product, if split differently; remapped blocks are made once on a single device
+    auto remapDeviceId = deviceMan.FetchDevices(1, node).front();
+    auto bStorage = ReblockStorage(b->GetStorage(), aStorage->GetColPartition(), colPartition, remapDeviceId, node->GetLibrary());
+    auto maskStorage = hasMask ? ReblockStorage(mask->GetStorage(), rowPartition, colPartition, remapDeviceId, node->GetLibrary()) : RefPtr<MatrixStorage>{};
+
+    // Clear w, so by default empty result returned
+    w->GetStorage()->Clear();
+    w->GetStorage()->SetPartition(rowPartition, colPartition);
 
     // Query block storage dimensions for matrices
-    std::size_t nBlockM = aStorage->GetNblockRows(),
-                nBlockK = aStorage->GetNblockCols(),
+    std::size_t nBlockK = aStorage->GetNblockCols(),
                 nBlockN = bStorage->GetNblockCols();
 
     using Index = MatrixStorage::Index;
     struct ToProcess {
         Index a;
         Index b;
+        MatrixStorage::BlockInfo aBlock;
+        MatrixStorage::BlockInfo bBlock;
+        std::size_t parts = 1;
+    };
+    struct ToMerge {
+        Index w;
+        std::vector<ToProcess> products;
     };
 
-    // Fetch blocks and store locally
-    MatrixStorage::EntryMap aBlocks;
-    MatrixStorage::EntryMap bBlocks;
-    MatrixStorage::EntryMap maskBlocks;
-    aStorage->GetBlocks(aBlocks);
-    bStorage->GetBlocks(bBlocks);
+    // Query blocks shapes; blocks themselves are fetched by product tasks on their devices
+    MatrixStorage::BlockInfoMap aBlocks;
+    MatrixStorage::BlockInfoMap bBlocks;
+    aStorage->GetBlocksInfo(aBlocks);
+    bStorage->GetBlocksInfo(bBlocks);
 
-    if (hasMask)
-        // If mask empty => does not apply mask at all
-        mask->GetStorage()->GetBlocks(maskBlocks);
+    // Enumerate block products a[i,k] x b[k,j] by intersection of non-empty blocks:
+    // for each block a[i,k] visit non-empty blocks of b block row k (Gustavson order),
+    // so planning takes time proportional to the number of products, not to the blocks grid
+    auto aIndex = aStorage->GetBlockIndex();
+    auto bIndex = bStorage->GetBlockIndex();
 
-    // Determine number of block products and product pairs for each result block
+    const auto noSlot = std::numeric_limits<std::size_t>::max();
     std::size_t totalProducts = 0;
-    std::size_t totalBlocks = 0;
-    std::vector<std::vector<ToProcess>> blockProducts(nBlockM * nBlockN);
-    for (std::size_t i = 0; i < nBlockM; i++) {
-        for (std::size_t j = 0; j < nBlockN; j++) {
-            auto &toProcess = blockProducts[i * nBlockN + j];
-            for (std::size_t k = 0; k < nBlockK; k++) {
-                Index aIndex{static_cast<unsigned int>(i), static_cast<unsigned int>(k)};
-                Index bIndex{static_cast<unsigned int>(k), static_cast<unsigned int>(j)};
-                auto aBlock = aBlocks.find(aIndex);
-                auto bBlock = bBlocks.find(bIndex);
+    std::vector<ToMerge> blockProducts;
+    std::vector<std::size_t> slots(nBlockN, noSlot);
+
+    for (std::size_t r = 0; r < aIndex->rows.size(); r++) {
+        auto i = aIndex->rows[r];
+        auto firstMerge = blockProducts.size();
+
+        for (auto ak = aIndex->offsets[r]; ak < aIndex->offsets[r + 1]; ak++) {
+            auto k = aIndex->cols[ak];
+            auto aBlock = aBlocks.find(Index{i, k});
+            auto bRow = bIndex->GetRow(k);
+
+            if (aBlock == aBlocks.end())
+                continue;
+
+            for (auto bk = bRow.first; bk < bRow.second; bk++) {
+                auto j = bIndex->cols[bk];
+                auto bBlock = bBlocks.find(Index{k, j});
 
                 // If has something to multiply in both a[i,k] and b[k,j] blocks
-                if (aBlock != aBlocks.end() && bBlock != bBlocks.end()) {
-                    toProcess.push_back(ToProcess{aIndex, bIndex});
-                    totalProducts += 1;
+                if (bBlock == bBlocks.end())
+                    continue;
+
+                if (slots[j] == noSlot) {
+                    slots[j] = blockProducts.size();
+                    blockProducts.push_back(ToMerge{Index{i, j}, {}});
                 }
+
+                blockProducts[slots[j]].products.push_back(ToProcess{aBlock->first, bBlock->first, aBlock->second, bBlock->second});
+                totalProducts += 1;
             }
-            // Count number of potentially not empty final w[i,j] blocks count
-            totalBlocks += toProcess.empty() ? 0 : 1;
         }
+
+        // Keep w[i,j] blocks of the row in column order and reset slots for the next row
+        std::sort(blockProducts.begin() + static_cast<std::ptrdiff_t>(firstMerge), blockProducts.end(),
+                  [](const ToMerge &x, const ToMerge &y) { return x.w.second < y.w.second; });
+        for (auto m = firstMerge; m < blockProducts.size(); m++)
+            slots[blockProducts[m].w.second] = noSlot;
     }
 
     // Edge case: if no products, return empty result
@@ -147,26 +220,76 @@ void spla::MxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
     }
 
     // Shared thread-safe storage to aggregate results of products
-    auto products = std::make_shared<ProductsResults>(nBlockM, nBlockN);
+    auto products = std::make_shared<ProductsResults>(blockProducts.size());
+
+    // Split heavy products into rows ranges of a block, so single dense block of skewed
+    // matrix is processed by several tasks in parallel instead of one long running task
+    auto splitThreshold = library->GetContextConfig().GetProductSplitThreshold();
+    auto maxParts = std::max<std::size_t>(2 * deviceMan.GetDevices().size(), 4);
+    std::size_t totalParts = 0;
+    for (auto &toMerge : blockProducts) {
+        for (auto &toProcess : toMerge.products) {
+            auto aNvals = toProcess.aBlock.nvals;
+            auto bNvals = toProcess.bBlock.nvals;
+            auto bNrows = std::max<std::size_t>(1, toProcess.bBlock.nrows);
+            auto flops = aNvals * bNvals / bNrows + aNvals;
+            toProcess.parts = math::GetSplitsCount(flops, splitThreshold, std::min(maxParts, toProcess.aBlock.nrows));
+            totalParts += toProcess.parts;
+        }
+    }
 
-    // Query required number of devices (strategy: device per product)
-    auto devicesForProducts = deviceMan.FetchDevices(totalProducts, node);
+    // Schedule products weighted by inputs nnz (strategy: device per product part)
+    // NOTE: products of w[i,j] are located in shared storage, so merge prefers their devices
+    auto productsOwner = deviceMan.NewLocationOwner();
+    std::vector<DeviceManager::Work> productsWork;
+    std::vector<std::size_t> mergeAmount(blockProducts.size(), 0);
+    productsWork.reserve(totalParts);
+    for (std::size_t m = 0; m < blockProducts.size(); m++) {
+        for (auto &toProcess : blockProducts[m].products) {
+            for (std::size_t part = 0; part < toProcess.parts; part++) {
+                DeviceManager::Work work;
+                work.amount = toProcess.aBlock.nvals / toProcess.parts + toProcess.bBlock.nvals;
+                work.inputs = {{aStorage->GetLocationOwner(), toProcess.a.first * nBlockK + toProcess.a.second},
+                               {bStorage->GetLocationOwner(), toProcess.b.first * nBlockN + toProcess.b.second}};
+                work.output = DeviceManager::Location{productsOwner, m};
+                mergeAmount[m] += work.amount;
+                productsWork.push_back(std::move(work));
+            }
+        }
+    }
 
-    // Dispatch tasks to compute a.block[i,k] x b.block[k,j] products
+    auto ticketsForProducts = deviceMan.Schedule(productsWork, node);
+
+    // Dispatch tasks to compute a.block[i,k] x b.block[k,j] products (or their rows ranges)
     std::size_t deviceToFetch = 0;
-    std::vector<std::vector<tf::Task>> blockProductsTasks(nBlockM * nBlockN);
-    for (std::size_t i = 0; i < nBlockM; i++) {
-        for (std::size_t j = 0; j < nBlockN; j++) {
-            auto &tasks = blockProductsTasks[i * nBlockN + j];
-            for (auto &toProcess : blockProducts[i * nBlockN + j]) {
-                auto deviceId = devicesForProducts[deviceToFetch];
-                auto aIdx = toProcess.a;
-                auto bIdx = toProcess.b;
-                auto aBlock = aBlocks.find(aIdx)->second;
-                auto bBlock = bBlocks.find(bIdx)->second;
-                auto maskBlock = GetMaskBlock(maskBlocks, Index{aIdx.first, bIdx.second});
-                auto task = builder.Emplace([=]() {
+    std::vector<std::vector<tf::Task>> blockProductsTasks(blockProducts.size());
+    for (std::size_t m = 0; m < blockProducts.size(); m++) {
+        auto &tasks = blockProductsTasks[m];
+        auto &toMerge = blockProducts[m];
+        for (std::size_t p = 0; p < toMerge.products.size(); p++) {
+            auto &toProcess = toMerge.products[p];
+            auto aIdx = toProcess.a;
+            auto bIdx = toProcess.b;
+            auto aNrows = toProcess.aBlock.nrows;
+            auto wIdx = toMerge.w;
+            auto parts = toProcess.parts;
+            auto taskName = "product (" + std::to_string(aIdx.first) + "," + std::to_string(aIdx.second) + ")x(" +
+                            std::to_string(bIdx.first) + "," + std::to_string(bIdx.second) + ")";
+
+            for (std::size_t part = 0; part < parts; part++) {
+                auto ticket = ticketsForProducts[deviceToFetch];
+                auto deviceId = ticket->GetDeviceId();
+                auto aBeginRow = aNrows * part / parts;
+                auto aEndRow = aNrows * (part + 1) / parts;
+                auto partName = parts > 1 ? taskName + " part " + std::to_string(part) : taskName;
+                auto task = builder.Emplace(partName, [=]() {
+                    // Fetch blocks only for the time of the product, so mapped blocks can be evicted after it
+                    auto aBlock = aStorage->GetBlock(aIdx, deviceId);
+                    auto bBlock = bStorage->GetBlock(bIdx, deviceId);
+                    // If mask empty => does not apply mask at all
+                    auto maskBlock = hasMask ? maskStorage->GetBlock(wIdx, deviceId) : RefPtr<MatrixBlock>{};
                     assert(aBlock->GetNcols() == bBlock->GetNrows());
+
                     ParamsMxM params;
                     params.desc = desc;
                     params.deviceId = deviceId;
@@ -179,14 +302,18 @@ void spla::MxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
                     params.ta = ta;
                     params.tb = tb;
                     params.tw = tw;
+                    params.aBeginRow = aBeginRow;
+                    params.aEndRow = aEndRow;
                     library->GetAlgoManager()->Dispatch(Algorithm::Type::MxM, params);
 
                     if (params.w.IsNotNull()) {
                         // If has not empty result, store it to sum later
-                        products->AddBlock(i, j, params.w);
-                        SPDLOG_LOGGER_TRACE(logger, "Blocks product ({},{})x({},{}) nnz={}",
-                                            aIdx.first, aIdx.second, bIdx.first, bIdx.second, params.w->GetNvals());
+                        products->AddBlock(m, ProductResult{p, part, params.w});
+                        SPDLOG_LOGGER_TRACE(logger, "Blocks product ({},{})x({},{}) part {}/{} nnz={}",
+                                            aIdx.first, aIdx.second, bIdx.first, bIdx.second, part, parts, params.w->GetNvals());
                     }
+
+                    ticket->Release();
                 });
                 deviceToFetch += 1;
                 tasks.push_back(std::move(task));
@@ -194,57 +321,92 @@ void spla::MxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
         }
     }
 
-    // Query required number of devices (strategy: device per not empty w[i,j])
-    auto devicesForFinalMerge = deviceMan.FetchDevices(totalBlocks, node);
+    // Schedule merges (strategy: device per not empty w[i,j])
+    std::vector<DeviceManager::Work> mergesWork;
+    mergesWork.reserve(blockProducts.size());
+    for (std::size_t m = 0; m < blockProducts.size(); m++) {
+        auto &index = blockProducts[m].w;
+        DeviceManager::Work work;
+        work.amount = mergeAmount[m];
+        work.inputs = {{productsOwner, m}};
+        work.output = DeviceManager::Location{w->GetStorage()->GetLocationOwner(), index.first * nBlockN + index.second};
+        mergesWork.push_back(std::move(work));
+    }
+
+    auto ticketsForFinalMerge = deviceMan.Schedule(mergesWork, node);
+
+    // Products locations are used only to schedule merges
+    deviceMan.ForgetLocations(productsOwner);
 
     // Finally, for each block w[i,j] we must aggregate intermediate
     // blocks multiplications results as a series of element-wise additions of blocks
-    deviceToFetch = 0;
-    for (std::size_t i = 0; i < nBlockM; i++) {
-        for (std::size_t j = 0; j < nBlockN; j++) {
-            auto &toProcess = blockProducts[i * nBlockN + j];
-            if (!toProcess.empty()) {
-                auto deviceId = devicesForFinalMerge[deviceToFetch];
-                auto task = builder.Emplace([=]() {
-                    std::vector<RefPtr<MatrixBlock>> blocks;
-                    products->GetBlocks(i, j, blocks);
-
-                    // Nothing to do, w[i,j] is empty
-                    if (blocks.empty())
-                        return;
-
-                    // Start to merge n blocks, number of merges n - 1
-                    auto block = blocks[0];
-                    for (std::size_t k = 1; k < blocks.size(); k++) {
-                        assert(block->GetNrows() == blocks[k]->GetNrows());
-                        assert(block->GetNcols() == blocks[k]->GetNcols());
-                        ParamsMatrixEWiseAdd params;
-                        params.desc = desc;
-                        params.deviceId = deviceId;
-                        params.op = add;
-                        params.a = block;
-                        params.b = blocks[k];
-                        params.type = tw;
-                        library->GetAlgoManager()->Dispatch(Algorithm::Type::MatrixEWiseAdd, params);
-
-                        // Store result for next iteration
-                        block = params.w;
-                    }
+    for (std::size_t m = 0; m < blockProducts.size(); m++) {
+        auto index = blockProducts[m].w;
+        auto ticket = ticketsForFinalMerge[m];
+        auto deviceId = ticket->GetDeviceId();
+        auto taskName = "merge (" + std::to_string(index.first) + "," + std::to_string(index.second) + ")";
+        auto task = builder.Emplace(taskName, [=]() {
+            using namespace boost;
+
+            std::vector<ProductResult> results;
+            products->GetBlocks(m, results);
+
+            // Nothing to do, w[i,j] is empty
+            if (results.empty()) {
+                ticket->Release();
+                return;
+            }
 
-                    // Store final result
-                    Index index{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
-                    w->GetStorage()->SetBlock(index, block);
-                });
+            // Parts of the same product have disjoint rows ranges, so they are concatenated in rows order
+            std::sort(results.begin(), results.end(), [](const ProductResult &x, const ProductResult &y) {
+                return std::make_pair(x.product, x.part) < std::make_pair(y.product, y.part);
+            });
 
-                // Setup dependencies
-                // Start aggregation as soon as all sums are computed for w[i,j]
-                auto &deps = blockProductsTasks[i * nBlockN + j];
-                for (auto &parent : deps)
-                    parent.precede(task);
+            std::vector<RefPtr<MatrixBlock>> blocks;
+            {
+                compute::context ctx = library->GetContext();
+                compute::command_queue queue(ctx, library->GetDeviceManager().GetDevice(deviceId));
+                QueueFinisher finisher(queue);
 
-                deviceToFetch += 1;
+                std::vector<RefPtr<MatrixBlock>> parts;
+                for (std::size_t r = 0; r < results.size(); r++) {
+                    parts.push_back(results[r].block);
+
+                    if (r + 1 == results.size() || results[r + 1].product != results[r].product) {
+                        blocks.push_back(ConcatenateParts(parts, tw->GetByteSize(), ctx, queue));
+                        parts.clear();
+                    }
+                }
             }
-        }
+
+            // Start to merge n blocks, number of merges n - 1
+            auto block = blocks[0];
+            for (std::size_t k = 1; k < blocks.size(); k++) {
+                assert(block->GetNrows() == blocks[k]->GetNrows());
+                assert(block->GetNcols() == blocks[k]->GetNcols());
+                ParamsMatrixEWiseAdd params;
+                params.desc = desc;
+                params.deviceId = deviceId;
+                params.op = add;
+                params.a = block;
+                params.b = blocks[k];
+                params.type = tw;
+                library->GetAlgoManager()->Dispatch(Algorithm::Type::MatrixEWiseAdd, params);
+
+                // Store result for next iteration
+                block = params.w;
+            }
+
+            // Store final result
+            w->GetStorage()->SetBlock(index, block);
+
+            ticket->Release();
+        });
+
+        // Setup dependencies
+        // Start aggregation as soon as all sums are computed for w[i,j]
+        for (auto &parent : blockProductsTasks[m])
+            parent.precede(task);
     }
 }
 
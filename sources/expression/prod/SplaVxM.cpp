@@ -27,8 +27,10 @@
 
 #include <algo/SplaAlgorithmManager.hpp>
 #include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaMath.hpp>
 #include <expression/prod/SplaVxM.hpp>
 #include <storage/SplaMatrixStorage.hpp>
+#include <storage/SplaVectorReblock.hpp>
 #include <storage/SplaVectorStorage.hpp>
 
 namespace spla {
@@ -66,6 +68,12 @@ bool spla::VxM::Select(std::size_t nodeIdx, const spla::Expression &expression)
 }
 
 void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    std::vector<std::vector<tf::Task>> blockTasks;
+    Process(nodeIdx, expression, builder, blockTasks);
+}
+
+void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder,
+                        std::vector<std::vector<tf::Task>> &blockTasks) {
     auto &nodes = expression.GetNodes();
     auto &node = nodes[nodeIdx];
     auto library = node->GetLibrary().GetPrivatePtr();
@@ -85,60 +93,95 @@ void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
     assert(b.IsNotNull());
     assert(desc.IsNotNull());
 
-    // Clear w, so by default empty result returned
-    w->GetStorage()->Clear();
-
     auto ta = a->GetType();
     auto tb = b->GetType();
     auto tw = w->GetType();
     auto hasMask = mask.IsNotNull();
     auto &aStorage = a->GetStorage();
     auto &bStorage = b->GetStorage();
+    auto &wStorage = w->GetStorage();
+    auto &rowPartition = bStorage->GetRowPartition();
+    auto &colPartition = bStorage->GetColPartition();
+
+    // Result is split as columns of b; clear w, so by default empty result returned
+    wStorage->SetBlockSize(bStorage->GetColBlockSize());
+    wStorage->Clear();
+
+    // Vectors are always split into equally sized blocks, while b may be split at balanced points;
+    // then a and mask blocks are remapped onto b blocks, and products are remapped onto w blocks
+    auto remapResult = wStorage->GetPartition() != colPartition;
 
     // Query block storage dimensions for vectors and matrix
-    std::size_t nBlockM = aStorage->GetNblockRows(),
-                nBlockN = bStorage->GetNblockCols();
+    std::size_t nBlockM = bStorage->GetNblockRows(),
+                nBlockN = bStorage->GetNblockCols(),
+                nBlockW = wStorage->GetNblockRows();
 
     using IndexV = VectorStorage::Index;
     using IndexM = MatrixStorage::Index;
     struct ToProcess {
         IndexV a;
         IndexM b;
+        std::size_t parts = 1;
     };
 
     // Fetch blocks and store locally
     VectorStorage::EntryMap aBlocks;
-    MatrixStorage::EntryMap bBlocks;
+    MatrixStorage::BlockInfoMap bBlocks;
     VectorStorage::EntryMap maskBlocks;
-    aStorage->GetBlocks(aBlocks);
-    bStorage->GetBlocks(bBlocks);
+    bStorage->GetBlocksInfo(bBlocks);
+
+    // Remapped blocks are made once on a single device, while tasks are composed
+    auto remapDeviceId = deviceMan.FetchDevices(1, node).front();
+    auto fetchBlocks = [&](const RefPtr<VectorStorage> &storage, const BlockPartition &partition, VectorStorage::EntryMap &blocks) {
+        if (storage->GetPartition() == partition) {
+            storage->GetBlocks(blocks);
+            return;
+        }
+
+        for (std::size_t k = 0; k < partition.GetBlocksCount(); k++) {
+            IndexV index{static_cast<unsigned int>(k)};
+            auto block = storage->GetBlock(partition, index, remapDeviceId);
+            if (block.IsNotNull())
+                blocks.emplace(index, block);
+        }
+    };
+
+    fetchBlocks(aStorage, rowPartition, aBlocks);
 
     if (hasMask)
         // If mask empty => does not apply mask at all
-        mask->GetStorage()->GetBlocks(maskBlocks);
+        fetchBlocks(mask->GetStorage(), colPartition, maskBlocks);
 
-    // Determine number of block products and product pairs for each result block
+    // Determine number of block products and product pairs for each result block;
+    // for each non-empty a[i] only non-empty blocks of b block row i are visited
+    auto bBlockIndex = bStorage->GetBlockIndex();
     std::size_t totalProducts = 0;
     std::size_t totalBlocks = 0;
     std::vector<std::vector<ToProcess>> blockProducts(nBlockN);
-    for (std::size_t j = 0; j < nBlockN; j++) {
-        auto &toProcess = blockProducts[j];
-        for (std::size_t i = 0; i < nBlockM; i++) {
-            IndexV aIndex{static_cast<unsigned int>(i)};
-            IndexM bIndex{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
-            auto aBlock = aBlocks.find(aIndex);
-            auto bBlock = bBlocks.find(bIndex);
-
-            // If has something to multiply in both a[i,k] and b[k,j] blocks
-            if (aBlock != aBlocks.end() && bBlock != bBlocks.end()) {
+    for (std::size_t i = 0; i < nBlockM; i++) {
+        IndexV aIndex{static_cast<unsigned int>(i)};
+        auto bRow = bBlockIndex->GetRow(aIndex);
+
+        if (bRow.first == bRow.second || aBlocks.find(aIndex) == aBlocks.end())
+            continue;
+
+        for (auto k = bRow.first; k < bRow.second; k++) {
+            IndexM bIndex{aIndex, bBlockIndex->cols[k]};
+
+            // If has something to multiply in both a[i] and b[i,j] blocks
+            if (bBlocks.find(bIndex) != bBlocks.end()) {
+                auto &toProcess = blockProducts[bIndex.second];
+                // Count number of potentially not empty final w[j] blocks
+                totalBlocks += toProcess.empty() ? 1 : 0;
                 toProcess.push_back(ToProcess{aIndex, bIndex});
                 totalProducts += 1;
             }
         }
-        // Count number of potentially not empty final w[j] blocks
-        totalBlocks += toProcess.empty() ? 0 : 1;
     }
 
+    blockTasks.clear();
+    blockTasks.resize(nBlockW);
+
     // Edge case: if no products, return empty result
     if (totalProducts == 0) {
         return;
@@ -147,51 +190,121 @@ void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
     // Shared thread-safe storage to aggregate results of products
     auto products = std::make_shared<ProductsResults>(nBlockN);
 
-    // Query required number of devices (strategy: device per product)
-    auto devicesForProducts = deviceMan.FetchDevices(totalProducts, node);
+    // Split heavy products into rows ranges of b block; partial results overlap, so they are summed by merge
+    auto splitThreshold = library->GetContextConfig().GetProductSplitThreshold();
+    auto maxParts = std::max<std::size_t>(2 * deviceMan.GetDevices().size(), 4);
+    std::size_t totalParts = 0;
+    for (std::size_t j = 0; j < nBlockN; j++) {
+        for (auto &toProcess : blockProducts[j]) {
+            auto &aBlock = aBlocks.find(toProcess.a)->second;
+            auto &bBlock = bBlocks.find(toProcess.b)->second;
+            auto aNvals = aBlock->GetNvals();
+            auto bNrows = std::max<std::size_t>(1, bBlock.nrows);
+            auto flops = aNvals * bBlock.nvals / bNrows + aNvals;
+            toProcess.parts = math::GetSplitsCount(flops, splitThreshold, std::min(maxParts, bBlock.nrows));
+            totalParts += toProcess.parts;
+        }
+    }
+
+    // Schedule products weighted by inputs nnz (strategy: device per product part)
+    // NOTE: products of w[j] are located in shared storage, so merge prefers their devices
+    auto productsOwner = deviceMan.NewLocationOwner();
+    std::vector<DeviceManager::Work> productsWork;
+    std::vector<std::size_t> mergeAmount(nBlockN, 0);
+    productsWork.reserve(totalParts);
+    for (std::size_t j = 0; j < nBlockN; j++) {
+        for (auto &toProcess : blockProducts[j]) {
+            for (std::size_t part = 0; part < toProcess.parts; part++) {
+                DeviceManager::Work work;
+                work.amount = (aBlocks.find(toProcess.a)->second->GetNvals() + bBlocks.find(toProcess.b)->second.nvals) / toProcess.parts;
+                work.inputs = {{aStorage->GetLocationOwner(), toProcess.a},
+                               {bStorage->GetLocationOwner(), toProcess.b.first * nBlockN + toProcess.b.second}};
+                work.output = DeviceManager::Location{productsOwner, j};
+                mergeAmount[j] += work.amount;
+                productsWork.push_back(std::move(work));
+            }
+        }
+    }
+
+    auto ticketsForProducts = deviceMan.Schedule(productsWork, node);
 
-    // Dispatch tasks to compute a.block[i] x b.block[i,j] products
+    // Dispatch tasks to compute a.block[i] x b.block[i,j] products (or their rows ranges)
     std::size_t deviceToFetch = 0;
     std::vector<std::vector<tf::Task>> blockProductsTasks(nBlockN);
     for (std::size_t j = 0; j < nBlockN; j++) {
         auto &tasks = blockProductsTasks[j];
         for (auto &toProcess : blockProducts[j]) {
-            auto deviceId = devicesForProducts[deviceToFetch];
             auto aIdx = toProcess.a;
             auto bIdx = toProcess.b;
             auto aBlock = aBlocks.find(aIdx)->second;
-            auto bBlock = bBlocks.find(bIdx)->second;
+            auto bNrows = bBlocks.find(bIdx)->second.nrows;
+            auto parts = toProcess.parts;
             auto maskBlock = GetMaskBlock(maskBlocks, IndexV{bIdx.second});
-            auto task = builder.Emplace([=]() {
-                assert(aBlock->GetNrows() == bBlock->GetNrows());
-                ParamsVxM params;
-                params.desc = desc;
-                params.deviceId = deviceId;
-                params.hasMask = hasMask;
-                params.mask = maskBlock;
-                params.mult = mult;
-                params.add = add;
-                params.a = aBlock;
-                params.b = bBlock;
-                params.ta = ta;
-                params.tb = tb;
-                params.tw = tw;
-                library->GetAlgoManager()->Dispatch(Algorithm::Type::VxM, params);
-
-                if (params.w.IsNotNull()) {
-                    // If has not empty result, store it to sum later
-                    products->AddBlock(j, params.w);
-                    SPDLOG_LOGGER_TRACE(logger, "Blocks product ({})x({},{}) nnz={}",
-                                        aIdx, bIdx.first, bIdx.second, params.w->GetNvals());
-                }
-            });
-            deviceToFetch += 1;
-            tasks.push_back(std::move(task));
+            auto taskName = "product (" + std::to_string(aIdx) + ")x(" +
+                            std::to_string(bIdx.first) + "," + std::to_string(bIdx.second) + ")";
+
+            for (std::size_t part = 0; part < parts; part++) {
+                auto ticket = ticketsForProducts[deviceToFetch];
+                auto deviceId = ticket->GetDeviceId();
+                auto aBeginRow = bNrows * part / parts;
+                auto aEndRow = bNrows * (part + 1) / parts;
+                auto partName = parts > 1 ? taskName + " part " + std::to_string(part) : taskName;
+                auto task = builder.Emplace(partName, [=]() {
+                    // Fetch matrix block only for the time of the product, so mapped block can be evicted after it
+                    auto bBlock = bStorage->GetBlock(bIdx, deviceId);
+                    assert(aBlock->GetNrows() == bBlock->GetNrows());
+                    ParamsVxM params;
+                    params.desc = desc;
+                    params.deviceId = deviceId;
+                    params.hasMask = hasMask;
+                    params.mask = maskBlock;
+                    params.mult = mult;
+                    params.add = add;
+                    params.a = aBlock;
+                    params.b = bBlock;
+                    params.ta = ta;
+                    params.tb = tb;
+                    params.tw = tw;
+                    params.aBeginRow = aBeginRow;
+                    params.aEndRow = aEndRow;
+                    library->GetAlgoManager()->Dispatch(Algorithm::Type::VxM, params);
+
+                    if (params.w.IsNotNull()) {
+                        // If has not empty result, store it to sum later
+                        products->AddBlock(j, params.w);
+                        SPDLOG_LOGGER_TRACE(logger, "Blocks product ({})x({},{}) part {}/{} nnz={}",
+                                            aIdx, bIdx.first, bIdx.second, part, parts, params.w->GetNvals());
+                    }
+
+                    ticket->Release();
+                });
+                deviceToFetch += 1;
+                tasks.push_back(std::move(task));
+            }
+        }
+    }
+
+    // Schedule merges (strategy: device per not empty w[j])
+    std::vector<DeviceManager::Work> mergesWork;
+    mergesWork.reserve(totalBlocks);
+    for (std::size_t j = 0; j < nBlockN; j++) {
+        if (!blockProducts[j].empty()) {
+            DeviceManager::Work work;
+            work.amount = mergeAmount[j];
+            work.inputs = {{productsOwner, j}};
+            work.output = DeviceManager::Location{remapResult ? productsOwner : wStorage->GetLocationOwner(), j};
+            mergesWork.push_back(std::move(work));
         }
     }
 
-    // Query required number of devices (strategy: device per not empty w[j])
-    auto devicesForFinalMerge = deviceMan.FetchDevices(totalBlocks, node);
+    auto ticketsForFinalMerge = deviceMan.Schedule(mergesWork, node);
+
+    // Products locations are used only to schedule merges
+    deviceMan.ForgetLocations(productsOwner);
+
+    // Final results of b columns blocks, if they must be remapped onto w blocks
+    auto results = std::make_shared<ProductsResults>(nBlockN);
+    std::vector<tf::Task> mergeTasks(nBlockN);
 
     // Finally, for each block w[i,j] we must aggregate intermediate
     // blocks multiplications results as a series of element-wise additions of blocks
@@ -199,14 +312,18 @@ void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
     for (std::size_t j = 0; j < nBlockN; j++) {
         auto &toProcess = blockProducts[j];
         if (!toProcess.empty()) {
-            auto deviceId = devicesForFinalMerge[deviceToFetch];
-            auto task = builder.Emplace([=]() {
+            auto ticket = ticketsForFinalMerge[deviceToFetch];
+            auto deviceId = ticket->GetDeviceId();
+            auto taskName = "merge (" + std::to_string(j) + ")";
+            auto task = builder.Emplace(taskName, [=]() {
                 std::vector<RefPtr<VectorBlock>> blocks;
                 products->GetBlocks(j, blocks);
 
                 // Nothing to do, w[j] is empty
-                if (blocks.empty())
+                if (blocks.empty()) {
+                    ticket->Release();
                     return;
+                }
 
                 // Start to merge n blocks, number of merges n - 1
                 auto block = blocks[0];
@@ -226,8 +343,12 @@ void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
                 }
 
                 // Store final result
-                IndexV index{static_cast<unsigned int>(j)};
-                w->GetStorage()->SetBlock(index, block);
+                if (remapResult)
+                    results->AddBlock(j, block);
+                else
+                    wStorage->SetBlock(IndexV{static_cast<unsigned int>(j)}, block);
+
+                ticket->Release();
             });
 
             // Setup dependencies
@@ -236,9 +357,60 @@ void spla::VxM::Process(std::size_t nodeIdx, const spla::Expression &expression,
             for (auto &parent : deps)
                 parent.precede(task);
 
+            if (!remapResult)
+                blockTasks[j].push_back(task);
+
+            mergeTasks[j] = task;
             deviceToFetch += 1;
         }
     }
+
+    if (!remapResult)
+        return;
+
+    // Copy entries of b columns blocks results into w blocks, which they intersect
+    auto remapDeviceIds = deviceMan.FetchDevices(nBlockW, node);
+    auto wPartition = wStorage->GetPartition();
+    for (std::size_t k = 0; k < nBlockW; k++) {
+        auto begin = wPartition.GetBlockOffset(k);
+        auto end = begin + static_cast<unsigned int>(wPartition.GetBlockSize(k));
+        auto first = colPartition.GetBlockIndex(begin);
+        auto last = colPartition.GetBlockIndex(end - 1);
+
+        std::vector<tf::Task> deps;
+        for (auto j = first; j <= last; j++) {
+            if (!blockProducts[j].empty())
+                deps.push_back(mergeTasks[j]);
+        }
+
+        // Nothing to do, w[k] is empty
+        if (deps.empty())
+            continue;
+
+        auto deviceId = remapDeviceIds[k];
+        auto task = builder.Emplace("remap (" + std::to_string(k) + ")", [=]() {
+            std::vector<RefPtr<VectorBlock>> blocks;
+            for (auto j = first; j <= last; j++) {
+                std::vector<RefPtr<VectorBlock>> result;
+                results->GetBlocks(j, result);
+                blocks.push_back(result.empty() ? RefPtr<VectorBlock>{} : result.front());
+            }
+
+            boost::compute::context ctx = library->GetContext();
+            boost::compute::command_queue queue(ctx, library->GetDeviceManager().GetDevice(deviceId));
+            auto block = ReblockVector(colPartition, first, blocks, begin, end, queue);
+
+            if (block.IsNotNull()) {
+                wStorage->SetBlock(IndexV{static_cast<unsigned int>(k)}, block);
+                SPDLOG_LOGGER_TRACE(logger, "Remap block ({}) nnz={}", k, block->GetNvals());
+            }
+        });
+
+        for (auto &parent : deps)
+            parent.precede(task);
+
+        blockTasks[k].push_back(task);
+    }
 }
 
 spla::ExpressionNode::Operation spla::VxM::GetOperationType() const {
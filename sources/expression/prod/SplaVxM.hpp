@@ -29,6 +29,7 @@
 #define SPLA_SPLAVXM_HPP
 
 #include <expression/SplaNodeProcessor.hpp>
+#include <vector>
 
 namespace spla {
 
@@ -38,6 +39,14 @@ namespace spla {
         bool Select(std::size_t nodeIdx, const Expression &expression) override;
         void Process(std::size_t nodeIdx, const Expression &expression, TaskBuilder &builder) override;
         ExpressionNode::Operation GetOperationType() const override;
+
+        /**
+         * Process node and collect tasks, which compute blocks of the result.
+         *
+         * @param blockTasks Tasks, which store result w[j] block, for each block j
+         */
+        void Process(std::size_t nodeIdx, const Expression &expression, TaskBuilder &builder,
+                     std::vector<std::vector<tf::Task>> &blockTasks);
     };
 
 }// namespace spla
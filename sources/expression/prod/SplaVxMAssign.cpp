@@ -0,0 +1,61 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <expression/prod/SplaVxMAssign.hpp>
+#include <vector>
+
+bool spla::VxMAssign::Select(std::size_t firstIdx, std::size_t secondIdx, const spla::Expression &expression) {
+    auto &nodes = expression.GetNodes();
+    auto &vxm = nodes[firstIdx];
+    auto &assign = nodes[secondIdx];
+
+    auto &w = vxm->GetArg(0);
+    auto &assignW = assign->GetArg(0);
+    auto &assignMask = assign->GetArg(1);
+
+    // NOTE: VxM fetches its input blocks while composing tasks, so assignment
+    // may overwrite product inputs, but not the product result itself
+    return assignMask.IsNotNull() && assignMask == w && !(assignW == w) &&
+           mVxM.Select(firstIdx, expression) &&
+           mAssign.Select(secondIdx, expression);
+}
+
+void spla::VxMAssign::Process(std::size_t firstIdx, std::size_t secondIdx, const spla::Expression &expression,
+                              spla::TaskBuilder &firstBuilder, spla::TaskBuilder &secondBuilder) {
+    // Assignment of w[i] depends only on the i-th block of the product
+    std::vector<std::vector<tf::Task>> blockTasks;
+    mVxM.Process(firstIdx, expression, firstBuilder, blockTasks);
+    mAssign.Process(secondIdx, expression, secondBuilder, blockTasks);
+}
+
+spla::ExpressionNode::Operation spla::VxMAssign::GetFirstOperationType() const {
+    return ExpressionNode::Operation::VxM;
+}
+
+spla::ExpressionNode::Operation spla::VxMAssign::GetSecondOperationType() const {
+    return ExpressionNode::Operation::VectorAssign;
+}
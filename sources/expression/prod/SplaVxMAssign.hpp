@@ -0,0 +1,61 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAVXMASSIGN_HPP
+#define SPLA_SPLAVXMASSIGN_HPP
+
+#include <expression/SplaFusedNodeProcessor.hpp>
+#include <expression/prod/SplaVxM.hpp>
+#include <expression/vector/SplaVectorAssign.hpp>
+
+namespace spla {
+
+    /**
+     * @brief Fused vector-matrix product and vector assignment, masked by product result.
+     *
+     * Common step of traversal algorithms: next front is computed as v x M,
+     * and then values are assigned to visited vertices using front as mask.
+     * Assignment of each block starts right after this block of product is computed,
+     * without waiting for the whole product.
+     */
+    class VxMAssign final : public FusedNodeProcessor {
+    public:
+        ~VxMAssign() override = default;
+        bool Select(std::size_t firstIdx, std::size_t secondIdx, const Expression &expression) override;
+        void Process(std::size_t firstIdx, std::size_t secondIdx, const Expression &expression,
+                     TaskBuilder &firstBuilder, TaskBuilder &secondBuilder) override;
+        ExpressionNode::Operation GetFirstOperationType() const override;
+        ExpressionNode::Operation GetSecondOperationType() const override;
+
+    private:
+        VxM mVxM;
+        VectorAssign mAssign;
+    };
+
+}// namespace spla
+
+#endif//SPLA_SPLAVXMASSIGN_HPP
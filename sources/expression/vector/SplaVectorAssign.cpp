@@ -37,6 +37,11 @@ bool spla::VectorAssign::Select(std::size_t nodeIdx, const spla::Expression &exp
 }
 
 void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder) {
+    Process(nodeIdx, expression, builder, std::vector<std::vector<tf::Task>>());
+}
+
+void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &expression, spla::TaskBuilder &builder,
+                                 const std::vector<std::vector<tf::Task>> &blockDeps) {
     auto &nodes = expression.GetNodes();
     auto &node = nodes[nodeIdx];
     auto library = node->GetLibrary().GetPrivatePtr();
@@ -57,7 +62,7 @@ void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &ex
     auto applyAccum = desc->IsParamSet(Descriptor::Param::AccumResult);
 
     // Create temporary vector for assignment result
-    if (applyAccum) tmp = Vector::Make(w->GetNrows(), w->GetType(), w->GetLibrary());
+    if (applyAccum) tmp = Vector::Make(w->GetNrows(), w->GetType(), w->GetLibrary(), w->GetStorage()->GetBlockSize());
 
     // If no accum, clear result first
     if (!applyAccum) w->GetStorage()->Clear();
@@ -65,13 +70,17 @@ void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &ex
     // If assign is null, make default to keep new entries
     if (applyAccum && accum.IsNull()) accum = utils::MakeFunctionChooseSecond(w->GetType());
 
+    // Mask blocks are remapped onto blocks of w, if split differently
+    auto partition = w->GetStorage()->GetPartition();
+    auto maskBlockSize = mask.IsNotNull() ? mask->GetStorage()->GetBlockSize() : w->GetStorage()->GetBlockSize();
+
     std::size_t requiredDeviceCount = w->GetStorage()->GetNblockRows();
     auto deviceIds = library->GetDeviceManager().FetchDevices(requiredDeviceCount, node);
 
     for (std::size_t i = 0; i < w->GetStorage()->GetNblockRows(); i++) {
         auto deviceId = deviceIds[i];
 
-        auto assignmentTask = builder.Emplace([=]() {
+        auto assignmentTask = builder.Emplace("block (" + std::to_string(i) + ")", [=]() {
             auto blockIdx = i;
             auto blockSize = w->GetStorage()->GetBlockSize();
             auto dim = w->GetStorage()->GetNrows();
@@ -81,7 +90,7 @@ void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &ex
             params.deviceId = deviceId;
             params.size = math::GetBlockActualSize(blockIdx, dim, blockSize);
             params.hasMask = mask.IsNotNull();
-            params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(i) : RefPtr<VectorBlock>{};
+            params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(partition, i, deviceId) : RefPtr<VectorBlock>{};
             params.s = s.IsNotNull() ? s->GetStorage()->GetValue() : RefPtr<ScalarValue>{};
             params.type = w->GetType();
             library->GetAlgoManager()->Dispatch(Algorithm::Type::VectorAssign, params);
@@ -92,8 +101,16 @@ void spla::VectorAssign::Process(std::size_t nodeIdx, const spla::Expression &ex
             }
         });
 
+        // Start assignment as soon as required blocks are computed
+        auto begin = partition.GetBlockOffset(i);
+        auto end = begin + partition.GetBlockSize(i);
+        for (auto k = begin / maskBlockSize; k <= (end - 1) / maskBlockSize && k < blockDeps.size(); k++) {
+            for (auto dep : blockDeps[k])
+                dep.precede(assignmentTask);
+        }
+
         if (applyAccum) {
-            auto accumTask = builder.Emplace([=]() {
+            auto accumTask = builder.Emplace("accum (" + std::to_string(i) + ")", [=]() {
                 auto tmpBlock = tmp->GetStorage()->GetBlock(i);
 
                 if (tmpBlock.IsNotNull()) {
@@ -29,6 +29,7 @@
 #define SPLA_SPLAVECTORASSIGN_HPP
 
 #include <expression/SplaNodeProcessor.hpp>
+#include <vector>
 
 namespace spla {
 
@@ -38,6 +39,14 @@ namespace spla {
         bool Select(std::size_t nodeIdx, const Expression &expression) override;
         void Process(std::size_t nodeIdx, const Expression &expression, TaskBuilder &builder) override;
         ExpressionNode::Operation GetOperationType() const override;
+
+        /**
+         * Process node, assignment of each block starts after provided tasks.
+         *
+         * @param blockDeps Tasks to finish before assignment of w[i] block, for each block i
+         */
+        void Process(std::size_t nodeIdx, const Expression &expression, TaskBuilder &builder,
+                     const std::vector<std::vector<tf::Task>> &blockDeps);
     };
 
 }// namespace spla
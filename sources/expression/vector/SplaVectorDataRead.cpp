@@ -77,7 +77,7 @@ void spla::VectorDataRead::Process(std::size_t nodeIdx, const spla::Expression &
                           "Supported only COO vector block format");
     }
 
-    auto collectNnz = builder.Emplace([=]() {
+    auto collectNnz = builder.Emplace("collect nnz", [=]() {
         auto &blockRowsNvals = shared->blockRowsNvals;
         auto &blockRowsOffsets = shared->blockRowsOffsets;
 
@@ -102,7 +102,7 @@ void spla::VectorDataRead::Process(std::size_t nodeIdx, const spla::Expression &
     for (std::size_t i = 0; i < storage->GetNblockRows(); i++) {
         tf::Task copyBlocksInRow;
         auto deviceId = devicesIds[i];
-        copyBlocksInRow = builder.Emplace([=]() {
+        copyBlocksInRow = builder.Emplace("block (" + std::to_string(i) + ")", [=]() {
             using namespace boost;
 
             auto device = library->GetDeviceManager().GetDevice(deviceId);
@@ -112,7 +112,7 @@ void spla::VectorDataRead::Process(std::size_t nodeIdx, const spla::Expression &
             // Where to start copy process
             std::size_t nvals = shared->blockRowsNvals[i];
             std::size_t offset = shared->blockRowsOffsets[i];
-            std::size_t blockFirstRow = i * library->GetBlockSize();
+            std::size_t blockFirstRow = i * storage->GetBlockSize();
 
             // If no values - nothing to do
             if (nvals == 0) {
@@ -55,7 +55,7 @@ void spla::VectorDataWrite::Process(std::size_t nodeIdx, const spla::Expression
     assert(desc.IsNotNull());
 
     auto nrows = vector->GetNrows();
-    auto blockSize = library->GetBlockSize();
+    auto blockSize = vector->GetStorage()->GetBlockSize();
 
     std::size_t blockCountInRow = math::GetBlocksCount(nrows, blockSize);
 
@@ -64,7 +64,7 @@ void spla::VectorDataWrite::Process(std::size_t nodeIdx, const spla::Expression
 
     for (std::size_t i = 0; i < blockCountInRow; i++) {
         auto deviceId = devicesIds[i];
-        builder.Emplace([=]() {
+        builder.Emplace("block (" + std::to_string(i) + ")", [=]() {
             using namespace boost;
 
             compute::device device = library->GetDeviceManager().GetDevice(deviceId);
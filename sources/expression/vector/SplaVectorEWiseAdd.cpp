@@ -53,20 +53,28 @@ void spla::VectorEWiseAdd::Process(std::size_t nodeIdx, const spla::Expression &
     assert(b.IsNotNull());
     assert(desc.IsNotNull());
 
+    // Blocks are added pairwise, so b and mask blocks are remapped onto blocks of a, if split differently;
+    // w may be b or mask itself, so they are read from clones, which keep blocks while w is resplit
+    auto partition = a->GetStorage()->GetPartition();
+    auto bStorage = b->GetStorage()->Clone();
+    auto maskStorage = mask.IsNotNull() ? mask->GetStorage()->Clone() : RefPtr<VectorStorage>{};
+
+    w->GetStorage()->SetBlockSize(a->GetStorage()->GetBlockSize());
+
     std::size_t requiredDeviceCount = w->GetStorage()->GetNblockRows();
     auto deviceIds = library->GetDeviceManager().FetchDevices(requiredDeviceCount, node);
 
     for (std::size_t i = 0; i < w->GetStorage()->GetNblockRows(); i++) {
         auto deviceId = deviceIds[i];
-        builder.Emplace([=]() {
+        builder.Emplace("block (" + std::to_string(i) + ")", [=]() {
             ParamsVectorEWiseAdd params;
             params.desc = desc;
             params.deviceId = deviceId;
             params.hasMask = mask.IsNotNull();
-            params.mask = mask.IsNotNull() ? mask->GetStorage()->GetBlock(i) : RefPtr<VectorBlock>{};
+            params.mask = mask.IsNotNull() ? maskStorage->GetBlock(partition, i, deviceId) : RefPtr<VectorBlock>{};
             params.op = op;
             params.a = a->GetStorage()->GetBlock(i);
-            params.b = b->GetStorage()->GetBlock(i);
+            params.b = bStorage->GetBlock(partition, i, deviceId);
             params.type = w->GetType();
             library->GetAlgoManager()->Dispatch(Algorithm::Type::VectorEWiseAdd, params);
 
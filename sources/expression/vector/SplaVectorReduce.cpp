@@ -115,7 +115,7 @@ void spla::VectorReduce::Process(std::size_t nodeIdx, const spla::Expression &ex
     for (std::size_t i = 0; i < blocksInVector; ++i) {
         auto deviceId = deviceIds[i];
 
-        tf::Task reduceIthBlock = builder.Emplace([=]() {
+        tf::Task reduceIthBlock = builder.Emplace("block (" + std::to_string(i) + ")", [=]() {
             ParamsVectorReduce params;
             params.desc = desc;
             params.deviceId = deviceId;
@@ -132,7 +132,7 @@ void spla::VectorReduce::Process(std::size_t nodeIdx, const spla::Expression &ex
     }
 
     auto lastReduceDeviceId = deviceIds[blocksInVector];
-    tf::Task reduceIntermediateBuffer = builder.Emplace([=]() {
+    tf::Task reduceIntermediateBuffer = builder.Emplace("final reduce", [=]() {
         auto &ctx = library->GetContext();
         auto queue = boost::compute::command_queue(ctx, library->GetDeviceManager().GetDevice(lastReduceDeviceId));
         QueueFinisher finisher(queue);
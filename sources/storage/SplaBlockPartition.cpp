@@ -0,0 +1,140 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaMath.hpp>
+#include <storage/SplaBlockPartition.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+spla::BlockPartition::BlockPartition(std::vector<unsigned int> offsets) : mOffsets(std::move(offsets)) {
+    assert(!mOffsets.empty());
+    assert(mOffsets.front() == 0);
+    assert(std::is_sorted(mOffsets.begin(), mOffsets.end()));
+}
+
+std::size_t spla::BlockPartition::GetBlocksCount() const noexcept {
+    return mOffsets.size() - 1;
+}
+
+std::size_t spla::BlockPartition::GetDim() const noexcept {
+    return mOffsets.back();
+}
+
+unsigned int spla::BlockPartition::GetBlockOffset(std::size_t block) const noexcept {
+    assert(block < GetBlocksCount());
+    return mOffsets[block];
+}
+
+std::size_t spla::BlockPartition::GetBlockSize(std::size_t block) const noexcept {
+    assert(block < GetBlocksCount());
+    return mOffsets[block + 1] - mOffsets[block];
+}
+
+std::size_t spla::BlockPartition::GetBlockIndex(unsigned int index) const noexcept {
+    assert(index < GetDim());
+
+    // Uniform partition resolved without search
+    if (mBlockSize)
+        return index / mBlockSize;
+
+    auto next = std::upper_bound(mOffsets.begin(), mOffsets.end(), index);
+    return static_cast<std::size_t>(next - mOffsets.begin()) - 1;
+}
+
+const std::vector<unsigned int> &spla::BlockPartition::GetOffsets() const noexcept {
+    return mOffsets;
+}
+
+bool spla::BlockPartition::IsUniform() const noexcept {
+    return mBlockSize != 0;
+}
+
+std::size_t spla::BlockPartition::GetUniformBlockSize() const noexcept {
+    return mBlockSize;
+}
+
+bool spla::BlockPartition::operator==(const spla::BlockPartition &other) const noexcept {
+    return mOffsets == other.mOffsets;
+}
+
+bool spla::BlockPartition::operator!=(const spla::BlockPartition &other) const noexcept {
+    return !(*this == other);
+}
+
+spla::BlockPartition spla::BlockPartition::Uniform(std::size_t dim, std::size_t blockSize) {
+    assert(blockSize > 0);
+
+    auto count = math::GetBlocksCount(dim, blockSize);
+    std::vector<unsigned int> offsets(count + 1);
+
+    for (std::size_t i = 0; i < count; i++)
+        offsets[i] = static_cast<unsigned int>(i * blockSize);
+    offsets[count] = static_cast<unsigned int>(dim);
+
+    BlockPartition partition(std::move(offsets));
+    partition.mBlockSize = blockSize;
+    return partition;
+}
+
+spla::BlockPartition spla::BlockPartition::Balanced(const std::vector<std::size_t> &counts, std::size_t blockSize) {
+    assert(blockSize > 0);
+
+    auto dim = counts.size();
+    auto count = math::GetBlocksCount(dim, blockSize);
+
+    std::size_t total = 0;
+    for (auto c : counts)
+        total += c;
+
+    // Nothing to balance
+    if (count <= 1 || total == 0)
+        return Uniform(dim, blockSize);
+
+    std::vector<unsigned int> offsets;
+    offsets.reserve(count + 1);
+    offsets.push_back(0);
+
+    // Cut next block, when prefix sum reaches next quantile;
+    // each block keeps at least one index, so the number of blocks is preserved
+    std::size_t prefix = 0;
+    for (std::size_t k = 0; k < dim && offsets.size() < count; k++) {
+        prefix += counts[k];
+
+        auto blocksLeft = count - offsets.size();
+        auto indicesLeft = dim - (k + 1);
+        auto quantile = total * offsets.size() / count;
+
+        if ((prefix >= quantile && indicesLeft >= blocksLeft) || indicesLeft == blocksLeft)
+            offsets.push_back(static_cast<unsigned int>(k + 1));
+    }
+
+    offsets.push_back(static_cast<unsigned int>(dim));
+    assert(offsets.size() == count + 1);
+
+    return BlockPartition(std::move(offsets));
+}
@@ -0,0 +1,121 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLABLOCKPARTITION_HPP
+#define SPLA_SPLABLOCKPARTITION_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class BlockPartition
+     *
+     * Split of a single dimension (rows or columns) into consecutive blocks.
+     * Stores split points: block `i` covers indices range [offsets[i]..offsets[i + 1]).
+     *
+     * Uniform partition has blocks of `blockSize` with clamped last block.
+     * Balanced partition has the same number of blocks, but split points are chosen
+     * so each block has approximately equal number of stored values.
+     */
+    class BlockPartition {
+    public:
+        BlockPartition() = default;
+
+        /**
+         * Make partition from split points.
+         *
+         * @param offsets Increasing split points; first is 0 and last is dimension
+         */
+        explicit BlockPartition(std::vector<unsigned int> offsets);
+
+        /** @return Number of blocks */
+        [[nodiscard]] std::size_t GetBlocksCount() const noexcept;
+
+        /** @return Partitioned dimension */
+        [[nodiscard]] std::size_t GetDim() const noexcept;
+
+        /** @return First index of the block */
+        [[nodiscard]] unsigned int GetBlockOffset(std::size_t block) const noexcept;
+
+        /** @return Number of indices in the block */
+        [[nodiscard]] std::size_t GetBlockSize(std::size_t block) const noexcept;
+
+        /** @return Block, which contains index */
+        [[nodiscard]] std::size_t GetBlockIndex(unsigned int index) const noexcept;
+
+        /** @return Split points */
+        [[nodiscard]] const std::vector<unsigned int> &GetOffsets() const noexcept;
+
+        /** @return True if partition is uniform */
+        [[nodiscard]] bool IsUniform() const noexcept;
+
+        /** @return Block size of uniform partition; zero if partition is not uniform */
+        [[nodiscard]] std::size_t GetUniformBlockSize() const noexcept;
+
+        bool operator==(const BlockPartition &other) const noexcept;
+        bool operator!=(const BlockPartition &other) const noexcept;
+
+        /**
+         * Make uniform partition.
+         *
+         * @param dim Dimension to split
+         * @param blockSize Size of the block
+         *
+         * @return Partition
+         */
+        static BlockPartition Uniform(std::size_t dim, std::size_t blockSize);
+
+        /**
+         * Make nnz balanced partition with the same number of blocks, as uniform one.
+         * Split points are placed at quantiles of values count prefix sum.
+         *
+         * @param counts Number of values for each index of dimension
+         * @param blockSize Size of the block of uniform partition
+         *
+         * @return Partition
+         */
+        static BlockPartition Balanced(const std::vector<std::size_t> &counts, std::size_t blockSize);
+
+    private:
+        std::vector<unsigned int> mOffsets{0};
+        std::size_t mBlockSize = 0;
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLABLOCKPARTITION_HPP
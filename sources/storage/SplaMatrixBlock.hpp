@@ -84,6 +84,9 @@ namespace spla {
         /** @return Size of the stored value (in bytes) */
         [[nodiscard]] virtual std::size_t GetValueByteSize() const noexcept = 0;
 
+        /** @return Size of the device memory used by the block (in bytes) */
+        [[nodiscard]] virtual std::size_t GetMemoryUsage() const noexcept = 0;
+
     protected:
         std::size_t mNrows;
         std::size_t mNcols;
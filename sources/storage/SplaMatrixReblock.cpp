@@ -0,0 +1,188 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algorithm>
+#include <boost/compute.hpp>
+#include <boost/compute/algorithm/scatter_if.hpp>
+#include <compute/SplaGather.hpp>
+#include <compute/SplaSortByRowColumn.hpp>
+#include <core/SplaError.hpp>
+#include <storage/SplaMatrixReblock.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+
+spla::RefPtr<spla::MatrixBlock> spla::ReblockMatrix(const spla::BlockPartition &rowPartition,
+                                                    const spla::BlockPartition &colPartition,
+                                                    const spla::MatrixStorage::EntryList &blocks,
+                                                    std::pair<unsigned int, unsigned int> rows,
+                                                    std::pair<unsigned int, unsigned int> cols,
+                                                    boost::compute::command_queue &queue) {
+    using namespace boost;
+    using compute::lambda::_1;
+
+    struct Range {
+        RefPtr<MatrixCOO> block;
+        unsigned int rowOffset;
+        unsigned int colOffset;
+        compute::vector<unsigned int> selected;
+    };
+
+    compute::context ctx = queue.get_context();
+    std::vector<Range> ranges;
+    std::size_t nvals = 0;
+    std::size_t byteSize = 0;
+    bool sort = false;
+
+    for (auto &entry : blocks) {
+        auto block = entry.second.Cast<MatrixCOO>();
+        CHECK_RAISE_ERROR(block.IsNotNull(), NotImplemented, "Supported only COO matrix blocks");
+
+        auto rowOffset = rowPartition.GetBlockOffset(entry.first.first);
+        auto colOffset = colPartition.GetBlockOffset(entry.first.second);
+        auto nrows = static_cast<unsigned int>(rowPartition.GetBlockSize(entry.first.first));
+        auto ncols = static_cast<unsigned int>(colPartition.GetBlockSize(entry.first.second));
+
+        // Source block matches ranges, nothing to copy
+        if (rowOffset == rows.first && rowOffset + nrows == rows.second &&
+            colOffset == cols.first && colOffset + ncols == cols.second)
+            return block.As<MatrixBlock>();
+
+        auto lowerRow = std::max(rows.first, rowOffset) - rowOffset;
+        auto upperRow = std::min(rows.second, rowOffset + nrows) - rowOffset;
+        auto lowerCol = std::max(cols.first, colOffset) - colOffset;
+        auto upperCol = std::min(cols.second, colOffset + ncols) - colOffset;
+        auto &blockRows = block->GetRows();
+        auto &blockCols = block->GetCols();
+
+        // Entries are sorted by rows, so entries of rows range are consecutive
+        std::size_t from = 0;
+        std::size_t to = block->GetNvals();
+        if (lowerRow > 0)
+            from = compute::lower_bound(blockRows.begin(), blockRows.end(), lowerRow, queue) - blockRows.begin();
+        if (upperRow < nrows)
+            to = compute::lower_bound(blockRows.begin(), blockRows.end(), upperRow, queue) - blockRows.begin();
+
+        if (from >= to)
+            continue;
+
+        auto count = to - from;
+        Range range{block, rowOffset, colOffset, compute::vector<unsigned int>(ctx)};
+
+        // Select all entries of rows range or only ones within columns range
+        if (lowerCol == 0 && upperCol == ncols) {
+            range.selected.resize(count, queue);
+            compute::copy(compute::counting_iterator<unsigned int>(from),
+                          compute::counting_iterator<unsigned int>(to),
+                          range.selected.begin(), queue);
+        } else {
+            // Extra zero flag at the end, so exclusive scan gives number of selected entries
+            auto width = upperCol - lowerCol;
+            compute::vector<unsigned int> flags(count + 1, ctx);
+            compute::vector<unsigned int> positions(count + 1, ctx);
+            compute::transform(blockCols.begin() + from, blockCols.begin() + to, flags.begin(), (_1 - lowerCol) < width, queue);
+            compute::fill_n(flags.begin() + count, 1, 0u, queue);
+            compute::exclusive_scan(flags.begin(), flags.end(), positions.begin(), queue);
+
+            unsigned int selected = 0;
+            compute::copy_n(positions.begin() + count, 1, &selected, queue);
+
+            if (!selected)
+                continue;
+
+            range.selected.resize(selected, queue);
+            compute::scatter_if(compute::counting_iterator<unsigned int>(from),
+                                compute::counting_iterator<unsigned int>(to),
+                                positions.begin(), flags.begin(), range.selected.begin(), queue);
+        }
+
+        // Entries of blocks of different columns interleave, so they must be sorted after concatenation
+        sort = sort || (!ranges.empty() && ranges.front().colOffset != colOffset);
+        nvals += range.selected.size();
+        byteSize = block->GetValueByteSize();
+        ranges.push_back(std::move(range));
+    }
+
+    if (!nvals)
+        return RefPtr<MatrixBlock>{};
+
+    compute::vector<unsigned int> resultRows(nvals, ctx);
+    compute::vector<unsigned int> resultCols(nvals, ctx);
+    compute::vector<unsigned char> resultVals(nvals * byteSize, ctx);
+
+    std::size_t written = 0;
+    for (auto &range : ranges) {
+        auto &selected = range.selected;
+        auto count = selected.size();
+        auto rowsBegin = resultRows.begin() + written;
+        auto colsBegin = resultCols.begin() + written;
+
+        // Shift indices from source block to ranges; may wrap around, but result is in ranges
+        auto rowShift = range.rowOffset - rows.first;
+        auto colShift = range.colOffset - cols.first;
+
+        compute::gather(selected.begin(), selected.end(), range.block->GetRows().begin(), rowsBegin, queue);
+        compute::gather(selected.begin(), selected.end(), range.block->GetCols().begin(), colsBegin, queue);
+        compute::transform(rowsBegin, rowsBegin + count, rowsBegin, _1 + rowShift, queue);
+        compute::transform(colsBegin, colsBegin + count, colsBegin, _1 + colShift, queue);
+
+        if (byteSize)
+            Gather(selected.begin(), selected.end(), range.block->GetVals().begin(), resultVals.begin() + written * byteSize, byteSize, queue);
+
+        written += count;
+    }
+
+    if (sort)
+        SortByRowColumn(resultRows, resultCols, resultVals, byteSize, queue);
+
+    queue.finish();
+
+    return MatrixCOO::Make(rows.second - rows.first, cols.second - cols.first, nvals,
+                           std::move(resultRows), std::move(resultCols), std::move(resultVals))
+            .As<MatrixBlock>();
+}
+
+spla::RefPtr<spla::MatrixStorage> spla::ReblockStorage(const spla::RefPtr<spla::MatrixStorage> &storage,
+                                                       const spla::BlockPartition &rows,
+                                                       const spla::BlockPartition &cols,
+                                                       std::size_t deviceId,
+                                                       spla::Library &library) {
+    if (storage->GetRowPartition() == rows && storage->GetColPartition() == cols)
+        return storage;
+
+    auto result = MatrixStorage::Make(storage->GetNrows(), storage->GetNcols(), library);
+    result->SetPartition(rows, cols);
+
+    for (std::size_t i = 0; i < rows.GetBlocksCount(); i++) {
+        for (std::size_t j = 0; j < cols.GetBlocksCount(); j++) {
+            MatrixStorage::Index index{static_cast<unsigned int>(i), static_cast<unsigned int>(j)};
+            auto block = storage->GetBlock(rows, cols, index, deviceId);
+            if (block.IsNotNull())
+                result->SetBlock(index, block);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,88 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAMATRIXREBLOCK_HPP
+#define SPLA_SPLAMATRIXREBLOCK_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <storage/SplaBlockPartition.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <utility>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * Make block of matrix entries in rows and columns ranges from blocks of other partition.
+     * Used to align matrix blocks with blocks of other argument, split at different points.
+     * Source block is returned as is, if it covers exactly the ranges.
+     *
+     * @param rowPartition Rows partition of source blocks
+     * @param colPartition Columns partition of source blocks
+     * @param blocks Source blocks, which intersect ranges, in rows then columns order
+     * @param rows Range [begin..end) of rows
+     * @param cols Range [begin..end) of columns
+     * @param queue Command queue to copy entries
+     *
+     * @return Block with ranges entries; null if ranges have no entries
+     */
+    RefPtr<MatrixBlock> ReblockMatrix(const BlockPartition &rowPartition,
+                                      const BlockPartition &colPartition,
+                                      const MatrixStorage::EntryList &blocks,
+                                      std::pair<unsigned int, unsigned int> rows,
+                                      std::pair<unsigned int, unsigned int> cols,
+                                      boost::compute::command_queue &queue);
+
+    /**
+     * Make storage split into blocks of other partitions, made of entries of storage blocks.
+     * Used, when the whole argument is aligned with other arguments before tasks are composed.
+     *
+     * @param storage Storage to remap
+     * @param rows Rows partition of the result
+     * @param cols Columns partition of the result
+     * @param deviceId Id of the device to copy entries on
+     * @param library Library instance
+     *
+     * @return Storage itself, if it has the same partitions, or new storage with remapped blocks
+     */
+    RefPtr<MatrixStorage> ReblockStorage(const RefPtr<MatrixStorage> &storage,
+                                         const BlockPartition &rows,
+                                         const BlockPartition &cols,
+                                         std::size_t deviceId,
+                                         Library &library);
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAMATRIXREBLOCK_HPP
@@ -25,14 +25,221 @@
 /* SOFTWARE.                                                                      */
 /**********************************************************************************/
 
+#include <algorithm>
+#include <boost/compute.hpp>
+#include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <core/SplaMath.hpp>
+#include <fstream>
+#include <list>
+#include <storage/SplaMatrixReblock.hpp>
 #include <storage/SplaMatrixStorage.hpp>
+#include <storage/block/SplaMatrixCOO.hpp>
+#include <utils/SplaMappedFile.hpp>
+
+namespace {
+    /** Counter of device memory, referenced by matrix storages blocks */
+    const char *const BLOCKS_MEMORY_COUNTER = "Matrix blocks memory";
+
+    /** Read snapshot header and blocks table, check that blocks fit snapshot blocks grid */
+    spla::snapshot::Header ReadSnapshot(const spla::MappedFile &file, std::size_t valueByteSize,
+                                        std::vector<spla::snapshot::Block> &blocks) {
+        using namespace spla;
+
+        auto header = snapshot::ReadHeader(file, snapshot::MatrixMagic, true, blocks);
+        auto rowBlockSize = header.blockSize;
+        auto colBlockSize = header.colBlockSize;
+
+        CHECK_RAISE_ERROR(header.valueByteSize == valueByteSize, InvalidType,
+                          "Snapshot values byte size " << header.valueByteSize << " does not match type byte size " << valueByteSize);
+
+        auto nblockRows = math::GetBlocksCount(header.nrows, rowBlockSize);
+        auto nblockCols = math::GetBlocksCount(header.ncols, colBlockSize);
+
+        for (std::size_t k = 0; k < blocks.size(); k++) {
+            auto &info = blocks[k];
+
+            CHECK_RAISE_ERROR(info.i < nblockRows && info.j < nblockCols, InvalidArgument,
+                              "Snapshot block (" << info.i << "," << info.j << ") is out of blocks grid");
+            CHECK_RAISE_ERROR(k == 0 || std::make_pair(blocks[k - 1].i, blocks[k - 1].j) < std::make_pair(info.i, info.j), InvalidArgument,
+                              "Snapshot block (" << info.i << "," << info.j << ") is out of order");
+            CHECK_RAISE_ERROR(info.format == static_cast<std::uint32_t>(MatrixBlock::Format::COO), InvalidArgument,
+                              "Snapshot block (" << info.i << "," << info.j << ") has unsupported format");
+            CHECK_RAISE_ERROR(info.nrows == math::GetBlockActualSize(info.i, header.nrows, rowBlockSize) &&
+                                      info.ncols == math::GetBlockActualSize(info.j, header.ncols, colBlockSize) &&
+                                      info.nvals > 0,
+                              InvalidArgument, "Snapshot block (" << info.i << "," << info.j << ") has invalid size");
+        }
+
+        return header;
+    }
+
+    /** Upload snapshot block data from mapped file into new COO block */
+    spla::RefPtr<spla::MatrixBlock> UploadBlock(const spla::MappedFile &file, const spla::snapshot::Block &info, std::size_t valueByteSize,
+                                                const boost::compute::context &ctx, boost::compute::command_queue &queue) {
+        using namespace spla;
+        using namespace boost;
+
+        auto nvals = static_cast<std::size_t>(info.nvals);
+        auto indicesSize = snapshot::GetAlignedSize(nvals * sizeof(unsigned int));
+        auto data = file.GetData() + info.offset;
+        auto rowsData = reinterpret_cast<const unsigned int *>(data);
+        auto colsData = reinterpret_cast<const unsigned int *>(data + indicesSize);
+        auto valsData = reinterpret_cast<const unsigned char *>(data + 2 * indicesSize);
+
+        compute::vector<unsigned int> rows(nvals, ctx);
+        compute::vector<unsigned int> cols(nvals, ctx);
+        compute::vector<unsigned char> vals(ctx);
+
+        compute::copy(rowsData, rowsData + nvals, rows.begin(), queue);
+        compute::copy(colsData, colsData + nvals, cols.begin(), queue);
+
+        if (valueByteSize) {
+            vals.resize(nvals * valueByteSize, queue);
+            compute::copy(valsData, valsData + nvals * valueByteSize, vals.begin(), queue);
+        }
+
+        auto block = MatrixCOO::Make(info.nrows, info.ncols, nvals, std::move(rows), std::move(cols), std::move(vals));
+        return block.As<MatrixBlock>();
+    }
+
+    /**
+     * Deleter of shared blocks map, which releases memory counter of blocks counted by the map,
+     * when last owner storage releases it. Block is counted by the map it was set into, so
+     * blocks copied into detached map are not counted twice.
+     */
+    struct BlocksMapDeleter {
+        spla::Tracer *tracer;
+        std::unordered_map<spla::MatrixStorage::Index, std::size_t, spla::PairHash> counted;
+
+        void operator()(spla::MatrixStorage::EntryMap *entryMap) const {
+            std::size_t memoryUsage = 0;
+            for (auto &entry : counted)
+                memoryUsage += entry.second;
+
+            tracer->AddCounter(BLOCKS_MEMORY_COUNTER, -static_cast<std::int64_t>(memoryUsage));
+            delete entryMap;
+        }
+    };
+
+    spla::MatrixStorage::EntryMapPtr MakeBlocksMap(spla::Tracer &tracer, spla::MatrixStorage::EntryMap entryMap = {}) {
+        using namespace spla;
+        return MatrixStorage::EntryMapPtr(new MatrixStorage::EntryMap(std::move(entryMap)), BlocksMapDeleter{&tracer, {}});
+    }
+
+    /** Counts memory of block, set into the map at index; @return Change of memory counter */
+    std::int64_t CountBlock(const spla::MatrixStorage::EntryMapPtr &blocks, const spla::MatrixStorage::Index &index, std::size_t memoryUsage) {
+        auto &counted = std::get_deleter<BlocksMapDeleter>(blocks)->counted;
+        auto &prev = counted[index];
+        auto change = static_cast<std::int64_t>(memoryUsage) - static_cast<std::int64_t>(prev);
+        prev = memoryUsage;
+        return change;
+    }
+
+    /** Stops counting memory of block, removed from the map at index; @return Change of memory counter */
+    std::int64_t UncountBlock(const spla::MatrixStorage::EntryMapPtr &blocks, const spla::MatrixStorage::Index &index) {
+        auto &counted = std::get_deleter<BlocksMapDeleter>(blocks)->counted;
+        auto found = counted.find(index);
+        if (found == counted.end())
+            return 0;
+
+        auto change = -static_cast<std::int64_t>(found->second);
+        counted.erase(found);
+        return change;
+    }
+}// namespace
+
+class spla::MatrixStorage::SnapshotCache {
+public:
+    SnapshotCache(std::shared_ptr<MappedFile> file, std::size_t valueByteSize, Library &library)
+        : mFile(std::move(file)), mValueByteSize(valueByteSize), mLibrary(library) {
+        mMemoryBudget = library.GetPrivate().GetContextConfig().GetMappedMemoryBudget();
+    }
+
+    ~SnapshotCache() {
+        mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, -static_cast<std::int64_t>(mResidentMemoryUsage));
+    }
+
+    [[nodiscard]] const MappedFile &GetFile() const { return *mFile; }
+    [[nodiscard]] std::size_t GetValueByteSize() const { return mValueByteSize; }
+
+    /** @return Uploaded block, marked as most recently used; null if block is not uploaded */
+    RefPtr<MatrixBlock> Find(const Index &index) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto resident = mResidentBlocks.find(index);
+        if (resident == mResidentBlocks.end())
+            return nullptr;
+
+        mResidentOrder.splice(mResidentOrder.begin(), mResidentOrder, mResidentOrderEntries[index]);
+        return resident->second;
+    }
+
+    /** Add uploaded block and evict least recently used ones; @return Block, uploaded first, if upload raced */
+    RefPtr<MatrixBlock> Insert(const Index &index, const RefPtr<MatrixBlock> &block) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto resident = mResidentBlocks.find(index);
+        if (resident != mResidentBlocks.end())
+            return resident->second;
+
+        mResidentBlocks.emplace(index, block);
+        mResidentOrder.push_front(index);
+        mResidentOrderEntries.emplace(index, mResidentOrder.begin());
+        mResidentMemoryUsage += block->GetMemoryUsage();
+        mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, static_cast<std::int64_t>(block->GetMemoryUsage()));
+
+        // Evict least recently used blocks, but always keep just uploaded one
+        while (mMemoryBudget && mResidentMemoryUsage > mMemoryBudget && mResidentOrder.size() > 1) {
+            auto evicted = mResidentOrder.back();
+            SPDLOG_LOGGER_TRACE(mLibrary.GetPrivate().GetLogger(), "Evict snapshot block ({},{}) memory={}",
+                                evicted.first, evicted.second, mResidentBlocks[evicted]->GetMemoryUsage());
+            DropUnlocked(evicted);
+        }
+
+        return block;
+    }
+
+    /** Remove uploaded block data, if present */
+    void Drop(const Index &index) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        DropUnlocked(index);
+    }
+
+private:
+    void DropUnlocked(const Index &index) {
+        auto resident = mResidentBlocks.find(index);
+        if (resident == mResidentBlocks.end())
+            return;
+
+        auto memoryUsage = resident->second->GetMemoryUsage();
+        mResidentMemoryUsage -= memoryUsage;
+        mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, -static_cast<std::int64_t>(memoryUsage));
+        mResidentBlocks.erase(resident);
+        mResidentOrder.erase(mResidentOrderEntries[index]);
+        mResidentOrderEntries.erase(index);
+    }
+
+    std::shared_ptr<MappedFile> mFile;
+    std::size_t mValueByteSize;
+    std::size_t mMemoryBudget = 0;
+    EntryMap mResidentBlocks;
+    std::list<Index> mResidentOrder;
+    std::unordered_map<Index, std::list<Index>::iterator, PairHash> mResidentOrderEntries;
+    std::size_t mResidentMemoryUsage = 0;
+    Library &mLibrary;
+    std::mutex mMutex;
+};
+
+spla::MatrixStorage::~MatrixStorage() = default;
 
 void spla::MatrixStorage::Clear() {
     std::lock_guard<std::mutex> lock(mMutex);
     mNvals = 0;
-    mBlocks.clear();
+    mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer());
+    mBlockIndex.reset();
+    mSnapshotBlocks.clear();
+    mSnapshot.reset();
 }
 
 void spla::MatrixStorage::SetBlock(const spla::MatrixStorage::Index &index, const spla::RefPtr<spla::MatrixBlock> &block) {
@@ -41,13 +248,19 @@ void spla::MatrixStorage::SetBlock(const spla::MatrixStorage::Index &index, cons
     assert(block.IsNotNull());
 
     std::lock_guard<std::mutex> lock(mMutex);
-    auto &prev = mBlocks[index];
+    DropSnapshotBlock(index);
+    DetachBlocks();
+
+    auto &prev = (*mBlocks)[index];
 
-    if (prev.IsNotNull())
+    if (prev.IsNotNull()) {
         mNvals -= prev->GetNvals();
+    } else
+        mBlockIndex.reset();
 
     prev = block;
     mNvals += block->GetNvals();
+    mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, CountBlock(mBlocks, index, block->GetMemoryUsage()));
 }
 
 void spla::MatrixStorage::RemoveBlock(const spla::MatrixStorage::Index &index) {
@@ -55,45 +268,199 @@ void spla::MatrixStorage::RemoveBlock(const spla::MatrixStorage::Index &index) {
     assert(index.second < mNblockCols);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    mBlocks.erase(index);
+    DropSnapshotBlock(index);
+
+    if (mBlocks->find(index) == mBlocks->end())
+        return;
+
+    DetachBlocks();
+
+    auto entry = mBlocks->find(index);
+    mNvals -= entry->second->GetNvals();
+    mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, UncountBlock(mBlocks, index));
+    mBlocks->erase(entry);
+    mBlockIndex.reset();
 }
 
 void spla::MatrixStorage::GetBlocks(spla::MatrixStorage::EntryList &entryList) const {
-    std::lock_guard<std::mutex> lock(mMutex);
+    EntryMap entryMap;
+    GetBlocks(entryMap);
     entryList.clear();
-    entryList.insert(entryList.begin(), mBlocks.begin(), mBlocks.end());
+    entryList.insert(entryList.begin(), entryMap.begin(), entryMap.end());
 }
 
 void spla::MatrixStorage::GetBlocks(spla::MatrixStorage::EntryMap &entryMap) const {
-    std::lock_guard<std::mutex> lock(mMutex);
-    entryMap = mBlocks;
+    std::vector<std::pair<Index, snapshot::Block>> toFetch;
+    std::shared_ptr<SnapshotCache> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        entryMap = *mBlocks;
+        cache = mSnapshot;
+        toFetch.assign(mSnapshotBlocks.begin(), mSnapshotBlocks.end());
+    }
+
+    // Distribute uploaded blocks between devices
+    auto devicesCount = mLibrary.GetPrivate().GetDeviceManager().GetDevices().size();
+
+    for (std::size_t k = 0; k < toFetch.size(); k++) {
+        auto &entry = toFetch[k];
+        auto block = FetchSnapshotBlock(entry.first, entry.second, cache, k % devicesCount);
+        if (block.IsNotNull())
+            entryMap[entry.first] = block;
+    }
 }
 
 void spla::MatrixStorage::GetBlocks(spla::MatrixStorage::EntryRowList &entryList) const {
-    std::lock_guard<std::mutex> lock(mMutex);
+    EntryMap entryMap;
+    GetBlocks(entryMap);
+    auto blockIndex = GetBlockIndex();
     entryList.clear();
-    entryList.reserve(mNblockRows);
-    for (unsigned int i = 0; i < mNblockRows; i++) {
-        auto &list = entryList.emplace_back();
-        for (unsigned int j = 0; j < mNblockCols; j++) {
-            auto entry = mBlocks.find({i, j});
-            if (entry != mBlocks.end())
+    entryList.resize(mNblockRows);
+    for (std::size_t r = 0; r < blockIndex->rows.size(); r++) {
+        auto &list = entryList[blockIndex->rows[r]];
+        for (auto k = blockIndex->offsets[r]; k < blockIndex->offsets[r + 1]; k++) {
+            auto entry = entryMap.find({blockIndex->rows[r], blockIndex->cols[k]});
+            if (entry != entryMap.end())
                 list.push_back(*entry);
         }
     }
 }
 
+void spla::MatrixStorage::GetBlocksInfo(spla::MatrixStorage::BlockInfoMap &infoMap) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    infoMap.clear();
+    infoMap.reserve(mBlocks->size() + mSnapshotBlocks.size());
+
+    for (auto &entry : *mBlocks)
+        infoMap.emplace(entry.first, BlockInfo{entry.second->GetFormat(), entry.second->GetNrows(), entry.second->GetNcols(), entry.second->GetNvals()});
+    for (auto &entry : mSnapshotBlocks)
+        infoMap.emplace(entry.first, BlockInfo{static_cast<MatrixBlock::Format>(entry.second.format), entry.second.nrows, entry.second.ncols, entry.second.nvals});
+}
+
+spla::MatrixStorage::BlockIndexPtr spla::MatrixStorage::GetBlockIndex() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mBlockIndex)
+        return mBlockIndex;
+
+    std::vector<Index> indices;
+    indices.reserve(mBlocks->size() + mSnapshotBlocks.size());
+    for (auto &entry : *mBlocks)
+        indices.push_back(entry.first);
+    for (auto &entry : mSnapshotBlocks)
+        indices.push_back(entry.first);
+
+    std::sort(indices.begin(), indices.end());
+
+    auto blockIndex = std::make_shared<BlockIndex>();
+    blockIndex->cols.reserve(indices.size());
+    blockIndex->offsets.push_back(0);
+
+    for (auto &index : indices) {
+        if (blockIndex->rows.empty() || blockIndex->rows.back() != index.first) {
+            if (!blockIndex->rows.empty())
+                blockIndex->offsets.push_back(blockIndex->cols.size());
+            blockIndex->rows.push_back(index.first);
+        }
+        blockIndex->cols.push_back(index.second);
+    }
+
+    if (!blockIndex->rows.empty())
+        blockIndex->offsets.push_back(blockIndex->cols.size());
+
+    mBlockIndex = std::move(blockIndex);
+    return mBlockIndex;
+}
+
+std::pair<std::size_t, std::size_t> spla::MatrixStorage::BlockIndex::GetRow(unsigned int row) const {
+    auto found = std::lower_bound(rows.begin(), rows.end(), row);
+    if (found == rows.end() || *found != row)
+        return {0, 0};
+
+    auto r = static_cast<std::size_t>(found - rows.begin());
+    return {offsets[r], offsets[r + 1]};
+}
+
 void spla::MatrixStorage::GetBlocksGrid(std::size_t &rows, std::size_t &cols) const {
     rows = mNblockRows;
     cols = mNblockCols;
 }
 
 spla::RefPtr<spla::MatrixBlock> spla::MatrixStorage::GetBlock(const spla::MatrixStorage::Index &index) const {
+    return GetBlock(index, 0);
+}
+
+spla::RefPtr<spla::MatrixBlock> spla::MatrixStorage::GetBlock(const spla::MatrixStorage::Index &index, std::size_t deviceId) const {
     assert(index.first < mNblockRows);
     assert(index.second < mNblockCols);
-    std::lock_guard<std::mutex> lock(mMutex);
-    auto entry = mBlocks.find(index);
-    return entry != mBlocks.end() ? entry->second : nullptr;
+
+    snapshot::Block info{};
+    std::shared_ptr<SnapshotCache> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto entry = mBlocks->find(index);
+        if (entry != mBlocks->end())
+            return entry->second;
+
+        auto snapshotEntry = mSnapshotBlocks.find(index);
+        if (snapshotEntry == mSnapshotBlocks.end())
+            return nullptr;
+
+        info = snapshotEntry->second;
+        cache = mSnapshot;
+    }
+
+    return FetchSnapshotBlock(index, info, cache, deviceId);
+}
+
+spla::RefPtr<spla::MatrixBlock> spla::MatrixStorage::GetBlock(const spla::BlockPartition &rows, const spla::BlockPartition &cols,
+                                                              const spla::MatrixStorage::Index &index, std::size_t deviceId) const {
+    using namespace boost;
+
+    assert(rows.GetDim() == mNrows);
+    assert(cols.GetDim() == mNcols);
+
+    auto rowBegin = rows.GetBlockOffset(index.first);
+    auto rowEnd = rowBegin + static_cast<unsigned int>(rows.GetBlockSize(index.first));
+    auto colBegin = cols.GetBlockOffset(index.second);
+    auto colEnd = colBegin + static_cast<unsigned int>(cols.GetBlockSize(index.second));
+
+    // Partition is changed only before storage is shared, so it is read without lock
+    auto firstRow = static_cast<unsigned int>(mRowPartition.GetBlockIndex(rowBegin));
+    auto lastRow = static_cast<unsigned int>(mRowPartition.GetBlockIndex(rowEnd - 1));
+    auto firstCol = static_cast<unsigned int>(mColPartition.GetBlockIndex(colBegin));
+    auto lastCol = static_cast<unsigned int>(mColPartition.GetBlockIndex(colEnd - 1));
+
+    // Blocks coincide, no need to copy entries
+    if (firstRow == lastRow && firstCol == lastCol &&
+        mRowPartition.GetBlockOffset(firstRow) == rowBegin && mRowPartition.GetBlockSize(firstRow) == rowEnd - rowBegin &&
+        mColPartition.GetBlockOffset(firstCol) == colBegin && mColPartition.GetBlockSize(firstCol) == colEnd - colBegin)
+        return GetBlock(Index{firstRow, firstCol}, deviceId);
+
+    EntryList blocks;
+    for (auto i = firstRow; i <= lastRow; i++) {
+        for (auto j = firstCol; j <= lastCol; j++) {
+            auto block = GetBlock(Index{i, j}, deviceId);
+            if (block.IsNotNull())
+                blocks.emplace_back(Index{i, j}, block);
+        }
+    }
+
+    if (blocks.empty())
+        return nullptr;
+
+    auto &libraryPrivate = mLibrary.GetPrivate();
+    compute::context ctx = libraryPrivate.GetContext();
+    compute::command_queue queue(ctx, libraryPrivate.GetDeviceManager().GetDevice(deviceId));
+    return ReblockMatrix(mRowPartition, mColPartition, blocks, {rowBegin, rowEnd}, {colBegin, colEnd}, queue);
+}
+
+std::size_t spla::MatrixStorage::GetLocationOwner() const noexcept {
+    return mLocationOwner;
 }
 
 std::size_t spla::MatrixStorage::GetNrows() const noexcept {
@@ -117,6 +484,47 @@ std::size_t spla::MatrixStorage::GetNblockCols() const noexcept {
     return mNblockCols;
 }
 
+const spla::BlockPartition &spla::MatrixStorage::GetRowPartition() const noexcept {
+    return mRowPartition;
+}
+
+const spla::BlockPartition &spla::MatrixStorage::GetColPartition() const noexcept {
+    return mColPartition;
+}
+
+std::size_t spla::MatrixStorage::GetRowBlockSize() const noexcept {
+    return mRowBlockSize;
+}
+
+std::size_t spla::MatrixStorage::GetColBlockSize() const noexcept {
+    return mColBlockSize;
+}
+
+bool spla::MatrixStorage::IsUniformPartition() const noexcept {
+    return mRowPartition.IsUniform() && mColPartition.IsUniform();
+}
+
+void spla::MatrixStorage::SetPartition(spla::BlockPartition rows, spla::BlockPartition cols) {
+    assert(rows.GetDim() == mNrows);
+    assert(cols.GetDim() == mNcols);
+
+    if (rows == mRowPartition && cols == mColPartition)
+        return;
+
+    Clear();
+
+    // Partition is read by processors without lock, so it is changed only before storage is shared
+    mRowPartition = std::move(rows);
+    mColPartition = std::move(cols);
+    mNblockRows = mRowPartition.GetBlocksCount();
+    mNblockCols = mColPartition.GetBlocksCount();
+
+    if (mRowPartition.IsUniform())
+        mRowBlockSize = mRowPartition.GetUniformBlockSize();
+    if (mColPartition.IsUniform())
+        mColBlockSize = mColPartition.GetUniformBlockSize();
+}
+
 void spla::MatrixStorage::Dump(std::ostream &stream) const {
     std::lock_guard<std::mutex> lock(mMutex);
 
@@ -124,39 +532,270 @@ void spla::MatrixStorage::Dump(std::ostream &stream) const {
            << " nrows=" << mNrows
            << " ncols=" << mNcols
            << " nvals=" << mNvals
-           << " bcount=" << mBlocks.size()
-           << " bsize=" << mBlockSize << std::endl;
+           << " bcount=" << mBlocks->size() + mSnapshotBlocks.size()
+           << " bsize=" << mRowBlockSize << "x" << mColBlockSize << std::endl;
 
-    auto bsize = static_cast<unsigned int>(mBlockSize);
-
-    for (auto &entry : mBlocks) {
+    for (auto &entry : *mBlocks) {
         auto &index = entry.first;
         auto &block = entry.second;
         stream << "Block (" << index.first << "," << index.second << ") ";
-        block->Dump(stream, index.first * bsize, index.second * bsize);
+        block->Dump(stream, mRowPartition.GetBlockOffset(index.first), mColPartition.GetBlockOffset(index.second));
+    }
+
+    for (auto &entry : mSnapshotBlocks) {
+        auto &index = entry.first;
+        auto resident = mSnapshot->Find(index);
+        stream << "Block (" << index.first << "," << index.second << ") ";
+
+        if (resident.IsNotNull())
+            resident->Dump(stream, mRowPartition.GetBlockOffset(index.first), mColPartition.GetBlockOffset(index.second));
+        else
+            stream << "not uploaded nvals=" << entry.second.nvals << std::endl;
     }
 }
 
 spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Clone() const {
     std::lock_guard<std::mutex> lock(mMutex);
 
-    auto storage = Make(GetNrows(), GetNcols(), mLibrary);
-    storage->mBlockSize = mBlockSize;
+    // Blocks map is shared until one of the storages is modified
+    auto storage = Make(GetNrows(), GetNcols(), mRowBlockSize, mColBlockSize, mLibrary);
+    storage->mRowPartition = mRowPartition;
+    storage->mColPartition = mColPartition;
+    storage->mNblockRows = mNblockRows;
+    storage->mNblockCols = mNblockCols;
     storage->mBlocks = mBlocks;
+    storage->mLocationOwner = mLocationOwner;
+    storage->mBlockIndex = mBlockIndex;
     storage->mNvals = mNvals;
+    storage->mSnapshot = mSnapshot;
+    storage->mSnapshotBlocks = mSnapshotBlocks;
+
+    return storage;
+}
+
+void spla::MatrixStorage::Save(const Filename &filename, std::size_t valueByteSize) const {
+    using namespace boost;
+
+    CHECK_RAISE_ERROR(IsUniformPartition(), NotImplemented,
+                      "Snapshot of matrix with non-uniform blocks partition is not supported");
+
+    // Snapshot blocks are copied from mapped file as is, so they are not uploaded to the device
+    struct ToSave {
+        Index index;
+        RefPtr<MatrixBlock> block;
+        snapshot::Block info{};
+    };
+
+    std::vector<ToSave> entries;
+    std::shared_ptr<SnapshotCache> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        entries.reserve(mBlocks->size() + mSnapshotBlocks.size());
+        for (auto &entry : *mBlocks)
+            entries.push_back(ToSave{entry.first, entry.second});
+        for (auto &entry : mSnapshotBlocks)
+            entries.push_back(ToSave{entry.first, nullptr, entry.second});
+        cache = mSnapshot;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const ToSave &a, const ToSave &b) { return a.index < b.index; });
+
+    CHECK_RAISE_ERROR(!cache || cache->GetValueByteSize() == valueByteSize, InvalidType,
+                      "Mapped snapshot values byte size does not match type byte size " << valueByteSize);
+
+    snapshot::Header header{};
+    std::memcpy(header.magic, snapshot::MatrixMagic, sizeof(header.magic));
+    header.version = snapshot::Version;
+    header.valueByteSize = static_cast<std::uint32_t>(valueByteSize);
+    header.nrows = mNrows;
+    header.ncols = mNcols;
+    header.blockSize = mRowBlockSize;
+    header.colBlockSize = mColBlockSize;
+    header.blocksCount = entries.size();
+
+    std::vector<snapshot::Block> blocks;
+    blocks.reserve(entries.size());
+    auto offset = snapshot::GetDataOffset(entries.size());
+
+    for (auto &entry : entries) {
+        snapshot::Block info{};
+
+        if (entry.block.IsNotNull()) {
+            auto &block = entry.block;
+            CHECK_RAISE_ERROR(block->GetFormat() == MatrixBlock::Format::COO, NotImplemented,
+                              "Snapshot of non-COO matrix blocks is not supported");
+            CHECK_RAISE_ERROR(block.Cast<MatrixCOO>()->GetVals().size() == block->GetNvals() * valueByteSize, InvalidType,
+                              "Block values byte size does not match type byte size " << valueByteSize);
+
+            info.format = static_cast<std::uint32_t>(block->GetFormat());
+            info.nrows = block->GetNrows();
+            info.ncols = block->GetNcols();
+            info.nvals = block->GetNvals();
+        } else
+            info = entry.info;
+
+        info.i = entry.index.first;
+        info.j = entry.index.second;
+        info.offset = offset;
+        blocks.push_back(info);
+
+        header.nvals += info.nvals;
+        offset += snapshot::GetBlockDataSize(info.nvals, valueByteSize, true);
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    CHECK_RAISE_ERROR(file.is_open(), MemOpFailed, "Failed to open snapshot file for writing");
+
+    snapshot::WriteHeader(file, header, blocks);
+
+    compute::context ctx = mLibrary.GetPrivate().GetContext();
+    compute::command_queue queue(ctx, ctx.get_device());
+
+    std::vector<unsigned int> rows;
+    std::vector<unsigned int> cols;
+    std::vector<unsigned char> vals;
+
+    for (auto &entry : entries) {
+        if (entry.block.IsNull()) {
+            auto nvals = static_cast<std::size_t>(entry.info.nvals);
+            auto indicesSize = snapshot::GetAlignedSize(nvals * sizeof(unsigned int));
+            auto data = cache->GetFile().GetData() + entry.info.offset;
+
+            snapshot::WriteArray(file, data, nvals * sizeof(unsigned int));
+            snapshot::WriteArray(file, data + indicesSize, nvals * sizeof(unsigned int));
+            snapshot::WriteArray(file, data + 2 * indicesSize, nvals * valueByteSize);
+            continue;
+        }
+
+        auto block = entry.block.Cast<MatrixCOO>();
+        assert(block.IsNotNull());
+
+        rows.resize(block->GetNvals());
+        cols.resize(block->GetNvals());
+        vals.resize(block->GetVals().size());
+
+        compute::copy(block->GetRows().begin(), block->GetRows().end(), rows.begin(), queue);
+        compute::copy(block->GetCols().begin(), block->GetCols().end(), cols.begin(), queue);
+        if (!vals.empty())
+            compute::copy(block->GetVals().begin(), block->GetVals().end(), vals.begin(), queue);
+
+        snapshot::WriteArray(file, rows.data(), rows.size() * sizeof(unsigned int));
+        snapshot::WriteArray(file, cols.data(), cols.size() * sizeof(unsigned int));
+        snapshot::WriteArray(file, vals.data(), vals.size());
+    }
+}
+
+spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Load(const Filename &filename, std::size_t valueByteSize, spla::Library &library) {
+    using namespace boost;
+
+    MappedFile file(filename);
+    std::vector<snapshot::Block> blocks;
+    auto header = ReadSnapshot(file, valueByteSize, blocks);
+    auto storage = Make(header.nrows, header.ncols, header.blockSize, header.colBlockSize, library);
+
+    // Upload blocks directly from mapped file, distributing them between devices
+    auto &libraryPrivate = library.GetPrivate();
+    compute::context ctx = libraryPrivate.GetContext();
+    auto &devices = libraryPrivate.GetDeviceManager().GetDevices();
+    std::vector<compute::command_queue> queues;
+    queues.reserve(devices.size());
+    for (auto &device : devices)
+        queues.emplace_back(ctx, device);
+
+    for (std::size_t k = 0; k < blocks.size(); k++) {
+        auto &info = blocks[k];
+        auto block = UploadBlock(file, info, valueByteSize, ctx, queues[k % queues.size()]);
+        storage->SetBlock(Index{info.i, info.j}, block);
+    }
+
+    return storage;
+}
+
+spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Map(const Filename &filename, std::size_t valueByteSize, spla::Library &library) {
+    auto file = std::make_shared<MappedFile>(filename);
+    std::vector<snapshot::Block> blocks;
+    auto header = ReadSnapshot(*file, valueByteSize, blocks);
+    auto storage = Make(header.nrows, header.ncols, header.blockSize, header.colBlockSize, library);
+
+    storage->mSnapshot = std::make_shared<SnapshotCache>(std::move(file), valueByteSize, library);
+    storage->mNvals = header.nvals;
+
+    for (auto &info : blocks)
+        storage->mSnapshotBlocks.emplace(Index{info.i, info.j}, info);
 
     return storage;
 }
 
-spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Make(std::size_t nrows, std::size_t ncols, spla::Library &library) {
+spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Make(std::size_t nrows, std::size_t ncols, spla::Library &library, std::size_t nvals) {
+    auto &libraryPrivate = library.GetPrivate();
+    return Make(nrows, ncols, libraryPrivate.GetBlockSize(nrows, nvals), libraryPrivate.GetBlockSize(ncols, nvals), library);
+}
+
+spla::RefPtr<spla::MatrixStorage> spla::MatrixStorage::Make(std::size_t nrows, std::size_t ncols,
+                                                            std::size_t rowBlockSize, std::size_t colBlockSize,
+                                                            spla::Library &library) {
     assert(nrows > 0);
     assert(ncols > 0);
-    return spla::RefPtr<spla::MatrixStorage>(new MatrixStorage(nrows, ncols, library));
+    assert(rowBlockSize > 0);
+    assert(colBlockSize > 0);
+    return spla::RefPtr<spla::MatrixStorage>(new MatrixStorage(nrows, ncols, rowBlockSize, colBlockSize, library));
+}
+
+spla::MatrixStorage::MatrixStorage(std::size_t nrows, std::size_t ncols, std::size_t rowBlockSize, std::size_t colBlockSize, spla::Library &library)
+    : mLocationOwner(library.GetPrivate().GetDeviceManager().NewLocationOwner()),
+      mNrows(nrows), mNcols(ncols), mRowBlockSize(rowBlockSize), mColBlockSize(colBlockSize), mLibrary(library) {
+    mRowPartition = BlockPartition::Uniform(nrows, mRowBlockSize);
+    mColPartition = BlockPartition::Uniform(ncols, mColBlockSize);
+    mNblockRows = mRowPartition.GetBlocksCount();
+    mNblockCols = mColPartition.GetBlocksCount();
+    mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer());
+}
+
+void spla::MatrixStorage::DetachBlocks() {
+    // Blocks are immutable, so only map itself is copied; blocks stay shared and counted by the source map
+    if (mBlocks.use_count() > 1)
+        mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer(), *mBlocks);
+}
+
+spla::RefPtr<spla::MatrixBlock> spla::MatrixStorage::FetchSnapshotBlock(const Index &index, const snapshot::Block &info,
+                                                                        const std::shared_ptr<SnapshotCache> &cache, std::size_t deviceId) const {
+    using namespace boost;
+
+    if (!cache)
+        return nullptr;
+
+    auto block = cache->Find(index);
+
+    if (block.IsNull()) {
+        // Upload without lock to the device of the caller, so other blocks can be accessed meanwhile
+        auto &libraryPrivate = mLibrary.GetPrivate();
+        compute::context ctx = libraryPrivate.GetContext();
+        compute::command_queue queue(ctx, libraryPrivate.GetDeviceManager().GetDevice(deviceId));
+        block = cache->Insert(index, UploadBlock(cache->GetFile(), info, cache->GetValueByteSize(), ctx, queue));
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Storage could be modified meanwhile
+    if (mSnapshot != cache || mSnapshotBlocks.find(index) == mSnapshotBlocks.end()) {
+        auto entry = mBlocks->find(index);
+        return entry != mBlocks->end() ? entry->second : nullptr;
+    }
+
+    return block;
 }
 
-spla::MatrixStorage::MatrixStorage(std::size_t nrows, std::size_t ncols, spla::Library &library)
-    : mNrows(nrows), mNcols(ncols), mLibrary(library) {
-    mBlockSize = mLibrary.GetPrivate().GetBlockSize();
-    mNblockRows = math::GetBlocksCount(nrows, mBlockSize);
-    mNblockCols = math::GetBlocksCount(ncols, mBlockSize);
-}
\ No newline at end of file
+void spla::MatrixStorage::DropSnapshotBlock(const Index &index) {
+    auto snapshotEntry = mSnapshotBlocks.find(index);
+    if (snapshotEntry == mSnapshotBlocks.end())
+        return;
+
+    mNvals -= snapshotEntry->second.nvals;
+    mSnapshotBlocks.erase(snapshotEntry);
+    mBlockIndex.reset();
+
+    // Uploaded data is kept while clones may still reference the block
+    if (mSnapshot.use_count() == 1)
+        mSnapshot->Drop(index);
+}
@@ -29,9 +29,12 @@
 #define SPLA_SPLAMATRIXSTORAGE_HPP
 
 #include <core/SplaHash.hpp>
+#include <memory>
 #include <mutex>
 #include <spla-cpp/SplaLibrary.hpp>
+#include <storage/SplaBlockPartition.hpp>
 #include <storage/SplaMatrixBlock.hpp>
+#include <storage/SplaStorageSnapshot.hpp>
 #include <unordered_map>
 #include <vector>
 
@@ -49,6 +52,10 @@ namespace spla {
      * where each block has size `library.blockSize` x `library.blockSize`.
      * Right and bottom blocks has clamped size, so they fit matrix dimension.
      *
+     * Storage can be repartitioned with non-uniform row and column split points
+     * (see `MatrixStorage::SetPartition`), for instance to balance number of values
+     * between blocks of power-law matrices. Number of blocks in each dimension is preserved.
+     *
      * Blocks are indexed using {i,j} indices, where i in [0..blocks in row)
      * and j in [0..blocks in col). Empty blocks are not stored.
      *
@@ -71,6 +78,20 @@ namespace spla {
      *                 (1, 1) : [ (1, 0, 4.0f), (1, 1, 7.0f) ] )}
      * @endcode
      *
+     * Storage can be backed by memory mapped snapshot file (see `MatrixStorage::Map`).
+     * In this case snapshot blocks are described only by metadata and uploaded to the device
+     * on first access through `GetBlock` and `GetBlocks`. Uploaded snapshot blocks are cached
+     * and evicted in least recently used order, when they exceed library mapped memory budget.
+     * Cache is shared by storage and its clones, so budget is applied once for the same blocks.
+     * Blocks, set or removed explicitly, replace snapshot blocks and are never evicted.
+     *
+     * Block-wise processing should query blocks shapes with `GetBlocksInfo` and fetch
+     * each block with `GetBlock` in the task, which processes it, so mapped blocks are
+     * uploaded to the device of the task and can be evicted after use.
+     *
+     * Blocks are immutable once set into storage. Cloned storages share blocks map
+     * until one of them is modified, so clone of the storage costs no device memory.
+     *
      * @see MatrixCOO
      * @see MatrixBlock
      *
@@ -83,8 +104,37 @@ namespace spla {
         using EntryList = std::vector<Entry>;
         using EntryRowList = std::vector<EntryList>;
         using EntryMap = std::unordered_map<Index, RefPtr<MatrixBlock>, PairHash>;
+        using EntryMapPtr = std::shared_ptr<EntryMap>;
+
+        /** Shape of stored block, known without upload of mapped snapshot block */
+        struct BlockInfo {
+            MatrixBlock::Format format = MatrixBlock::Format::COO;
+            std::size_t nrows = 0;
+            std::size_t ncols = 0;
+            std::size_t nvals = 0;
+        };
+
+        using BlockInfoMap = std::unordered_map<Index, BlockInfo, PairHash>;
+
+        /**
+         * Sorted index of non-empty blocks in doubly compressed rows form (DCSR of blocks).
+         * Allows to enumerate blocks of block row in time proportional to number of non-empty blocks.
+         */
+        struct BlockIndex {
+            /** Non-empty block rows in ascending order */
+            std::vector<unsigned int> rows;
+            /** Range of each non-empty block row in cols; has rows.size() + 1 entries */
+            std::vector<std::size_t> offsets;
+            /** Block columns of non-empty blocks, ascending within block row */
+            std::vector<unsigned int> cols;
 
-        ~MatrixStorage() override = default;
+            /** @return Range [first, last) of block row in cols; empty if block row has no blocks */
+            [[nodiscard]] std::pair<std::size_t, std::size_t> GetRow(unsigned int row) const;
+        };
+
+        using BlockIndexPtr = std::shared_ptr<const BlockIndex>;
+
+        ~MatrixStorage() override;
 
         /** Remove all blocks from storage (empty matrix) */
         void Clear();
@@ -98,18 +148,51 @@ namespace spla {
         /** Get list of non-null presented blocks in storage */
         void GetBlocks(EntryList &entryList) const;
 
-        /** Get map of non-null presented blocks in storage */
+        /**
+         * Get map of non-null presented blocks in storage.
+         * @note Uploads all mapped snapshot blocks at once; use `GetBlocksInfo` and `GetBlock` to process blocks one by one.
+         */
         void GetBlocks(EntryMap &entryMap) const;
 
         /** Get list of non-null presented blocks in storage per row */
         void GetBlocks(EntryRowList &entryList) const;
 
+        /**
+         * Get sorted index of non-empty blocks.
+         * Index is built on first query after storage modification and is shared with clones.
+         *
+         * @return Immutable index of blocks, present in storage at the moment of the call
+         */
+        BlockIndexPtr GetBlockIndex() const;
+
+        /** Get shapes of non-null presented blocks in storage; mapped snapshot blocks are not uploaded */
+        void GetBlocksInfo(BlockInfoMap &infoMap) const;
+
         /** Get blocks grid (number of blocks in each dimension) */
         void GetBlocksGrid(std::size_t &rows, std::size_t &cols) const;
 
         /** @return Block at specified index; may be null */
         RefPtr<MatrixBlock> GetBlock(const Index &index) const;
 
+        /** @return Block at specified index, mapped snapshot block is uploaded to device with deviceId; may be null */
+        RefPtr<MatrixBlock> GetBlock(const Index &index, std::size_t deviceId) const;
+
+        /**
+         * Get block of other blocks partition, made of entries of storage blocks.
+         * Storage block is returned as is, if it coincides with requested block.
+         *
+         * @param rows Rows partition of the storage dimension
+         * @param cols Columns partition of the storage dimension
+         * @param index Index of block in partitions
+         * @param deviceId Id of the device to copy entries on
+         *
+         * @return Block at specified index of partitions; may be null
+         */
+        RefPtr<MatrixBlock> GetBlock(const BlockPartition &rows, const BlockPartition &cols, const Index &index, std::size_t deviceId) const;
+
+        /** @return Id of the storage blocks locations for device scheduling; shared with clones */
+        [[nodiscard]] std::size_t GetLocationOwner() const noexcept;
+
         /** @return Number of rows of the storage */
         [[nodiscard]] std::size_t GetNrows() const noexcept;
 
@@ -125,33 +208,141 @@ namespace spla {
         /** @return Number of cols of blocks */
         [[nodiscard]] std::size_t GetNblockCols() const noexcept;
 
+        /** @return Split of matrix rows into blocks */
+        [[nodiscard]] const BlockPartition &GetRowPartition() const noexcept;
+
+        /** @return Split of matrix columns into blocks */
+        [[nodiscard]] const BlockPartition &GetColPartition() const noexcept;
+
+        /** @return Size of blocks of uniform rows partition of this storage */
+        [[nodiscard]] std::size_t GetRowBlockSize() const noexcept;
+
+        /** @return Size of blocks of uniform columns partition of this storage */
+        [[nodiscard]] std::size_t GetColBlockSize() const noexcept;
+
+        /** @return True if both row and column partitions are uniform */
+        [[nodiscard]] bool IsUniformPartition() const noexcept;
+
+        /**
+         * Set rows and columns split points of the storage.
+         * Storage content is cleared, since existing blocks do not fit new partition.
+         * If partition is not changed, storage content is kept.
+         * Uniform partition also replaces rows (columns) block size of the storage.
+         *
+         * @param rows Split of matrix rows; must partition matrix rows
+         * @param cols Split of matrix columns; must partition matrix columns
+         */
+        void SetPartition(BlockPartition rows, BlockPartition cols);
+
         /** Dump matrix content to provided stream */
         void Dump(std::ostream &stream) const;
 
-        /** @return Cloned `cow` storage */
+        /**
+         * Clone storage in copy-on-write manner.
+         * Clone shares blocks map with this storage, so it takes constant time and no device memory.
+         * Map is copied by the storage on first modification; blocks themselves are never copied.
+         *
+         * @return Cloned storage
+         */
         RefPtr<MatrixStorage> Clone() const;
 
         /**
-         * Make new matrix storage.
+         * Save storage blocks into binary snapshot file.
+         * @throw Error with `NotImplemented` status if storage has non-uniform partition.
+         * @see SplaStorageSnapshot.hpp
+         *
+         * @param filename Name of the file to write
+         * @param valueByteSize Size of stored values in bytes
+         */
+        void Save(const Filename &filename, std::size_t valueByteSize) const;
+
+        /**
+         * Make new matrix storage with block size chosen by library for each dimension.
          *
          * @param nrows Number of rows in matrix
          * @param ncols Number of column in matrix
          * @param library Library instance
+         * @param nvals Expected number of values; zero if unknown
          *
          * @return New empty storage instance
          */
-        static RefPtr<MatrixStorage> Make(std::size_t nrows, std::size_t ncols, Library &library);
+        static RefPtr<MatrixStorage> Make(std::size_t nrows, std::size_t ncols, Library &library, std::size_t nvals = 0);
+
+        /**
+         * Make new matrix storage with specified blocks grid.
+         *
+         * @param nrows Number of rows in matrix
+         * @param ncols Number of column in matrix
+         * @param rowBlockSize Number of rows in block; must be greater than zero
+         * @param colBlockSize Number of columns in block; must be greater than zero
+         * @param library Library instance
+         *
+         * @return New empty storage instance
+         */
+        static RefPtr<MatrixStorage> Make(std::size_t nrows, std::size_t ncols, std::size_t rowBlockSize, std::size_t colBlockSize, Library &library);
+
+        /**
+         * Load storage from binary snapshot file.
+         * Blocks data is uploaded into COO blocks as is, without sort and duplicates reduction.
+         * Storage gets blocks grid of the snapshot.
+         * @throw Error with `InvalidArgument` status if snapshot is invalid.
+         * @throw Error with `InvalidType` status if snapshot has different values byte size.
+         *
+         * @param filename Name of the file to load
+         * @param valueByteSize Expected size of stored values in bytes
+         * @param library Library instance
+         *
+         * @return New storage instance
+         */
+        static RefPtr<MatrixStorage> Load(const Filename &filename, std::size_t valueByteSize, Library &library);
+
+        /**
+         * Make storage backed by memory mapped snapshot file.
+         * Blocks are uploaded lazily on first access and evicted under library mapped memory budget.
+         * Storage gets blocks grid of the snapshot.
+         * @throw Error with `InvalidArgument` status if snapshot is invalid.
+         * @throw Error with `InvalidType` status if snapshot has different values byte size.
+         *
+         * @param filename Name of the file to map; file must not be changed while storage is alive
+         * @param valueByteSize Expected size of stored values in bytes
+         * @param library Library instance
+         *
+         * @return New storage instance
+         */
+        static RefPtr<MatrixStorage> Map(const Filename &filename, std::size_t valueByteSize, Library &library);
 
     private:
-        MatrixStorage(std::size_t nrows, std::size_t ncols, Library &library);
+        /** Uploaded blocks of mapped snapshot, shared by storage and its clones */
+        class SnapshotCache;
+
+        MatrixStorage(std::size_t nrows, std::size_t ncols, std::size_t rowBlockSize, std::size_t colBlockSize, Library &library);
 
-        EntryMap mBlocks;
+        /** @return Snapshot block, uploading it to device if required; must be called without lock */
+        RefPtr<MatrixBlock> FetchSnapshotBlock(const Index &index, const snapshot::Block &info,
+                                               const std::shared_ptr<SnapshotCache> &cache, std::size_t deviceId) const;
+
+        /** Remove snapshot block metadata and uploaded data; must be called under lock */
+        void DropSnapshotBlock(const Index &index);
+
+        /** Make blocks map unique before modification, if it is shared with clones; must be called under lock */
+        void DetachBlocks();
+
+        EntryMapPtr mBlocks;
+        std::size_t mLocationOwner;
+        mutable BlockIndexPtr mBlockIndex;
         std::size_t mNrows;
         std::size_t mNcols;
         std::size_t mNvals = 0;
         std::size_t mNblockRows = 0;
         std::size_t mNblockCols = 0;
-        std::size_t mBlockSize = 0;
+        std::size_t mRowBlockSize = 0;
+        std::size_t mColBlockSize = 0;
+        BlockPartition mRowPartition;
+        BlockPartition mColPartition;
+
+        // Snapshot backing of mapped storage
+        std::shared_ptr<SnapshotCache> mSnapshot;
+        std::unordered_map<Index, snapshot::Block, PairHash> mSnapshotBlocks;
 
         Library &mLibrary;
         mutable std::mutex mMutex;
@@ -0,0 +1,87 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <cassert>
+#include <core/SplaError.hpp>
+#include <cstring>
+#include <storage/SplaStorageSnapshot.hpp>
+
+void spla::snapshot::WriteHeader(std::ostream &stream, const Header &header, const std::vector<Block> &blocks) {
+    assert(header.blocksCount == blocks.size());
+
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(Block)));
+    CHECK_RAISE_ERROR(stream.good(), MemOpFailed, "Failed to write snapshot header");
+}
+
+void spla::snapshot::WriteArray(std::ostream &stream, const void *data, std::size_t size) {
+    const char padding[Alignment] = {};
+    auto paddingSize = GetAlignedSize(size) - size;
+
+    stream.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+    stream.write(padding, static_cast<std::streamsize>(paddingSize));
+    CHECK_RAISE_ERROR(stream.good(), MemOpFailed, "Failed to write snapshot data");
+}
+
+spla::snapshot::Header spla::snapshot::ReadHeader(const MappedFile &file, const char (&magic)[8], bool hasCols, std::vector<Block> &blocks) {
+    Header header{};
+
+    CHECK_RAISE_ERROR(file.GetSize() >= sizeof(Header), InvalidArgument, "Snapshot file is too small");
+    std::memcpy(&header, file.GetData(), sizeof(Header));
+
+    CHECK_RAISE_ERROR(std::memcmp(header.magic, magic, sizeof(header.magic)) == 0, InvalidArgument,
+                      "Invalid snapshot magic; expected " << magic);
+    CHECK_RAISE_ERROR(header.version == Version, InvalidArgument,
+                      "Unsupported snapshot version " << header.version << "; expected " << Version);
+    CHECK_RAISE_ERROR(header.nrows > 0 && header.ncols > 0 && header.blockSize > 0 && header.colBlockSize > 0, InvalidArgument,
+                      "Invalid snapshot dimensions");
+
+    auto dataOffset = GetDataOffset(header.blocksCount);
+    CHECK_RAISE_ERROR(header.blocksCount <= file.GetSize() / sizeof(Block) && dataOffset <= file.GetSize(), InvalidArgument,
+                      "Snapshot blocks table is truncated");
+
+    blocks.resize(header.blocksCount);
+    std::memcpy(blocks.data(), file.GetData() + sizeof(Header), blocks.size() * sizeof(Block));
+
+    std::uint64_t nvals = 0;
+
+    for (auto &block : blocks) {
+        auto dataSize = GetBlockDataSize(block.nvals, header.valueByteSize, hasCols);
+
+        CHECK_RAISE_ERROR(block.nvals <= file.GetSize() && block.offset % Alignment == 0 &&
+                                  block.offset >= dataOffset && block.offset <= file.GetSize() &&
+                                  dataSize <= file.GetSize() - block.offset,
+                          InvalidArgument, "Snapshot block (" << block.i << "," << block.j << ") data is truncated");
+
+        nvals += block.nvals;
+    }
+
+    CHECK_RAISE_ERROR(nvals == header.nvals, InvalidArgument,
+                      "Snapshot blocks have " << nvals << " values; expected " << header.nvals);
+
+    return header;
+}
@@ -0,0 +1,135 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLASTORAGESNAPSHOT_HPP
+#define SPLA_SPLASTORAGESNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utils/SplaMappedFile.hpp>
+#include <vector>
+
+namespace spla::snapshot {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * Binary snapshot layout of matrix and vector storages.
+     *
+     * Snapshot file starts with Header, followed by the table of `blocksCount`
+     * Block entries in (block row, block column) order, followed by blocks data.
+     * Data of each block starts at its `offset` and consists of rows indices,
+     * cols indices (matrix only) and values arrays, each padded to `Alignment` bytes.
+     * Indices are block-local, sorted and have no duplicates, exactly as in COO blocks.
+     * Blocks grid is uniform with `blockSize` rows and `colBlockSize` columns per block.
+     * All fields are stored in native byte order.
+     */
+
+    /** Current snapshot format version; incremented on any layout change */
+    constexpr std::uint32_t Version = 2;
+
+    /** Alignment of the blocks data arrays in the file */
+    constexpr std::size_t Alignment = 8;
+
+    constexpr char MatrixMagic[8] = {'S', 'P', 'L', 'A', 'M', 'T', 'X', '\0'};
+    constexpr char VectorMagic[8] = {'S', 'P', 'L', 'A', 'V', 'E', 'C', '\0'};
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t valueByteSize;
+        std::uint64_t nrows;
+        std::uint64_t ncols;
+        std::uint64_t nvals;
+        std::uint64_t blockSize;
+        std::uint64_t blocksCount;
+        std::uint64_t colBlockSize;
+    };
+
+    struct Block {
+        std::uint32_t i;
+        std::uint32_t j;
+        std::uint32_t format;
+        std::uint32_t reserved;
+        std::uint64_t nrows;
+        std::uint64_t ncols;
+        std::uint64_t nvals;
+        std::uint64_t offset;
+    };
+
+    /** @return Size padded to the snapshot alignment */
+    inline std::uint64_t GetAlignedSize(std::uint64_t size) {
+        return (size + Alignment - 1) / Alignment * Alignment;
+    }
+
+    /** @return Size of the block data in file */
+    inline std::uint64_t GetBlockDataSize(std::uint64_t nvals, std::uint64_t valueByteSize, bool hasCols) {
+        auto indicesSize = GetAlignedSize(nvals * sizeof(std::uint32_t));
+        return indicesSize * (hasCols ? 2 : 1) + GetAlignedSize(nvals * valueByteSize);
+    }
+
+    /** @return Offset of the first block data in file */
+    inline std::uint64_t GetDataOffset(std::uint64_t blocksCount) {
+        return sizeof(Header) + blocksCount * sizeof(Block);
+    }
+
+    /**
+     * Write snapshot header and blocks table.
+     * @throw Error with `MemOpFailed` status if failed to write.
+     */
+    void WriteHeader(std::ostream &stream, const Header &header, const std::vector<Block> &blocks);
+
+    /**
+     * Write array of block data, padded to the snapshot alignment.
+     * @throw Error with `MemOpFailed` status if failed to write.
+     */
+    void WriteArray(std::ostream &stream, const void *data, std::size_t size);
+
+    /**
+     * Read and validate snapshot header and blocks table of mapped file.
+     * @throw Error with `InvalidArgument` status if file is not a valid snapshot of expected kind.
+     *
+     * @param file Mapped snapshot file
+     * @param magic Expected snapshot kind magic
+     * @param hasCols True if blocks data has cols indices array
+     * @param[out] blocks Blocks table
+     *
+     * @return Snapshot header
+     */
+    Header ReadHeader(const MappedFile &file, const char (&magic)[8], bool hasCols, std::vector<Block> &blocks);
+
+    /**
+     * @}
+     */
+
+}// namespace spla::snapshot
+
+#endif//SPLA_SPLASTORAGESNAPSHOT_HPP
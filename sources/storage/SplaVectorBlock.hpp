@@ -75,6 +75,9 @@ namespace spla {
         /** Dump vector content to provided stream */
         virtual void Dump(std::ostream &stream, unsigned int baseI) const = 0;
 
+        /** @return Size of the device memory used by the block (in bytes) */
+        [[nodiscard]] virtual std::size_t GetMemoryUsage() const noexcept = 0;
+
     protected:
         std::size_t mNrows;
         std::size_t mNvals;
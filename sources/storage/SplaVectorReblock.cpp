@@ -0,0 +1,114 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <algorithm>
+#include <boost/compute.hpp>
+#include <core/SplaError.hpp>
+#include <storage/SplaVectorReblock.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+
+spla::RefPtr<spla::VectorBlock> spla::ReblockVector(const spla::BlockPartition &partition,
+                                                    std::size_t first,
+                                                    const std::vector<RefPtr<VectorBlock>> &blocks,
+                                                    unsigned int begin,
+                                                    unsigned int end,
+                                                    boost::compute::command_queue &queue) {
+    using namespace boost;
+
+    struct Range {
+        RefPtr<VectorCOO> block;
+        unsigned int offset;
+        std::size_t from;
+        std::size_t to;
+    };
+
+    std::vector<Range> ranges;
+    std::size_t nvals = 0;
+    std::size_t byteSize = 0;
+
+    for (std::size_t k = 0; k < blocks.size(); k++) {
+        if (blocks[k].IsNull())
+            continue;
+
+        auto block = blocks[k].Cast<VectorCOO>();
+        CHECK_RAISE_ERROR(block.IsNotNull(), NotImplemented, "Supported only COO vector blocks");
+
+        auto offset = partition.GetBlockOffset(first + k);
+        auto size = static_cast<unsigned int>(partition.GetBlockSize(first + k));
+
+        // Source block matches range, nothing to copy
+        if (offset == begin && offset + size == end)
+            return block.As<VectorBlock>();
+
+        // Rows of block are sorted, so entries of the range are consecutive
+        auto lower = std::max(begin, offset) - offset;
+        auto upper = std::min(end, offset + size) - offset;
+        auto &rows = block->GetRows();
+
+        Range range{block, offset, 0, block->GetNvals()};
+        if (lower > 0)
+            range.from = compute::lower_bound(rows.begin(), rows.end(), lower, queue) - rows.begin();
+        if (upper < size)
+            range.to = compute::lower_bound(rows.begin(), rows.end(), upper, queue) - rows.begin();
+
+        if (range.from < range.to) {
+            nvals += range.to - range.from;
+            byteSize = block->GetVals().size() / block->GetNvals();
+            ranges.push_back(std::move(range));
+        }
+    }
+
+    if (!nvals)
+        return RefPtr<VectorBlock>{};
+
+    compute::context ctx = queue.get_context();
+    compute::vector<unsigned int> rows(nvals, ctx);
+    compute::vector<unsigned char> vals(nvals * byteSize, ctx);
+
+    std::size_t written = 0;
+    for (auto &range : ranges) {
+        using compute::lambda::_1;
+
+        // Shift rows from source block to range; may wrap around, but result is in range
+        auto shift = range.offset - begin;
+        auto &srcRows = range.block->GetRows();
+        auto &srcVals = range.block->GetVals();
+
+        compute::transform(srcRows.begin() + range.from, srcRows.begin() + range.to,
+                           rows.begin() + written, _1 + shift, queue);
+
+        if (byteSize)
+            compute::copy(srcVals.begin() + range.from * byteSize, srcVals.begin() + range.to * byteSize,
+                          vals.begin() + written * byteSize, queue);
+
+        written += range.to - range.from;
+    }
+
+    queue.finish();
+
+    return VectorCOO::Make(end - begin, nvals, std::move(rows), std::move(vals)).As<VectorBlock>();
+}
@@ -0,0 +1,70 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAVECTORREBLOCK_HPP
+#define SPLA_SPLAVECTORREBLOCK_HPP
+
+#include <boost/compute/command_queue.hpp>
+#include <storage/SplaBlockPartition.hpp>
+#include <storage/SplaVectorBlock.hpp>
+#include <vector>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * Make block of vector entries in rows range [begin..end) from blocks of other partition.
+     * Used to align vector blocks with blocks of other argument, split at different points.
+     * Source block is returned as is, if it covers exactly the range.
+     *
+     * @param partition Rows partition of source blocks
+     * @param first Index of the first block in source blocks list
+     * @param blocks Source blocks, which intersect range, in partition order; may be null
+     * @param begin First row of the range
+     * @param end Row past the last row of the range
+     * @param queue Command queue to copy entries
+     *
+     * @return Block with range rows; null if range has no entries
+     */
+    RefPtr<VectorBlock> ReblockVector(const BlockPartition &partition,
+                                      std::size_t first,
+                                      const std::vector<RefPtr<VectorBlock>> &blocks,
+                                      unsigned int begin,
+                                      unsigned int end,
+                                      boost::compute::command_queue &queue);
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAVECTORREBLOCK_HPP
@@ -25,14 +25,74 @@
 /* SOFTWARE.                                                                      */
 /**********************************************************************************/
 
+#include <algorithm>
+#include <boost/compute.hpp>
+#include <core/SplaError.hpp>
 #include <core/SplaLibraryPrivate.hpp>
 #include <core/SplaMath.hpp>
+#include <fstream>
+#include <storage/SplaStorageSnapshot.hpp>
+#include <storage/SplaVectorReblock.hpp>
 #include <storage/SplaVectorStorage.hpp>
+#include <storage/block/SplaVectorCOO.hpp>
+#include <utils/SplaMappedFile.hpp>
+
+namespace {
+    /** Counter of device memory, referenced by vector storages blocks */
+    const char *const BLOCKS_MEMORY_COUNTER = "Vector blocks memory";
+
+    /**
+     * Deleter of shared blocks map, which releases memory counter of blocks counted by the map,
+     * when last owner storage releases it. Block is counted by the map it was set into, so
+     * blocks copied into detached map are not counted twice.
+     */
+    struct BlocksMapDeleter {
+        spla::Tracer *tracer;
+        std::unordered_map<spla::VectorStorage::Index, std::size_t> counted;
+
+        void operator()(spla::VectorStorage::EntryMap *entryMap) const {
+            std::size_t memoryUsage = 0;
+            for (auto &entry : counted)
+                memoryUsage += entry.second;
+
+            tracer->AddCounter(BLOCKS_MEMORY_COUNTER, -static_cast<std::int64_t>(memoryUsage));
+            delete entryMap;
+        }
+    };
+
+    spla::VectorStorage::EntryMapPtr MakeBlocksMap(spla::Tracer &tracer, spla::VectorStorage::EntryMap entryMap = {}) {
+        using namespace spla;
+        return VectorStorage::EntryMapPtr(new VectorStorage::EntryMap(std::move(entryMap)), BlocksMapDeleter{&tracer, {}});
+    }
+
+    /** Counts memory of block, set into the map at index; @return Change of memory counter */
+    std::int64_t CountBlock(const spla::VectorStorage::EntryMapPtr &blocks, const spla::VectorStorage::Index &index, std::size_t memoryUsage) {
+        auto &counted = std::get_deleter<BlocksMapDeleter>(blocks)->counted;
+        auto &prev = counted[index];
+        auto change = static_cast<std::int64_t>(memoryUsage) - static_cast<std::int64_t>(prev);
+        prev = memoryUsage;
+        return change;
+    }
+
+    /** Stops counting memory of block, removed from the map at index; @return Change of memory counter */
+    std::int64_t UncountBlock(const spla::VectorStorage::EntryMapPtr &blocks, const spla::VectorStorage::Index &index) {
+        auto &counted = std::get_deleter<BlocksMapDeleter>(blocks)->counted;
+        auto found = counted.find(index);
+        if (found == counted.end())
+            return 0;
+
+        auto change = -static_cast<std::int64_t>(found->second);
+        counted.erase(found);
+        return change;
+    }
+}// namespace
+
+spla::VectorStorage::~VectorStorage() = default;
 
 void spla::VectorStorage::Clear() {
     std::lock_guard<std::mutex> lock(mMutex);
     mNvals = 0;
-    mBlocks.clear();
+    mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer());
 }
 
 void spla::VectorStorage::SetBlock(const spla::VectorStorage::Index &index, const spla::RefPtr<spla::VectorBlock> &block) {
@@ -40,24 +100,28 @@ void spla::VectorStorage::SetBlock(const spla::VectorStorage::Index &index, cons
     assert(block.IsNotNull());
 
     std::lock_guard<std::mutex> lock(mMutex);
-    auto &prev = mBlocks[index];
+    DetachBlocks();
+
+    auto &prev = (*mBlocks)[index];
 
-    if (prev.IsNotNull())
+    if (prev.IsNotNull()) {
         mNvals -= prev->GetNvals();
+    }
 
     prev = block;
     mNvals += block->GetNvals();
+    mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, CountBlock(mBlocks, index, block->GetMemoryUsage()));
 }
 
 void spla::VectorStorage::GetBlocks(spla::VectorStorage::EntryList &entryList) const {
     std::lock_guard<std::mutex> lock(mMutex);
     entryList.clear();
-    entryList.insert(entryList.begin(), mBlocks.begin(), mBlocks.end());
+    entryList.insert(entryList.begin(), mBlocks->begin(), mBlocks->end());
 }
 
 void spla::VectorStorage::GetBlocks(EntryMap &entryMap) const {
     std::lock_guard<std::mutex> lock(mMutex);
-    entryMap = mBlocks;
+    entryMap = *mBlocks;
 }
 
 void spla::VectorStorage::GetBlocksGrid(std::size_t &rows) const {
@@ -67,8 +131,39 @@ void spla::VectorStorage::GetBlocksGrid(std::size_t &rows) const {
 spla::RefPtr<spla::VectorBlock> spla::VectorStorage::GetBlock(const spla::VectorStorage::Index &index) const {
     assert(index < mNblockRows);
     std::lock_guard<std::mutex> lock(mMutex);
-    auto entry = mBlocks.find(index);
-    return entry != mBlocks.end() ? entry->second : nullptr;
+    auto entry = mBlocks->find(index);
+    return entry != mBlocks->end() ? entry->second : nullptr;
+}
+
+spla::RefPtr<spla::VectorBlock> spla::VectorStorage::GetBlock(const spla::BlockPartition &partition, const spla::VectorStorage::Index &index, std::size_t deviceId) const {
+    using namespace boost;
+
+    assert(partition.GetDim() == mNrows);
+    assert(index < partition.GetBlocksCount());
+
+    auto begin = partition.GetBlockOffset(index);
+    auto end = begin + static_cast<unsigned int>(partition.GetBlockSize(index));
+    auto bsize = static_cast<unsigned int>(mBlockSize);
+    auto first = begin / bsize;
+    auto last = (end - 1) / bsize;
+
+    // Blocks coincide, no need to copy entries
+    if (begin == first * bsize && end == std::min(begin + bsize, static_cast<unsigned int>(mNrows)))
+        return GetBlock(first);
+
+    std::vector<RefPtr<VectorBlock>> blocks;
+    blocks.reserve(last - first + 1);
+    for (auto i = first; i <= last; i++)
+        blocks.push_back(GetBlock(i));
+
+    auto &libraryPrivate = mLibrary.GetPrivate();
+    compute::context ctx = libraryPrivate.GetContext();
+    compute::command_queue queue(ctx, libraryPrivate.GetDeviceManager().GetDevice(deviceId));
+    return ReblockVector(GetPartition(), first, blocks, begin, end, queue);
+}
+
+std::size_t spla::VectorStorage::GetLocationOwner() const noexcept {
+    return mLocationOwner;
 }
 
 std::size_t spla::VectorStorage::GetNrows() const noexcept {
@@ -80,21 +175,164 @@ std::size_t spla::VectorStorage::GetNvals() const noexcept {
     return mNvals;
 }
 
-spla::RefPtr<spla::VectorStorage> spla::VectorStorage::Make(std::size_t nrows, spla::Library &library) {
-    return {new VectorStorage(nrows, library)};
+void spla::VectorStorage::Save(const Filename &filename, std::size_t valueByteSize) const {
+    using namespace boost;
+
+    EntryList entries;
+    GetBlocks(entries);
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.first < b.first; });
+
+    snapshot::Header header{};
+    std::memcpy(header.magic, snapshot::VectorMagic, sizeof(header.magic));
+    header.version = snapshot::Version;
+    header.valueByteSize = static_cast<std::uint32_t>(valueByteSize);
+    header.nrows = mNrows;
+    header.ncols = 1;
+    header.blockSize = mBlockSize;
+    header.blocksCount = entries.size();
+    header.colBlockSize = 1;
+
+    std::vector<snapshot::Block> blocks;
+    blocks.reserve(entries.size());
+    auto offset = snapshot::GetDataOffset(entries.size());
+
+    for (auto &entry : entries) {
+        auto &block = entry.second;
+        CHECK_RAISE_ERROR(block->GetFormat() == VectorBlock::Format::COO, NotImplemented,
+                          "Snapshot of non-COO vector blocks is not supported");
+        CHECK_RAISE_ERROR(block.Cast<VectorCOO>()->GetVals().size() == block->GetNvals() * valueByteSize, InvalidType,
+                          "Block values byte size does not match type byte size " << valueByteSize);
+
+        snapshot::Block info{};
+        info.i = entry.first;
+        info.format = static_cast<std::uint32_t>(block->GetFormat());
+        info.nrows = block->GetNrows();
+        info.ncols = 1;
+        info.nvals = block->GetNvals();
+        info.offset = offset;
+        blocks.push_back(info);
+
+        header.nvals += info.nvals;
+        offset += snapshot::GetBlockDataSize(info.nvals, valueByteSize, false);
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    CHECK_RAISE_ERROR(file.is_open(), MemOpFailed, "Failed to open snapshot file for writing");
+
+    snapshot::WriteHeader(file, header, blocks);
+
+    compute::context ctx = mLibrary.GetPrivate().GetContext();
+    compute::command_queue queue(ctx, ctx.get_device());
+
+    std::vector<unsigned int> rows;
+    std::vector<unsigned char> vals;
+
+    for (auto &entry : entries) {
+        auto block = entry.second.Cast<VectorCOO>();
+        assert(block.IsNotNull());
+
+        rows.resize(block->GetNvals());
+        vals.resize(block->GetVals().size());
+
+        compute::copy(block->GetRows().begin(), block->GetRows().end(), rows.begin(), queue);
+        if (!vals.empty())
+            compute::copy(block->GetVals().begin(), block->GetVals().end(), vals.begin(), queue);
+
+        snapshot::WriteArray(file, rows.data(), rows.size() * sizeof(unsigned int));
+        snapshot::WriteArray(file, vals.data(), vals.size());
+    }
+}
+
+spla::RefPtr<spla::VectorStorage> spla::VectorStorage::Load(const Filename &filename, std::size_t valueByteSize, spla::Library &library) {
+    using namespace boost;
+
+    MappedFile file(filename);
+    std::vector<snapshot::Block> blocks;
+    auto header = snapshot::ReadHeader(file, snapshot::VectorMagic, false, blocks);
+    auto &libraryPrivate = library.GetPrivate();
+
+    CHECK_RAISE_ERROR(header.valueByteSize == valueByteSize, InvalidType,
+                      "Snapshot values byte size " << header.valueByteSize << " does not match type byte size " << valueByteSize);
+
+    auto storage = Make(header.nrows, header.blockSize, library);
+
+    // Upload blocks directly from mapped file, distributing them between devices
+    compute::context ctx = libraryPrivate.GetContext();
+    auto &devices = libraryPrivate.GetDeviceManager().GetDevices();
+    std::vector<compute::command_queue> queues;
+    queues.reserve(devices.size());
+    for (auto &device : devices)
+        queues.emplace_back(ctx, device);
+
+    for (std::size_t k = 0; k < blocks.size(); k++) {
+        auto &info = blocks[k];
+
+        CHECK_RAISE_ERROR(info.i < storage->mNblockRows, InvalidArgument,
+                          "Snapshot block (" << info.i << ") is out of blocks grid");
+        CHECK_RAISE_ERROR(info.format == static_cast<std::uint32_t>(VectorBlock::Format::COO), InvalidArgument,
+                          "Snapshot block (" << info.i << ") has unsupported format");
+        CHECK_RAISE_ERROR(info.nrows == math::GetBlockActualSize(info.i, header.nrows, header.blockSize) && info.nvals > 0,
+                          InvalidArgument, "Snapshot block (" << info.i << ") has invalid size");
+
+        auto &queue = queues[k % queues.size()];
+        auto nvals = static_cast<std::size_t>(info.nvals);
+        auto data = file.GetData() + info.offset;
+        auto rowsData = reinterpret_cast<const unsigned int *>(data);
+        auto valsData = reinterpret_cast<const unsigned char *>(data + snapshot::GetAlignedSize(nvals * sizeof(unsigned int)));
+
+        compute::vector<unsigned int> rows(nvals, ctx);
+        compute::vector<unsigned char> vals(ctx);
+
+        compute::copy(rowsData, rowsData + nvals, rows.begin(), queue);
+
+        if (valueByteSize) {
+            vals.resize(nvals * valueByteSize, queue);
+            compute::copy(valsData, valsData + nvals * valueByteSize, vals.begin(), queue);
+        }
+
+        auto block = VectorCOO::Make(info.nrows, nvals, std::move(rows), std::move(vals));
+        storage->SetBlock(info.i, block.As<VectorBlock>());
+    }
+
+    return storage;
 }
 
-spla::VectorStorage::VectorStorage(std::size_t nrows, spla::Library &library)
-    : mNrows(nrows), mLibrary(library) {
-    mBlockSize = mLibrary.GetPrivate().GetBlockSize();
+spla::RefPtr<spla::VectorStorage> spla::VectorStorage::Make(std::size_t nrows, spla::Library &library, std::size_t nvals) {
+    return Make(nrows, library.GetPrivate().GetBlockSize(nrows, nvals), library);
+}
+
+spla::RefPtr<spla::VectorStorage> spla::VectorStorage::Make(std::size_t nrows, std::size_t blockSize, spla::Library &library) {
+    assert(blockSize > 0);
+    return {new VectorStorage(nrows, blockSize, library)};
+}
+
+spla::VectorStorage::VectorStorage(std::size_t nrows, std::size_t blockSize, spla::Library &library)
+    : mLocationOwner(library.GetPrivate().GetDeviceManager().NewLocationOwner()),
+      mNrows(nrows), mBlockSize(blockSize), mLibrary(library) {
     mNblockRows = math::GetBlocksCount(nrows, mBlockSize);
+    mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer());
+}
+
+void spla::VectorStorage::DetachBlocks() {
+    // Blocks are immutable, so only map itself is copied; blocks stay shared and counted by the source map
+    if (mBlocks.use_count() > 1)
+        mBlocks = MakeBlocksMap(mLibrary.GetPrivate().GetTracer(), *mBlocks);
 }
 
 void spla::VectorStorage::RemoveBlock(const spla::VectorStorage::Index &index) {
     assert(index < mNblockRows);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    mBlocks.erase(index);
+
+    if (mBlocks->find(index) == mBlocks->end())
+        return;
+
+    DetachBlocks();
+
+    auto entry = mBlocks->find(index);
+    mNvals -= entry->second->GetNvals();
+    mLibrary.GetPrivate().GetTracer().AddCounter(BLOCKS_MEMORY_COUNTER, UncountBlock(mBlocks, index));
+    mBlocks->erase(entry);
 }
 
 std::size_t spla::VectorStorage::GetNblockRows() const noexcept {
@@ -105,18 +343,35 @@ std::size_t spla::VectorStorage::GetBlockSize() const noexcept {
     return mBlockSize;
 }
 
+spla::BlockPartition spla::VectorStorage::GetPartition() const {
+    return BlockPartition::Uniform(mNrows, mBlockSize);
+}
+
+void spla::VectorStorage::SetBlockSize(std::size_t blockSize) {
+    assert(blockSize > 0);
+
+    if (blockSize == mBlockSize)
+        return;
+
+    Clear();
+
+    // Block size is read by processors without lock, so it is changed only before storage is shared
+    mBlockSize = blockSize;
+    mNblockRows = math::GetBlocksCount(mNrows, mBlockSize);
+}
+
 void spla::VectorStorage::Dump(std::ostream &stream) const {
     std::lock_guard<std::mutex> lock(mMutex);
 
     stream << "VectorStorage:"
            << " nrows=" << mNrows
            << " nvals=" << mNvals
-           << " bcount=" << mBlocks.size()
+           << " bcount=" << mBlocks->size()
            << " bsize=" << mBlockSize << std::endl;
 
     auto bsize = static_cast<unsigned int>(mBlockSize);
 
-    for (auto &entry : mBlocks) {
+    for (auto &entry : *mBlocks) {
         auto index = entry.first;
         auto &block = entry.second;
         stream << "Block (" << index << ") ";
@@ -127,9 +382,10 @@ void spla::VectorStorage::Dump(std::ostream &stream) const {
 spla::RefPtr<spla::VectorStorage> spla::VectorStorage::Clone() const {
     std::lock_guard<std::mutex> lock(mMutex);
 
-    auto storage = Make(GetNrows(), mLibrary);
-    storage->mBlockSize = mBlockSize;
+    // Blocks map is shared until one of the storages is modified
+    auto storage = Make(GetNrows(), mBlockSize, mLibrary);
     storage->mBlocks = mBlocks;
+    storage->mLocationOwner = mLocationOwner;
     storage->mNvals = mNvals;
 
     return storage;
@@ -28,8 +28,10 @@
 #ifndef SPLA_SPLAVECTORSTORAGE_HPP
 #define SPLA_SPLAVECTORSTORAGE_HPP
 
+#include <memory>
 #include <mutex>
 #include <spla-cpp/SplaLibrary.hpp>
+#include <storage/SplaBlockPartition.hpp>
 #include <storage/SplaVectorBlock.hpp>
 #include <unordered_map>
 #include <vector>
@@ -51,8 +53,9 @@ namespace spla {
         using EntryList = std::vector<Entry>;
         using EntryRowList = std::vector<EntryList>;
         using EntryMap = std::unordered_map<Index, RefPtr<VectorBlock>>;
+        using EntryMapPtr = std::shared_ptr<EntryMap>;
 
-        ~VectorStorage() override = default;
+        ~VectorStorage() override;
 
         /** Remove all blocks from storage (empty matrix) */
         void Clear();
@@ -75,6 +78,21 @@ namespace spla {
         /** @return Block at specified index; may be null */
         [[nodiscard]] RefPtr<VectorBlock> GetBlock(const Index &index) const;
 
+        /**
+         * Get block of other rows partition, made of entries of storage blocks.
+         * Storage block is returned as is, if it coincides with requested block.
+         *
+         * @param partition Rows partition of the storage dimension
+         * @param index Index of block in partition
+         * @param deviceId Id of the device to copy entries on
+         *
+         * @return Block at specified index of partition; may be null
+         */
+        [[nodiscard]] RefPtr<VectorBlock> GetBlock(const BlockPartition &partition, const Index &index, std::size_t deviceId) const;
+
+        /** @return Id of the storage blocks locations for device scheduling; shared with clones */
+        [[nodiscard]] std::size_t GetLocationOwner() const noexcept;
+
         /** @return Number of rows of the storage */
         [[nodiscard]] std::size_t GetNrows() const noexcept;
 
@@ -87,18 +105,67 @@ namespace spla {
         /** @return Block size param */
         [[nodiscard]] std::size_t GetBlockSize() const noexcept;
 
+        /** @return Uniform rows partition of storage blocks */
+        [[nodiscard]] BlockPartition GetPartition() const;
+
+        /**
+         * Set size of the storage blocks.
+         * Storage content is cleared, if block size is changed.
+         *
+         * @param blockSize Number of rows in block; must be greater than zero
+         */
+        void SetBlockSize(std::size_t blockSize);
+
         /** Dump vector content to provided stream */
         void Dump(std::ostream &stream) const;
 
-        /** @return Cloned `cow` storage */
+        /**
+         * Clone storage in copy-on-write manner.
+         * Clone shares blocks map with this storage, so it takes constant time and no device memory.
+         * Map is copied by the storage on first modification; blocks themselves are never copied.
+         *
+         * @return Cloned storage
+         */
         RefPtr<VectorStorage> Clone() const;
 
-        static RefPtr<VectorStorage> Make(std::size_t nrows, Library &library);
+        /**
+         * Save storage blocks into binary snapshot file.
+         * @see SplaStorageSnapshot.hpp
+         *
+         * @param filename Name of the file to write
+         * @param valueByteSize Size of stored values in bytes
+         */
+        void Save(const Filename &filename, std::size_t valueByteSize) const;
+
+        /** Make new vector storage with block size chosen by library for expected number of values (zero if unknown) */
+        static RefPtr<VectorStorage> Make(std::size_t nrows, Library &library, std::size_t nvals = 0);
+
+        /** Make new vector storage with specified block size */
+        static RefPtr<VectorStorage> Make(std::size_t nrows, std::size_t blockSize, Library &library);
+
+        /**
+         * Load storage from binary snapshot file.
+         * Blocks data is uploaded into COO blocks as is, without sort and duplicates reduction.
+         * Storage gets block size of the snapshot.
+         * @throw Error with `InvalidArgument` status if snapshot is invalid.
+         * @throw Error with `InvalidType` status if snapshot has different values byte size.
+         *
+         * @param filename Name of the file to load
+         * @param valueByteSize Expected size of stored values in bytes
+         * @param library Library instance
+         *
+         * @return New storage instance
+         */
+        static RefPtr<VectorStorage> Load(const Filename &filename, std::size_t valueByteSize, Library &library);
 
     private:
-        VectorStorage(std::size_t nrows, Library &library);
+        VectorStorage(std::size_t nrows, std::size_t blockSize, Library &library);
+
+        /** Make blocks map unique before modification, if it is shared with clones; must be called under lock */
+        void DetachBlocks();
 
-        EntryMap mBlocks;
+        EntryMapPtr mBlocks;
+        std::size_t mLocationOwner;
         std::size_t mNrows;
         std::size_t mNvals = 0;
         std::size_t mNblockRows = 0;
@@ -98,3 +98,7 @@ void spla::MatrixCOO::Dump(std::ostream &stream, unsigned int baseI, unsigned in
 std::size_t spla::MatrixCOO::GetValueByteSize() const noexcept {
     return GetVals().size() / GetNvals();
 }
+
+std::size_t spla::MatrixCOO::GetMemoryUsage() const noexcept {
+    return (mRows.size() + mCols.size()) * sizeof(unsigned int) + mVals.size();
+}
@@ -56,6 +56,8 @@ namespace spla {
 
         [[nodiscard]] std::size_t GetValueByteSize() const noexcept override;
 
+        [[nodiscard]] std::size_t GetMemoryUsage() const noexcept override;
+
         static RefPtr<MatrixCOO> Make(std::size_t nrows, std::size_t ncols, std::size_t nvals, Indices rows, Indices cols, Values vals);
 
     private:
@@ -84,3 +84,7 @@ void spla::VectorCOO::Dump(std::ostream &stream, unsigned int baseI) const {
                << std::dec;
     }
 }
+
+std::size_t spla::VectorCOO::GetMemoryUsage() const noexcept {
+    return mRows.size() * sizeof(unsigned int) + mVals.size();
+}
@@ -51,6 +51,8 @@ namespace spla {
 
         void Dump(std::ostream &stream, unsigned int baseI) const override;
 
+        [[nodiscard]] std::size_t GetMemoryUsage() const noexcept override;
+
         static RefPtr<VectorCOO> Make(std::size_t nrows, std::size_t nvals, Indices rows, Values vals);
 
     private:
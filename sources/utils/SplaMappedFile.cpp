@@ -0,0 +1,120 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <core/SplaError.hpp>
+#include <utils/SplaMappedFile.hpp>
+
+#if defined(SPLA_TARGET_WINDOWS)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if defined(SPLA_TARGET_WINDOWS)
+
+spla::MappedFile::MappedFile(const Filename &filename) {
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    CHECK_RAISE_ERROR(file != INVALID_HANDLE_VALUE, MemOpFailed, "Failed to open file");
+    mFile = file;
+
+    // NOTE: destructor is not called if constructor throws, so release handles here
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        RAISE_ERROR(MemOpFailed, "Failed to query file size");
+    }
+
+    mSize = static_cast<std::size_t>(size.QuadPart);
+
+    if (mSize == 0)
+        return;
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        RAISE_ERROR(MemOpFailed, "Failed to create file mapping");
+    }
+
+    mMapping = mapping;
+    mData = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        RAISE_ERROR(MemOpFailed, "Failed to map file view");
+    }
+}
+
+spla::MappedFile::~MappedFile() {
+    if (mData)
+        UnmapViewOfFile(mData);
+    if (mMapping)
+        CloseHandle(mMapping);
+    if (mFile)
+        CloseHandle(mFile);
+}
+
+#else
+
+spla::MappedFile::MappedFile(const Filename &filename) {
+    mFile = open(filename.c_str(), O_RDONLY);
+    CHECK_RAISE_ERROR(mFile != -1, MemOpFailed, "Failed to open file " << filename);
+
+    // NOTE: destructor is not called if constructor throws, so release file here
+    struct stat info {};
+    if (fstat(mFile, &info) != 0) {
+        close(mFile);
+        RAISE_ERROR(MemOpFailed, "Failed to query file size " << filename);
+    }
+
+    mSize = static_cast<std::size_t>(info.st_size);
+
+    if (mSize == 0)
+        return;
+
+    void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+    if (data == MAP_FAILED) {
+        close(mFile);
+        RAISE_ERROR(MemOpFailed, "Failed to map file " << filename);
+    }
+
+    mData = static_cast<const char *>(data);
+
+    // File is parsed mostly sequentially by chunks
+    madvise(data, mSize, MADV_SEQUENTIAL);
+}
+
+spla::MappedFile::~MappedFile() {
+    if (mData)
+        munmap(const_cast<char *>(mData), mSize);
+    if (mFile != -1)
+        close(mFile);
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#ifndef SPLA_SPLAMAPPEDFILE_HPP
+#define SPLA_SPLAMAPPEDFILE_HPP
+
+#include <cstddef>
+#include <spla-cpp/SplaConfig.hpp>
+
+namespace spla {
+
+    /**
+     * @addtogroup Internal
+     * @{
+     */
+
+    /**
+     * @class MappedFile
+     * @brief Read-only memory mapped file.
+     *
+     * Maps whole file content into process address space,
+     * so it can be parsed in parallel without explicit reads.
+     * Mapping is released on object destruction.
+     */
+    class MappedFile {
+    public:
+        /**
+         * Map file for reading.
+         * @throw Error with `MemOpFailed` status if failed to open or map file.
+         *
+         * @param filename Name of the file to map
+         */
+        explicit MappedFile(const Filename &filename);
+        MappedFile(const MappedFile &) = delete;
+        MappedFile(MappedFile &&) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile &operator=(MappedFile &&) = delete;
+        ~MappedFile();
+
+        /** @return Pointer to the file content; null if file is empty */
+        [[nodiscard]] const char *GetData() const noexcept {
+            return mData;
+        }
+
+        /** @return Size of the file in bytes */
+        [[nodiscard]] std::size_t GetSize() const noexcept {
+            return mSize;
+        }
+
+    private:
+        const char *mData = nullptr;
+        std::size_t mSize = 0;
+#if defined(SPLA_TARGET_WINDOWS)
+        void *mFile = nullptr;
+        void *mMapping = nullptr;
+#else
+        int mFile = -1;
+#endif
+    };
+
+    /**
+     * @}
+     */
+
+}// namespace spla
+
+#endif//SPLA_SPLAMAPPEDFILE_HPP
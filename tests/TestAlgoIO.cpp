@@ -0,0 +1,252 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <tuple>
+#include <utility>
+
+void testMatrixMarket(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix source = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+
+    std::string filename = "TestAlgoIO_" + std::to_string(seed) + ".mtx";
+    {
+        // Write entries in reversed order to check, that loader groups them itself
+        std::ofstream file(filename);
+        file << "%%MatrixMarket matrix coordinate real general\n";
+        file << "% generated by TestAlgoIO\n";
+        file << M << " " << N << " " << source.GetNvals() << "\n";
+        file << std::setprecision(9);
+        for (std::size_t k = source.GetNvals(); k > 0; k--) {
+            file << source.GetRows()[k - 1] + 1 << " " << source.GetCols()[k - 1] + 1 << " " << source.GetVals()[k - 1] << "\n";
+        }
+    }
+
+    auto hostM = spla::LoadMatrixMarket(filename, library);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(hostM->GetNrows(), M);
+    ASSERT_EQ(hostM->GetNcols(), N);
+    ASSERT_EQ(hostM->GetNnvals(), source.GetNvals());
+
+    // Loaded data is blocked, sorted and has no duplicates
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesBlocked);
+
+    auto spM = spla::Matrix::Make(M, N, spla::Types::Float32(library), library);
+    auto spExpr = spla::Expression::Make(library);
+    spExpr->MakeDataWrite(spM, hostM->GetData(library), spDesc);
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    ASSERT_TRUE(source.Equals(spM));
+}
+
+void testEdgeList(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix source = utils::Matrix<float>::Generate(M, M, nvals, seed);
+
+    std::string filename = "TestAlgoIO_" + std::to_string(seed) + ".bin";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        for (std::size_t k = 0; k < source.GetNvals(); k++) {
+            std::uint32_t edge[2] = {source.GetRows()[k], source.GetCols()[k]};
+            file.write(reinterpret_cast<const char *>(edge), sizeof(edge));
+        }
+    }
+
+    auto hostM = spla::LoadEdgeList(filename, M, library);
+    std::remove(filename.c_str());
+
+    std::vector<std::pair<spla::Index, spla::Index>> expected;
+    for (std::size_t k = 0; k < source.GetNvals(); k++) {
+        expected.emplace_back(source.GetRows()[k], source.GetCols()[k]);
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    std::vector<std::pair<spla::Index, spla::Index>> actual;
+    for (std::size_t k = 0; k < hostM->GetNnvals(); k++) {
+        actual.emplace_back(hostM->GetRowIndices()[k], hostM->GetColIndices()[k]);
+    }
+    std::sort(actual.begin(), actual.end());
+
+    ASSERT_EQ(hostM->GetNrows(), M);
+    ASSERT_EQ(hostM->GetNcols(), M);
+    ASSERT_FALSE(hostM->HasValues());
+    ASSERT_EQ(expected, actual);
+}
+
+using MMEntry = std::tuple<spla::Index, spla::Index, double>;
+
+spla::RefPtr<spla::HostMatrix> loadMatrixMarketText(spla::Library &library, const std::string &text) {
+    std::string filename = "TestAlgoIO_fixture.mtx";
+    {
+        std::ofstream file(filename);
+        file << text;
+    }
+
+    spla::RefPtr<spla::HostMatrix> hostM;
+    try {
+        hostM = spla::LoadMatrixMarket(filename, library);
+    } catch (...) {
+        std::remove(filename.c_str());
+        throw;
+    }
+
+    std::remove(filename.c_str());
+    return hostM;
+}
+
+template<typename T>
+std::vector<MMEntry> getEntries(const spla::RefPtr<spla::HostMatrix> &hostM) {
+    std::vector<MMEntry> entries;
+    for (std::size_t k = 0; k < hostM->GetNnvals(); k++) {
+        double value = 0;
+        if (hostM->HasValues()) {
+            T typed;
+            std::memcpy(&typed, hostM->GetValues().data() + k * sizeof(T), sizeof(T));
+            value = static_cast<double>(typed);
+        }
+        entries.emplace_back(hostM->GetRowIndices()[k], hostM->GetColIndices()[k], value);
+    }
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+template<typename T>
+void testMatrixMarketFixture(const std::string &text, std::size_t M, std::size_t N, bool hasValues, std::vector<MMEntry> expected) {
+    utils::testBlocks({2, 1000}, [&](spla::Library &library) {
+        auto hostM = loadMatrixMarketText(library, text);
+
+        ASSERT_EQ(hostM->GetNrows(), M);
+        ASSERT_EQ(hostM->GetNcols(), N);
+        ASSERT_EQ(hostM->HasValues(), hasValues);
+
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(getEntries<T>(hostM), expected);
+    });
+}
+
+void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter) {
+    utils::testBlocks({1000, 10000, 100000}, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testMatrixMarket(library, M, N, nvals, i);
+            testEdgeList(library, M, nvals, i);
+        }
+    });
+}
+
+TEST(AlgoIO, Small) {
+    std::size_t M = 100, N = 200;
+    test(M, N, M, M, 5);
+}
+
+TEST(AlgoIO, Medium) {
+    std::size_t M = 1300, N = 2100;
+    test(M, N, M, M, 5);
+}
+
+TEST(AlgoIO, Large) {
+    std::size_t M = 10300, N = 18000;
+    test(M, N, M, M, 3);
+}
+
+TEST(AlgoIO, MatrixMarketSymmetric) {
+    // Diagonal entries are not mirrored
+    testMatrixMarketFixture<float>("%%MatrixMarket matrix coordinate real symmetric\n"
+                                   "3 3 4\n"
+                                   "1 1 1.5\n"
+                                   "2 1 2.0\n"
+                                   "3 2 3.0\n"
+                                   "3 3 4.0\n",
+                                   3, 3, true,
+                                   {{0, 0, 1.5}, {1, 0, 2.0}, {0, 1, 2.0}, {2, 1, 3.0}, {1, 2, 3.0}, {2, 2, 4.0}});
+}
+
+TEST(AlgoIO, MatrixMarketSkewSymmetric) {
+    testMatrixMarketFixture<std::int32_t>("%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+                                          "3 3 2\n"
+                                          "2 1 5\n"
+                                          "3 1 -2\n",
+                                          3, 3, true,
+                                          {{1, 0, 5}, {0, 1, -5}, {2, 0, -2}, {0, 2, 2}});
+}
+
+TEST(AlgoIO, MatrixMarketPattern) {
+    testMatrixMarketFixture<float>("%%MatrixMarket matrix coordinate pattern general\n"
+                                   "% comment\n"
+                                   "3 4 3\n"
+                                   "1 2\n"
+                                   "3 4\n"
+                                   "2 1\n",
+                                   3, 4, false,
+                                   {{0, 1, 0}, {2, 3, 0}, {1, 0, 0}});
+}
+
+TEST(AlgoIO, MatrixMarketPatternSymmetric) {
+    testMatrixMarketFixture<float>("%%MatrixMarket matrix coordinate pattern symmetric\n"
+                                   "3 3 2\n"
+                                   "2 2\n"
+                                   "3 1\n",
+                                   3, 3, false,
+                                   {{1, 1, 0}, {2, 0, 0}, {0, 2, 0}});
+}
+
+TEST(AlgoIO, MatrixMarketInteger) {
+    testMatrixMarketFixture<std::int32_t>("%%MatrixMarket matrix coordinate integer general\n"
+                                          "2 3 2\n"
+                                          "1 1 -7\n"
+                                          "2 3 42\n",
+                                          2, 3, true,
+                                          {{0, 0, -7}, {1, 2, 42}});
+}
+
+TEST(AlgoIO, MatrixMarketNvalsMismatch) {
+    utils::testBlocks({1000}, [&](spla::Library &library) {
+        // Truncated file
+        EXPECT_ANY_THROW(loadMatrixMarketText(library, "%%MatrixMarket matrix coordinate real general\n"
+                                                       "2 2 3\n"
+                                                       "1 1 1.0\n"
+                                                       "2 2 2.0\n"));
+        // Overlong file
+        EXPECT_ANY_THROW(loadMatrixMarketText(library, "%%MatrixMarket matrix coordinate real general\n"
+                                                       "2 2 1\n"
+                                                       "1 1 1.0\n"
+                                                       "2 2 2.0\n"));
+    });
+}
+
+SPLA_GTEST_MAIN
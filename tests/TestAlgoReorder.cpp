@@ -0,0 +1,117 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+void testCase(spla::Library &library, std::size_t M, std::size_t nvals, spla::Reordering method, std::size_t seed = 0) {
+    auto rnd = utils::UniformIntGenerator<spla::Index>(seed, 0, M - 1);
+    auto sp_Int32 = spla::Types::Int32(library);
+    auto s = rnd();
+
+    utils::Matrix A = utils::Matrix<std::int32_t>::Generate(M, M, nvals, seed).SortReduceDuplicates();
+    A.Fill(utils::UniformIntGenerator<std::int32_t>());
+
+    auto host_A = A.ToHostMatrix();
+    auto sp_A = spla::Matrix::Make(M, M, sp_Int32, library);
+    auto perm = spla::WriteReordered(sp_A, host_A, method);
+
+    // Permutation is a bijection
+    ASSERT_EQ(perm.size(), M);
+    std::vector<bool> seen(M, false);
+    for (auto i : perm) {
+        ASSERT_LT(i, M);
+        ASSERT_FALSE(seen[i]);
+        seen[i] = true;
+    }
+
+    // Written matrix is the permuted one
+    utils::Matrix R = utils::Matrix<std::int32_t>::FromHostMatrix(spla::PermuteMatrix(host_A, perm, library)).SortReduceDuplicates();
+    ASSERT_TRUE(R.Equals(sp_A));
+
+    // Bfs over reordered graph is mapped back to bfs over original one
+    auto sp_v = spla::RefPtr<spla::Vector>();
+    spla::Bfs(sp_v, sp_A, perm[s]);
+
+    auto host_v = spla::RefPtr<spla::HostVector>();
+    auto host_rv = spla::RefPtr<spla::HostVector>();
+    spla::Bfs(host_v, host_A, s);
+    spla::Bfs(host_rv, R.ToHostMatrix(), perm[s]);
+
+    ASSERT_TRUE(utils::Vector<std::int32_t>::FromHostVector(host_rv).Equals(sp_v));
+
+    auto host_back = spla::PermuteVector(host_rv, perm, true);
+    ASSERT_EQ(host_back->GetRowIndices(), host_v->GetRowIndices());
+    ASSERT_EQ(host_back->GetValues(), host_v->GetValues());
+}
+
+void test(std::size_t M, std::size_t nvals, const std::vector<std::size_t> &blocksSizes) {
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        for (auto method : {spla::Reordering::Degree, spla::Reordering::ReverseCuthillMcKee, spla::Reordering::Clustering})
+            testCase(library, M, nvals, method);
+    });
+}
+
+TEST(Reorder, Bandwidth) {
+    spla::Library library;
+
+    // Path graph with shuffled vertices gets bandwidth 1 after reverse Cuthill-McKee
+    std::size_t n = 100;
+    std::vector<spla::Index> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(0));
+
+    std::vector<spla::Index> rows, cols;
+    for (std::size_t k = 0; k + 1 < n; k++) {
+        rows.push_back(order[k]);
+        cols.push_back(order[k + 1]);
+    }
+
+    auto host_A = spla::RefPtr<spla::HostMatrix>(new spla::HostMatrix(n, n, rows, cols, {}));
+    auto perm = spla::ComputeReordering(host_A, spla::Reordering::ReverseCuthillMcKee);
+
+    for (std::size_t k = 0; k < rows.size(); k++) {
+        auto i = static_cast<long long>(perm[rows[k]]);
+        auto j = static_cast<long long>(perm[cols[k]]);
+        EXPECT_EQ(std::abs(i - j), 1);
+    }
+}
+
+TEST(Reorder, Small) {
+    std::vector<std::size_t> blockSizes = {10, 100};
+    test(120, 360, blockSizes);
+}
+
+TEST(Reorder, Medium) {
+    std::vector<std::size_t> blockSizes = {100, 1000};
+    test(1220, 3660, blockSizes);
+}
+
+SPLA_GTEST_MAIN
@@ -0,0 +1,115 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <algo/SplaAlgorithmManager.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+    /** Algorithm with fixed estimation and actual processing time */
+    class FakeAlgorithm final : public spla::Algorithm {
+    public:
+        FakeAlgorithm(std::string name, double estimation, std::chrono::milliseconds duration, std::vector<std::string> &log)
+            : mName(std::move(name)), mEstimation(estimation), mDuration(duration), mLog(log) {}
+
+        ~FakeAlgorithm() override = default;
+
+        bool Select(const spla::AlgorithmParams &params) const override {
+            return true;
+        }
+
+        Cost EstimateCost(const spla::AlgorithmParams &params, const spla::DeviceManager::Device &device) const override {
+            return Cost{1000, mEstimation};
+        }
+
+        void Process(spla::AlgorithmParams &params) override {
+            std::this_thread::sleep_for(mDuration);
+            mLog.push_back(mName);
+        }
+
+        Type GetType() const override {
+            return Type::MatrixEWiseMult;
+        }
+
+        std::string GetName() const override {
+            return mName;
+        }
+
+    private:
+        std::string mName;
+        double mEstimation;
+        std::chrono::milliseconds mDuration;
+        std::vector<std::string> &mLog;
+    };
+
+    void dispatch(spla::Library &library, spla::AlgorithmManager &manager, std::size_t times) {
+        spla::AlgorithmParams params;
+        params.desc = spla::Descriptor::Make(library);
+        params.deviceId = 0;
+
+        for (std::size_t i = 0; i < times; i++)
+            manager.Dispatch(spla::Algorithm::Type::MatrixEWiseMult, params);
+    }
+
+}// namespace
+
+TEST(AlgorithmSelection, Cheapest) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU));
+    spla::AlgorithmManager manager(library);
+    std::vector<std::string> log;
+
+    manager.Register(new FakeAlgorithm("expensive", 2.0, std::chrono::milliseconds(0), log));
+    manager.Register(new FakeAlgorithm("cheap", 1.0, std::chrono::milliseconds(0), log));
+
+    dispatch(library, manager, 3);
+
+    EXPECT_EQ(log, std::vector<std::string>({"cheap", "cheap", "cheap"}));
+    EXPECT_FALSE(manager.GetMeasuredTime("cheap", 1000).has_value());
+}
+
+TEST(AlgorithmSelection, Calibration) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).SetAlgorithmCalibration(true));
+    spla::AlgorithmManager manager(library);
+    std::vector<std::string> log;
+
+    // Estimation is wrong: estimated cheap algorithm is actually slower
+    manager.Register(new FakeAlgorithm("slow", 1.0, std::chrono::milliseconds(20), log));
+    manager.Register(new FakeAlgorithm("fast", 2.0, std::chrono::milliseconds(1), log));
+
+    dispatch(library, manager, 4);
+
+    // Each algorithm is measured once, then the fastest one is selected
+    EXPECT_EQ(log, std::vector<std::string>({"slow", "fast", "fast", "fast"}));
+    EXPECT_TRUE(manager.GetMeasuredTime("slow", 1000).has_value());
+    EXPECT_LT(manager.GetMeasuredTime("fast", 1000).value(), manager.GetMeasuredTime("slow", 1000).value());
+}
+
+SPLA_GTEST_MAIN
@@ -0,0 +1,227 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <storage/SplaBlockPartition.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <storage/SplaVectorStorage.hpp>
+
+/** Matrix with a few dense hub rows and columns, as in power-law graphs */
+template<typename Type>
+utils::Matrix<Type> makeSkewed(std::size_t N, std::size_t hubs, std::size_t nvals, std::size_t seed) {
+    utils::Matrix<Type> random = utils::Matrix<Type>::Generate(N, N, nvals, seed);
+
+    std::vector<unsigned int> rows = random.GetRowsVec();
+    std::vector<unsigned int> cols = random.GetColsVec();
+
+    for (std::size_t h = 0; h < hubs; h++) {
+        for (std::size_t k = 0; k < N; k++) {
+            rows.push_back(static_cast<unsigned int>(h));
+            cols.push_back(static_cast<unsigned int>(k));
+            rows.push_back(static_cast<unsigned int>(k));
+            cols.push_back(static_cast<unsigned int>(h));
+        }
+    }
+
+    std::vector<Type> vals(rows.size());
+    utils::Matrix<Type> skewed(N, N, std::move(rows), std::move(cols), std::move(vals));
+    return skewed.SortReduceDuplicates();
+}
+
+TEST(BlockPartition, Uniform) {
+    auto partition = spla::BlockPartition::Uniform(10, 4);
+
+    EXPECT_TRUE(partition.IsUniform());
+    EXPECT_EQ(partition.GetBlocksCount(), 3);
+    EXPECT_EQ(partition.GetDim(), 10);
+    EXPECT_EQ(partition.GetBlockOffset(2), 8);
+    EXPECT_EQ(partition.GetBlockSize(2), 2);
+    EXPECT_EQ(partition.GetBlockIndex(7), 1);
+    EXPECT_EQ(partition.GetBlockIndex(9), 2);
+}
+
+TEST(BlockPartition, Balanced) {
+    // Most of values are in first rows
+    std::vector<std::size_t> counts(100, 1);
+    counts[0] = 500;
+    counts[1] = 300;
+
+    auto partition = spla::BlockPartition::Balanced(counts, 25);
+
+    EXPECT_FALSE(partition.IsUniform());
+    ASSERT_EQ(partition.GetBlocksCount(), 4);
+    EXPECT_EQ(partition.GetDim(), 100);
+    EXPECT_EQ(partition.GetBlockSize(0), 1);
+
+    for (unsigned int k = 0; k < 100; k++) {
+        auto block = partition.GetBlockIndex(k);
+        EXPECT_LE(partition.GetBlockOffset(block), k);
+        EXPECT_LT(k, partition.GetBlockOffset(block) + partition.GetBlockSize(block));
+    }
+
+    // Nothing to balance
+    EXPECT_EQ(spla::BlockPartition::Balanced(std::vector<std::size_t>(100, 0), 25), spla::BlockPartition::Uniform(100, 25));
+}
+
+template<typename Type>
+void testWriteRead(spla::Library &library, std::size_t N, std::size_t nvals, const spla::RefPtr<spla::Type> &spT) {
+    utils::Matrix a = makeSkewed<Type>(N, 3, nvals, 0);
+    a.Fill(utils::UniformGenerator<Type>());
+
+    auto spA = spla::Matrix::Make(N, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::BalancedBlocks);
+
+    auto spExpr = spla::Expression::Make(library);
+    spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    auto &storage = spA->GetStorage();
+    EXPECT_EQ(storage->GetRowPartition(), storage->GetColPartition());
+    EXPECT_EQ(storage->GetNblockRows(), storage->GetRowPartition().GetBlocksCount());
+    ASSERT_TRUE(a.Equals(spA));
+}
+
+template<typename Type>
+void testMxM(spla::Library &library, std::size_t N, std::size_t nvals, const spla::RefPtr<spla::Type> &spT) {
+    utils::Matrix a = makeSkewed<Type>(N, 2, nvals, 1);
+    utils::Matrix b = makeSkewed<Type>(N, 4, nvals, 2);
+
+    a.Fill(utils::UniformIntGenerator<Type>(0, 1, 10));
+    b.Fill(utils::UniformIntGenerator<Type>(1, 1, 10));
+
+    auto spA = spla::Matrix::Make(N, N, spT, library);
+    auto spB = spla::Matrix::Make(N, N, spT, library);
+    auto spW = spla::Matrix::Make(N, N, spT, library);
+    auto spT1 = spla::Matrix::Make(N, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+    spDesc->SetParam(spla::Descriptor::Param::BalancedBlocks);
+
+    // Multiply a by itself, since both dimensions of a are split the same way
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spMxM = spExpr->MakeMxM(spW, nullptr, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spA, spA);
+    auto spTranspose = spExpr->MakeTranspose(spT1, nullptr, nullptr, spA);
+    spExpr->Dependency(spWriteA, spMxM);
+    spExpr->Dependency(spWriteA, spTranspose);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(a.template MxM<Type>(a, std::multiplies<>(), std::plus<>()).Equals(spW));
+    ASSERT_TRUE(a.Transpose().Equals(spT1));
+
+    // Matrices with different split points are multiplied with b remapped onto split points of a
+    auto spRemap = spla::Expression::Make(library);
+    auto spWriteB = spRemap->MakeDataWrite(spB, b.GetData(library), spDesc);
+    auto spMxMRemap = spRemap->MakeMxM(spW, nullptr, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spA, spB);
+    auto spAddRemap = spRemap->MakeEWiseAdd(spT1, nullptr, spla::Functions::PlusInt32(library), spA, spB);
+    spRemap->Dependency(spWriteB, spMxMRemap);
+    spRemap->Dependency(spWriteB, spAddRemap);
+    spRemap->Submit();
+    spRemap->Wait();
+
+    ASSERT_EQ(spRemap->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(a.template MxM<Type>(b, std::multiplies<>(), std::plus<>()).Equals(spW));
+    ASSERT_TRUE(a.EWiseAdd(b, std::plus<Type>()).Equals(spT1));
+    EXPECT_EQ(spT1->GetStorage()->GetRowPartition(), spA->GetStorage()->GetRowPartition());
+}
+
+template<typename Type>
+void testVxM(spla::Library &library, std::size_t N, std::size_t nvals, const spla::RefPtr<spla::Type> &spT) {
+    utils::Vector a = utils::Vector<Type>::Generate(N, nvals, 3).SortReduceDuplicates();
+    utils::Matrix b = makeSkewed<Type>(N, 3, nvals, 4);
+    utils::Vector mask = utils::Vector<unsigned char>::Generate(N, nvals, 5).SortReduceDuplicates();
+
+    a.Fill(utils::UniformIntGenerator<Type>(0, 1, 10));
+    b.Fill(utils::UniformIntGenerator<Type>(1, 1, 10));
+
+    auto spA = spla::Vector::Make(N, spT, library);
+    auto spB = spla::Matrix::Make(N, N, spT, library);
+    auto spW = spla::Vector::Make(N, spT, library);
+    auto spMaskedW = spla::Vector::Make(N, spT, library);
+    auto spMask = spla::Vector::Make(N, spla::Types::Void(library), library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spBalancedDesc = spla::Descriptor::Make(library);
+    spBalancedDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spBalancedDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+    spBalancedDesc->SetParam(spla::Descriptor::Param::BalancedBlocks);
+
+    // Vectors keep uniform blocks, so they are remapped onto split points of b
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library), spBalancedDesc);
+    auto spWriteMask = spExpr->MakeDataWrite(spMask, mask.GetDataIndices(library), spDesc);
+    auto spVxM = spExpr->MakeVxM(spW, nullptr, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spA, spB);
+    auto spMaskedVxM = spExpr->MakeVxM(spMaskedW, spMask, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spA, spB);
+    spExpr->Dependency(spWriteA, spVxM);
+    spExpr->Dependency(spWriteB, spVxM);
+    spExpr->Dependency(spWriteA, spMaskedVxM);
+    spExpr->Dependency(spWriteB, spMaskedVxM);
+    spExpr->Dependency(spWriteMask, spMaskedVxM);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(utils::VxM(a, b, std::multiplies<>(), std::plus<>()).Equals(spW));
+    ASSERT_TRUE(utils::VxM(mask, false, a, b, std::multiplies<>(), std::plus<>()).Equals(spMaskedW));
+    EXPECT_EQ(spW->GetStorage()->GetBlockSize(), spB->GetStorage()->GetColBlockSize());
+}
+
+TEST(BlockPartition, WriteRead) {
+    std::vector<std::size_t> blockSizes = {10, 50, 1000};
+    utils::testBlocks(blockSizes, [](spla::Library &library) {
+        testWriteRead<std::int32_t>(library, 200, 400, spla::Types::Int32(library));
+    });
+}
+
+TEST(BlockPartition, MxM) {
+    std::vector<std::size_t> blockSizes = {10, 50, 1000};
+    utils::testBlocks(blockSizes, [](spla::Library &library) {
+        testMxM<std::int32_t>(library, 200, 400, spla::Types::Int32(library));
+    });
+}
+
+TEST(BlockPartition, VxM) {
+    std::vector<std::size_t> blockSizes = {10, 50, 1000};
+    utils::testBlocks(blockSizes, [](spla::Library &library) {
+        testVxM<std::int32_t>(library, 200, 400, spla::Types::Int32(library));
+    });
+}
+
+SPLA_GTEST_MAIN
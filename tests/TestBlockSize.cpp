@@ -0,0 +1,224 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <core/SplaMath.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+#include <storage/SplaVectorStorage.hpp>
+
+#include <cstdio>
+
+TEST(BlockSize, Adaptive) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU));
+    auto &libraryPrivate = library.GetPrivate();
+
+    ASSERT_TRUE(libraryPrivate.GetContextConfig().IsBlockSizeAdaptive());
+
+    // Small dimensions are not split
+    EXPECT_EQ(libraryPrivate.GetBlockSize(100), spla::Library::Config::MIN_ADAPTIVE_BLOCK_SIZE);
+
+    // Large dimensions are split into several blocks, but not more than into twice the number of devices
+    std::size_t M = 200000, N = 50000;
+    auto devicesCount = libraryPrivate.GetDeviceManager().GetDevices().size();
+
+    for (auto dim : {M, N}) {
+        auto blockSize = libraryPrivate.GetBlockSize(dim);
+        EXPECT_GE(blockSize, spla::Library::Config::MIN_ADAPTIVE_BLOCK_SIZE);
+        EXPECT_LE(blockSize, spla::Library::Config::DEFAULT_BLOCK_SIZE);
+        EXPECT_LE(spla::math::GetBlocksCount(dim, blockSize), 2 * devicesCount);
+        EXPECT_GT(spla::math::GetBlocksCount(dim, blockSize), 1);
+    }
+
+    // Objects of the same dimension share blocks grid
+    auto spT = spla::Types::Int32(library);
+    auto spA = spla::Matrix::Make(M, N, spT, library);
+    auto spB = spla::Matrix::Make(N, M, spT, library);
+    auto spV = spla::Vector::Make(M, spT, library);
+
+    EXPECT_EQ(spA->GetStorage()->GetRowBlockSize(), spB->GetStorage()->GetColBlockSize());
+    EXPECT_EQ(spA->GetStorage()->GetColBlockSize(), spB->GetStorage()->GetRowBlockSize());
+    EXPECT_EQ(spA->GetStorage()->GetRowBlockSize(), spV->GetStorage()->GetBlockSize());
+
+    // Sparse objects are not split, dense enough ones are split as without expected values
+    EXPECT_EQ(spla::math::GetBlocksCount(M, libraryPrivate.GetBlockSize(M, 1000)), 1);
+    EXPECT_EQ(libraryPrivate.GetBlockSize(M, M * N), libraryPrivate.GetBlockSize(M));
+
+    auto spS = spla::Matrix::Make(M, N, spT, library, 0, 1000);
+    EXPECT_EQ(spS->GetStorage()->GetNblockRows(), 1);
+    EXPECT_EQ(spS->GetStorage()->GetNblockCols(), 1);
+
+    // Explicit library block size is used as is
+    spla::Library fixed(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).SetBlockSize(100));
+    EXPECT_FALSE(fixed.GetPrivate().GetContextConfig().IsBlockSizeAdaptive());
+    EXPECT_EQ(fixed.GetPrivate().GetBlockSize(M), 100);
+}
+
+template<typename Type>
+void testMatrixOverride(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals,
+                        const spla::RefPtr<spla::Type> &spT, const spla::RefPtr<spla::FunctionBinary> &spOp) {
+    utils::Matrix a = utils::Matrix<Type>::Generate(M, N, nvals, 0).SortReduceDuplicates();
+    utils::Matrix b = utils::Matrix<Type>::Generate(M, N, nvals, 1).SortReduceDuplicates();
+    a.Fill(utils::UniformGenerator<Type>());
+    b.Fill(utils::UniformGenerator<Type>());
+
+    auto spA = spla::Matrix::Make(M, N, spT, library, 30);
+    auto spB = spla::Matrix::Make(M, N, spT, library, 30);
+    auto spC = spla::Matrix::Make(M, N, spT, library, 70);
+    auto spW = spla::Matrix::Make(M, N, spT, library);
+
+    EXPECT_EQ(spA->GetStorage()->GetRowBlockSize(), 30);
+    EXPECT_EQ(spA->GetStorage()->GetNblockCols(), spla::math::GetBlocksCount(N, 30));
+
+    // Result takes blocks grid of the arguments
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library));
+    auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library));
+    auto spAdd = spExpr->MakeEWiseAdd(spW, nullptr, spOp, spA, spB);
+    spExpr->Dependency(spWriteA, spAdd);
+    spExpr->Dependency(spWriteB, spAdd);
+    spExpr->SubmitWait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_EQ(spW->GetStorage()->GetRowBlockSize(), 30);
+    ASSERT_TRUE(a.EWiseAdd(b, std::plus<Type>()).Equals(spW));
+
+    // Arguments with different blocks grids are remapped onto blocks of the first argument
+    utils::Matrix c = utils::Matrix<Type>::Generate(M, N, nvals, 2).SortReduceDuplicates();
+    utils::Matrix d = utils::Matrix<Type>::Generate(N, M, nvals, 3).SortReduceDuplicates();
+    c.Fill(utils::UniformIntGenerator<Type>(0, 1, 10));
+    d.Fill(utils::UniformIntGenerator<Type>(1, 1, 10));
+
+    auto spD = spla::Matrix::Make(N, M, spT, library, 70);
+    auto spSum = spla::Matrix::Make(M, N, spT, library, 70);
+    auto spProduct = spla::Matrix::Make(M, M, spT, library);
+
+    auto spRemap = spla::Expression::Make(library);
+    auto spWriteC = spRemap->MakeDataWrite(spC, c.GetData(library));
+    auto spWriteD = spRemap->MakeDataWrite(spD, d.GetData(library));
+    auto spAddC = spRemap->MakeEWiseAdd(spSum, nullptr, spOp, spA, spC);
+    auto spMxM = spRemap->MakeMxM(spProduct, nullptr, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spC, spD);
+    spRemap->Dependency(spWriteC, spAddC);
+    spRemap->Dependency(spWriteC, spMxM);
+    spRemap->Dependency(spWriteD, spMxM);
+    spRemap->SubmitWait();
+
+    ASSERT_EQ(spRemap->GetState(), spla::Expression::State::Evaluated);
+    EXPECT_EQ(spSum->GetStorage()->GetRowBlockSize(), 30);
+    ASSERT_TRUE(a.EWiseAdd(c, std::plus<Type>()).Equals(spSum));
+    ASSERT_TRUE(c.template MxM<Type>(d, std::multiplies<>(), std::plus<>()).Equals(spProduct));
+}
+
+template<typename Type>
+void testVectorOverride(spla::Library &library, std::size_t M, std::size_t nvals,
+                        const spla::RefPtr<spla::Type> &spT, const spla::RefPtr<spla::FunctionBinary> &spOp) {
+    utils::Vector a = utils::Vector<Type>::Generate(M, nvals, 0).SortReduceDuplicates();
+    utils::Vector b = utils::Vector<Type>::Generate(M, nvals, 1).SortReduceDuplicates();
+    a.Fill(utils::UniformGenerator<Type>());
+    b.Fill(utils::UniformGenerator<Type>());
+
+    auto spA = spla::Vector::Make(M, spT, library, 30);
+    auto spB = spla::Vector::Make(M, spT, library, 30);
+    auto spC = spla::Vector::Make(M, spT, library, 70);
+    auto spW = spla::Vector::Make(M, spT, library);
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library));
+    auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library));
+    auto spAdd = spExpr->MakeEWiseAdd(spW, nullptr, spOp, spA, spB);
+    spExpr->Dependency(spWriteA, spAdd);
+    spExpr->Dependency(spWriteB, spAdd);
+    spExpr->SubmitWait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_EQ(spW->GetStorage()->GetBlockSize(), 30);
+    ASSERT_TRUE(a.EWiseAdd(b, std::plus<Type>()).Equals(spW));
+
+    // Arguments with different blocks grids are remapped onto blocks of the first argument
+    utils::Vector c = utils::Vector<Type>::Generate(M, nvals, 2).SortReduceDuplicates();
+    utils::Matrix d = utils::Matrix<Type>::Generate(M, M, nvals, 3).SortReduceDuplicates();
+    c.Fill(utils::UniformIntGenerator<Type>(0, 1, 10));
+    d.Fill(utils::UniformIntGenerator<Type>(1, 1, 10));
+
+    auto spD = spla::Matrix::Make(M, M, spT, library, 50);
+    auto spSum = spla::Vector::Make(M, spT, library, 70);
+    auto spProduct = spla::Vector::Make(M, spT, library);
+
+    auto spRemap = spla::Expression::Make(library);
+    auto spWriteC = spRemap->MakeDataWrite(spC, c.GetData(library));
+    auto spWriteD = spRemap->MakeDataWrite(spD, d.GetData(library));
+    auto spAddC = spRemap->MakeEWiseAdd(spSum, nullptr, spOp, spA, spC);
+    auto spVxM = spRemap->MakeVxM(spProduct, nullptr, spla::Functions::MultInt32(library), spla::Functions::PlusInt32(library), spC, spD);
+    spRemap->Dependency(spWriteC, spAddC);
+    spRemap->Dependency(spWriteC, spVxM);
+    spRemap->Dependency(spWriteD, spVxM);
+    spRemap->SubmitWait();
+
+    ASSERT_EQ(spRemap->GetState(), spla::Expression::State::Evaluated);
+    EXPECT_EQ(spSum->GetStorage()->GetBlockSize(), 30);
+    ASSERT_TRUE(a.EWiseAdd(c, std::plus<Type>()).Equals(spSum));
+    ASSERT_TRUE(utils::VxM(c, d, std::multiplies<>(), std::plus<>()).Equals(spProduct));
+}
+
+TEST(BlockSize, Override) {
+    std::vector<std::size_t> blockSizes = {10, 1000};
+    utils::testBlocks(blockSizes, [](spla::Library &library) {
+        testMatrixOverride<std::int32_t>(library, 200, 300, 1000, spla::Types::Int32(library), spla::Functions::PlusInt32(library));
+        testVectorOverride<std::int32_t>(library, 200, 100, spla::Types::Int32(library), spla::Functions::PlusInt32(library));
+    });
+}
+
+TEST(BlockSize, SnapshotGrid) {
+    std::size_t M = 200, N = 300;
+    utils::Matrix source = utils::Matrix<float>::Generate(M, N, 1000, 0).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+
+    std::string filename = "TestBlockSize.splamtx";
+
+    {
+        spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).SetBlockSize(1000));
+        auto spM = spla::Matrix::Make(M, N, spla::Types::Float32(library), library, 40);
+
+        auto spExpr = spla::Expression::Make(library);
+        spExpr->MakeDataWrite(spM, source.GetData(library));
+        spExpr->SubmitWait();
+        ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+        spM->Save(filename);
+    }
+
+    // Snapshot keeps its blocks grid regardless of loading library block size
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).SetBlockSize(70));
+    auto spLoaded = spla::Matrix::Load(filename, spla::Types::Float32(library), library);
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(spLoaded->GetStorage()->GetRowBlockSize(), 40);
+    EXPECT_EQ(spLoaded->GetStorage()->GetColBlockSize(), 40);
+    ASSERT_TRUE(source.Equals(spLoaded));
+}
+
+SPLA_GTEST_MAIN
@@ -79,6 +79,32 @@ void testSortedNoDuplicates(spla::Library &library, std::size_t M, std::size_t N
     ASSERT_TRUE(expected.Equals(spM));
 }
 
+void testClone(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix source = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix other = utils::Matrix<float>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+    other.Fill(utils::UniformRealGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spM = spla::Matrix::Make(M, N, spT, library);
+
+    auto spExprWrite = spla::Expression::Make(library);
+    spExprWrite->MakeDataWrite(spM, source.GetData(library));
+    spExprWrite->SubmitWait();
+    ASSERT_EQ(spExprWrite->GetState(), spla::Expression::State::Evaluated);
+
+    // Clone shares blocks, so rewrite of the origin must not affect it
+    auto spClone = spM->Clone().Cast<spla::Matrix>();
+
+    auto spExprRewrite = spla::Expression::Make(library);
+    spExprRewrite->MakeDataWrite(spM, other.GetData(library));
+    spExprRewrite->SubmitWait();
+    ASSERT_EQ(spExprRewrite->GetState(), spla::Expression::State::Evaluated);
+
+    ASSERT_TRUE(source.Equals(spClone));
+    ASSERT_TRUE(other.Equals(spM));
+}
+
 void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter) {
     utils::testBlocks({1000, 10000, 100000}, [=](spla::Library &library) {
         for (std::size_t i = 0; i < iter; i++) {
@@ -90,6 +116,11 @@ void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std:
             std::size_t nvals = base + i * step;
             testSortedNoDuplicates(library, M, N, nvals, i);
         }
+
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testClone(library, M, N, nvals, i);
+        }
     });
 }
 
@@ -0,0 +1,119 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <core/SplaDeviceManager.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+
+TEST(DeviceScheduler, Load) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU));
+    auto &deviceMan = library.GetPrivate().GetDeviceManager();
+    auto devicesCount = deviceMan.GetDevices().size();
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spNode = spExpr->MakeDataWrite(spla::Scalar::Make(spla::Types::Int32(library), library), spla::DataScalar::Make(library));
+
+    auto owner = deviceMan.NewLocationOwner();
+    std::vector<spla::DeviceManager::Work> work(4);
+    for (std::size_t i = 0; i < work.size(); i++) {
+        work[i].amount = (i + 1) * 100;
+        work[i].inputs = {{owner, i}};
+        work[i].output = spla::DeviceManager::Location{owner, i + work.size()};
+    }
+
+    auto totalLoad = [&]() {
+        std::size_t total = 0;
+        for (std::size_t id = 0; id < devicesCount; id++)
+            total += deviceMan.GetLoad(id);
+        return total;
+    };
+
+    auto tickets = deviceMan.Schedule(work, spNode);
+    ASSERT_EQ(tickets.size(), work.size());
+    EXPECT_EQ(totalLoad(), 1000);
+
+    // Release is idempotent, the rest is released on destruction
+    tickets[0]->Release();
+    tickets[0]->Release();
+    EXPECT_EQ(totalLoad(), 900);
+
+    tickets.clear();
+    EXPECT_EQ(totalLoad(), 0);
+}
+
+TEST(DeviceScheduler, Balance) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).LimitAmount(2));
+    auto &deviceMan = library.GetPrivate().GetDeviceManager();
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spNode = spExpr->MakeDataWrite(spla::Scalar::Make(spla::Types::Int32(library), library), spla::DataScalar::Make(library));
+
+    // Single heavy piece and a number of light ones
+    std::vector<spla::DeviceManager::Work> work(5);
+    work[0].amount = 400;
+    for (std::size_t i = 1; i < work.size(); i++)
+        work[i].amount = 100;
+
+    auto tickets = deviceMan.Schedule(work, spNode);
+
+    if (deviceMan.GetDevices().size() > 1) {
+        // Light pieces go to the other device
+        for (std::size_t i = 1; i < work.size(); i++)
+            EXPECT_NE(tickets[i]->GetDeviceId(), tickets[0]->GetDeviceId());
+    }
+}
+
+TEST(DeviceScheduler, Locality) {
+    spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU).LimitAmount(2));
+    auto &deviceMan = library.GetPrivate().GetDeviceManager();
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spNode = spExpr->MakeDataWrite(spla::Scalar::Make(spla::Types::Int32(library), library), spla::DataScalar::Make(library));
+
+    // Owners ids are not reused, so stale locations never match blocks of new owners
+    auto owner = deviceMan.NewLocationOwner();
+    auto other = deviceMan.NewLocationOwner();
+    EXPECT_NE(owner, other);
+
+    std::vector<spla::DeviceManager::Work> produce(1);
+    produce[0].amount = 100;
+    produce[0].output = spla::DeviceManager::Location{owner, 0};
+    auto producer = deviceMan.Schedule(produce, spNode)[0]->GetDeviceId();
+
+    // Consumer of the block is placed on its producer device, since both devices are idle
+    for (std::size_t i = 0; i < 3; i++) {
+        std::vector<spla::DeviceManager::Work> consume(1);
+        consume[0].amount = 100;
+        consume[0].inputs = {{owner, 0}};
+        EXPECT_EQ(deviceMan.Schedule(consume, spNode)[0]->GetDeviceId(), producer);
+    }
+
+    deviceMan.ForgetLocations(owner);
+    deviceMan.ForgetLocations(other);
+}
+
+SPLA_GTEST_MAIN
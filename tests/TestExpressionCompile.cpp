@@ -0,0 +1,143 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+
+void testResubmit(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    utils::Vector a = utils::Vector<float>::Generate(M, nvals, seed).SortReduceDuplicates();
+    utils::Vector b = utils::Vector<float>::Generate(M, nvals, seed + 1).SortReduceDuplicates();
+    utils::Vector c = utils::Vector<float>::Generate(M, nvals, seed + 2).SortReduceDuplicates();
+
+    a.Fill(utils::UniformGenerator<float>());
+    b.Fill(utils::UniformGenerator<float>());
+    c.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spOp = spla::Functions::PlusFloat32(library);
+    auto spA = spla::Vector::Make(M, spT, library);
+    auto spB = spla::Vector::Make(M, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spSetup = spla::Expression::Make(library);
+    spSetup->MakeDataWrite(spB, b.GetData(library), spDesc);
+    spSetup->SubmitWait();
+
+    // Out arg is aliased with input, so each run must work with fresh proxy
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spEAddAB = spExpr->MakeEWiseAdd(spA, nullptr, spOp, spA, spB);
+    spExpr->Dependency(spWriteA, spEAddAB);
+    spExpr->Compile();
+
+    ASSERT_TRUE(spExpr->IsCompiled());
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Compiled);
+
+    auto add = [](float x, float y) { return x + y; };
+
+    for (std::size_t i = 0; i < 3; i++) {
+        spExpr->SubmitWait();
+        ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+        ASSERT_TRUE(a.EWiseAdd(b, add).Equals(spA));
+    }
+
+    // Rebind source data of the write node
+    spExpr->Bind(spWriteA, c.GetData(library).As<spla::Data>());
+
+    for (std::size_t i = 0; i < 2; i++) {
+        spExpr->SubmitWait();
+        ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+        ASSERT_TRUE(c.EWiseAdd(b, add).Equals(spA));
+    }
+}
+
+void testScalarUpdate(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    utils::Vector w = utils::Vector<std::int32_t>::Empty(M);
+    utils::Vector mask = utils::Vector<unsigned char>::Generate(M, nvals, seed).SortReduceDuplicates();
+
+    auto spT = spla::Types::Int32(library);
+    auto spW = spla::Vector::Make(M, spT, library);
+    auto spS = spla::Scalar::Make(spT, library);
+    auto spMask = spla::Vector::Make(M, spla::Types::Void(library), library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spSetup = spla::Expression::Make(library);
+    spSetup->MakeDataWrite(spMask, mask.GetDataIndices(library), spDesc);
+    spSetup->SubmitWait();
+
+    // Scalar data references host variable, updated between submissions
+    std::int32_t s = 0;
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteS = spExpr->MakeDataWrite(spS, spla::DataScalar::Make(&s, library));
+    auto spAssign = spExpr->MakeAssign(spW, spMask, nullptr, spS);
+    spExpr->Dependency(spWriteS, spAssign);
+    spExpr->Compile();
+
+    auto second = [](std::int32_t x, std::int32_t y) { return y; };
+
+    for (s = 1; s <= 4; s++) {
+        spExpr->SubmitWait();
+        ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+        ASSERT_TRUE(w.Assign(mask, false, s, second).Equals(spW));
+    }
+
+    // Scalar data can be also replaced by other host variable
+    std::int32_t t = 10;
+    spExpr->Bind(spWriteS, spla::DataScalar::Make(&t, library).As<spla::Data>());
+    spExpr->SubmitWait();
+    ASSERT_TRUE(w.Assign(mask, false, t, second).Equals(spW));
+}
+
+void test(std::size_t M, std::size_t base, std::size_t step, std::size_t iter, const std::vector<std::size_t> &blocksSizes) {
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testResubmit(library, M, nvals, i);
+            testScalarUpdate(library, M, nvals, i);
+        }
+    });
+}
+
+TEST(ExpressionCompile, Small) {
+    std::vector<std::size_t> blocksSizes{10, 100, 1000};
+    std::size_t M = 100;
+    test(M, M, M, 10, blocksSizes);
+}
+
+TEST(ExpressionCompile, Medium) {
+    std::vector<std::size_t> blocksSizes{100, 1000, 10000};
+    std::size_t M = 1000;
+    test(M, M, M, 5, blocksSizes);
+}
+
+SPLA_GTEST_MAIN
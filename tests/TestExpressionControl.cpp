@@ -0,0 +1,141 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+
+void testLoopReach(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    auto rnd = utils::UniformIntGenerator<spla::Index>(seed, 0, M - 1);
+    auto spT = spla::Types::Int32(library);
+    spla::Index s = rnd();
+    std::int32_t one = 1;
+
+    utils::Matrix A = utils::Matrix<std::int32_t>::Generate(M, M, nvals, seed).SortReduceDuplicates();
+    A.Fill(utils::UniformIntGenerator<std::int32_t>());
+
+    auto spA = spla::Matrix::Make(M, M, spT, library);
+    auto spV = spla::Vector::Make(M, spT, library);
+    auto spQ = spla::Vector::Make(M, spla::Types::Void(library), library);
+    auto spOne = spla::Scalar::Make(spT, library);
+
+    auto spDescAccum = spla::Descriptor::Make(library);
+    spDescAccum->SetParam(spla::Descriptor::Param::AccumResult);
+
+    auto spDescComp = spla::Descriptor::Make(library);
+    spDescComp->SetParam(spla::Descriptor::Param::MaskComplement);
+
+    // Single step of reachability: v[q] = 1, q[!v] = q x A
+    auto spBody = spla::Expression::Make(library);
+    auto spAssign = spBody->MakeAssign(spV, spQ, nullptr, spOne, spDescAccum);
+    auto spVxM = spBody->MakeVxM(spQ, spV, nullptr, nullptr, spQ, spA, spDescComp);
+    spBody->Dependency(spAssign, spVxM);
+
+    // Whole traversal is evaluated as single submission
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, A.GetData(library));
+    auto spWriteQ = spExpr->MakeDataWrite(spQ, spla::DataVector::Make(&s, nullptr, 1, library));
+    auto spWriteOne = spExpr->MakeDataWrite(spOne, spla::DataScalar::Make(&one, library));
+    auto spLoop = spExpr->MakeLoop(spBody, spQ);
+    spExpr->Dependency(spWriteA, spLoop);
+    spExpr->Dependency(spWriteQ, spLoop);
+    spExpr->Dependency(spWriteOne, spLoop);
+    spExpr->SubmitWait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_EQ(spQ->GetNvals(), 0);
+
+    auto hostV = spla::RefPtr<spla::HostVector>();
+    spla::Bfs(hostV, A.ToHostMatrix(), s);
+
+    auto reached = utils::Vector<std::int32_t>::FromHostVector(hostV);
+    ASSERT_TRUE(reached.EqualsStructure(spV));
+}
+
+void testCondition(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    utils::Vector a = utils::Vector<float>::Generate(M, nvals, seed).SortReduceDuplicates();
+    a.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spA = spla::Vector::Make(M, spT, library);
+    auto spFlag = spla::Scalar::Make(spla::Types::Int32(library), library);
+    auto spEmpty = spla::Vector::Make(M, spla::Types::Void(library), library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spBody = spla::Expression::Make(library);
+    spBody->MakeDataWrite(spA, a.GetData(library), spDesc);
+
+    // Condition on empty vector never holds
+    auto spSkip = spla::Expression::Make(library);
+    spSkip->MakeCondition(spBody, spEmpty);
+    spSkip->SubmitWait();
+    ASSERT_EQ(spSkip->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_EQ(spA->GetNvals(), 0);
+
+    // Condition on scalar holds only for non-zero value
+    std::int32_t flag = 0;
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteFlag = spExpr->MakeDataWrite(spFlag, spla::DataScalar::Make(&flag, library));
+    auto spCondition = spExpr->MakeCondition(spBody, spFlag);
+    spExpr->Dependency(spWriteFlag, spCondition);
+    spExpr->Compile();
+
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_EQ(spA->GetNvals(), 0);
+
+    flag = 1;
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(a.Equals(spA));
+}
+
+void test(std::size_t M, std::size_t base, std::size_t step, std::size_t iter, const std::vector<std::size_t> &blocksSizes) {
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testLoopReach(library, M, nvals, i);
+            testCondition(library, M, nvals, i);
+        }
+    });
+}
+
+TEST(ExpressionControl, Small) {
+    std::vector<std::size_t> blocksSizes{10, 100, 1000};
+    std::size_t M = 120;
+    test(M, M, M, 10, blocksSizes);
+}
+
+TEST(ExpressionControl, Medium) {
+    std::vector<std::size_t> blocksSizes{100, 1000, 10000};
+    std::size_t M = 1220;
+    test(M, M, M, 5, blocksSizes);
+}
+
+SPLA_GTEST_MAIN
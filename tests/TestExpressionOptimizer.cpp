@@ -0,0 +1,202 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+#include <Testing.hpp>
+
+void testDeadWrite(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix b = utils::Matrix<float>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+
+    a.Fill(utils::UniformGenerator<float>());
+    b.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spW = spla::Matrix::Make(M, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    // First write is overwritten before being observed
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spW, a.GetData(library), spDesc);
+    auto spWriteB = spExpr->MakeDataWrite(spW, b.GetData(library), spDesc);
+    spExpr->Dependency(spWriteA, spWriteB);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(b.Equals(spW));
+}
+
+void testIdentical(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix b = utils::Matrix<float>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+
+    a.Fill(utils::UniformGenerator<float>());
+    b.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spOp = spla::Functions::PlusFloat32(library);
+    auto spA = spla::Matrix::Make(M, N, spT, library);
+    auto spB = spla::Matrix::Make(M, N, spT, library);
+    auto spW1 = spla::Matrix::Make(M, N, spT, library);
+    auto spW2 = spla::Matrix::Make(M, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    // Second and third additions compute the same result as the first one
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library), spDesc);
+    auto spAdd1 = spExpr->MakeEWiseAdd(spW1, nullptr, spOp, spA, spB);
+    auto spAdd2 = spExpr->MakeEWiseAdd(spW2, nullptr, spOp, spA, spB);
+    auto spAdd3 = spExpr->MakeEWiseAdd(spW1, nullptr, spOp, spA, spB);
+    spExpr->Dependency(spWriteA, spAdd1);
+    spExpr->Dependency(spWriteB, spAdd1);
+    spExpr->Dependency(spWriteA, spAdd2);
+    spExpr->Dependency(spWriteB, spAdd2);
+    spExpr->Dependency(spAdd1, spAdd3);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    utils::Matrix<float> c = a.EWiseAdd(b, [](float x, float y) { return x + y; });
+    ASSERT_TRUE(c.Equals(spW1));
+    ASSERT_TRUE(c.Equals(spW2));
+}
+
+void testForward(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    a.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spA = spla::Matrix::Make(M, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    std::vector<unsigned int> rows(a.GetNvals());
+    std::vector<unsigned int> cols(a.GetNvals());
+    std::vector<float> vals(a.GetNvals());
+
+    auto spData = spla::DataMatrix::Make(library);
+    spData->SetRows(rows.data());
+    spData->SetCols(cols.data());
+    spData->SetVals(vals.data());
+    spData->SetNvals(a.GetNvals());
+
+    // Read of just written matrix
+    auto spExpr = spla::Expression::Make(library);
+    auto spWrite = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spRead = spExpr->MakeDataRead(spA, spData);
+    spExpr->Dependency(spWrite, spRead);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    ASSERT_TRUE(a.Equals(spA));
+    ASSERT_EQ(rows, a.GetRowsVec());
+    ASSERT_EQ(cols, a.GetColsVec());
+    ASSERT_EQ(vals, a.GetValsVec());
+}
+
+void testVxMAssign(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Vector a = utils::Vector<float>::Generate(M, nvals, seed).SortReduceDuplicates();
+    utils::Matrix b = utils::Matrix<float>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+    float s = 2.0f;
+
+    a.Fill(utils::UniformGenerator<float>());
+    b.Fill(utils::UniformGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spMult = spla::Functions::MultFloat32(library);
+    auto spAdd = spla::Functions::PlusFloat32(library);
+    auto spA = spla::Vector::Make(M, spT, library);
+    auto spB = spla::Matrix::Make(M, N, spT, library);
+    auto spW = spla::Vector::Make(N, spT, library);
+    auto spV = spla::Vector::Make(N, spT, library);
+    auto spS = spla::Scalar::Make(spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    // Assignment masked by product result is fused with product
+    auto spExpr = spla::Expression::Make(library);
+    auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library), spDesc);
+    auto spWriteS = spExpr->MakeDataWrite(spS, utils::GetData(s, library));
+    auto spVxM = spExpr->MakeVxM(spW, nullptr, spMult, spAdd, spA, spB);
+    auto spAssign = spExpr->MakeAssign(spV, spW, nullptr, spS);
+    spExpr->Dependency(spWriteA, spVxM);
+    spExpr->Dependency(spWriteB, spVxM);
+    spExpr->Dependency(spWriteS, spVxM);
+    spExpr->Dependency(spVxM, spAssign);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    auto mult = [](float x, float y) { return x * y; };
+    auto add = [](float x, float y) { return x + y; };
+    utils::Vector<float> w = utils::VxM(a, b, mult, add);
+    utils::Vector<float> v = utils::Vector<float>::Empty(N).Assign(w, false, s, add);
+    ASSERT_TRUE(w.Equals(spW));
+    ASSERT_TRUE(v.Equals(spV));
+}
+
+void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter, const std::vector<std::size_t> &blocksSizes) {
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testDeadWrite(library, M, N, nvals, i);
+            testIdentical(library, M, N, nvals, i);
+            testForward(library, M, N, nvals, i);
+            testVxMAssign(library, M, N, nvals, i);
+        }
+    });
+}
+
+TEST(ExpressionOptimizer, Small) {
+    std::vector<std::size_t> blocksSizes{10, 100, 1000};
+    std::size_t M = 100;
+    std::size_t N = 120;
+    test(M, N, M, M, 10, blocksSizes);
+}
+
+TEST(ExpressionOptimizer, Medium) {
+    std::vector<std::size_t> blocksSizes{100, 1000, 10000};
+    std::size_t M = 1000;
+    std::size_t N = 900;
+    test(M, N, M, M, 5, blocksSizes);
+}
+
+SPLA_GTEST_MAIN
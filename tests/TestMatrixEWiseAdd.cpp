@@ -275,6 +275,29 @@ void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std:
     });
 }
 
+TEST(MatrixEWiseAdd, ForceHostPath) {
+    // Every blocks pair is merged natively on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetForceHostPath(true));
+
+        auto spT = spla::Types::Int32(library);
+        auto spOp = spla::Functions::PlusInt32(library);
+        auto op = [](std::int32_t x, std::int32_t y) { return x + y; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 500 + i * 500;
+            testCommon<std::int32_t>(library, 420, 380, nvals, spT, spOp, op, i);
+            testMasked<std::int32_t>(library, 420, 380, nvals, spT, spOp, op, i);
+            testMaskedComplement<std::int32_t>(library, 420, 380, nvals, spT, spOp, op, i);
+            testOneIsEmpty<std::int32_t>(library, 420, 380, nvals, spT, spOp, op, i);
+            testNoValues(library, 420, 380, nvals, i);
+        }
+    }
+}
+
 TEST(MatrixEWiseAdd, Small) {
     std::vector<std::size_t> blocksSizes{100, 1000};
     std::size_t M = 100;
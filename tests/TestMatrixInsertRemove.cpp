@@ -0,0 +1,174 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+#include <Testing.hpp>
+#include <storage/SplaMatrixStorage.hpp>
+
+/** Index of non-empty blocks must follow storage modifications */
+void checkBlockIndex(const spla::RefPtr<spla::Matrix> &m) {
+    spla::MatrixStorage::EntryList entries;
+    m->GetStorage()->GetBlocks(entries);
+
+    std::vector<spla::MatrixStorage::Index> expected;
+    for (auto &entry : entries)
+        expected.push_back(entry.first);
+    std::sort(expected.begin(), expected.end());
+
+    auto blockIndex = m->GetStorage()->GetBlockIndex();
+    std::vector<spla::MatrixStorage::Index> actual;
+    ASSERT_EQ(blockIndex->offsets.size(), blockIndex->rows.size() + 1);
+    for (std::size_t r = 0; r < blockIndex->rows.size(); r++) {
+        for (auto k = blockIndex->offsets[r]; k < blockIndex->offsets[r + 1]; k++)
+            actual.emplace_back(blockIndex->rows[r], blockIndex->cols[k]);
+    }
+
+    EXPECT_EQ(actual, expected);
+}
+
+template<typename Type>
+void testInsert(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals,
+                const spla::RefPtr<spla::Type> &spT, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<Type>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix batch = utils::Matrix<Type>::Generate(M, N, nvals / 4 + 1, seed + 1);
+
+    a.Fill(utils::UniformGenerator<Type>());
+    batch.Fill(utils::UniformGenerator<Type>());
+
+    auto spA = spla::Matrix::Make(M, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    // Batch is not sorted and may contain duplicates
+    auto spExpr = spla::Expression::Make(library);
+    auto spWrite = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spInsert = spExpr->MakeInsert(spA, batch.GetData(library));
+    spExpr->Dependency(spWrite, spInsert);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    utils::Matrix<Type> c = a.EWiseAdd(batch.SortReduceDuplicates(), [](Type x, Type y) { return y; });
+    ASSERT_TRUE(c.Equals(spA));
+    checkBlockIndex(spA);
+}
+
+template<typename Type>
+void testRemove(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals,
+                const spla::RefPtr<spla::Type> &spT, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<Type>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix batch = utils::Matrix<Type>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+
+    a.Fill(utils::UniformGenerator<Type>());
+
+    auto spA = spla::Matrix::Make(M, N, spT, library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spWrite = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+    auto spRemove = spExpr->MakeRemove(spA, batch.GetDataIndices(library));
+    spExpr->Dependency(spWrite, spRemove);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    utils::Matrix<Type> c = a.Mask(batch, true);
+    ASSERT_TRUE(c.Equals(spA));
+    checkBlockIndex(spA);
+}
+
+void testNoValues(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix a = utils::Matrix<unsigned char>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    utils::Matrix inserted = utils::Matrix<unsigned char>::Generate(M, N, nvals, seed + 1).SortReduceDuplicates();
+    utils::Matrix removed = utils::Matrix<unsigned char>::Generate(M, N, nvals, seed + 2).SortReduceDuplicates();
+
+    auto spA = spla::Matrix::Make(M, N, spla::Types::Void(library), library);
+
+    auto spDesc = spla::Descriptor::Make(library);
+    spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+    spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+    auto spExpr = spla::Expression::Make(library);
+    auto spWrite = spExpr->MakeDataWrite(spA, a.GetDataIndices(library), spDesc);
+    auto spInsert = spExpr->MakeInsert(spA, inserted.GetDataIndices(library));
+    auto spRemove = spExpr->MakeRemove(spA, removed.GetDataIndices(library));
+    spExpr->Dependency(spWrite, spInsert);
+    spExpr->Dependency(spInsert, spRemove);
+    spExpr->Submit();
+    spExpr->Wait();
+
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    auto c = a.EWiseAdd(inserted, [](unsigned char x, unsigned char y) { return y; }).Mask(removed, true);
+    ASSERT_TRUE(c.EqualsStructure(spA));
+}
+
+void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter, const std::vector<std::size_t> &blocksSizes) {
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        auto spT = spla::Types::Float32(library);
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testInsert<float>(library, M, N, nvals, spT, i);
+            testRemove<float>(library, M, N, nvals, spT, i);
+        }
+    });
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        auto spT = spla::Types::Int32(library);
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testInsert<std::int32_t>(library, M, N, nvals, spT, i);
+            testRemove<std::int32_t>(library, M, N, nvals, spT, i);
+        }
+    });
+    utils::testBlocks(blocksSizes, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testNoValues(library, M, N, nvals, i);
+        }
+    });
+}
+
+TEST(MatrixInsertRemove, Small) {
+    std::vector<std::size_t> blocksSizes{10, 100, 1000};
+    std::size_t M = 100;
+    std::size_t N = 120;
+    test(M, N, M, M, 10, blocksSizes);
+}
+
+TEST(MatrixInsertRemove, Medium) {
+    std::vector<std::size_t> blocksSizes{100, 1000, 10000};
+    std::size_t M = 1000;
+    std::size_t N = 900;
+    test(M, N, M, M, 10, blocksSizes);
+}
+
+SPLA_GTEST_MAIN
@@ -221,6 +221,51 @@ TEST(MxM, Tiny) {
                              false);
 }
 
+TEST(MxM, SplitProducts) {
+    // Every blocks product is split into rows ranges
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetProductSplitThreshold(1));
+
+        auto spT = spla::Types::Int32(library);
+        auto spMult = spla::Functions::MultInt32(library);
+        auto spAdd = spla::Functions::PlusInt32(library);
+        auto intGen = utils::UniformIntGenerator<std::int32_t>();
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 800 + i * 800;
+            testCommon<std::int32_t>(library, 380, 440, 420, nvals, spT, spMult, spAdd, std::multiplies<>(), std::plus<>(), i, intGen);
+            testMasked<std::int32_t>(library, 380, 440, 420, nvals, spT, spMult, spAdd, std::multiplies<>(), std::plus<>(), i, intGen, false);
+            testNoValues(library, 380, 440, 420, nvals, i);
+        }
+    }
+}
+
+TEST(MxM, ForceHostPath) {
+    // Every blocks product is evaluated natively on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetForceHostPath(true));
+
+        auto spT = spla::Types::Int32(library);
+        auto spMult = spla::Functions::MultInt32(library);
+        auto spAdd = spla::Functions::PlusInt32(library);
+        auto intGen = utils::UniformIntGenerator<std::int32_t>();
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 800 + i * 800;
+            testCommon<std::int32_t>(library, 380, 440, 420, nvals, spT, spMult, spAdd, std::multiplies<>(), std::plus<>(), i, intGen);
+            testMasked<std::int32_t>(library, 380, 440, 420, nvals, spT, spMult, spAdd, std::multiplies<>(), std::plus<>(), i, intGen, false);
+            testMasked<std::int32_t>(library, 380, 440, 420, nvals, spT, spMult, spAdd, std::multiplies<>(), std::plus<>(), i, intGen, true);
+            testNoValues(library, 380, 440, 420, nvals, i);
+        }
+    }
+}
+
 TEST(MxM, Small) {
     std::vector<std::size_t> blockSizes = {100, 1000};
     std::size_t M = 80, K = 140, N = 120;
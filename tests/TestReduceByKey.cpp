@@ -219,4 +219,66 @@ TEST(ReduceByKey, PairKeySeveralSimilar) {
             {1, 4});
 }
 
+TEST(ReduceByKey, PairKeySegmentLengths) {
+    // Short segments, long segments, and short segments with a single long one
+    std::vector<std::size_t> mixedLengths(600, 1);
+    mixedLengths.push_back(200);
+
+    const std::vector<std::vector<std::size_t>> segmentsLengths = {
+            std::vector<std::size_t>(500, 2),
+            std::vector<std::size_t>(50, 40),
+            mixedLengths};
+
+    for (const auto &lengths : segmentsLengths) {
+        std::vector<std::uint32_t> keys1, keys2;
+        std::vector<std::uint8_t> values;
+        std::vector<std::uint32_t> keys1Expected, keys2Expected;
+        std::vector<std::uint8_t> valuesExpected;
+
+        for (std::size_t s = 0; s < lengths.size(); s++) {
+            std::uint8_t mult = 1, sum = 0;
+            for (std::size_t i = 0; i < lengths[s]; i++) {
+                auto a = static_cast<std::uint8_t>(1 + (i + s) % 3);
+                auto b = static_cast<std::uint8_t>((i * 7 + s) % 11);
+                keys1.push_back(static_cast<std::uint32_t>(s / 2));
+                keys2.push_back(static_cast<std::uint32_t>(s % 2));
+                values.push_back(a);
+                values.push_back(b);
+                mult = static_cast<std::uint8_t>(mult * a);
+                sum = static_cast<std::uint8_t>(sum + b);
+            }
+            keys1Expected.push_back(static_cast<std::uint32_t>(s / 2));
+            keys2Expected.push_back(static_cast<std::uint32_t>(s % 2));
+            valuesExpected.push_back(mult);
+            valuesExpected.push_back(sum);
+        }
+
+        std::vector<std::uint32_t> keysExpected_1;
+        std::vector<std::uint8_t> valuesExpected_1;
+
+        for (std::size_t s = 0; s < keys1Expected.size(); s++) {
+            if (s % 2 == 0) {
+                keysExpected_1.push_back(keys1Expected[s]);
+                valuesExpected_1.push_back(valuesExpected[s * 2]);
+                valuesExpected_1.push_back(valuesExpected[s * 2 + 1]);
+            } else {
+                auto &mult = valuesExpected_1[valuesExpected_1.size() - 2];
+                auto &sum = valuesExpected_1[valuesExpected_1.size() - 1];
+                mult = static_cast<std::uint8_t>(mult * valuesExpected[s * 2]);
+                sum = static_cast<std::uint8_t>(sum + valuesExpected[s * 2 + 1]);
+            }
+        }
+
+        TestReduceAlignedValuesByPairKey(
+                keys1,
+                keys2,
+                values,
+                keys1Expected,
+                keys2Expected,
+                valuesExpected,
+                keysExpected_1,
+                valuesExpected_1);
+    }
+}
+
 SPLA_GTEST_MAIN
@@ -0,0 +1,116 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <compute/SplaScan.hpp>
+#include <numeric>
+
+namespace {
+    using Values = std::vector<unsigned int>;
+
+    constexpr std::size_t TILE_SIZE = spla::detail::SinglePassScanKernel::MAX_WORK_GROUP_SIZE *
+                                      spla::detail::SinglePassScanKernel::ITEMS_PER_THREAD;
+
+    Values read(const boost::compute::vector<unsigned int> &deviceValues, boost::compute::command_queue &queue) {
+        Values values(deviceValues.size());
+        boost::compute::copy(deviceValues.begin(), deviceValues.end(), values.begin(), queue);
+        return values;
+    }
+
+    void test(std::size_t count, std::size_t seed) {
+        using namespace boost;
+        auto ctx = compute::system::default_context();
+        auto queue = compute::system::default_queue();
+
+        // Small values and flags with zeros to check compaction
+        Values values = utils::GenerateVector<unsigned int>(count, utils::UniformIntGenerator<unsigned int>(seed, 0, 3));
+
+        Values exclusive(count);
+        std::exclusive_scan(values.begin(), values.end(), exclusive.begin(), 0u);
+        const std::size_t sum = std::accumulate(values.begin(), values.end(), std::size_t{0});
+
+        Values inclusiveMax(count);
+        std::inclusive_scan(values.begin(), values.end(), inclusiveMax.begin(),
+                            [](unsigned int x, unsigned int y) { return std::max(x, y); });
+        const std::size_t max = count > 0 ? inclusiveMax.back() : 0;
+
+        Values compacted;
+        for (std::size_t i = 0; i < count; i++)
+            if (values[i])
+                compacted.push_back(static_cast<unsigned int>(i));
+
+        compute::vector<unsigned int> deviceValues(count, ctx);
+        compute::vector<unsigned int> result(count, ctx);
+        compute::copy(values.begin(), values.end(), deviceValues.begin(), queue);
+
+        EXPECT_EQ(spla::ExclusiveScan(deviceValues.begin(), deviceValues.end(), result.begin(), queue), sum);
+        EXPECT_EQ(read(result, queue), exclusive);
+
+        EXPECT_EQ(spla::InclusiveScanMax(deviceValues.begin(), deviceValues.end(), result.begin(), queue), max);
+        EXPECT_EQ(read(result, queue), inclusiveMax);
+
+        compute::vector<unsigned int> indices(ctx);
+        EXPECT_EQ(spla::Compact(deviceValues.begin(), deviceValues.end(), indices, queue), compacted.size());
+        EXPECT_EQ(read(indices, queue), compacted);
+
+        // In-place scans with reused status
+        spla::ScanStatus status(ctx);
+
+        compute::copy(values.begin(), values.end(), result.begin(), queue);
+        spla::ExclusiveScan(result.begin(), result.end(), result.begin(), status, queue);
+        EXPECT_EQ(status.ReadTotal(queue), sum);
+        EXPECT_EQ(read(result, queue), exclusive);
+
+        compute::copy(values.begin(), values.end(), result.begin(), queue);
+        spla::InclusiveScanMax(result.begin(), result.end(), result.begin(), status, queue);
+        EXPECT_EQ(status.ReadTotal(queue), max);
+        EXPECT_EQ(read(result, queue), inclusiveMax);
+    }
+}// namespace
+
+TEST(Scan, Empty) {
+    test(0, 0);
+}
+
+TEST(Scan, Single) {
+    for (std::size_t seed = 0; seed < 4; seed++)
+        test(1, seed);
+}
+
+TEST(Scan, SingleTile) {
+    test(TILE_SIZE - 1, 0);
+    test(TILE_SIZE, 1);
+    test(TILE_SIZE + 1, 2);
+}
+
+TEST(Scan, ManyTiles) {
+    test(TILE_SIZE * 37 + 5, 0);
+    test(TILE_SIZE * 1000, 1);
+    test((1u << 22) + 3, 2);
+}
+
+SPLA_GTEST_MAIN
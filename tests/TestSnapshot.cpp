@@ -0,0 +1,161 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+
+#include <cstdio>
+
+void testMatrix(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix source = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spM = spla::Matrix::Make(M, N, spT, library);
+
+    auto spExpr = spla::Expression::Make(library);
+    spExpr->MakeDataWrite(spM, source.GetData(library));
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    std::string filename = "TestSnapshot_" + std::to_string(seed) + ".splamtx";
+    spM->Save(filename);
+    auto spLoaded = spla::Matrix::Load(filename, spT, library);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(spLoaded->GetNrows(), M);
+    ASSERT_EQ(spLoaded->GetNcols(), N);
+    ASSERT_EQ(spLoaded->GetNvals(), source.GetNvals());
+    ASSERT_TRUE(source.Equals(spLoaded));
+}
+
+void testMapped(spla::Library &library, std::size_t M, std::size_t N, std::size_t nvals, std::size_t seed = 0) {
+    utils::Matrix source = utils::Matrix<float>::Generate(M, N, nvals, seed).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spM = spla::Matrix::Make(M, N, spT, library);
+
+    auto spExpr = spla::Expression::Make(library);
+    spExpr->MakeDataWrite(spM, source.GetData(library));
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    std::string filename = "TestSnapshot_" + std::to_string(seed) + ".splamtx";
+    std::string filenameCopy = "TestSnapshot_" + std::to_string(seed) + "_copy.splamtx";
+    spM->Save(filename);
+
+    {
+        auto spMapped = spla::Matrix::Map(filename, spT, library);
+        ASSERT_EQ(spMapped->GetNvals(), source.GetNvals());
+
+        // Read twice, so evicted blocks are uploaded again
+        ASSERT_TRUE(source.Equals(spMapped));
+        ASSERT_TRUE(source.Equals(spMapped));
+
+        // Clone shares uploaded blocks and budget with mapped matrix
+        auto spCloned = spMapped->Clone().Cast<spla::Matrix>();
+        ASSERT_TRUE(source.Equals(spCloned));
+        ASSERT_TRUE(source.Equals(spMapped));
+
+        // Mapped blocks are saved from the mapped file as is
+        spMapped->Save(filenameCopy);
+        auto spLoaded = spla::Matrix::Load(filenameCopy, spT, library);
+        ASSERT_TRUE(source.Equals(spLoaded));
+    }
+
+    std::remove(filename.c_str());
+    std::remove(filenameCopy.c_str());
+}
+
+void testVector(spla::Library &library, std::size_t M, std::size_t nvals, std::size_t seed = 0) {
+    utils::Vector source = utils::Vector<float>::Generate(M, nvals, seed).SortReduceDuplicates();
+    source.Fill(utils::UniformRealGenerator<float>());
+
+    auto spT = spla::Types::Float32(library);
+    auto spV = spla::Vector::Make(M, spT, library);
+
+    auto spExpr = spla::Expression::Make(library);
+    spExpr->MakeDataWrite(spV, source.GetData(library));
+    spExpr->SubmitWait();
+    ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+
+    std::string filename = "TestSnapshot_" + std::to_string(seed) + ".splavec";
+    spV->Save(filename);
+    auto spLoaded = spla::Vector::Load(filename, spT, library);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(spLoaded->GetNrows(), M);
+    ASSERT_EQ(spLoaded->GetNvals(), source.GetNvals());
+    ASSERT_TRUE(source.Equals(spLoaded));
+}
+
+void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter) {
+    utils::testBlocks({1000, 10000, 100000}, [=](spla::Library &library) {
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testMatrix(library, M, N, nvals, i);
+            testVector(library, M, nvals, i);
+        }
+    });
+}
+
+void testBudget(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std::size_t iter) {
+    for (std::size_t blockSize : {100, 1000}) {
+        // Budget of a single small block forces eviction on almost every upload
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetMappedMemoryBudget(blockSize * 8));
+
+        for (std::size_t i = 0; i < iter; i++) {
+            std::size_t nvals = base + i * step;
+            testMapped(library, M, N, nvals, i);
+        }
+    }
+}
+
+TEST(Snapshot, Small) {
+    std::size_t M = 100, N = 200;
+    test(M, N, M, M, 5);
+}
+
+TEST(Snapshot, Medium) {
+    std::size_t M = 1300, N = 2100;
+    test(M, N, M, M, 5);
+}
+
+TEST(Snapshot, Large) {
+    std::size_t M = 10300, N = 18000;
+    test(M, N, M, M, 3);
+}
+
+TEST(Snapshot, MappedBudget) {
+    std::size_t M = 1300, N = 2100;
+    testBudget(M, N, M, M, 5);
+}
+
+SPLA_GTEST_MAIN
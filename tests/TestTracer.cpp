@@ -0,0 +1,258 @@
+/**********************************************************************************/
+/* This file is part of spla project                                              */
+/* https://github.com/JetBrains-Research/spla                                     */
+/**********************************************************************************/
+/* MIT License                                                                    */
+/*                                                                                */
+/* Copyright (c) 2021 JetBrains-Research                                          */
+/*                                                                                */
+/* Permission is hereby granted, free of charge, to any person obtaining a copy   */
+/* of this software and associated documentation files (the "Software"), to deal  */
+/* in the Software without restriction, including without limitation the rights   */
+/* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      */
+/* copies of the Software, and to permit persons to whom the Software is          */
+/* furnished to do so, subject to the following conditions:                       */
+/*                                                                                */
+/* The above copyright notice and this permission notice shall be included in all */
+/* copies or substantial portions of the Software.                                */
+/*                                                                                */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     */
+/* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       */
+/* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    */
+/* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         */
+/* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  */
+/* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE  */
+/* SOFTWARE.                                                                      */
+/**********************************************************************************/
+
+#include <Testing.hpp>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    /** Minimal JSON value to check structure of the trace file */
+    struct JsonValue {
+        enum class Kind {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        Kind kind = Kind::Null;
+        double number = 0;
+        std::string string;
+        std::vector<JsonValue> array;
+        std::map<std::string, JsonValue> object;
+
+        [[nodiscard]] bool Has(const std::string &key) const {
+            return kind == Kind::Object && object.find(key) != object.end();
+        }
+
+        [[nodiscard]] const JsonValue &At(const std::string &key) const {
+            return object.at(key);
+        }
+    };
+
+    /** Strict recursive descent JSON parser; throws std::runtime_error on malformed input */
+    class JsonParser {
+    public:
+        explicit JsonParser(std::string text) : mText(std::move(text)) {}
+
+        JsonValue Parse() {
+            auto value = ParseValue();
+            SkipSpaces();
+            Expect(mPos == mText.size(), "trailing characters");
+            return value;
+        }
+
+    private:
+        JsonValue ParseValue() {
+            SkipSpaces();
+            Expect(mPos < mText.size(), "unexpected end");
+
+            JsonValue value;
+            char c = mText[mPos];
+
+            if (c == '{') {
+                value.kind = JsonValue::Kind::Object;
+                mPos += 1;
+                SkipSpaces();
+                if (Consume('}'))
+                    return value;
+                do {
+                    SkipSpaces();
+                    auto key = ParseString();
+                    SkipSpaces();
+                    Expect(Consume(':'), "expected ':'");
+                    value.object[key] = ParseValue();
+                    SkipSpaces();
+                } while (Consume(','));
+                Expect(Consume('}'), "expected '}'");
+            } else if (c == '[') {
+                value.kind = JsonValue::Kind::Array;
+                mPos += 1;
+                SkipSpaces();
+                if (Consume(']'))
+                    return value;
+                do {
+                    value.array.push_back(ParseValue());
+                    SkipSpaces();
+                } while (Consume(','));
+                Expect(Consume(']'), "expected ']'");
+            } else if (c == '"') {
+                value.kind = JsonValue::Kind::String;
+                value.string = ParseString();
+            } else if (ConsumeWord("true") || ConsumeWord("false")) {
+                value.kind = JsonValue::Kind::Bool;
+            } else if (ConsumeWord("null")) {
+                value.kind = JsonValue::Kind::Null;
+            } else {
+                value.kind = JsonValue::Kind::Number;
+                std::size_t parsed = 0;
+                value.number = std::stod(mText.substr(mPos), &parsed);
+                mPos += parsed;
+            }
+
+            return value;
+        }
+
+        std::string ParseString() {
+            Expect(Consume('"'), "expected string");
+            std::string result;
+
+            while (true) {
+                Expect(mPos < mText.size(), "unterminated string");
+                char c = mText[mPos++];
+                if (c == '"')
+                    return result;
+                Expect(static_cast<unsigned char>(c) >= 0x20, "control character in string");
+                if (c == '\\') {
+                    Expect(mPos < mText.size(), "unterminated escape");
+                    char escaped = mText[mPos++];
+                    Expect(std::string("\"\\/bfnrtu").find(escaped) != std::string::npos, "invalid escape");
+                    if (escaped == 'u')
+                        mPos += 4;
+                    c = escaped == 'n' ? '\n' : escaped;
+                }
+                result.push_back(c);
+            }
+        }
+
+        void SkipSpaces() {
+            while (mPos < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPos])))
+                mPos += 1;
+        }
+
+        bool Consume(char c) {
+            if (mPos < mText.size() && mText[mPos] == c) {
+                mPos += 1;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeWord(const std::string &word) {
+            if (mText.compare(mPos, word.size(), word) != 0)
+                return false;
+            mPos += word.size();
+            return true;
+        }
+
+        void Expect(bool condition, const char *message) const {
+            if (!condition)
+                throw std::runtime_error(std::string(message) + " at " + std::to_string(mPos));
+        }
+
+        std::string mText;
+        std::size_t mPos = 0;
+    };
+
+    void runExpression(spla::Library &library, std::size_t M, std::size_t nvals) {
+        utils::Vector a = utils::Vector<std::int32_t>::Generate(M, nvals, 0).SortReduceDuplicates();
+        utils::Vector b = utils::Vector<std::int32_t>::Generate(M, nvals, 1).SortReduceDuplicates();
+        a.Fill(utils::UniformGenerator<std::int32_t>());
+        b.Fill(utils::UniformGenerator<std::int32_t>());
+
+        auto spT = spla::Types::Int32(library);
+        auto spA = spla::Vector::Make(M, spT, library);
+        auto spB = spla::Vector::Make(M, spT, library);
+        auto spC = spla::Vector::Make(M, spT, library);
+
+        auto spDesc = spla::Descriptor::Make(library);
+        spDesc->SetParam(spla::Descriptor::Param::ValuesSorted);
+        spDesc->SetParam(spla::Descriptor::Param::NoDuplicates);
+
+        auto spExpr = spla::Expression::Make(library);
+        auto spWriteA = spExpr->MakeDataWrite(spA, a.GetData(library), spDesc);
+        auto spWriteB = spExpr->MakeDataWrite(spB, b.GetData(library), spDesc);
+        auto spEAdd = spExpr->MakeEWiseAdd(spC, nullptr, spla::Functions::PlusInt32(library), spA, spB);
+        spExpr->Dependency(spWriteA, spEAdd);
+        spExpr->Dependency(spWriteB, spEAdd);
+        spExpr->Submit();
+        spExpr->Wait();
+        ASSERT_EQ(spExpr->GetState(), spla::Expression::State::Evaluated);
+    }
+}// namespace
+
+TEST(Tracer, ExpressionTrace) {
+    std::string filename = "TestTracer.json";
+    std::remove(filename.c_str());
+
+    // Trace is written on library destruction
+    {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(100)
+                                      .SetTraceFilename(filename));
+        runExpression(library, 1000, 500);
+    }
+
+    std::ifstream file(filename);
+    ASSERT_TRUE(file.is_open());
+    std::stringstream text;
+    text << file.rdbuf();
+
+    JsonValue root;
+    ASSERT_NO_THROW(root = JsonParser(text.str()).Parse());
+    ASSERT_TRUE(root.Has("traceEvents"));
+    ASSERT_EQ(root.At("traceEvents").kind, JsonValue::Kind::Array);
+
+    std::size_t taskSpans = 0;
+    std::size_t algoSpans = 0;
+    std::size_t memoryCounters = 0;
+
+    for (const auto &event : root.At("traceEvents").array) {
+        ASSERT_EQ(event.kind, JsonValue::Kind::Object);
+        ASSERT_TRUE(event.Has("name") && event.Has("ph") && event.Has("pid") && event.Has("tid"));
+
+        const auto &phase = event.At("ph").string;
+
+        if (phase == "X") {
+            ASSERT_TRUE(event.Has("cat") && event.Has("ts") && event.Has("dur"));
+            EXPECT_GE(event.At("dur").number, 0);
+            taskSpans += event.At("cat").string == "task";
+            algoSpans += event.At("cat").string == "algo";
+        } else if (phase == "C") {
+            ASSERT_TRUE(event.Has("ts") && event.Has("args"));
+            ASSERT_TRUE(event.At("args").Has("bytes"));
+            memoryCounters += event.At("name").string == "Vector blocks memory";
+        } else {
+            EXPECT_EQ(phase, "M");
+        }
+    }
+
+    EXPECT_GT(taskSpans, 0);
+    EXPECT_GT(algoSpans, 0);
+    EXPECT_GT(memoryCounters, 0);
+
+    std::remove(filename.c_str());
+}
+
+SPLA_GTEST_MAIN
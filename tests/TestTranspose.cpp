@@ -242,6 +242,30 @@ void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std:
     });
 }
 
+TEST(Transpose, ForceHostPath) {
+    // Every block is transposed on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetForceHostPath(true));
+
+        using T = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spAccum = spla::Functions::PlusInt32(library);
+        auto accum = [](T a, T b) { return a + b; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 500 + i * 500;
+            testCommon<T>(library, 420, 380, nvals, spT, i);
+            testWithAccum<T>(library, 420, 380, nvals, spT, spAccum, accum, i);
+            testMasked<T>(library, 420, 380, nvals, spT, spAccum, accum, true, i);
+            testMasked<T>(library, 420, 380, nvals, spT, spAccum, accum, false, i);
+            testNoValues(library, 420, 380, nvals, i);
+        }
+    }
+}
+
 TEST(Transpose, Small) {
     std::vector<std::size_t> blocksSizes{100, 1000};
     std::size_t M = 100;
@@ -217,6 +217,28 @@ TEST(VectorAssign, Small) {
     test(M, M / 2, M / 10, 10, blocksSizes);
 }
 
+TEST(VectorAssign, HostPath) {
+    // Every block is assigned on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetHostPathThreshold(1 << 20));
+
+        using Type = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spAccum = spla::Functions::PlusInt32(library);
+        auto accum = [](Type x, Type y) { return x + y; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 500 + i * 100;
+            testMasked<Type>(library, 1100, nvals, spT, spAccum, accum, i);
+            testMaskedComplement<Type>(library, 1100, nvals, spT, spAccum, accum, i);
+            testNoValues(library, 1100, nvals, i);
+        }
+    }
+}
+
 TEST(VectorAssign, Medium) {
     std::vector<std::size_t> blocksSizes{100, 1000, 10000};
     std::size_t M = 1100;
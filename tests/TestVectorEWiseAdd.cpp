@@ -26,6 +26,11 @@
 /**********************************************************************************/
 
 #include <Testing.hpp>
+#include <core/SplaKernelTuner.hpp>
+#include <core/SplaLibraryPrivate.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 template<typename Type, typename BinaryOp>
 void testCommon(spla::Library &library, std::size_t M, std::size_t nvals,
@@ -278,6 +283,135 @@ TEST(VectorEWiseAdd, Small) {
     test(M, M / 2, M / 10, 10, blocksSizes);
 }
 
+TEST(VectorEWiseAdd, HostPath) {
+    // Every blocks pair is merged on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetHostPathThreshold(1 << 20));
+
+        auto spT = spla::Types::Int32(library);
+        auto spOp = spla::Functions::PlusInt32(library);
+        auto spDeviceOp = spla::FunctionBinary::Make(spT, spT, spT, spOp->GetSource(), library);
+        auto op = [](std::int32_t x, std::int32_t y) { return x + y; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 500 + i * 100;
+            testCommon<std::int32_t>(library, 1100, nvals, spT, spOp, op, i);
+            testCommon<std::int32_t>(library, 1100, nvals, spT, spDeviceOp, op, i);
+            testMasked<std::int32_t>(library, 1100, nvals, spT, spOp, op, i);
+            testMaskedComplement<std::int32_t>(library, 1100, nvals, spT, spOp, op, i);
+            testOneIsEmpty<std::int32_t>(library, 1100, nvals, spT, spOp, op, i);
+            testNoValues(library, 1100, nvals, i);
+        }
+    }
+}
+
+namespace {
+    struct TunedValue {
+        std::string device;
+        std::string parameter;
+        std::size_t value = 0;
+    };
+
+    std::vector<TunedValue> readTuningFile(const std::string &filename) {
+        std::vector<TunedValue> values;
+        std::ifstream file(filename);
+        std::string line;
+
+        while (std::getline(file, line)) {
+            std::istringstream stream(line);
+            TunedValue entry;
+            std::getline(stream, entry.device, '\t');
+            std::getline(stream, entry.parameter, '\t');
+            stream >> entry.value;
+            values.push_back(entry);
+        }
+
+        return values;
+    }
+}// namespace
+
+TEST(VectorEWiseAdd, KernelTuning) {
+    std::string filename = "TestVectorEWiseAdd_KernelTuning.txt";
+    std::remove(filename.c_str());
+
+    auto runWorkload = [](spla::Library &library) {
+        auto spT = spla::Types::Int32(library);
+        auto spOp = spla::Functions::PlusInt32(library);
+        auto op = [](std::int32_t x, std::int32_t y) { return x + y; };
+
+        for (std::size_t i = 0; i < 3; i++) {
+            std::size_t nvals = 150000 + i * 10000;
+            testCommon<std::int32_t>(library, 300000, nvals, spT, spOp, op, i);
+            testMasked<std::int32_t>(library, 300000, nvals, spT, spOp, op, i);
+        }
+    };
+
+    // First large launches benchmark candidates and store the fastest ones
+    {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(1000000)
+                                      .SetKernelTuning(true)
+                                      .SetKernelTuningFilename(filename));
+        runWorkload(library);
+    }
+
+    auto tuned = readTuningFile(filename);
+    ASSERT_FALSE(tuned.empty());
+
+    // Values, which are not benchmarked, since they are present only in the file
+    std::string parameter = "TestVectorEWiseAdd_KernelTuning";
+    std::string staleParameter = "TestVectorEWiseAdd_KernelTuning_Stale";
+    std::string malformedParameter = "TestVectorEWiseAdd_KernelTuning_Malformed";
+    {
+        spla::Library library(spla::Library::Config().SetDeviceType(spla::Library::Config::GPU));
+        auto device = library.GetPrivate().GetDevices().front();
+        auto deviceKey = spla::KernelTuner::GetDeviceKey(device);
+        std::ofstream file(filename, std::ios::app);
+        file << deviceKey << '\t' << parameter << '\t' << 2 << '\n'
+             << deviceKey << '\t' << staleParameter << '\t' << 42 << '\n'
+             << deviceKey << '\t' << malformedParameter << '\t' << "none" << '\n';
+    }
+
+    // New library loads the file and uses stored values without benchmarking
+    {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(1000000)
+                                      .SetKernelTuningFilename(filename));
+        auto device = library.GetPrivate().GetDevices().front();
+        auto deviceKey = spla::KernelTuner::GetDeviceKey(device);
+        auto &tuner = spla::KernelTuner::Instance();
+        auto work = spla::KernelTuner::MIN_TUNING_WORK;
+        auto fail = [](std::size_t) { FAIL() << "Tuned value must not be benchmarked"; };
+
+        EXPECT_EQ(tuner.Select(device, parameter, {1, 2}, 1, work, fail), 2);
+
+        // Values, which are not candidates or are not parsed, are replaced by default one
+        EXPECT_EQ(tuner.Select(device, staleParameter, {1, 2}, 1, work, fail), 1);
+        EXPECT_EQ(tuner.Select(device, malformedParameter, {1, 2}, 1, work, fail), 1);
+
+        for (const auto &entry : tuned) {
+            EXPECT_EQ(entry.device, deviceKey);
+            EXPECT_EQ(tuner.Select(device, entry.parameter, {entry.value, entry.value + 1}, 0, work, fail), entry.value);
+        }
+
+        runWorkload(library);
+
+        // Libraries existing at the same time must share the tuning file
+        EXPECT_ANY_THROW(spla::Library(spla::Library::Config()
+                                               .SetDeviceType(spla::Library::Config::GPU)
+                                               .SetKernelTuningFilename(filename + ".other")));
+    }
+
+    EXPECT_EQ(readTuningFile(filename).size(), tuned.size() + 3);
+
+    std::remove(filename.c_str());
+}
+
 TEST(VectorEWiseAdd, Medium) {
     std::vector<std::size_t> blocksSizes{100, 1000, 10000};
     std::size_t M = 1100;
@@ -111,6 +111,46 @@ TEST(VectorReduce, Small) {
     test(M, M / 2, M / 10, 10, blocksSizes);
 }
 
+TEST(VectorReduce, HostPath) {
+    // Every block is reduced by single work item
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetHostPathThreshold(1 << 20));
+
+        using Type = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spAccum = spla::Functions::PlusInt32(library);
+        auto accum = [](Type x, Type y) { return x + y; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 1 + i * 250;
+            testSimple<Type>(library, 1100, nvals, spT, spAccum, accum, i);
+        }
+
+        testEmpty<Type>(library, spT, spAccum);
+    }
+}
+
+TEST(VectorReduce, CustomFunction) {
+    // Predefined functions are reduced natively, functions from source use generic path
+    utils::testBlocks({100, 1000}, [](spla::Library &library) {
+        using Type = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spMax = spla::Functions::MaxInt32(library);
+        auto spCustomPlus = spla::FunctionBinary::Make(spT, spT, spT, spla::Functions::PlusInt32(library)->GetSource(), library);
+        auto max = [](Type x, Type y) { return std::max(x, y); };
+        auto plus = [](Type x, Type y) { return x + y; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 550 + i * 110;
+            testSimple<Type>(library, 1100, nvals, spT, spMax, max, i);
+            testSimple<Type>(library, 1100, nvals, spT, spCustomPlus, plus, i);
+        }
+    });
+}
+
 TEST(VectorReduce, Medium) {
     std::vector<std::size_t> blocksSizes{100, 1000, 10000};
     std::size_t M = 1100;
@@ -203,6 +203,58 @@ void test(std::size_t M, std::size_t N, std::size_t base, std::size_t step, std:
     });
 }
 
+TEST(VxM, SplitProducts) {
+    // Every blocks product is split into rows ranges
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetProductSplitThreshold(1));
+
+        using T = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spMult = spla::Functions::MultInt32(library);
+        auto spAdd = spla::Functions::PlusInt32(library);
+        auto mult = [](T a, T b) { return a * b; };
+        auto add = [](T a, T b) { return a + b; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 400 + i * 400;
+            testCommon<T>(library, 420, 380, nvals, spT, spMult, spAdd, mult, add, i);
+            testMasked<T>(library, 420, 380, nvals, spT, spMult, spAdd, mult, add, false, i);
+            testNoValues(library, 420, 380, nvals, i);
+        }
+    }
+}
+
+TEST(VxM, HostPath) {
+    // Every blocks product is evaluated on host
+    for (std::size_t blockSize : {100, 1000}) {
+        spla::Library library(spla::Library::Config()
+                                      .SetDeviceType(spla::Library::Config::GPU)
+                                      .SetBlockSize(blockSize)
+                                      .SetHostPathThreshold(1 << 20));
+
+        using T = std::int32_t;
+        auto spT = spla::Types::Int32(library);
+        auto spMult = spla::Functions::MultInt32(library);
+        auto spAdd = spla::Functions::PlusInt32(library);
+        auto spDeviceMult = spla::FunctionBinary::Make(spT, spT, spT, spMult->GetSource(), library);
+        auto spDeviceAdd = spla::FunctionBinary::Make(spT, spT, spT, spAdd->GetSource(), library);
+        auto mult = [](T a, T b) { return a * b; };
+        auto add = [](T a, T b) { return a + b; };
+
+        for (std::size_t i = 0; i < 5; i++) {
+            std::size_t nvals = 400 + i * 400;
+            testCommon<T>(library, 420, 380, nvals, spT, spMult, spAdd, mult, add, i);
+            testCommon<T>(library, 420, 380, nvals, spT, spDeviceMult, spDeviceAdd, mult, add, i);
+            testMasked<T>(library, 420, 380, nvals, spT, spMult, spAdd, mult, add, false, i);
+            testMasked<T>(library, 420, 380, nvals, spT, spMult, spAdd, mult, add, true, i);
+            testNoValues(library, 420, 380, nvals, i);
+        }
+    }
+}
+
 TEST(VxM, Small) {
     std::vector<std::size_t> blockSizes = {100, 1000};
     std::size_t M = 120, N = 80;